@@ -6,6 +6,84 @@
 
 #define LOG_MSG_COUNT (" @" + to_string(msgCount))
 
+//scale factors and URA tables shared by all instances. They are constant data computed at compile time
+//a helper to compute 2^n at compile time
+constexpr double POW2(int n) { return n == 0 ? 1.0 : (n > 0 ? 2.0 * POW2(n - 1) : 0.5 * POW2(n + 1)); }
+//scale factors for GPS (see GPS ICD)
+const double GNSSdataFromGRD::GPS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS] = {
+    {POW2(4), POW2(-31), POW2(-43), POW2(-55)},                     //T0c, Af0, Af1, Af2
+    {1.0, POW2(-5), POW2(-43) * ThisPI, POW2(-31) * ThisPI},        //IODE, Crs, Delta N, M0
+    {POW2(-29), POW2(-33), POW2(-29), POW2(-19)},                   //Cuc, e, Cus, sqrt(A)
+    {POW2(4), POW2(-29), POW2(-31) * ThisPI, POW2(-29)},            //TOE, Cic, Omega0, Cis
+    {POW2(-31) * ThisPI, POW2(-5), POW2(-31) * ThisPI, POW2(-43) * ThisPI},    //i0, Crc, w, w dot
+    {POW2(-43) * ThisPI, 1.0, 1.0, 1.0},                            //Idot, L2 codes, GPS week, L2P flag
+    {1.0, 1.0, POW2(-31), 1.0},                                     //SV accuracy, SV health, TGD, IODC
+    {0.01, 1.0, 0.0, 0.0},                                          //Transmission time of message in sec x 100, fit interval, spares
+    {POW2(-30), POW2(-27), POW2(-24), POW2(-24)},                   //Iono alfa0 to alfa3
+    {POW2(11), POW2(14), POW2(16), POW2(16)},                       //Iono beta0 to beta3
+    {POW2(-30), POW2(-50), POW2(12), 1.0},                          //GPST - UTC: A0, A1, t0t, WNt
+    {1.0, 1.0, 1.0, 1.0},
+    {1.0, 1.0, 1.0, 1.0}                                            //leap seconds
+};
+//scale factors for GLONASS (see GLONASS ICD)
+const double GNSSdataFromGRD::GLO_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS] = {
+    {1.0, POW2(-30), POW2(-40), 1.0},           //T0c, -TauN, +GammaN, Message frame time
+    {POW2(-11), POW2(-20), POW2(-30), 1.0},     //X, Vel X, Accel X, SV Health
+    {POW2(-11), POW2(-20), POW2(-30), 1.0},     //Y, Vel Y, Accel Y, Frequency number
+    {POW2(-11), POW2(-20), POW2(-30), 1.0},     //Z, Vel Z, Accel Z, Age of oper.
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {0.0, 0.0, 0.0, 0.0},
+    {POW2(-31), 0.0, 0.0, 0.0},                 //TauC
+    {POW2(-30), 0.0, 0.0, 0.0},                 //TauGPS
+    {0.0, 0.0, 0.0, 0.0}
+};
+//scale factors for Galileo (see Galileo OS ICD)
+const double GNSSdataFromGRD::GAL_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS] = {
+    {60.0, POW2(-34), POW2(-46), POW2(-59)},                        //T0c, Af0, Af1, Af2
+    {1.0, POW2(-5), POW2(-43) * ThisPI, POW2(-31) * ThisPI},        //IODnav, Crs, Delta N, M0
+    {POW2(-29), POW2(-33), POW2(-29), POW2(-19)},                   //Cuc, e, Cus, sqrt(A)
+    {60.0, POW2(-29), POW2(-31) * ThisPI, POW2(-29)},               //TOE, Cic, Omega0, Cis
+    {POW2(-31) * ThisPI, POW2(-5), POW2(-31) * ThisPI, POW2(-43) * ThisPI},    //i0, Crc, w, w dot
+    {POW2(-43) * ThisPI, 1.0, 1.0, 0.0},                            //Idot, data sources, GAL week, spare
+    {1.0, 1.0, POW2(-32), POW2(-32)},                               //SISA, SV health, BGD E5a/E1, BGD E5b/E1
+    {1.0, 1.0, 1.0, 1.0},                                           //Transmission time of message, spares
+    {POW2(-2), POW2(-8), POW2(-15), 0.0},                           //Iono Ai0, Ai1, Ai2, blank
+    {POW2(11), POW2(14), POW2(16), POW2(16)},
+    {POW2(-30), POW2(-50), 3600.0, 1.0},                            //GST - UTC: A0, A1, t0t, WNt
+    {POW2(-35), POW2(-51), 3600.0, 1.0},                            //GST - GPS time: A0G, A1G, t0G, WN0G
+    {1.0, 1.0, 1.0, 1.0}                                            //leap seconds
+};
+//scale factors for BDS (see BDS ICD)
+const double GNSSdataFromGRD::BDS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS] = {
+    {POW2(3), POW2(-33), POW2(-50), POW2(-66)},                     //T0c, Af0, Af1, Af2
+    {1.0, POW2(-6), POW2(-43) * ThisPI, POW2(-31) * ThisPI},        //AODE, Crs, Delta N, M0
+    {POW2(-31), POW2(-33), POW2(-31), POW2(-19)},                   //Cuc, e, Cus, sqrt(A)
+    {POW2(3), POW2(-31), POW2(-31) * ThisPI, POW2(-31)},            //T0e, Cic, Omega0, Cis
+    {POW2(-31) * ThisPI, POW2(-6), POW2(-31) * ThisPI, POW2(-43) * ThisPI},    //i0, Crc, w, w dot
+    {POW2(-43) * ThisPI, 0.0, 1.0, 0.0},                            //Idot, spare, BDT week, spare
+    {1.0, 1.0, 1.0, 1.0},                                           //SV accuracy, SatH1, TGD1, TGD2
+    {1.0, 1.0, 0.0, 0.0},                                           //Transmission time of message, AODC, spares
+    {POW2(-30), POW2(-27), POW2(-24), POW2(-24)},                   //Iono alfa0 to alfa3
+    {POW2(11), POW2(14), POW2(16), POW2(16)},                       //Iono beta0 to beta3
+    {POW2(-30), POW2(-50), 1.0, 1.0},                               //BDT - UTC: A0, A1
+    {1.0E-10, 1.0E-10, 1.0, 1.0},                                   //BDT - GPS time: A0GPS, A1GPS
+    {1.0, 1.0, 1.0, 1.0}                                            //leap seconds
+};
+//table to obtain in meters the value associated to the satellite accuracy index, as per GPS ICD 20.3.3.3.1.3
+const double GNSSdataFromGRD::GPS_URA[16] = {
+    2.0, 2.8, 4.0, 5.7, 8.0, 11.3, POW2(4), POW2(5),
+    POW2(6), POW2(7), POW2(8), POW2(9), POW2(10), POW2(11), POW2(12), 6144.0
+};
+//table to obtain in meters the value associated to the satellite accuracy index, as per BDS ICD
+const double GNSSdataFromGRD::BDS_URA[16] = {
+    2.4, 3.4, 4.85, 6.85, 9.65, 13.65, 24.0, 48.0,
+    96.0, 192.0, 384.0, 768.0, 1536.0, 3072.0, 6144.0, 6144.0
+};
+
 /**Constructs a GNSSdataFromGRD object using parameter passed.
  *
  *@param pl a pointer to the Logger to be used to record logging messages
@@ -39,7 +117,6 @@ GNSSdataFromGRD::~GNSSdataFromGRD(void) {
 bool GNSSdataFromGRD::openInputGRD(string inputFilePath, string inputFileName) {
     msgCount = 0;
     //open input raw data file
-    bool retVal = true;
     string inFileName = inputFilePath + inputFileName;
     if ((grdFile = fopen(inFileName.c_str(), "r")) == NULL) {
         plog->warning(LOG_MSG_ERROPEN + inFileName);
@@ -64,7 +141,8 @@ void GNSSdataFromGRD::closeInputGRD() {
 /**collectHeaderData extracts data from the current ORD or NRD file for the RINEX file header.
  * Also other parameters useful for processing observation or navigation data are collected here.
  * <p>To collect these data the whole file is parsed from begin to end, and lines with message types not containing
- * data useful for header are skipped.
+ * data useful for header are skipped. For NRD files, parsing ends when all constellations having navigation messages
+ * have provided the corrections for the header.
  * <p>Most data are collected only from the first file. Data from MT_SATOBS useful to identify systems and signals
  * being tracked, and from MT_SATNAV_GLONASS_L1_CA related to slot number and carrier frequency are collected from all files.
  * <p>Data collected are saved in the RinexData object passed.
@@ -96,11 +174,16 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
     bool tofoUnset = true;   //time of first observation not set
     int weekNumber;     //GPS week number without roll over
     string msgEpoch = "Fist epoch";
+    bool isNrdFile = false;
+    //corrections are looked for in each input file, as constellations can appear only in some of them
+    navCorrSet.clear();
     rewind(grdFile);
     while ((feof(grdFile) == 0) && (fscanf(grdFile, "%d;", &msgType) == 1)) {
         //there are messages in the raw data file
         msgCount++;
         logMsg = getMsgDescription(msgType);
+        //register constellations having navigation messages
+        if ((constId = navMsgSystem(msgType)) != 0) navCorrSet.insert(make_pair(constId, 0));
         switch(msgType) {
             case MT_GRDVER:
                 if ((fgets(msgBuffer, sizeof msgBuffer, grdFile) != msgBuffer)
@@ -109,6 +192,7 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
                     plog->severe(logMsg + "CANNOT process this file (.type;version): " + string(msgBuffer));
                     return false;
                 }
+                isNrdFile = NRD_FILE_EXTENSION.compare(0, string::npos, msgBuffer, NRD_FILE_EXTENSION.length()) == 0;
                 //fgets already reads the EOL (skipToEOM not neccesary)!
                 continue;
             case MT_DATE:
@@ -136,7 +220,7 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
             case MT_SATOBS:
                 //it includes data used to identify systems and signals being tracked
                 memset(smallBuffer, 0, sizeof smallBuffer);     //signal identification to be stored here
-                if (fscanf(grdFile, "%c%d;%c%c;%d;%*lld;%*lf;%d;%*lf;%*lf;%lf", &constId, &satNum, smallBuffer, smallBuffer+1, &trackState, &phaseState, &carrierFrequencyMHz) == 7) {
+                if (fscanf(grdFile, "%c%d;%c%c;%d;%*d;%*f;%d;%*f;%*f;%lf", &constId, &satNum, smallBuffer, smallBuffer+1, &trackState, &phaseState, &carrierFrequencyMHz) == 7) {
                     if (constId == 'R') satNum = gloOSN(satNum, *smallBuffer, carrierFrequencyMHz, true);
                     //ignore unknown measurements or not having at least a valid pseudorrange or carrier phase
                     if (isKnownMeasur(constId, satNum, *smallBuffer, *(smallBuffer+1))) {
@@ -167,7 +251,7 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
                 break;
             case MT_SATNAV_GPS_L1_CA:
                 //it includes data used in corrections (ionospheric, time, etc.) header lines
-                if (collectGPSL1CACorrections(rinex, msgType)) {
+                if (collectCorrections<GPSL1CATraits>(rinex, msgType)) {
                     rinex.setHdLnData(RinexData::SYS, 'G', aVectorStr);
                 }
                 break;
@@ -185,7 +269,7 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
                 break;
             case MT_SATNAV_GALILEO_INAV:
                 //it includes data used in corrections (ionospheric, time, etc.) header lines
-                if (collectGALINCorrections(rinex, msgType)) {
+                if (collectCorrections<GALINTraits>(rinex, msgType)) {
                     rinex.setHdLnData(RinexData::SYS, 'E', aVectorStr);
                 }
                 break;
@@ -195,7 +279,7 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
                 break;
             case MT_SATNAV_BEIDOU_D1:
                 //it includes data used in corrections (ionospheric, time, etc.) header lines
-                if (collectBDSD1Corrections(rinex, msgType)) {
+                if (collectCorrections<BDSD1Traits>(rinex, msgType)) {
                     rinex.setHdLnData(RinexData::SYS, 'C', aVectorStr);
                 }
                 break;
@@ -208,16 +292,21 @@ bool GNSSdataFromGRD::collectHeaderData(RinexData &rinex, int inFileNum = 0, int
                 break;
         }
         skipToEOM();
+        if (isNrdFile && navMsgSystem(msgType) != 0 && hasAllCorrections()) {
+            plog->config(LOG_MSG_ALLCORR + to_string(msgCount));
+            break;
+        }
     }
     if (inFileNum == inFileLast) {
         setHdSys(rinex);
         processFilterData(rinex);
         hasGLOsats = false;
-        for (int i=0; rinex.getHdLnData(RinexData::SYS, constId, aVectorStr, i); i++) {
+        aVectorStr.clear();
+        RinexData::DataRange<RinexData::GNSSsystem> hdSystems = rinex.getHdSystems();
+        for (RinexData::DataRange<RinexData::GNSSsystem>::const_iterator it = hdSystems.begin(); it != hdSystems.end(); it++) {
             //set empty PHSH records because Android does not provide specific data on this subject
-            aVectorStr.clear();
-            rinex.setHdLnData(RinexData::PHSH, constId, string(), 0.0, aVectorStr);
-            if (constId == 'R') hasGLOsats = true;
+            rinex.setHdLnData(RinexData::PHSH, it->system, string(), 0.0, aVectorStr);
+            if (it->system == 'R') hasGLOsats = true;
         }
         if (hasGLOsats) {
             //set empty GLPHS records because Android does not provides data on this subject
@@ -296,6 +385,7 @@ bool GNSSdataFromGRD::collectEpochObsData(RinexData &rinex) {
             case MT_EPOCH:
                 if (numMeasur > 0) plog->warning(getMsgDescription(msgType) + "Few MT_SATOBS in epoch");
                 tRx = collectAndSetEpochTime(rinex, tow, numMeasur, getMsgDescription(msgType) + "Epoch");
+                if (elevMask > 0.0) computeSatPositions(rinex);
                 break;
             case MT_SATOBS:
                 if (numMeasur <= 0) {
@@ -317,7 +407,10 @@ bool GNSSdataFromGRD::collectEpochObsData(RinexData &rinex) {
                 if (isKnownMeasur(constellId, satNum, signalId[1], signalId[2])) {
                     psAmbiguous = isPsAmbiguous(constellId, signalId+1, synchState, tRx, tRxGNSS, tTx);
                     phInvalid = isCarrierPhInvalid(constellId, signalId, carrierPhaseState);
-                    if (!psAmbiguous || !phInvalid) {
+                    if (isBelowMask(constellId, satNum)) {
+                        plog->finer(getMsgDescription(msgType) + string(1, constellId) + to_string(satNum) + MSG_SPACE +
+                                    string(signalId+1) + LOG_MSG_BELOWMASK);
+                    } else if (!psAmbiguous || !phInvalid) {
                         //from data available compute signal to noise RINEX index
                         sn_rnx = (int) (cn0db / 6);
                         if (sn_rnx < 1) sn_rnx = 1;
@@ -380,46 +473,14 @@ bool GNSSdataFromGRD::collectEpochObsData(RinexData &rinex) {
 /**collectNavData iterates over the input raw data file extracting navigation messages to process their data.
  * Data extracted are saved in a RinexData object for futher printing in a navigation RINEX file.
  * It is assumed that grdFile file type and version are the correct ones.
+ * When the MT_NAVTHREADS setup parameter is set, messages of each constellation are decoded in its own thread.
  *
  * @param rinex the RinexData object where data got from receiver will be placed
  * @return true when navigation data from at least one epoch messages have been acquired, false otherwise
  */
 bool GNSSdataFromGRD::collectNavData(RinexData &rinex) {
-    int msgType;
-    bool acquiredNavData = false;
-    msgCount = 0;
-    while (fscanf(grdFile, "%d;", &msgType) == 1) {
-        msgCount++;
-        switch(msgType) {
-            case MT_SATNAV_GPS_L1_CA:
-                acquiredNavData |= collectGPSL1CAEphemeris(rinex, msgType);
-                break;
-            case MT_SATNAV_GLONASS_L1_CA:
-                acquiredNavData |= collectGLOL1CAEphemeris(rinex, msgType);
-                break;
-            case MT_SATNAV_GALILEO_INAV:
-                acquiredNavData |= collectGALINEphemeris(rinex, msgType);
-                break;
-            case MT_SATNAV_BEIDOU_D1:
-                acquiredNavData |= collectBDSD1Ephemeris(rinex, msgType);
-                break;
-            case MT_SATNAV_GPS_L5_C:
-            case MT_SATNAV_GPS_C2:
-            case MT_SATNAV_GPS_L2_C:
-            case MT_SATNAV_GALILEO_FNAV:
-            case MT_SATNAV_BEIDOU_D2:
-                plog->warning(getMsgDescription(msgType) + MSG_NOT_IMPL + LOG_MSG_NAVIG);
-                break;
-            case MT_EPOCH:
-                break;
-            case MT_SATOBS:
-                plog->warning(getMsgDescription(msgType) + LOG_MSG_NONI);
-            default:
-                break;
-        }
-        skipToEOM();
-    }
-    return acquiredNavData;
+    if (navThreads) return decodeNavDataThreaded(rinex);
+    return decodeNavData(rinex);
 }
 
 /**processHdData sets the Rinex header record data from the contents of the given message.
@@ -486,6 +547,12 @@ bool GNSSdataFromGRD::processHdData(RinexData &rinex, int msgType, string msgCon
                 return rinex.setHdLnData(rinex.COMM, rinex.RUNBY, msgContent);
             case MT_MARKER_NUM:
                 return rinex.setHdLnData(rinex.MRKNUMBER, msgContent, svoid, svoid);
+            case MT_ELEVMASK:
+                elevMask = stod(msgContent) * dgrToRads;
+                return true;
+            case MT_NAVTHREADS:
+                navThreads = msgContent.find("TRUE") != string::npos;
+                return true;
             case MT_CLKOFFS:
                 clkoffset = stoi(msgContent);
                 rinex.setHdLnData(rinex.CLKOFFS, clkoffset);
@@ -549,199 +616,25 @@ void GNSSdataFromGRD::processFilterData(RinexData &rinex) {
  * <b>Called by the construtors
  */
 void GNSSdataFromGRD::setInitValues() {
+    grdFile = NULL;
     ordVersion = 0;
     nrdVersion = 0;
     msgCount = 0;
     clkoffset = 0;
     applyBias = false;
     fitInterval = false;
+    elevMask = 0.0;
+    hasRxPosition = false;
+    rxX = rxY = rxZ = 0.0;
+    navThreads = false;
+    navDecoding = NULL;
+    navMsgDecoding = 0;
+    navMsgPos = NULL;
+    navCorrSet.clear();
     //default values for roll overs
     nGPSrollOver = 2;
     nGALrollOver = 0;
     nBDSrollOver = 0;
-    //scale factors to apply to ephemeris
-    //set default values
-    double COMMON_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS]; //the scale factors to apply to GPS, GAL and BDS broadcast orbit data to obtain ephemeris
-    for (int i = 0; i < BO_LINSTOTAL; i++) {
-        for (int j = 0; j < BO_MAXCOLS; j++) {
-            COMMON_SCALEFACTOR[i][j] = 1.0;
-        }
-    }
-    //factors common to GPS, Glonass, Galileo or Beidou?
-    //SV clock data have specific factors for each constellation
-    //broadcast orbit 1
-    COMMON_SCALEFACTOR[1][1] = pow(2.0, -5.0);              //Crs
-    COMMON_SCALEFACTOR[1][2] = pow(2.0, -43.0) * ThisPI;	//Delta N
-    COMMON_SCALEFACTOR[1][3] = pow(2.0, -31.0) * ThisPI;	//M0
-    //broadcast orbit 2
-    COMMON_SCALEFACTOR[2][0] = pow(2.0, -29.0);	//Cuc
-    COMMON_SCALEFACTOR[2][1] = pow(2.0, -33.0);	//e
-    COMMON_SCALEFACTOR[2][2] = pow(2.0, -29.0);	//Cus
-    COMMON_SCALEFACTOR[2][3] = pow(2.0, -19.0);	//sqrt(A) ????
-    //broadcast orbit 3
-    COMMON_SCALEFACTOR[3][1] = pow(2.0, -29.0);	    //Cic
-    COMMON_SCALEFACTOR[3][2] = pow(2.0, -31.0) * ThisPI;	//Omega0
-    COMMON_SCALEFACTOR[3][3] = pow(2.0, -29.0);	    //Cis
-    //broadcast orbit 4
-    COMMON_SCALEFACTOR[4][0] = pow(2.0, -31.0) * ThisPI;	//i0
-    COMMON_SCALEFACTOR[4][1] = pow(2.0, -5.0);              //Crc
-    COMMON_SCALEFACTOR[4][2] = pow(2.0, -31.0) * ThisPI;	//w
-    COMMON_SCALEFACTOR[4][3] = pow(2.0, -43.0) * ThisPI;	//w dot
-    //broadcast orbit 5
-    COMMON_SCALEFACTOR[5][0] = pow(2.0, -43.0) * ThisPI;	//Idot
-    //Iono scale factors
-    COMMON_SCALEFACTOR[BO_LIN_IONOA][0] = pow(2.0, -30);   //Iono alfa0
-    COMMON_SCALEFACTOR[BO_LIN_IONOA][1] = pow(2.0, -27);   //Iono alfa1
-    COMMON_SCALEFACTOR[BO_LIN_IONOA][2] = pow(2.0, -24);   //Iono alfa2
-    COMMON_SCALEFACTOR[BO_LIN_IONOA][3] = pow(2.0, -24);   //Iono alfa3
-    COMMON_SCALEFACTOR[BO_LIN_IONOB][0] = pow(2.0, 11);   //Iono beta0
-    COMMON_SCALEFACTOR[BO_LIN_IONOB][1] = pow(2.0, 14);   //Iono beta1
-    COMMON_SCALEFACTOR[BO_LIN_IONOB][2] = pow(2.0, 16);   //Iono beta2
-    COMMON_SCALEFACTOR[BO_LIN_IONOB][3] = pow(2.0, 16);   //Iono beta3
-    //Time corrections common scale factors
-    COMMON_SCALEFACTOR[BO_LIN_TIMEU][0] = pow(2.0, -30);   //TCORR A0UTC
-    COMMON_SCALEFACTOR[BO_LIN_TIMEU][1] = pow(2.0, -50);   //TCORR A1UTC
-    COMMON_SCALEFACTOR[BO_LIN_TIMEU][3] = 1.0;      //WNt scale factor
-    COMMON_SCALEFACTOR[BO_LIN_TIMEG][2] = 1.0;
-    COMMON_SCALEFACTOR[BO_LIN_TIMEG][3] = 1.0;
-    //set scale factors for GPS
-    memcpy(GPS_SCALEFACTOR, COMMON_SCALEFACTOR, sizeof(GPS_SCALEFACTOR));
-    //SV clock data
-    GPS_SCALEFACTOR[0][0] = pow(2.0, 4.0);		//T0c
-    GPS_SCALEFACTOR[0][1] = pow(2.0, -31.0);	//Af0: SV clock bias
-    GPS_SCALEFACTOR[0][2] = pow(2.0, -43.0);	//Af1: SV clock drift
-    GPS_SCALEFACTOR[0][3] = pow(2.0, -55.0);	//Af2: SV clock drift rate GAL
-    //broadcast orbit 3
-    GPS_SCALEFACTOR[3][0] = pow(2.0, 4.0);		//TOE
-    //broadcast orbit 6
-    GPS_SCALEFACTOR[6][2] = pow(2.0, -31.0);	//TGD
-    //broadcast orbit 7
-    GPS_SCALEFACTOR[7][0] = 0.01;	//Transmission time of message in sec x 100
-    GPS_SCALEFACTOR[7][2] = 0.0;	//Spare
-    GPS_SCALEFACTOR[7][3] = 0.0;	//Spare
-    //GPST - UTC factors
-    GPS_SCALEFACTOR[BO_LIN_TIMEU][2] = pow(2.0, 12);    //t0t scale factor
-
-    //GPS_URA table to obtain in meters the value associated to the satellite accuracy index
-    //fill GPS_URA table as per GPS ICD 20.3.3.3.1.3
-    GPS_URA[0] = 2.0;		//0
-    GPS_URA[1] = 2.8;		//1
-    GPS_URA[2] = 4.0;		//2
-    GPS_URA[3] = 5.7;		//3
-    GPS_URA[4] = 8.0;		//4
-    GPS_URA[5] = 11.3;		//5
-    GPS_URA[6] = pow(2.0, 4.0);		//<=6
-    GPS_URA[7] = pow(2.0, 5.0);
-    GPS_URA[8] = pow(2.0, 6.0);
-    GPS_URA[9] = pow(2.0, 7.0);
-    GPS_URA[10] = pow(2.0, 8.0);
-    GPS_URA[11] = pow(2.0, 9.0);
-    GPS_URA[12] = pow(2.0, 10.0);
-    GPS_URA[13] = pow(2.0, 11.0);
-    GPS_URA[14] = pow(2.0, 12.0);
-    GPS_URA[15] = 6144.00;
-    //set factors for Galileo
-    memcpy(GAL_SCALEFACTOR, COMMON_SCALEFACTOR, sizeof(GAL_SCALEFACTOR));
-    //SV clock data
-    GAL_SCALEFACTOR[0][0] = 60.;		        //T0c
-    GAL_SCALEFACTOR[0][1] = pow(2.0, -34.0);	//Af0: SV clock bias
-    GAL_SCALEFACTOR[0][2] = pow(2.0, -46.0);	//Af1: SV clock drift
-    GAL_SCALEFACTOR[0][3] = pow(2.0, -59.0);	//Af2: SV clock drift rate
-    //broadcast orbit 3
-    GAL_SCALEFACTOR[3][0] = 60.;		//TOE
-    //broadcast orbit 5
-    GAL_SCALEFACTOR[5][3] = 0.0;		//spare
-    //broadcast orbit 6
-    GAL_SCALEFACTOR[6][2] = pow(2.0, -32.0);	//BGD E5a / E1
-    GAL_SCALEFACTOR[6][3] = pow(2.0, -32.0);	//BGD E5b / E1
-    //broadcast orbit 7
-    //GAL_SCALEFACTOR[7][0] = 1.0;	//Transmission time of message
-    //GAL_SCALEFACTOR[7][1] = 0.0;	//Spare
-    //GAL_SCALEFACTOR[7][2] = 0.0;	//Spare
-    //GAL_SCALEFACTOR[7][3] = 0.0;	//Spare
-    //other data stored in bom
-    GAL_SCALEFACTOR[BO_LIN_IONOA][0] = pow(2.0, -2);   //Iono Ai0
-    GAL_SCALEFACTOR[BO_LIN_IONOA][1] = pow(2.0, -8);   //Iono Ai1
-    GAL_SCALEFACTOR[BO_LIN_IONOA][2] = pow(2.0, -15);  //Iono Ai2
-    GAL_SCALEFACTOR[BO_LIN_IONOA][3] = 0.0;           //Iono blank
-    GAL_SCALEFACTOR[BO_LIN_TIMEU][2] = 3600;          //GST-UTC t0t
-    GAL_SCALEFACTOR[BO_LIN_TIMEG][0] = pow(2.0, -35);    //GST - GPS time corr. A0GPS
-    GAL_SCALEFACTOR[BO_LIN_TIMEG][1] = pow(2.0, -51);    //GST - GPS time corr. A1GPS
-    GAL_SCALEFACTOR[BO_LIN_TIMEG][2] = 3600;          //GST-GPS t0G
-    //Glonass scale factors
-    //SV clock data
-    GLO_SCALEFACTOR[0][0] = 1.;		            //T0c
-    GLO_SCALEFACTOR[0][1] = pow(2.0, -30.0);	//-TauN
-    GLO_SCALEFACTOR[0][2] = pow(2.0, -40.0);	//+GammaN
-    GLO_SCALEFACTOR[0][3] = 1.;					//Message frame time
-    //broadcast orbit 1
-    GLO_SCALEFACTOR[1][0] = pow(2.0, -11.0);	//X
-    GLO_SCALEFACTOR[1][1] = pow(2.0, -20.0);	//Vel X
-    GLO_SCALEFACTOR[1][2] = pow(2.0, -30.0);	//Accel X
-    GLO_SCALEFACTOR[1][3] = 1.;					//SV Health
-    //broadcast orbit 2
-    GLO_SCALEFACTOR[2][0] = pow(2.0, -11.0);	//Y
-    GLO_SCALEFACTOR[2][1] = pow(2.0, -20.0);	//Vel Y
-    GLO_SCALEFACTOR[2][2] = pow(2.0, -30.0);	//Accel Y
-    GLO_SCALEFACTOR[2][3] = 1.;					//Frequency number
-    //broadcast orbit 3
-    GLO_SCALEFACTOR[3][0] = pow(2.0, -11.0);	//Z
-    GLO_SCALEFACTOR[3][1] = pow(2.0, -20.0);	//Vel Z
-    GLO_SCALEFACTOR[3][2] = pow(2.0, -30.0);	//Accel Z
-    GLO_SCALEFACTOR[3][3] = 1.;					//Age of oper.
-    //other data stored in bom
-    GLO_SCALEFACTOR[BO_LIN_TIMEU][0] = pow(2.0, -31);    //TauC
-    GLO_SCALEFACTOR[BO_LIN_TIMEU][1] = 0.0;
-    GLO_SCALEFACTOR[BO_LIN_TIMEU][2] = 0.0;
-    GLO_SCALEFACTOR[BO_LIN_TIMEU][3] = 0.0;
-    GLO_SCALEFACTOR[BO_LIN_TIMEG][0] = pow(2.0, -30);    //TauGPS
-    GLO_SCALEFACTOR[BO_LIN_TIMEG][1] = 0.0;
-    GLO_SCALEFACTOR[BO_LIN_TIMEG][2] = 0.0;
-    GLO_SCALEFACTOR[BO_LIN_TIMEG][3] = 0.0;
-    //set scale factors for BDS
-    memcpy(BDS_SCALEFACTOR, COMMON_SCALEFACTOR, sizeof(BDS_SCALEFACTOR));
-    //SV clock data
-    BDS_SCALEFACTOR[0][0] = pow(2.0, 3.0);		//T0c
-    BDS_SCALEFACTOR[0][1] = pow(2.0, -33.0);	//Af0: SV clock bias
-    BDS_SCALEFACTOR[0][2] = pow(2.0, -50.0);	//Af1: SV clock drift
-    BDS_SCALEFACTOR[0][3] = pow(2.0, -66.0);	//Af2: SV clock drift rate GAL
-    //broadcast orbit 1
-    BDS_SCALEFACTOR[1][1] = pow(2.0, -6.0);     //Crs
-    //broadcast orbit 2
-    BDS_SCALEFACTOR[2][0] = pow(2.0, -31.0);	//Cuc
-    BDS_SCALEFACTOR[2][2] = pow(2.0, -31.0);	//Cus
-    //broadcast orbit 3
-    BDS_SCALEFACTOR[3][0] = pow(2.0, 3.0);	    //T0e
-    BDS_SCALEFACTOR[3][1] = pow(2.0, -31.0);	//Cic
-    BDS_SCALEFACTOR[3][3] = pow(2.0, -31.0);	//Cis
-    //broadcast orbit 4
-    BDS_SCALEFACTOR[4][1] = pow(2.0, -6.0);     //Crc
-    //broadcast orbit 5
-    BDS_SCALEFACTOR[5][1] = 0.0;	//Spare
-    BDS_SCALEFACTOR[5][3] = 0.0;	//Spare
-    //broadcast orbit 6
-    //broadcast orbit 7
-    BDS_SCALEFACTOR[7][2] = 0.0;	//Spare
-    BDS_SCALEFACTOR[7][3] = 0.0;	//Spare
-    //other data stored in bom
-    BDS_SCALEFACTOR[BO_LIN_TIMEG][0] = BDS_SCALEFACTOR[BO_LIN_TIMEG][1] = 1.0E-10;    //A0GPS, A1GPS
-    //BDS_URA table to obtain in meters the value associated to the satellite accuracy index
-    BDS_URA[0] = 2.4;
-    BDS_URA[1] = 3.4;
-    BDS_URA[2] = 4.85;
-    BDS_URA[3] = 6.85;
-    BDS_URA[4] = 9.65;
-    BDS_URA[5] = 13.65;
-    BDS_URA[6] = 24.0;
-    BDS_URA[7] = 48.0;
-    BDS_URA[8] = 96.0;
-    BDS_URA[9] = 192,0;
-    BDS_URA[10] = 384,0;
-    BDS_URA[11] = 768,0;
-    BDS_URA[12] = 1536.0;
-    BDS_URA[13] = 3072.0;
-    BDS_URA[14] = 6144.0;
-    BDS_URA[15] = 6144.0;
     //set tables to 0
     memset(gpsSatFrame, 0, sizeof(gpsSatFrame));
     memset(gloSatFrame, 0, sizeof(gloSatFrame));
@@ -749,107 +642,527 @@ void GNSSdataFromGRD::setInitValues() {
     for(int i=0; i<GLO_MAXSATELLITES; i++) glonassOSN_FCN[i].fcnSet = false;
     memset(nAhnA, 0, sizeof(nAhnA));
     memset(galInavSatFrame, 0, sizeof(galInavSatFrame));
+    memset(gpsCnavSatFrame, 0, sizeof(gpsCnavSatFrame));
+    memset(galFnavSatFrame, 0, sizeof(galFnavSatFrame));
+    memset(bdsD2SatFrame, 0, sizeof(bdsD2SatFrame));
+    memset(gpsLastEph, 0, sizeof(gpsLastEph));
+    memset(galLastEph, 0, sizeof(galLastEph));
+    memset(bdsLastEph, 0, sizeof(bdsLastEph));
+    memset(gpsCnavLastEph, 0, sizeof(gpsCnavLastEph));
+    memset(galFnavLastEph, 0, sizeof(galFnavLastEph));
+    memset(bdsD2LastEph, 0, sizeof(bdsD2LastEph));
 }
 
 
-//methods for GPS L1 CA message processing
-//A macro to get bit position in a subframe from the bit position (BITNUMBER) in the message subframe stated in the GPS ICD
-//Each GPS 30 bits message word is stored in an uint32_t (aligned to the rigth)
-//Each GPS subframe, comprising 10 words, is tored in an stream of 10 uint32_t
-//BITNUMBER is the position in the subframe, GPSL1CA_BIT gets the position in the stream
-#define GPSL1CA_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+//methods to decode navigation messages, serially or in one thread for each constellation
+//the constellations having a decoding thread
+const char NAV_THREAD_SYS[] = {'G', 'R', 'E', 'C'};
+#define NAV_THREADS (int) sizeof(NAV_THREAD_SYS)
 
-/**collectGPSL1CAEphemeris gets GPS L1 C/A navigation data from a raw message and store them to generate RINEX navigation files.
- * Satellite navigation messages are temporary stored until all needed subframes for the current satellite and epoch have been received.
- * When completed, satellite ephemeris are extracted from subframes, scaled to working units, and stored into "broadcast orbit lines"
- * of the RinexData object.
- * For GPS L1 C/A each subframe of the navigation message contains 10 30-bit words.
- * Each word (30 bits) should be fit into the last 30 bits in a 4-byte word (skip B31 and B32), with MSB first,
- * for a total of 40 bytes, covering a time period of 6, 6, and 0.6 seconds, respectively.
- * Only have interest subframes: 1,2,3 & page 18 of subframe 4 (pgID = 56 in GPS ICD Table 20-V)
+/**readNavMsgHeader reads the data preceding the message bytes in a satellite navigation message: status, satellite
+ * identification, two numbers whose meaning depends on the message type (subframe, page, string, frame, ...), and the
+ * message size. Data are read from the message being decoded from memory, if any, or from the input raw data file.
+ *
+ * @param status the status of the navigation message
+ * @param constId the constellation identification
+ * @param satNum the satellite number
+ * @param num1 the first number depending on the message type
+ * @param num2 the second number depending on the message type
+ * @param msgSize the message size in bytes
+ * @return true if all data have been read, false otherwise
+ */
+bool GNSSdataFromGRD::readNavMsgHeader(int &status, char &constId, int &satNum, int &num1, int &num2, int &msgSize) {
+    int n = 0;
+    if (navMsgPos == NULL) return fscanf(grdFile, "%d;%c%d;%d;%d;%d", &status, &constId, &satNum, &num1, &num2, &msgSize) == 6;
+    if (sscanf(navMsgPos, "%d;%c%d;%d;%d;%d%n", &status, &constId, &satNum, &num1, &num2, &msgSize, &n) != 6) return false;
+    navMsgPos += n;
+    return true;
+}
+
+/**readNavMsgByte reads the next message byte (an hexadecimal value preceded by ;) in a satellite navigation message.
+ * Data are read from the message being decoded from memory, if any, or from the input raw data file.
+ *
+ * @param byte the byte read
+ * @return true if the byte has been read, false otherwise
+ */
+bool GNSSdataFromGRD::readNavMsgByte(unsigned int &byte) {
+    char *end;
+    if (navMsgPos == NULL) return fscanf(grdFile, ";%X", &byte) == 1;
+    if (*navMsgPos != ';') return false;
+    byte = (unsigned int) strtoul(navMsgPos + 1, &end, 16);
+    if (end == navMsgPos + 1) return false;
+    navMsgPos = end;
+    return true;
+}
+
+/**decodeNavMsg decodes the navigation message of the given type, whose type has been already read, and skips to
+ * the end of the message. Messages not having navigation data are ignored.
+ *
+ * @param rinex the RinexData object where data got from receiver will be placed
+ * @param msgType the message type
+ * @return true when navigation data have been acquired from the message, false otherwise
+ */
+bool GNSSdataFromGRD::decodeNavMsg(RinexData &rinex, int msgType) {
+    bool acquiredNavData = false;
+    switch(msgType) {
+        case MT_SATNAV_GPS_L1_CA:
+            acquiredNavData = collectEphemeris<GPSL1CATraits>(rinex, msgType);
+            break;
+        case MT_SATNAV_GLONASS_L1_CA:
+            acquiredNavData = collectGLOL1CAEphemeris(rinex, msgType);
+            break;
+        case MT_SATNAV_GALILEO_INAV:
+            acquiredNavData = collectEphemeris<GALINTraits>(rinex, msgType);
+            break;
+        case MT_SATNAV_BEIDOU_D1:
+            acquiredNavData = collectEphemeris<BDSD1Traits>(rinex, msgType);
+            break;
+        case MT_SATNAV_GPS_L5_C:
+        case MT_SATNAV_GPS_L2_C:
+            acquiredNavData = collectEphemeris<GPSCNAVTraits>(rinex, msgType);
+            break;
+        case MT_SATNAV_GALILEO_FNAV:
+            acquiredNavData = collectEphemeris<GALFNTraits>(rinex, msgType);
+            break;
+        case MT_SATNAV_BEIDOU_D2:
+            acquiredNavData = collectEphemeris<BDSD2Traits>(rinex, msgType);
+            break;
+        case MT_SATNAV_GPS_C2:
+            plog->warning(getMsgDescription(msgType) + MSG_NOT_IMPL + LOG_MSG_NAVIG);
+            break;
+        case MT_EPOCH:
+            break;
+        case MT_SATOBS:
+            plog->warning(getMsgDescription(msgType) + LOG_MSG_NONI);
+        default:
+            break;
+    }
+    skipToEOM();
+    return acquiredNavData;
+}
+
+/**decodeNavData iterates over the input raw data file decoding navigation messages.
+ *
+ * @param rinex the RinexData object where data got from receiver will be placed
+ * @return true when navigation data from at least one epoch messages have been acquired, false otherwise
+ */
+bool GNSSdataFromGRD::decodeNavData(RinexData &rinex) {
+    int msgType;
+    bool acquiredNavData = false;
+    msgCount = 0;
+    while (fscanf(grdFile, "%d;", &msgType) == 1) {
+        msgCount++;
+        acquiredNavData |= decodeNavMsg(rinex, msgType);
+    }
+    return acquiredNavData;
+}
+
+/**decodeNavDataThreaded decodes navigation messages from the input raw data file using one thread for each constellation.
+ * Frame assembly data of each constellation are independent, and each thread uses its own GNSSdataFromGRD object,
+ * with the state of its constellation copied from this one. A reader thread reads the file once, from the current
+ * position, and queues each message to the thread of its constellation. The ephemeris decoded by the threads are
+ * queued, and saved into the RinexData object by the calling thread in the same order they would have been saved
+ * decoding messages serially, as soon as no thread can decode an older one.
+ * As queues are bounded (see NAV_QUEUESIZE), the memory used does not depend on the file size.
+ * Finally, the state of each constellation is copied back to continue decoding other files.
+ *
+ * @param rinex the RinexData object where data got from receiver will be placed
+ * @return true when navigation data from at least one epoch messages have been acquired, false otherwise
+ */
+bool GNSSdataFromGRD::decodeNavDataThreaded(RinexData &rinex) {
+    GNSSdataFromGRD *decoder[NAV_THREADS];
+    bool acquired[NAV_THREADS];
+    thread threads[NAV_THREADS];
+    NavDecoding decoding;
+    bool acquiredNavData = false;
+    plog->fine("Navigation data decoding threads:" + to_string(NAV_THREADS));
+    for (int i = 0; i < NAV_THREADS; ++i) {
+        decoder[i] = new GNSSdataFromGRD(plog);
+        decoder[i]->copyNavState(*this, NAV_THREAD_SYS[i]);
+        decoder[i]->navDecoding = &decoding;
+        acquired[i] = false;
+        threads[i] = thread([&rinex, &decoder, &acquired, i]() {
+            acquired[i] = decoder[i]->decodeQueuedNavMsgs(rinex);
+        });
+    }
+    thread reader([this, &decoder]() {
+        queueNavMsgs(decoder);
+    });
+    saveDecodedEph(rinex, decoder);
+    reader.join();
+    for (int i = 0; i < NAV_THREADS; ++i) {
+        threads[i].join();
+        acquiredNavData |= acquired[i];
+        copyNavState(*decoder[i], NAV_THREAD_SYS[i]);
+        delete decoder[i];
+    }
+    return acquiredNavData;
+}
+
+/**queueNavMsgs reads the input raw data file from the current position to its end, and queues each message to
+ * the decoder of its constellation, with its number in the file. Messages not related to any constellation having a
+ * decoder are queued to the first one. When the queue of a decoder is full, it waits until the decoder takes messages.
+ *
+ * @param decoder the decoders of the constellations in NAV_THREAD_SYS
+ */
+void GNSSdataFromGRD::queueNavMsgs(GNSSdataFromGRD *decoder[]) {
+    NavDecoding &decoding = *decoder[0]->navDecoding;
+    char buffer[256];
+    string msg;
+    int msgType, nRead, i;
+    char msgSys;
+    msgCount = 0;
+    while (fgets(buffer, sizeof buffer, grdFile) != NULL) {
+        msg += buffer;
+        if (msg.back() != '\n' && !feof(grdFile)) continue;     //the message continues
+        if ((nRead = sscanf(msg.c_str(), "%d;", &msgType)) != 1) {
+            if (nRead == EOF) {                 //empty line: skip it
+                msg.clear();
+                continue;
+            }
+            break;
+        }
+        msgCount++;
+        msgSys = navMsgSystem(msgType);
+        for (i = NAV_THREADS - 1; i > 0 && NAV_THREAD_SYS[i] != msgSys; --i);
+        unique_lock<mutex> lock(decoding.lock);
+        decoding.changed.wait(lock, [&decoder, i]() { return decoder[i]->navMsgQueue.size() < NAV_QUEUESIZE; });
+        decoder[i]->navMsgQueue.push_back(QueuedNavMsg(msgCount, msg));
+        decoding.nRead = msgCount;
+        decoding.changed.notify_all();
+        msg.clear();
+    }
+    lock_guard<mutex> lock(decoding.lock);
+    decoding.endRead = true;
+    decoding.changed.notify_all();
+}
+
+/**decodeQueuedNavMsgs decodes the messages queued to this constellation decoder until all messages have been read.
+ * Each message is decoded from memory, keeping its number in the input file.
+ *
+ * @param rinex the RinexData object passed to message decoding (ephemeris decoded are queued in decodedEph)
+ * @return true when navigation data from at least one epoch messages have been acquired, false otherwise
+ */
+bool GNSSdataFromGRD::decodeQueuedNavMsgs(RinexData &rinex) {
+    NavDecoding &decoding = *navDecoding;
+    bool acquiredNavData = false;
+    int msgType, n;
+    string msg;
+    for (;;) {
+        {
+            unique_lock<mutex> lock(decoding.lock);
+            decoding.changed.wait(lock, [this, &decoding]() { return !navMsgQueue.empty() || decoding.endRead; });
+            if (navMsgQueue.empty()) break;
+            msgCount = navMsgDecoding = navMsgQueue.front().msgNum;
+            msg.swap(navMsgQueue.front().msg);
+            navMsgQueue.pop_front();
+            decoding.changed.notify_all();
+        }
+        n = 0;
+        if (sscanf(msg.c_str(), "%d;%n", &msgType, &n) == 1 && n > 0) {
+            navMsgPos = msg.c_str() + n;
+            acquiredNavData |= decodeNavMsg(rinex, msgType);
+            navMsgPos = NULL;
+        }
+        lock_guard<mutex> lock(decoding.lock);
+        navMsgDecoding = 0;
+        decoding.changed.notify_all();
+    }
+    return acquiredNavData;
+}
+
+/**navMsgsDecoded gives the number of the last message up to which all messages queued to this decoder have been
+ * decoded, that is, any ephemeris it decodes later will come from a newer message.
+ * The lock of the shared decoding state shall be owned by the caller.
+ *
+ * @return the number of the message, or INT_MAX if the decoder has ended
+ */
+int GNSSdataFromGRD::navMsgsDecoded() {
+    if (navMsgDecoding != 0) return navMsgDecoding - 1;
+    if (!navMsgQueue.empty()) return navMsgQueue.front().msgNum - 1;
+    if (navDecoding->endRead) return INT_MAX;
+    return navDecoding->nRead;
+}
+
+/**saveDecodedEph saves the ephemeris queued by the decoders into the RinexData object and the orbits container, in the
+ * order of the messages they were completed in. The oldest ephemeris queued is saved when all other decoders having
+ * no ephemeris queued have already decoded the messages up to the one it was completed in.
+ * It ends when all decoders have ended and their queues are empty.
+ *
+ * @param rinex the RinexData object where data will be saved
+ * @param decoder the decoders of the constellations in NAV_THREAD_SYS
+ */
+void GNSSdataFromGRD::saveDecodedEph(RinexData &rinex, GNSSdataFromGRD *decoder[]) {
+    NavDecoding &decoding = *decoder[0]->navDecoding;
+    unique_lock<mutex> lock(decoding.lock);
+    int from;
+    bool due;
+    for (;;) {
+        from = -1;
+        for (int i = 0; i < NAV_THREADS; ++i) {
+            if (!decoder[i]->decodedEph.empty()
+                && (from < 0 || decoder[i]->decodedEph.front().msgNum < decoder[from]->decodedEph.front().msgNum)) from = i;
+        }
+        due = true;
+        for (int i = 0; due && i < NAV_THREADS; ++i) {
+            if (decoder[i]->decodedEph.empty()) due = decoder[i]->navMsgsDecoded() >= (from < 0? INT_MAX : decoder[from]->decodedEph.front().msgNum);
+        }
+        if (from < 0 && due) break;             //all decoders ended
+        if (from < 0 || !due) {
+            decoding.changed.wait(lock);
+            continue;
+        }
+        DecodedEph eph = decoder[from]->decodedEph.front();
+        decoder[from]->decodedEph.pop_front();
+        decoding.changed.notify_all();
+        lock.unlock();
+        saveEphemeris(rinex, eph.sys, eph.sat, eph.bom, eph.scaler);
+        lock.lock();
+    }
+}
+
+/**copyNavState copies from other object the data needed to decode navigation messages of the given constellation:
+ * frames being assembled, last ephemeris decoded, and roll overs (and GLONASS OSN-FCN tables).
+ *
+ * @param from the object with the data to copy
+ * @param sys the constellation (G, R, E, C)
+ */
+void GNSSdataFromGRD::copyNavState(const GNSSdataFromGRD &from, char sys) {
+    nGPSrollOver = from.nGPSrollOver;
+    nGALrollOver = from.nGALrollOver;
+    nBDSrollOver = from.nBDSrollOver;
+    switch (sys) {
+        case 'G':
+            memcpy(gpsSatFrame, from.gpsSatFrame, sizeof(gpsSatFrame));
+            memcpy(gpsCnavSatFrame, from.gpsCnavSatFrame, sizeof(gpsCnavSatFrame));
+            memcpy(gpsLastEph, from.gpsLastEph, sizeof(gpsLastEph));
+            memcpy(gpsCnavLastEph, from.gpsCnavLastEph, sizeof(gpsCnavLastEph));
+            break;
+        case 'R':
+            memcpy(gloSatFrame, from.gloSatFrame, sizeof(gloSatFrame));
+            memcpy(glonassOSN_FCN, from.glonassOSN_FCN, sizeof(glonassOSN_FCN));
+            memcpy(nAhnA, from.nAhnA, sizeof(nAhnA));
+            break;
+        case 'E':
+            memcpy(galInavSatFrame, from.galInavSatFrame, sizeof(galInavSatFrame));
+            memcpy(galFnavSatFrame, from.galFnavSatFrame, sizeof(galFnavSatFrame));
+            memcpy(galLastEph, from.galLastEph, sizeof(galLastEph));
+            memcpy(galFnavLastEph, from.galFnavLastEph, sizeof(galFnavLastEph));
+            break;
+        case 'C':
+            memcpy(bdsSatFrame, from.bdsSatFrame, sizeof(bdsSatFrame));
+            memcpy(bdsD2SatFrame, from.bdsD2SatFrame, sizeof(bdsD2SatFrame));
+            memcpy(bdsLastEph, from.bdsLastEph, sizeof(bdsLastEph));
+            memcpy(bdsD2LastEph, from.bdsD2LastEph, sizeof(bdsD2LastEph));
+            break;
+        default:
+            break;
+    }
+}
+
+/**hasAllCorrections checks if all constellations having navigation messages have provided all the corrections for
+ * the header of navigation files they can provide.
+ * For GLONASS, the slot and frequency numbers of the satellites seen shall be also known, as they are needed for the
+ * GLONASS SLOT / FRQ # header record and the ephemeris.
+ *
+ * @return true if there are constellations with navigation messages and all their corrections have been got, false otherwise
+ */
+bool GNSSdataFromGRD::hasAllCorrections() {
+    int corrAll;
+    if (navCorrSet.empty()) return false;
+    for (map<char, int>::iterator it = navCorrSet.begin(); it != navCorrSet.end(); ++it) {
+        switch (it->first) {
+            case 'G': corrAll = CORR_ALL_GPS; break;
+            case 'R':
+                if (!hasAllGLOSlots()) return false;
+                corrAll = CORR_ALL_GLO;
+                break;
+            case 'E': corrAll = CORR_ALL_GAL; break;
+            case 'C': corrAll = CORR_ALL_BDS; break;
+            default: corrAll = 0; break;
+        }
+        if ((it->second & corrAll) != corrAll) return false;
+    }
+    return true;
+}
+
+/**hasAllGLOSlots checks if the OSN - FCN table has the FCN of all GLONASS satellites seen (the ones identified by their
+ * OSN), and the OSN and its FCN of the ones identified by their FCN.
+ *
+ * @return true if all satellites seen have their OSN and FCN, false otherwise
+ */
+bool GNSSdataFromGRD::hasAllGLOSlots() {
+    for (int i = 0; i < GLO_MAXSATELLITES; i++) {
+        GLONASSosnfcn* pOSN_FCN = &glonassOSN_FCN[i];
+        if (i < GLO_MAXOSN) {
+            if ((pOSN_FCN->osn != 0) && !pOSN_FCN->fcnSet) return false;
+        } else if (pOSN_FCN->fcnSet) {
+            if ((pOSN_FCN->osn < GLO_MINOSN) || (pOSN_FCN->osn > GLO_MAXOSN)) return false;
+            if (!glonassOSN_FCN[pOSN_FCN->osn - 1].fcnSet) return false;
+        }
+    }
+    return true;
+}
+
+/**navMsgSystem gives the constellation of a navigation message type.
+ *
+ * @param msgType the message type
+ * @return the constellation identifier (G, R, E, C), or 0 if it is not a navigation message of them
+ */
+char GNSSdataFromGRD::navMsgSystem(int msgType) {
+    switch (msgType) {
+        case MT_SATNAV_GPS_L1_CA:
+        case MT_SATNAV_GPS_L5_C:
+        case MT_SATNAV_GPS_C2:
+        case MT_SATNAV_GPS_L2_C:
+            return 'G';
+        case MT_SATNAV_GLONASS_L1_CA:
+            return 'R';
+        case MT_SATNAV_GALILEO_INAV:
+        case MT_SATNAV_GALILEO_FNAV:
+            return 'E';
+        case MT_SATNAV_BEIDOU_D1:
+        case MT_SATNAV_BEIDOU_D2:
+            return 'C';
+        default:
+            return 0;
+    }
+}
+
+
+//generic methods for the navigation messages sharing the same frame handling
+/**collectEphemeris gets navigation data from a raw message of the constellation and signal stated by Traits, and stores
+ * them to generate RINEX navigation files.
+ * Satellite navigation messages are temporary stored until all needed subframes (or words) for the current satellite
+ * and epoch have been received.
+ * When completed, and if they are not a rebroadcast of the last ones decoded, satellite ephemeris are extracted,
+ * scaled to working units, and stored into "broadcast orbit lines" of the RinexData object.
+ * Traits are GPSL1CATraits, GPSCNAVTraits, GALINTraits, GALFNTraits, BDSD1Traits or BDSD2Traits, and this template
+ * replaces what were one method for each of them.
  *
  * @param rinex	the class instance where data are stored
  * @param msgType the true type of the message
  * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
  */
-bool GNSSdataFromGRD::collectGPSL1CAEphemeris(RinexData &rinex, int msgType) {
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int pageNum;    //navigation message page number
+template <class Traits> bool GNSSdataFromGRD::collectEphemeris(RinexData &rinex, int msgType) {
+    int satNum;		//the satellite number this navigation message belongs
+    uint32_t iod;   //the Issue Of Data of the ephemeris
     int bom[BO_LINSTOTAL][BO_MAXCOLS];		//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
-    GPSFrameData *pframe;
     string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_GPS_L1_CA message data
-    if (!readGPSL1CANavMsg(constId, satNum, sfrmNum, pageNum, logMsg)) return false;
-    pframe = &gpsSatFrame[satNum - 1];
-    //check if all ephemeris have been received, that is:
-    //-subframes 1, 2, and 3 have data
-    //-and their data belong belong to the same Issue Of Data (IOD)
-    bool allRec = pframe->hasData;
-    for (int i = 0; allRec && i < 3; ++i) allRec = allRec && pframe->gpsSatSubframes[i].hasData;
-    if (allRec) {
+    if (!Traits::read(*this, satNum, logMsg)) return false;
+    typename Traits::Frame &frame = Traits::frame(*this, satNum);
+    //check if all ephemeris have been received, and their data belong to the same Issue Of Data (IOD)
+    if (Traits::hasEphemeris(frame)) {
         logMsg += LOG_MSG_FRM;
-        //IODC (8LSB in subframe 1) must be equal to IODE in subframe 2 and IODE in subframe 3
-        uint32_t iodcLSB = getBits(pframe->gpsSatSubframes[0].words, GPSL1CA_BIT(211), 8);
-        uint32_t iode2 = getBits(pframe->gpsSatSubframes[1].words, GPSL1CA_BIT(61), 8);
-        uint32_t iode3 = getBits(pframe->gpsSatSubframes[2].words, GPSL1CA_BIT(271), 8);
-        if ((iodcLSB == iode2) && (iodcLSB == iode3)) {
-            //all ephemerides have been already received; extract and store them into the RINEX object
+        if (Traits::getIod(frame, iod)) {
             logMsg += LOG_MSG_IOD;
-            plog->fine(logMsg);
-            extractGPSL1CAEphemeris(satNum - 1, bom);
-            tTag = scaleGPSEphemeris(bom, bo);
-            rinex.saveNavData('G', satNum, bo, tTag);
+            if (isEphRepeated(Traits::lastEph(*this, satNum), iod, Traits::hash(frame))) {
+                plog->finer(logMsg + LOG_MSG_REPEPH);
+            } else {
+                //all ephemerides have been already received; extract and store them into the RINEX object
+                plog->fine(logMsg);
+                Traits::extract(*this, satNum, bom);
+                saveEphemeris(rinex, Traits::SYS, satNum, bom, Traits::scale);
+            }
             //clear satellite frame storage
-            pframe->hasData = false;
-            for (int i = 0; i < GPS_MAXSUBFRS; ++i) pframe->gpsSatSubframes[i].hasData = false;
+            Traits::clearEphemeris(frame);
         } else plog->fine(logMsg + " and IODs different.");
     } else plog->finer(logMsg);
     return true;
 }
 
-/**collectGPSL1CACorrections gets from GPS L1 C/A navigation raw data message the ionospheric, clock and leap corrections data
- * needed to generate some RINEX navigation files header records.
- * Satellite navigation messages are temporary stored until subframes 1 and 4 of a given satellite and epoch have been received.
- * When completed, corrections are extracted from subframes, scaled to working units, and stored into header records of the RinexData object.
+/**collectCorrections gets from a navigation raw data message of the constellation and signal stated by Traits the
+ * ionospheric, clock and leap corrections data needed to generate some RINEX navigation files header records.
+ * Satellite navigation messages are temporary stored until subframes (or words) containing corrections have been received.
+ * When received, only corrections are extracted, scaled to working units, and stored into header records of the RinexData object.
+ * The corrections got for the constellation are recorded in navCorrSet.
  *
  * @param rinex	the class instance where data are stored
  * @param msgType the true type of the message
  * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
  */
-bool GNSSdataFromGRD::collectGPSL1CACorrections(RinexData &rinex, int msgType) {
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int pageNum;    //navigation message page number
+template <class Traits> bool GNSSdataFromGRD::collectCorrections(RinexData &rinex, int msgType) {
+    int satNum;		//the satellite number this navigation message belongs
     int bom[BO_LINSTOTAL][BO_MAXCOLS];		//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
     double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
     string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_GPS_L1_CA message data
-    if (!readGPSL1CANavMsg(constId, satNum, sfrmNum, pageNum, logMsg)) return false;
-    GPSFrameData* pframe = &gpsSatFrame[satNum - 1];
-    //check if corrections have been received, that is, subframes 1 and 4 have data
-    if (pframe->hasData && pframe->gpsSatSubframes[0].hasData && pframe->gpsSatSubframes[3].hasData) {
+    if (!Traits::read(*this, satNum, logMsg)) return false;
+    typename Traits::Frame &frame = Traits::frame(*this, satNum);
+    if (Traits::hasCorrections(frame)) {
         logMsg += LOG_MSG_CORR;
-        extractGPSL1CAEphemeris(satNum - 1, bom);
-        tTag = scaleGPSEphemeris(bom, bo);
-        rinex.setHdLnData(rinex.IONC, rinex.IONC_GPSA, bo[BO_LIN_IONOA], bom[BO_LIN_TIMEG][2], satNum);
-        rinex.setHdLnData(rinex.IONC, rinex.IONC_GPSB, bo[BO_LIN_IONOB], bom[BO_LIN_TIMEG][2], satNum);
-        rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GPUT, bo[BO_LIN_TIMEU], 0, satNum);
-        rinex.setHdLnData(rinex.LEAP, (int) bo[BO_LIN_LEAPS][0], (int) bo[BO_LIN_LEAPS][1], (int) bo[BO_LIN_LEAPS][2], (int) bo[BO_LIN_LEAPS][3], 'G');
-        logMsg += "IONA&B TIMEG TIMEU LEAPS";
+        Traits::extractCorrections(*this, satNum, bom);
+        Traits::scaleCorrections(bom, bo);
+        navCorrSet[char(Traits::SYS)] |= Traits::saveCorrections(rinex, frame, bom, bo, satNum, logMsg);
         plog->fine(logMsg);
         //clear satellite frame storage
-        pframe->hasData = false;
-        for (int i = 0; i < GPS_MAXSUBFRS; ++i) pframe->gpsSatSubframes[i].hasData = false;
+        Traits::clearCorrections(frame);
     } else plog->finer(logMsg);
     return true;
 }
 
+
+//methods for GPS L1 CA message processing
+//A macro to get bit position in a subframe from the bit position (BITNUMBER) in the message subframe stated in the GPS ICD
+//Each GPS 30 bits message word is stored in an uint32_t (aligned to the rigth)
+//Each GPS subframe, comprising 10 words, is tored in an stream of 10 uint32_t
+//BITNUMBER is the position in the subframe, GPSL1CA_BIT gets the position in the stream
+#define GPSL1CA_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+
+/**GPSL1CATraits states how GPS L1 C/A navigation messages are handled by the collectEphemeris and collectCorrections templates.
+ * For GPS L1 C/A each subframe of the navigation message contains 10 30-bit words.
+ * Each word (30 bits) should be fit into the last 30 bits in a 4-byte word (skip B31 and B32), with MSB first,
+ * for a total of 40 bytes, covering a time period of 6, 6, and 0.6 seconds, respectively.
+ * Only have interest subframes: 1,2,3 & page 18 of subframe 4 (pgID = 56 in GPS ICD Table 20-V)
+ */
+struct GNSSdataFromGRD::GPSL1CATraits {
+    typedef GPSFrameData Frame;
+    static const char SYS = 'G';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.gpsSatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.gpsLastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int sfrmNum, pageNum;
+        return g.readGPSL1CANavMsg(constId, satNum, sfrmNum, pageNum, logMsg);
+    }
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGPSL1CAEphemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleGPSEphemeris(bom, bo); }
+    static void extractCorrections(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGPSL1CACorrections(satNum - 1, bom); }
+    static void scaleCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { scaleGPSCorrections(bom, bo); }
+    //ephemeris are complete when subframes 1, 2, and 3 have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.hasData;
+        for (int i = 0; allRec && i < 3; ++i) allRec = allRec && f.gpsSatSubframes[i].hasData;
+        return allRec;
+    }
+    //IODC (8LSB in subframe 1) must be equal to IODE in subframe 2 and IODE in subframe 3
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.gpsSatSubframes[0].words, GPSL1CA_BIT(211), 8);
+        return iod == getBits(f.gpsSatSubframes[1].words, GPSL1CA_BIT(61), 8)
+            && iod == getBits(f.gpsSatSubframes[2].words, GPSL1CA_BIT(271), 8);
+    }
+    //hash words 3 to 10 of subframes 1 to 3 (TLM and HOW words change in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        uint32_t hash = 0;
+        for (int i = 0; i < 3; ++i) hash = hashNavWords(hash, f.gpsSatSubframes[i].words + 2, GPS_SUBFRWORDS - 2);
+        return hash;
+    }
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < GPS_MAXSUBFRS; ++i) f.gpsSatSubframes[i].hasData = false;
+    }
+    //corrections are complete when subframes 1 and 4 have data
+    static bool hasCorrections(Frame &f) { return f.hasData && f.gpsSatSubframes[0].hasData && f.gpsSatSubframes[3].hasData; }
+    static int saveCorrections(RinexData &rinex, Frame &, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS], int satNum, string &logMsg) {
+        rinex.setHdLnData(rinex.IONC, rinex.IONC_GPSA, bo[BO_LIN_IONOA], bom[BO_LIN_TIMEG][2], satNum);
+        rinex.setHdLnData(rinex.IONC, rinex.IONC_GPSB, bo[BO_LIN_IONOB], bom[BO_LIN_TIMEG][2], satNum);
+        rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GPUT, bo[BO_LIN_TIMEU], 0, satNum);
+        rinex.setHdLnData(rinex.LEAP, (int) bo[BO_LIN_LEAPS][0], (int) bo[BO_LIN_LEAPS][1], (int) bo[BO_LIN_LEAPS][2], (int) bo[BO_LIN_LEAPS][3], 'G');
+        logMsg += "IONA&B TIMEG TIMEU LEAPS";
+        return CORR_ALL_GPS;
+    }
+    static void clearCorrections(Frame &f) { clearEphemeris(f); }
+};
+
 /**readGPSL1CANavMsg read a GPS L1 C/A navigation message data from the navigation raw data file.
  * Data are stored in gpsSatFrame of the corresponding satNum.
  * For GPS L1 C/A each subframe of the navigation message contains 10 30-bit words.
@@ -868,11 +1181,12 @@ bool GNSSdataFromGRD::readGPSL1CANavMsg(char &constId, int &satNum, int &sfrmNum
     int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
     int msgSize;    //the message size in bytes
     unsigned int navMsg[GPS_L1_CA_MSGSIZE]; //to store GPS message bytes from receiver
+    uint32_t words[GPS_SUBFRWORDS];         //the subframe words packed from message bytes
     GPSSubframeData *psubframe;
     GPSFrameData *pframe;
     try {
         //read MT_SATNAV_GPS_L1_CA message data
-        if (fscanf(grdFile, "%d;%c%d;%d;%d;%d", &status, &constId, &satNum, &sfrmNum, &pageNum, &msgSize) != 6
+        if (!readNavMsgHeader(status, constId, satNum, sfrmNum, pageNum, msgSize)
             || status < 1
             || constId != 'G'
             || satNum < GPS_MINPRN
@@ -883,7 +1197,7 @@ bool GNSSdataFromGRD::readGPSL1CANavMsg(char &constId, int &satNum, int &sfrmNum
         }
         logMsg += " sat:" + to_string(satNum) + " subfr:" + to_string(sfrmNum) + " pg:" + to_string(pageNum);
         for (int i = 0; i < GPS_L1_CA_MSGSIZE; ++i) {
-            if (fscanf(grdFile,";%X", navMsg+i) != 1) {
+            if (!readNavMsgByte(navMsg[i])) {
                 plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
                 return false;
             }
@@ -892,12 +1206,17 @@ bool GNSSdataFromGRD::readGPSL1CANavMsg(char &constId, int &satNum, int &sfrmNum
             plog->finer(logMsg + LOG_MSG_NAVIG);
             return false;
         }
-        pframe = &gpsSatFrame[satNum - 1];
-        psubframe = &pframe->gpsSatSubframes[sfrmNum - 1];
-        //pack message bytes into the ten words with navigation data
+        //pack message bytes into the ten words with navigation data, and verify their parity before storing them
         for (int i = 0, n=0; i < GPS_SUBFRWORDS; ++i, n+=4) {
-            psubframe->words[i] = navMsg[n]<<24 | navMsg[n+1]<<16 | navMsg[n+2]<<8 | navMsg[n+3];
+            words[i] = navMsg[n]<<24 | navMsg[n+1]<<16 | navMsg[n+2]<<8 | navMsg[n+3];
         }
+        if (!isGPSL1CAParityOk(words)) {
+            plog->fine(logMsg + LOG_MSG_PARITY + LOG_MSG_NAVIG);
+            return false;
+        }
+        pframe = &gpsSatFrame[satNum - 1];
+        psubframe = &pframe->gpsSatSubframes[sfrmNum - 1];
+        memcpy(psubframe->words, words, sizeof(words));
         psubframe->hasData = true;
         pframe->hasData = true;
         logMsg += LOG_MSG_SFR;
@@ -917,6 +1236,93 @@ bool GNSSdataFromGRD::readGPSL1CANavMsg(char &constId, int &satNum, int &sfrmNum
     return true;
 }
 
+//bit masks to compute GPS L1 C/A parity bits D25 to D30 (see GPS ICD Table 20-XIV) from a word having D29* and D30*
+//of the previous word in bits 31 and 30, data bits d1 to d24 in bits 29 to 6, and parity bits in bits 5 to 0
+const uint32_t GPSL1CA_PARITY_MASK[6] = {0xBB1F3480, 0x5D8F9A40, 0xAEC7CD00, 0x5763E680, 0x6BB1F340, 0x8B7A89C0};
+
+/**isGPSL1CAParityOk verifies the parity of the ten words in a GPS L1 C/A subframe.
+ * Each parity bit is computed at once for a word using a bit mask and the parity (popcount modulo 2) of the masked bits.
+ * Data bits are checked as transmitted (complemented when D30* is set) and also as source data, because receivers may
+ * provide them already decoded. D29* and D30* for word 1 (TLM) are 0, as bits 29 and 30 of word 10 are always 0.
+ *
+ * @param words the subframe words, each one with 30 bits aligned to the right
+ * @return true if parity is correct for all the words, false otherwise
+ */
+bool GNSSdataFromGRD::isGPSL1CAParityOk(const uint32_t (&words)[GPS_SUBFRWORDS]) {
+    uint32_t prevBits = 0;  //D29* and D30* in bits 31 and 30
+    for (int i = 0; i < GPS_SUBFRWORDS; ++i) {
+        uint32_t word = prevBits | (words[i] & 0x3FFFFFFF);
+        bool ok = false;
+        for (int pass = 0; !ok && pass < 2; ++pass) {
+            if (pass == 1) {
+                if ((word & 0x40000000) == 0) break;  //data not complemented: second pass would be the same
+                word ^= 0x3FFFFFC0;
+            }
+            uint32_t parity = 0;
+            for (int j = 0; j < 6; ++j) parity = (parity << 1) | (getBitCount(word & GPSL1CA_PARITY_MASK[j]) & 1);
+            ok = parity == (word & 0x3F);
+        }
+        if (!ok) return false;
+        prevBits = words[i] << 30;
+    }
+    return true;
+}
+
+//GPS L1 C/A ephemeris fields in subframes 1, 2 and 3, streams 0 to 2 respectively (see GPS ICD)
+constexpr NavBitField GPSL1CA_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(219), 16}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{0, GPSL1CA_BIT(271), 22}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{0, GPSL1CA_BIT(249), 16}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{0, GPSL1CA_BIT(241), 8}}},	//Af2
+    {1, 0, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(61), 8}}},	//IODE
+    {1, 1, NAVF_TWOSCOMP, {{1, GPSL1CA_BIT(69), 16}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{1, GPSL1CA_BIT(91), 16}}},	//Delta n
+    {1, 3, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(107), 8}, {1, GPSL1CA_BIT(121), 24}}},	//M0
+    {2, 0, NAVF_TWOSCOMP, {{1, GPSL1CA_BIT(151), 16}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(167), 8}, {1, GPSL1CA_BIT(181), 24}}},	//e
+    {2, 2, NAVF_TWOSCOMP, {{1, GPSL1CA_BIT(211), 16}}},	//Cus
+    {2, 3, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(227), 8}, {1, GPSL1CA_BIT(241), 24}}},	//sqrt(A)
+    {3, 0, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(271), 16}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{2, GPSL1CA_BIT(61), 16}}},	//Cic
+    {3, 2, NAVF_UNSIGNED, {{2, GPSL1CA_BIT(77), 8}, {2, GPSL1CA_BIT(91), 24}}},	//OMEGA0
+    {3, 3, NAVF_TWOSCOMP, {{2, GPSL1CA_BIT(121), 16}}},	//CIS
+    {4, 0, NAVF_UNSIGNED, {{2, GPSL1CA_BIT(137), 8}, {2, GPSL1CA_BIT(151), 24}}},	//i0
+    {4, 1, NAVF_TWOSCOMP, {{2, GPSL1CA_BIT(181), 16}}},	//Crc
+    {4, 2, NAVF_UNSIGNED, {{2, GPSL1CA_BIT(197), 8}, {2, GPSL1CA_BIT(211), 24}}},	//w (omega)
+    {4, 3, NAVF_TWOSCOMP, {{2, GPSL1CA_BIT(241), 24}}},	//w dot
+    {5, 0, NAVF_TWOSCOMP, {{2, GPSL1CA_BIT(279), 14}}},	//IDOT
+    {5, 1, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(71), 2}}},	//Codes on L2
+    {5, 3, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(91), 1}}},	//L2P data flag
+    {6, 0, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(73), 4}}},	//URA index
+    {6, 1, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(77), 6}}},	//SV health
+    {6, 2, NAVF_TWOSCOMP, {{0, GPSL1CA_BIT(197), 8}}},	//TGD
+    {6, 3, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(83), 2}, {0, GPSL1CA_BIT(211), 8}}},	//IODC
+    {7, 0, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(31), 17}}},	//Transmission time of message: the 17 MSB of the Zcount in HOW (scaled after extraction)
+    {7, 1, NAVF_UNSIGNED, {{1, GPSL1CA_BIT(287), 1}}},	//Fit interval flag
+};
+
+//GPS L1 C/A header corrections fields in subframes 1 and 4 (page 18), streams 0 and 3 respectively (see GPS ICD)
+constexpr NavBitField GPSL1CA_CORR_FIELDS[] = {
+    {5, 2, NAVF_UNSIGNED, {{0, GPSL1CA_BIT(61), 10}}},	//GPS week# (roll over added after extraction)
+    {BO_LIN_IONOA, 0, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(69), 8}}},	//alfa0
+    {BO_LIN_IONOA, 1, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(77), 8}}},	//alfa1
+    {BO_LIN_IONOA, 2, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(91), 8}}},	//alfa2
+    {BO_LIN_IONOA, 3, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(99), 8}}},	//alfa3
+    {BO_LIN_IONOB, 0, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(107), 8}}},	//beta0
+    {BO_LIN_IONOB, 1, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(121), 8}}},	//beta1
+    {BO_LIN_IONOB, 2, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(129), 8}}},	//beta2
+    {BO_LIN_IONOB, 3, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(137), 8}}},	//beta3
+    {BO_LIN_TIMEU, 0, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(181), 24}, {3, GPSL1CA_BIT(211), 8}}},	//Time correction A0
+    {BO_LIN_TIMEU, 1, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(151), 24}}},	//Time correction A1
+    {BO_LIN_TIMEU, 2, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(219), 8}}},	//t0t, ref time for for UTC data
+    {BO_LIN_TIMEU, 3, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(227), 8}}},	//WNt, UTC ref week number
+    {BO_LIN_TIMEG, 2, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(31), 17}}},	//Transmission time of message: the 17 MSB of the Zcount in HOW (scaled after extraction)
+    {BO_LIN_LEAPS, 0, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(241), 8}}},	//delta tLS (leap seconds)
+    {BO_LIN_LEAPS, 1, NAVF_TWOSCOMP, {{3, GPSL1CA_BIT(271), 8}}},	//delta tLSF
+    {BO_LIN_LEAPS, 2, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(249), 8}}},	//WN_LSF
+    {BO_LIN_LEAPS, 3, NAVF_UNSIGNED, {{3, GPSL1CA_BIT(257), 8}}},	//DN_LSF
+};
+
 /**extractGPSL1CAEphemeris extract satellite ephemeris from the stored navigation frames transmitted for a given GPS satellite.
  * <p>The navigation message data of interest here have been stored in GPS frame (gpsSatFrame) data words (without parity).
  * Ephemeris are extracted from data words and stored into a RINEX Broadcast Orbit lines like arrangement.
@@ -929,74 +1335,29 @@ bool GNSSdataFromGRD::readGPSL1CANavMsg(char &constId, int &satNum, int &sfrmNum
  * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
  */
 void GNSSdataFromGRD::extractGPSL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
-    uint32_t *psubfr1data = gpsSatFrame[satIdx].gpsSatSubframes[0].words;
-    uint32_t *psubfr2data = gpsSatFrame[satIdx].gpsSatSubframes[1].words;
-    uint32_t *psubfr3data = gpsSatFrame[satIdx].gpsSatSubframes[2].words;
-    uint32_t *psubfr4data = gpsSatFrame[satIdx].gpsSatSubframes[3].words;
-    for (int i = 0; i < BO_LINSTOTAL; ++i) {
-        for (int j = 0; j < BO_MAXCOLS; ++j) {
-            bom[i][j] = 0;
-        }
-    }
-    //broadcast line 0
-    bom[0][0] = getBits(psubfr1data, GPSL1CA_BIT(219), 16);	                    //T0C
-    bom[0][1] = getTwosComplement(getBits(psubfr1data, GPSL1CA_BIT(271), 22), 22);	//Af0
-    bom[0][2] = getTwosComplement(getBits(psubfr1data, GPSL1CA_BIT(249), 16), 16);	//Af1
-    bom[0][3] = getTwosComplement(getBits(psubfr1data, GPSL1CA_BIT(241), 8), 8);	//Af2
-    //broadcast line 1
-    bom[1][0] = getBits(psubfr2data, GPSL1CA_BIT(61), 8);	                        //IODE
-    bom[1][1] = getTwosComplement(getBits(psubfr2data, GPSL1CA_BIT(69), 16), 16);	//Crs
-    bom[1][2] = getTwosComplement(getBits(psubfr2data, GPSL1CA_BIT(91), 16), 16);	//Delta n
-    bom[1][3] = (getBits(psubfr2data, GPSL1CA_BIT(107), 8) << 24) | getBits(psubfr2data, GPSL1CA_BIT(121), 24);//M0
-    //broadcast line 2
-    bom[2][0] = getTwosComplement(getBits(psubfr2data, GPSL1CA_BIT(151), 16), 16);			                            //Cuc
-    bom[2][1] = (getBits(psubfr2data, GPSL1CA_BIT(167), 8) << 24) | getBits(psubfr2data, GPSL1CA_BIT(181), 24);	//e
-    bom[2][2] = getTwosComplement(getBits(psubfr2data, GPSL1CA_BIT(211), 16), 16);		                                //Cus
-    bom[2][3] = (getBits(psubfr2data, GPSL1CA_BIT(227), 8) << 24) | getBits(psubfr2data, GPSL1CA_BIT(241), 24);	//sqrt(A)
-    //broadcast line 3
-    bom[3][0] = getBits(psubfr2data, GPSL1CA_BIT(271), 16);	                                                        //Toe
-    bom[3][1] = getTwosComplement(getBits(psubfr3data, GPSL1CA_BIT(61), 16), 16);						                //Cic
-    bom[3][2] = (getBits(psubfr3data, GPSL1CA_BIT(77), 8) << 24) | getBits(psubfr3data, GPSL1CA_BIT(91), 24); 	//OMEGA0
-    bom[3][3] = getTwosComplement(getBits(psubfr3data, GPSL1CA_BIT(121), 16), 16);		                				//CIS
-    //broadcast line 4
-    bom[4][0] = (getBits(psubfr3data, GPSL1CA_BIT(137), 8) << 24) | getBits(psubfr3data, GPSL1CA_BIT(151), 24);	//i0
-    bom[4][1] = getTwosComplement(getBits(psubfr3data, GPSL1CA_BIT(181), 16), 16);										//Crc
-    bom[4][2] = (getBits(psubfr3data, GPSL1CA_BIT(197), 8) << 24) | getBits(psubfr3data, GPSL1CA_BIT(211), 24);	//w (omega)
-    bom[4][3] = getTwosComplement(getBits(psubfr3data, GPSL1CA_BIT(241), 24), 24);                                     //w dot
-    //broadcast line 5
-    bom[5][0] = getTwosComplement(getBits(psubfr3data, GPSL1CA_BIT(279), 14), 14);	//IDOT
-    bom[5][1] = getBits(psubfr1data, GPSL1CA_BIT(71), 2);		            		//Codes on L2
-    bom[5][2] = getBits(psubfr1data, GPSL1CA_BIT(61), 10) + nGPSrollOver * 1024; 	//GPS week#
-    bom[5][3] = getBits(psubfr1data, GPSL1CA_BIT(91), 1);				            //L2P data flag
-    //broadcast line 6
-    bom[6][0] = getBits(psubfr1data, GPSL1CA_BIT(73), 4);		//URA index
-    bom[6][1] = getBits(psubfr1data, GPSL1CA_BIT(77), 6);      	//SV health
-    bom[6][2] = getTwosComplement(getBits(psubfr1data, GPSL1CA_BIT(197), 8), 8);                                //TGD
-    bom[6][3] = (getBits(psubfr1data, GPSL1CA_BIT(83), 2) << 8) | getBits(psubfr1data, GPSL1CA_BIT(211), 8);	//IODC
-    //broadcast line 7
-    bom[7][0] = getBits(psubfr1data, GPSL1CA_BIT(31), 17) *6 *100; //Transmission time of message:
-                // the 17 MSB of the Zcount in HOW converted to sec and scaled by 100
-    bom[7][1] = getBits(psubfr2data, GPSL1CA_BIT(287), 1);			//Fit interval flag
-    bom[BO_LIN_IONOA][0] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(69), 8), 8);    //alfa0
-    bom[BO_LIN_IONOA][1] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(77), 8), 8);    //alfa1
-    bom[BO_LIN_IONOA][2] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(91), 8), 8);    //alfa2
-    bom[BO_LIN_IONOA][3] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(99), 8), 8);    //alfa3
-    bom[BO_LIN_IONOB][0] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(107), 8), 8);   //beta0
-    bom[BO_LIN_IONOB][1] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(121), 8), 8);   //beta1
-    bom[BO_LIN_IONOB][2] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(129), 8), 8);   //beta2
-    bom[BO_LIN_IONOB][3] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(137), 8), 8);   //beta3
-    bom[BO_LIN_TIMEU][0] = (getBits(psubfr4data, GPSL1CA_BIT(181), 24) << 8) | getBits(psubfr4data, GPSL1CA_BIT(211), 8);    //Time correction A0
-    bom[BO_LIN_TIMEU][1] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(151), 24), 24);    //Time correction A1
-    bom[BO_LIN_TIMEU][2] = getBits(psubfr4data, GPSL1CA_BIT(219), 8);       //t0t, ref time for for UTC data
-    bom[BO_LIN_TIMEU][3] = getBits(psubfr4data, GPSL1CA_BIT(227), 8);       //WNt, UTC ref week number
+    uint32_t *streams[GPS_MAXSUBFRS];
+    for (int i = 0; i < GPS_MAXSUBFRS; ++i) streams[i] = gpsSatFrame[satIdx].gpsSatSubframes[i].words;
+    extractGPSL1CACorrections(satIdx, bom);
+    extractNavFields<GPSL1CA_FIELDS, sizeof(GPSL1CA_FIELDS) / sizeof(NavBitField)>(streams, bom, false);
+    bom[7][0] *= 6 * 100;                   //Transmission time of message converted to sec and scaled by 100
+}
+
+/**extractGPSL1CACorrections extract from the stored navigation frames transmitted for a given GPS satellite only the
+ * data needed for the header of navigation files: iono and time corrections, and UTC leap seconds (see extractGPSL1CAEphemeris).
+ * They are stored in the rows BO_LIN_IONOA, BO_LIN_IONOB, BO_LIN_TIMEx, and BO_LIN_LEAP, and the week number in line 5.
+ *
+ * @param satIdx the satellite index in the gpsSatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ */
+void GNSSdataFromGRD::extractGPSL1CACorrections(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[GPS_MAXSUBFRS];
+    for (int i = 0; i < GPS_MAXSUBFRS; ++i) streams[i] = gpsSatFrame[satIdx].gpsSatSubframes[i].words;
+    extractNavFields<GPSL1CA_CORR_FIELDS, sizeof(GPSL1CA_CORR_FIELDS) / sizeof(NavBitField)>(streams, bom);
+    bom[5][2] += nGPSrollOver * 1024;       //GPS week# with roll over
     bom[BO_LIN_TIMEU][3] |= bom[5][2] & (~MASK8b);       //put WNt as a continuous week number
-    bom[BO_LIN_TIMEG][2] = getBits(psubfr4data, GPSL1CA_BIT(31), 17) * 6; //Transmission time of message: the 17 MSB of the Zcount in HOw
+    bom[BO_LIN_TIMEG][2] *= 6;              //Transmission time of message converted to sec
     bom[BO_LIN_TIMEG][3] = bom[5][2];      //the week number when message was transmitted
-    bom[BO_LIN_LEAPS][0] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(241), 8), 8);    //delta tLS (leap seconds)
-    bom[BO_LIN_LEAPS][1] = getTwosComplement(getBits(psubfr4data, GPSL1CA_BIT(271), 8), 8);    //delta tLSF
-    bom[BO_LIN_LEAPS][2] = getBits(psubfr4data, GPSL1CA_BIT(249), 8);    //WN_LSF
     bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
-    bom[BO_LIN_LEAPS][3] = getBits(psubfr4data, GPSL1CA_BIT(257), 8);    //DN_LSF
 }
 
 /**scaleGPSEphemeris apply GPS scale factors to satellite ephemeris mantissas to obtain true satellite ephemeris and store them
@@ -1013,15 +1374,15 @@ void GNSSdataFromGRD::extractGPSL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTA
 double GNSSdataFromGRD::scaleGPSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
     double aDouble;
     int iodc = bom[6][3];
-    for(int i=0; i<BO_LINSTOTAL; i++) {
+    for(int i=0; i<BO_MAXLINS; i++) {
         for (int j = 0; j < BO_MAXCOLS; j++) {
             bo[i][j] = bom[i][j] * GPS_SCALEFACTOR[i][j];
         }
     }
+    scaleGPSCorrections(bom, bo);
     //recompute the ones being 32 bits twos complement signed integers
     bo[2][1] = ((unsigned int) bom[2][1]) * GPS_SCALEFACTOR[2][1];  //e
     bo[2][3] = ((unsigned int) bom[2][3]) * GPS_SCALEFACTOR[2][3];  //sqrt(A)
-    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * GPS_SCALEFACTOR[BO_LIN_TIMEU][0]; //A0
     //fit interval
     if (bom[7][1] == 0) aDouble = 4.0;
     else if (iodc>=240 && iodc<=247) aDouble = 8.0;
@@ -1037,16 +1398,246 @@ double GNSSdataFromGRD::scaleGPSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS],
             bom[5][2],	//GPS week# whitout roll over
             bo[0][0]);  //T0c
 }
+
+/**scaleGPSCorrections apply GPS scale factors to the mantissas of header corrections (rows BO_LIN_IONOA to BO_LIN_LEAPS)
+ * to obtain their true values.
+ *
+ * @param bom the mantissas of orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ * @param bo the orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ */
+void GNSSdataFromGRD::scaleGPSCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    for(int i=BO_LIN_IONOA; i<BO_LINSTOTAL; i++) {
+        for (int j = 0; j < BO_MAXCOLS; j++) {
+            bo[i][j] = bom[i][j] * GPS_SCALEFACTOR[i][j];
+        }
+    }
+    //recompute the ones being 32 bits twos complement signed integers
+    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * GPS_SCALEFACTOR[BO_LIN_TIMEU][0]; //A0
+}
 #undef GPSL1CA_BIT
 
-//methods for GLONASS L1 CA message processing
-//A macro to get bit position in a stream from the bit position (BITNUMBER) in the message string stated in the GLONASS ICD
-//Each GLONASS 85 bits string is stored in an array of 3 uint32_t (the stream)
-#define GLOL1CA_BIT(BITNUMBER) (85 - BITNUMBER)
+//methods for GPS L2 CNAV and L5 CNAV message processing
+//A macro to get bit position in a message stream from the bit position (BITNUMBER) stated in the GPS ICD (IS-GPS-200 and IS-GPS-705)
+//The 300 bits of each message are stored in an stream of 10 uint32_t, MSB first
+#define GPSCNAV_BIT(BITNUMBER) (BITNUMBER-1)
 
-/**collectGLOL1CAEphemeris gets GLONASS navigation data from a raw message and store them to generate RINEX navigation files.
- * Satellite navigation messages are temporary stored until all needed swtrings for the current satellite and epoch have been received.
- * When completed, satellite ephemeris are extracted from strings, scaled to working units, and stored into "broadcast orbit lines"
+/**GPSCNAVTraits states how GPS L2 CNAV and L5 CNAV navigation messages are handled by the collectEphemeris template.
+ * Each message contains 300 bits, and ephemeris are in message types 10 and 11, and clock data in message type 30.
+ * L2 and L5 messages have the same data, and they are stored in the same frame.
+ */
+struct GNSSdataFromGRD::GPSCNAVTraits {
+    typedef GPSCNAVFrameData Frame;
+    static const char SYS = 'G';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.gpsCnavSatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.gpsCnavLastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int msgType;
+        return g.readGPSCNAVNavMsg(constId, satNum, msgType, logMsg);
+    }
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGPSCNAVEphemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleGPSCNAVEphemeris(bom, bo); }
+    //ephemeris are complete when message types 10, 11 and 30 have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.hasData;
+        for (int i = 0; allRec && i < GPSCNAV_MAXMSGS; ++i) allRec = allRec && f.gpsSatMsgs[i].hasData;
+        return allRec;
+    }
+    //there is no IOD in CNAV: toe in message types 10 and 11, and toc in message type 30, shall be the same
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.gpsSatMsgs[0].words, GPSCNAV_BIT(71), 11);
+        return iod == getBits(f.gpsSatMsgs[1].words, GPSCNAV_BIT(39), 11)
+            && iod == getBits(f.gpsSatMsgs[2].words, GPSCNAV_BIT(61), 11);
+    }
+    //hash data after the message header up to the CRC (TOW changes in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        uint32_t hash = 0;
+        for (int i = 0; i < GPSCNAV_MAXMSGS; ++i) hash = hashNavBits(hash, f.gpsSatMsgs[i].words, GPSCNAV_BIT(39), GPSCNAV_MSGBITS - 38);
+        return hash;
+    }
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < GPSCNAV_MAXMSGS; ++i) f.gpsSatMsgs[i].hasData = false;
+    }
+};
+
+/**readGPSCNAVNavMsg read a GPS L2 CNAV or L5 CNAV navigation message from the navigation raw data file.
+ * Data are stored in gpsCnavSatFrame of the corresponding satNum.
+ * Each message contains 300 bits that should be fit into 38 bytes, with MSB first (skip B301-B304).
+ * The message type is taken from the message data, and only have interest types 10, 11 and 30.
+ *
+ * @param constId constellation identification (G, R, E, ...)
+ * @param satNum satellite number in the constellation
+ * @param msgType the message type stated in the message
+ * @param logMsg is the loggin message
+ * @return true if data succesful read, false otherwise
+ */
+bool GNSSdataFromGRD::readGPSCNAVNavMsg(char &constId, int &satNum, int &msgType, string &logMsg) {
+    int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
+    int msgSize;    //the message size in bytes
+    int sfrmNum, pageNum;   //not used for CNAV
+    unsigned int navMsg[GPSCNAV_MSGSIZE];   //to store GPS message bytes from receiver
+    uint32_t words[GPSCNAV_WORDS] = {0};    //the message bits packed from message bytes
+    GPSCNAVmsgData *pmsg;
+    try {
+        //read MT_SATNAV_GPS_L2_C or MT_SATNAV_GPS_L5_C message data
+        if (!readNavMsgHeader(status, constId, satNum, sfrmNum, pageNum, msgSize)
+            || status < 1
+            || constId != 'G'
+            || satNum < GPS_MINPRN
+            || satNum > GPS_MAXPRN
+            || msgSize != GPSCNAV_MSGSIZE) {
+            plog->warning(logMsg + LOG_MSG_INMP + LOG_MSG_OSIZ);
+            return false;
+        }
+        logMsg += " sat:" + to_string(satNum);
+        for (int i = 0; i < GPSCNAV_MSGSIZE; ++i) {
+            if (!readNavMsgByte(navMsg[i])) {
+                plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
+                return false;
+            }
+            words[i / 4] |= (navMsg[i] & 0xFF) << (24 - 8 * (i % 4));
+        }
+        msgType = getBits(words, GPSCNAV_BIT(15), 6);
+        logMsg += " msg:" + to_string(msgType);
+        if (msgType != 10 && msgType != 11 && msgType != 30) {
+            plog->finer(logMsg + LOG_MSG_NAVIG);
+            return false;
+        }
+        if (!isNavCrcOk(words, GPSCNAV_MSGBITS)) {
+            plog->fine(logMsg + LOG_MSG_CRC + LOG_MSG_NAVIG);
+            return false;
+        }
+        if ((int) getBits(words, GPSCNAV_BIT(9), 6) != satNum) {
+            plog->fine(logMsg + LOG_MSG_SATDIF + to_string(getBits(words, GPSCNAV_BIT(9), 6)) + LOG_MSG_NAVIG);
+            return false;
+        }
+        pmsg = &gpsCnavSatFrame[satNum - 1].gpsSatMsgs[msgType == 10 ? 0 : (msgType == 11 ? 1 : 2)];
+        memcpy(pmsg->words, words, sizeof(words));
+        pmsg->hasData = true;
+        gpsCnavSatFrame[satNum - 1].hasData = true;
+        logMsg += " Message saved.";
+    } catch (int error) {
+        plog->severe(logMsg + LOG_MSG_ERRO + to_string((long long) error));
+        return false;
+    }
+    return true;
+}
+
+//GPS CNAV fields in message types 10, 11 and 30, streams 0 to 2 respectively (see IS-GPS-200 30.3.3)
+//Angles and eccentricity have 33 bits: the 32 MSB and the LSB are extracted in different elements, being the LSB placed
+//in elements not used by CNAV (L2 codes, L2P flag, IODC and spares), and both are put together when scaling.
+constexpr NavBitField GPSCNAV_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{2, GPSCNAV_BIT(61), 11}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{2, GPSCNAV_BIT(72), 26}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{2, GPSCNAV_BIT(98), 20}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{2, GPSCNAV_BIT(118), 10}}},	//Af2
+    {1, 1, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(180), 24}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{0, GPSCNAV_BIT(133), 17}}},	//Delta n0
+    {1, 3, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(173), 32}}},	//M0 (32 MSB)
+    {2, 0, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(249), 21}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(206), 32}}},	//e (32 MSB)
+    {2, 2, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(228), 21}}},	//Cus
+    {2, 3, NAVF_TWOSCOMP, {{0, GPSCNAV_BIT(82), 26}}},	//Delta A (sqrt(A) computed when scaling)
+    {3, 0, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(71), 11}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(164), 16}}},	//Cic
+    {3, 2, NAVF_UNSIGNED, {{1, GPSCNAV_BIT(50), 32}}},	//OMEGA0 (32 MSB)
+    {3, 3, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(148), 16}}},	//CIS
+    {4, 0, NAVF_UNSIGNED, {{1, GPSCNAV_BIT(83), 32}}},	//i0 (32 MSB)
+    {4, 1, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(204), 24}}},	//Crc
+    {4, 2, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(239), 32}}},	//w (omega) (32 MSB)
+    {4, 3, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(116), 17}}},	//Delta OMEGA dot (w dot computed when scaling)
+    {5, 0, NAVF_TWOSCOMP, {{1, GPSCNAV_BIT(133), 15}}},	//IDOT
+    {5, 1, NAVF_UNSIGNED, {{1, GPSCNAV_BIT(82), 1}}},	//OMEGA0 LSB
+    {5, 2, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(39), 13}}},	//GPS week# (13 bits, no roll over)
+    {5, 3, NAVF_UNSIGNED, {{1, GPSCNAV_BIT(115), 1}}},	//i0 LSB
+    {6, 0, NAVF_TWOSCOMP, {{0, GPSCNAV_BIT(66), 5}}},	//URA_ED index
+    {6, 1, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(52), 3}}},	//SV health: L1, L2, L5
+    {6, 2, NAVF_TWOSCOMP, {{2, GPSCNAV_BIT(128), 13}}},	//TGD
+    {6, 3, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(271), 1}}},	//w (omega) LSB
+    {7, 0, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(21), 17}}},	//Transmission time of message: TOW count (scaled when scaling)
+    {7, 2, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(205), 1}}},	//M0 LSB
+    {7, 3, NAVF_UNSIGNED, {{0, GPSCNAV_BIT(238), 1}}},	//e LSB
+};
+
+/**extractGPSCNAVEphemeris extract satellite ephemeris from the stored CNAV messages transmitted for a given GPS satellite.
+ * <p>The navigation message data of interest here have been stored in GPS CNAV frame (gpsCnavSatFrame) message words.
+ * Ephemeris are extracted from message words and stored into a RINEX Broadcast Orbit lines like arrangement.
+ * <p>This method stores the MANTISSA of each satellite ephemeris into a broadcast orbit array, without applying any scale factor.
+ *
+ * @param satIdx the satellite index in the gpsCnavSatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ */
+void GNSSdataFromGRD::extractGPSCNAVEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[GPSCNAV_MAXMSGS];
+    for (int i = 0; i < GPSCNAV_MAXMSGS; ++i) streams[i] = gpsCnavSatFrame[satIdx].gpsSatMsgs[i].words;
+    extractNavFields<GPSCNAV_FIELDS, sizeof(GPSCNAV_FIELDS) / sizeof(NavBitField)>(streams, bom);
+}
+
+/**scaleGPSCNAVEphemeris apply GPS CNAV scale factors to satellite ephemeris mantissas to obtain true satellite ephemeris and
+ * store them in RINEX broadcast orbit like arrangements.
+ * The given navigation data are the mantissa parameters as transmitted in the GPS CNAV navigation message, that shall be
+ * converted to the values of a RINEX GPS ephemeris: the 33 bits parameters are put together, sqrt(A) and OMEGA dot are
+ * computed from their reference values, and their rates (A dot, delta n0 dot), not included in RINEX, are not used.
+ * As there is no IOD in CNAV, IODE and IODC are set to the Toe mantissa.
+ * It is obtained a time tag from the week number and time of clock inside the satellite ephemeris. Its value are the
+ * seconds transcurred from the GPS epoch.
+ *
+ * @param bom the mantissas of orbital parameters data arranged as per RINEX broadcast orbit into eight lines with four parameters each
+ * @param bo the orbital parameters data arranged as per RINEX broadcast orbit into eight lines with four parameters each
+ * @return the time tag of the satellite ephemeris as seconds from the GPS epoch
+ */
+double GNSSdataFromGRD::scaleGPSCNAVEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    const double A_REF = 26559710.0;            //semi-major axis reference (meters)
+    const double OMEGADOT_REF = -2.6E-9;        //rate of right ascension reference (semi-circles/second)
+    for(int i=0; i<BO_LINSTOTAL; i++) {
+        for (int j = 0; j < BO_MAXCOLS; j++) {
+            bo[i][j] = 0.0;
+        }
+    }
+    bo[0][0] = bom[0][0] * 300.0;                               //T0c
+    bo[0][1] = bom[0][1] * POW2(-35);                           //Af0
+    bo[0][2] = bom[0][2] * POW2(-48);                           //Af1
+    bo[0][3] = bom[0][3] * POW2(-60);                           //Af2
+    bo[1][0] = bom[3][0];                                       //IODE
+    bo[1][1] = bom[1][1] * POW2(-8);                            //Crs
+    bo[1][2] = bom[1][2] * POW2(-44) * ThisPI;                  //Delta n0
+    bo[1][3] = (2.0 * bom[1][3] + bom[7][2]) * POW2(-32) * ThisPI;   //M0
+    bo[2][0] = bom[2][0] * POW2(-30);                           //Cuc
+    bo[2][1] = (2.0 * (unsigned int) bom[2][1] + bom[7][3]) * POW2(-34);     //e
+    bo[2][2] = bom[2][2] * POW2(-30);                           //Cus
+    bo[2][3] = sqrt(A_REF + bom[2][3] * POW2(-9));              //sqrt(A)
+    bo[3][0] = bom[3][0] * 300.0;                               //Toe
+    bo[3][1] = bom[3][1] * POW2(-30);                           //Cic
+    bo[3][2] = (2.0 * bom[3][2] + bom[5][1]) * POW2(-32) * ThisPI;   //OMEGA0
+    bo[3][3] = bom[3][3] * POW2(-30);                           //Cis
+    bo[4][0] = (2.0 * bom[4][0] + bom[5][3]) * POW2(-32) * ThisPI;   //i0
+    bo[4][1] = bom[4][1] * POW2(-8);                            //Crc
+    bo[4][2] = (2.0 * bom[4][2] + bom[6][3]) * POW2(-32) * ThisPI;   //w (omega)
+    bo[4][3] = (OMEGADOT_REF + bom[4][3] * POW2(-44)) * ThisPI; //w dot
+    bo[5][0] = bom[5][0] * POW2(-44) * ThisPI;                  //IDOT
+    bo[5][2] = bom[5][2];                                       //GPS week#
+    //compute User Range Accuracy value from the URA_ED index (-16 to 15)
+    if (bom[6][0] < 0) bo[6][0] = pow(2.0, 1.0 + bom[6][0] / 2.0);
+    else bo[6][0] = bom[6][0] < 16? GPS_URA[bom[6][0]] : GPS_URA[15];
+    bo[6][1] = bom[6][1];                                       //SV health
+    if (bom[6][2] != -4096) bo[6][2] = bom[6][2] * POW2(-35);   //TGD (-4096 means not available)
+    bo[6][3] = bom[3][0];                                       //IODC
+    bo[7][0] = bom[7][0] * 6.0;                                 //Transmission time of message
+    return getInstantGNSStime(
+            bom[5][2],	//GPS week#
+            bo[0][0]);  //T0c
+}
+#undef GPSCNAV_BIT
+
+//methods for GLONASS L1 CA message processing
+//A macro to get bit position in a stream from the bit position (BITNUMBER) in the message string stated in the GLONASS ICD
+//Each GLONASS 85 bits string is stored in an array of 3 uint32_t (the stream)
+#define GLOL1CA_BIT(BITNUMBER) (85 - BITNUMBER)
+
+/**collectGLOL1CAEphemeris gets GLONASS navigation data from a raw message and store them to generate RINEX navigation files.
+ * Satellite navigation messages are temporary stored until all needed swtrings for the current satellite and epoch have been received.
+ * When completed, satellite ephemeris are extracted from strings, scaled to working units, and stored into "broadcast orbit lines"
  * of the RinexData object.
  * <p>For Glonass L1 C/A, each string contains 85 data bits, including the checksum.
  * <p>These bits should be fit into 11 bytes, with MSB first (skip B86-B88), covering a time period of 2 seconds
@@ -1065,9 +1656,6 @@ bool GNSSdataFromGRD::collectGLOL1CAEphemeris(RinexData &rinex, int msgType) {
     int frmNum;      //navigation message frame number
     //needed for RINEX
     int bom[BO_LINSTOTAL][BO_MAXCOLS];			//the RINEX broadcats orbit like arrangement for satellite ephemeris mantissa (as extracted from nav message)
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];		//the RINEX broadcats orbit arrangement for satellite ephemeris (after applying scale factors)
-    uint32_t wd[GLO_STRWORDS]; //a place to store the 84 bits of a GLONASS string
-    double tTag;    //the time tag for ephemeris data
     int sltnum;     //the GLONASS slot number extracted from navigation message
     string logmsg = getMsgDescription(msgType);			//a place to build log messages
     //read MT_SATNAV_GLONASS_L1_CA message data
@@ -1083,8 +1671,7 @@ bool GNSSdataFromGRD::collectGLOL1CAEphemeris(RinexData &rinex, int msgType) {
         if ((sltnum < GLO_MINOSN) || (sltnum > GLO_MAXOSN)) {
             logmsg + ", but out of range";
         } else {
-            tTag = scaleGLOEphemeris(bom, bo);
-            rinex.saveNavData('R', sltnum, bo, tTag);
+            saveEphemeris(rinex, 'R', sltnum, bom, scaleGLOEphemeris);
         }
         plog->fine(logmsg);
         //clear satellite string storage
@@ -1112,8 +1699,6 @@ bool GNSSdataFromGRD::collectGLOL1CACorrections(RinexData &rinex, int msgType) {
     int frmNum;         //navigation message frame number
     int bom[BO_LINSTOTAL][BO_MAXCOLS];		//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
     double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    uint32_t wd[GLO_STRWORDS]; //a place to store the 84 bits of a GLONASS string
-    double tTag;		//the time tag for ephemeris data
     string logMsg = getMsgDescription(msgType);
     //read MT_SATNAV_GLO_L1_CA message data
     if (!readGLOL1CANavMsg(constId, satNum, satIdx, strNum, frmNum, logMsg)) return false;
@@ -1123,7 +1708,7 @@ bool GNSSdataFromGRD::collectGLOL1CACorrections(RinexData &rinex, int msgType) {
         && pFrame->gloSatStrings[3].hasData
         && pFrame->gloSatStrings[4].hasData) {
         //extract and store corrections
-        extractGLOL1CAEphemeris(satIdx, bom, satOSN);
+        extractGLOL1CACorrections(satIdx, bom, satOSN);
         logMsg += " Corrections completed";
         if ((satOSN < GLO_MINOSN) || (satOSN > GLO_MAXOSN)) {
             logMsg += ", but OSN out of range";
@@ -1137,10 +1722,11 @@ bool GNSSdataFromGRD::collectGLOL1CACorrections(RinexData &rinex, int msgType) {
                 pOSN_FCN->fcnSet = true;
             }
             //set time corrections
-            tTag = scaleGLOEphemeris(bom, bo);
+            scaleGLOCorrections(bom, bo);
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GLUT, bo[BO_LIN_TIMEU], 0, satOSN);
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GLGP, bo[BO_LIN_TIMEG], 0, satOSN);
             logMsg += " TIMEU TIMEG";
+            navCorrSet['R'] |= CORR_ALL_GLO;
         }
         plog->fine(logMsg);
         //clear satellite string storage
@@ -1150,6 +1736,60 @@ bool GNSSdataFromGRD::collectGLOL1CACorrections(RinexData &rinex, int msgType) {
     return true;
 }
 
+//bit masks to verify the Hamming code of a GLONASS string stored in a stream (see GLONASS ICD 4.7)
+//Masks 0 to 6 select the check bit Bk (bit k) and the data bits (9 to 85) included in the checksum Ck
+//Mask 7 selects all bits in the string (1 to 85), included in the checksum CS
+const uint32_t GLOL1CA_HAMMING_MASK[8][GLO_STRWORDS] = {
+    {0x55555AAA, 0xAAAAB555, 0x6AD80800},
+    {0x66666CCC, 0xCCCCD999, 0xB3681000},
+    {0x87878F0F, 0x0F0F1E1E, 0x3C702000},
+    {0x07F80FF0, 0x0FF01FE0, 0x3F804000},
+    {0xF8000FFF, 0xF0001FFF, 0xC0008000},
+    {0x00000FFF, 0xFFFFE000, 0x00010000},
+    {0xFFFFF000, 0x00000000, 0x00020000},
+    {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFF800}
+};
+
+/**isGLOL1CAHammingOk verifies the Hamming code of a GLONASS string, correcting a single error in data bits if possible.
+ * Checksums C1 to C7 and CS are computed at once for the string using bit masks and the parity of the masked bits.
+ * As per GLONASS ICD 4.7, the string is correct when all checksums are 0, or when only one of C1 to C7 is 1 and CS is 1
+ * (the error is in a check bit). When two or more of C1 to C7 are 1 and CS is 1, there is a single error in the data bit
+ * given by C7...C1, which is corrected. Otherwise the string has errors which cannot be corrected.
+ *
+ * @param wd the stream containing the string. It is corrected if needed
+ * @param corrected is set to true if a data bit has been corrected, false otherwise
+ * @return true if the string is correct or has been corrected, false otherwise
+ */
+bool GNSSdataFromGRD::isGLOL1CAHammingOk(uint32_t (&wd)[GLO_STRWORDS], bool &corrected) {
+    uint32_t syndrome = 0;  //C7...C1
+    int nChecks = 0;        //number of checksums C1 to C7 equal to 1
+    int cs = 0;             //the checksum CS
+    for (int k = 0; k < 8; ++k) {
+        int c = 0;
+        for (int i = 0; i < GLO_STRWORDS; ++i) c += getBitCount(wd[i] & GLOL1CA_HAMMING_MASK[k][i]);
+        c &= 1;
+        if (k == 7) cs = c;
+        else if (c != 0) {
+            syndrome |= 1 << k;
+            nChecks++;
+        }
+    }
+    corrected = false;
+    if (cs == 0) return nChecks == 0;
+    if (nChecks == 0) return false;
+    if (nChecks == 1) return true;
+    //the bit in error is the data bit number syndrome (counting also check bits positions) + 8 - K, where K is the
+    //number of check bits positions before it
+    int k = 0;
+    while ((1u << k) <= syndrome) k++;
+    int bitNum = syndrome + 8 - k;
+    if (bitNum > 85) return false;
+    int pos = GLOL1CA_BIT(bitNum);
+    wd[pos >> 5] ^= 0x80000000u >> (pos & 0x1F);
+    corrected = true;
+    return true;
+}
+
 /**readGLOL1CANavMsg read a GLONASS navigation message from the navigation raw data file and save data read.
  * Data are stored in the gloSatFrame and gloSatStrings of the corresponding satNum and string.
  * In addition it updates the Glonass OSN_FCN table. See explanation for GLONASSosnfcn struct in GNSSdataFromGRD.h
@@ -1172,11 +1812,12 @@ bool GNSSdataFromGRD::readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx,
     GLONASSosnfcn* pto;
     GLOFrameData* ptFrm;
     GLOStrData* pString;
-    unsigned int navMsg[GLO_STRWORDS * 4];
+    unsigned int navMsg[GLO_STRWORDS * 4] = {0};
     uint32_t wd[GLO_STRWORDS]; //a place to store the 84 bits of a GLONASS string
+    bool corrected;
     try {
         //read MT_SATNAV_GLONASS_L1_CA message data
-        if (fscanf(grdFile, "%d;%c%d;%d;%d;%d", &status, &constId, &satNum, &strNum, &frmNum, &msgSize) != 6
+        if (!readNavMsgHeader(status, constId, satNum, strNum, frmNum, msgSize)
             || msgSize != GLO_L1_CA_MSGSIZE
             || status < 1) {
             plog->warning(logMsg + LOG_MSG_INMP + LOG_MSG_OSIZ);
@@ -1192,11 +1833,20 @@ bool GNSSdataFromGRD::readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx,
             return false;
         }
         for (int i = 0; i < GLO_L1_CA_MSGSIZE; ++i) {
-            if (fscanf(grdFile,";%X", navMsg+i) != 1) {
+            if (!readNavMsgByte(navMsg[i])) {
                 plog->warning(logMsg + LOG_MSG_INMP);
                 return false;
             }
         }
+        //pack message bytes into words with navigation data, and verify the Hamming code before using them
+        for (int i = 0; i < GLO_STRWORDS; ++i) {
+            wd[i] = navMsg[i*4]<<24 | navMsg[i*4+1]<<16 | navMsg[i*4+2]<<8 | navMsg[i*4+3];
+        }
+        if (!isGLOL1CAHammingOk(wd, corrected)) {
+            plog->fine(logMsg + LOG_MSG_HAMMING + LOG_MSG_NAVIG);
+            return false;
+        }
+        if (corrected) logMsg += " Hamming corrected";
         //set OSN or FCN values directly from satNum if possible
         GLONASSosnfcn* pOSN_FCN = &glonassOSN_FCN[satIdx];
         if (satIdx < GLO_MAXOSN) pOSN_FCN->osn = satNum;
@@ -1205,10 +1855,6 @@ bool GNSSdataFromGRD::readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx,
             pOSN_FCN->fcn = satNum - 100;
             pOSN_FCN->fcnSet = true;
         }
-        //pack message bytes into words with navigation data
-        for (int i = 0; i < GLO_STRWORDS; ++i) {
-            wd[i] = navMsg[i*4]<<24 | navMsg[i*4+1]<<16 | navMsg[i*4+2]<<8 | navMsg[i*4+3];
-        }
         switch (strNum) {
             case 4:
                 //string 4 includes de OSN (n in the ICD). Save it in the glonassOSN_FCN table
@@ -1282,6 +1928,29 @@ bool GNSSdataFromGRD::readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx,
     return false;
 }
 
+//GLONASS L1 C/A ephemeris fields in strings 1 to 4, streams 0 to 3 respectively (see GLONASS ICD)
+constexpr NavBitField GLOL1CA_FIELDS[] = {
+    {0, 1, NAVF_SIGNMAG, {{3, GLOL1CA_BIT(80), 22}}},	//Clock bias TauN: bits 80-59 string 4 (sign changed after extraction)
+    {0, 2, NAVF_SIGNMAG, {{2, GLOL1CA_BIT(79), 11}}},	//Relative frequency bias GammaN: bits 79-69 string 3
+    {1, 0, NAVF_SIGNMAG, {{0, GLOL1CA_BIT(35), 27}}},	//Satellite position, X: bits 35-9 string 1
+    {1, 1, NAVF_SIGNMAG, {{0, GLOL1CA_BIT(64), 24}}},	//Satellite velocity, X: bits 64-41 string 1
+    {1, 2, NAVF_SIGNMAG, {{0, GLOL1CA_BIT(40), 5}}},	//Satellite acceleration, X: bits 40-36 string 1
+    {1, 3, NAVF_UNSIGNED, {{1, GLOL1CA_BIT(80), 3}}},	//Satellite health Bn: bits 80-78 string 2
+    {2, 0, NAVF_SIGNMAG, {{1, GLOL1CA_BIT(35), 27}}},	//Satellite position, Y: bits 35-9 string 2
+    {2, 1, NAVF_SIGNMAG, {{1, GLOL1CA_BIT(64), 24}}},	//Satellite velocity, Y: bits 64-41 string 2
+    {2, 2, NAVF_SIGNMAG, {{1, GLOL1CA_BIT(40), 5}}},	//Satellite acceleration, Y: bits 40-36 string 2
+    {3, 0, NAVF_SIGNMAG, {{2, GLOL1CA_BIT(35), 27}}},	//Satellite position, Z: bits 35-9 string 3
+    {3, 1, NAVF_SIGNMAG, {{2, GLOL1CA_BIT(64), 24}}},	//Satellite velocity, Z: bits 64-41 string 3
+    {3, 2, NAVF_SIGNMAG, {{2, GLOL1CA_BIT(40), 5}}},	//Satellite acceleration, Z: bits 40-36 string 3
+    {3, 3, NAVF_UNSIGNED, {{3, GLOL1CA_BIT(53), 5}}},	//Age of oper. information (days) (En): bits 53-49 string 4
+};
+
+//GLONASS L1 C/A header corrections fields in string 5, stream 4 (see GLONASS ICD)
+constexpr NavBitField GLOL1CA_CORR_FIELDS[] = {
+    {BO_LIN_TIMEU, 0, NAVF_UNSIGNED, {{4, GLOL1CA_BIT(69), 32}}},	//TauC
+    {BO_LIN_TIMEG, 0, NAVF_UNSIGNED, {{4, GLOL1CA_BIT(31), 22}}},	//TauGPS
+};
+
 /**extractGLOL1CAEphemeris extract satellite number, time tag, and ephemeris from the given navigation message string transmitted by GLONASS satellites.
  * <p>The navigation message data frames of interest here have been stored in GLONASS strings for each satellite.
  * Ephemeris are extracted from strings and stored into a RINEX Broadcast Orbit lines like arrangement.
@@ -1295,21 +1964,12 @@ bool GNSSdataFromGRD::readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx,
  * @param slt the slot number extracted from navigation message
  */
 void GNSSdataFromGRD::extractGLOL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slt) {
-    uint32_t *pstring1 = gloSatFrame[satIdx].gloSatStrings[0].words;
-    uint32_t *pstring2 = gloSatFrame[satIdx].gloSatStrings[1].words;
-    uint32_t *pstring3 = gloSatFrame[satIdx].gloSatStrings[2].words;
-    uint32_t *pstring4 = gloSatFrame[satIdx].gloSatStrings[3].words;
-    uint32_t *pstring5 = gloSatFrame[satIdx].gloSatStrings[4].words;
-    for (int i = 0; i < BO_LINSTOTAL; ++i) {
-        for (int j = 0; j < BO_MAXCOLS; ++j) {
-            bom[i][j] = 0;
-        }
-    }
-    //TODO verify need or not for string 5
-    /*  not used in this version
-    slt = getBits(pstring4, GLOL1CA_BIT(15), 5);	//slot number (n) in string 4, bits 15-11
-    */
-    slt = glonassOSN_FCN[satIdx].osn;
+    uint32_t *streams[GLO_MAXSTRS];
+    for (int i = 0; i < GLO_MAXSTRS; ++i) streams[i] = gloSatFrame[satIdx].gloSatStrings[i].words;
+    uint32_t *pstring2 = streams[1];
+    uint32_t *pstring4 = streams[3];
+    uint32_t *pstring5 = streams[4];
+    extractGLOL1CACorrections(satIdx, bom, slt);
     int n4 = getBits(pstring5, GLOL1CA_BIT(36), 5);	//four-year interval number N4: bits 36-32 string 5
     int nt = getBits(pstring4, GLOL1CA_BIT(26), 11);	//day number NT: bits 26-16 string 4
     int tb = getBits(pstring2, GLOL1CA_BIT(76), 7); //time interval index tb: bits 76-70 string 2
@@ -1320,27 +1980,32 @@ void GNSSdataFromGRD::extractGLOL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTA
     tkSec += ((tk >> 1) & 0x3F) * 60;	//add min. in tk to secs.
     tkSec += (tk & 0x01) == 0? 0: 30;	//add sec. interval to secs.
     */
+    extractNavFields<GLOL1CA_FIELDS, sizeof(GLOL1CA_FIELDS) / sizeof(NavBitField)>(streams, bom, false);
     //convert frame time (in GLONASS time) to an UTC instant (use GPS ephemeris for convenience)
     double tTag = getInstantGPSdate(1996 + (n4-1)*4, 1, nt, 0, 0, (float) tb) - 3*60*60;
     bom[0][0] = (int) tTag;													//Toc
-    bom[0][1] = -getSigned(getBits(pstring4, GLOL1CA_BIT(80), 22), 22);	//Clock bias TauN: bits 80-59 string 4
-    bom[0][2] = getSigned(getBits(pstring3, GLOL1CA_BIT(79), 11), 11);	//Relative frequency bias GammaN: bits 79-69 string 3
+    bom[0][1] = -bom[0][1];                                                 //-TauN
     bom[0][3] = ((int) getTowGNSSinstant(tTag) + 518400) % 604800;		//seconds from UTC week start (mon 00:00). Note that GNSS week starts sun 00:00.
-    bom[1][0] = getSigned(getBits(pstring1, GLOL1CA_BIT(35), 27), 27);	//Satellite position, X: bits 35-9 string 1
-    bom[1][1] = getSigned(getBits(pstring1, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, X: bits 64-41 string 1
-    bom[1][2] = getSigned(getBits(pstring1, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, X: bits 40-36 string 1
-    bom[1][3] = getBits(pstring2, GLOL1CA_BIT(80), 3);					//Satellite health Bn: bits 80-78 string 2
-    bom[2][0] = getSigned(getBits(pstring2, GLOL1CA_BIT(35), 27), 27);	//Satellite position, Y: bits 35-9 string 2
-    bom[2][1] = getSigned(getBits(pstring2, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, Y: bits 64-41 string 2
-    bom[2][2] = getSigned(getBits(pstring2, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, Y: bits 40-36 string 2
     bom[2][3] = glonassOSN_FCN[satIdx].fcn;								//Frequency number (-7 ... +6)
-    bom[3][0] = getSigned(getBits(pstring3, GLOL1CA_BIT(35), 27), 27);	//Satellite position, Z: bits 35-9 string 3
-    bom[3][1] = getSigned(getBits(pstring3, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, Z: bits 64-41 string 3
-    bom[3][2] = getSigned(getBits(pstring3, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, Z: bits 40-36 string 3
-    bom[3][3] = getBits(pstring4, GLOL1CA_BIT(53), 5);			//Age of oper. information (days) (En): bits 53-49 string 4
-    //get time corrections data from string 5
-    bom[BO_LIN_TIMEU][0] = getBits(pstring5, GLOL1CA_BIT(69), 32);   //TauC
-    bom[BO_LIN_TIMEG][0] = getBits(pstring5, GLOL1CA_BIT(31), 22);   //TauGPS
+}
+
+/**extractGLOL1CACorrections extract from the navigation message strings stored for a GLONASS satellite only the
+ * data needed for the header of navigation files: the time corrections (see extractGLOL1CAEphemeris).
+ * They are stored in the rows BO_LIN_TIMEx.
+ *
+ * @param satIdx the satellite index
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ * @param slt the slot number extracted from navigation message
+ */
+void GNSSdataFromGRD::extractGLOL1CACorrections(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slt) {
+    uint32_t *streams[GLO_MAXSTRS];
+    for (int i = 0; i < GLO_MAXSTRS; ++i) streams[i] = gloSatFrame[satIdx].gloSatStrings[i].words;
+    //TODO verify need or not for string 5
+    /*  not used in this version
+    slt = getBits(streams[3], GLOL1CA_BIT(15), 5);	//slot number (n) in string 4, bits 15-11
+    */
+    slt = glonassOSN_FCN[satIdx].osn;
+    extractNavFields<GLOL1CA_CORR_FIELDS, sizeof(GLOL1CA_CORR_FIELDS) / sizeof(NavBitField)>(streams, bom);
 }
 
 /**scaleGLOEphemeris apply scale factors to satellite ephemeris mantissas to obtain true satellite ephemeris and store them
@@ -1354,14 +2019,29 @@ void GNSSdataFromGRD::extractGLOL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTA
  * @return the time tag of the satellite ephemeris as UTC seconds from the GPS epoch
  */
 double GNSSdataFromGRD::scaleGLOEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
-    for(int i=0; i<BO_LINSTOTAL; i++) {
+    for(int i=0; i<BO_MAXLINS; i++) {
+        for(int j=0; j<BO_MAXCOLS; j++) {
+            bo[i][j] =  bom[i][j] * GLO_SCALEFACTOR[i][j];
+        }
+    }
+    scaleGLOCorrections(bom, bo);
+    return (double) bom[0][0];
+}
+
+/**scaleGLOCorrections apply GLONASS scale factors to the mantissas of header corrections (rows BO_LIN_IONOA to BO_LIN_LEAPS)
+ * to obtain their true values.
+ *
+ * @param bom the mantissas of orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ * @param bo the orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ */
+void GNSSdataFromGRD::scaleGLOCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    for(int i=BO_LIN_IONOA; i<BO_LINSTOTAL; i++) {
         for(int j=0; j<BO_MAXCOLS; j++) {
             bo[i][j] =  bom[i][j] * GLO_SCALEFACTOR[i][j];
         }
     }
     //recompute the ones being 32 bits twos complement signed integers
     bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * GLO_SCALEFACTOR[BO_LIN_TIMEU][0];  //TauC
-    return (double) bom[0][0];
 }
 
 /**gloSatIdx obtains the satellite index from the given OSN or FCN.
@@ -1429,104 +2109,101 @@ int GNSSdataFromGRD::gloOSN(int satNum, char band, double carrFrq, bool updTbl)
 //a macro to get bit position in a message word (0 to 127) from what is bit position stated in the Galileo ICD
 #define GALIN_BIT(BITNUMBER) BITNUMBER
 
-/**collectGALINEphemeris gets from a GALILEO I/NAV navigation data from a raw message and store them to generate RINEX navigation files.
- * Satellite navigation messages are temporary stored until all words having ephemeris (1,2,3,4 & 5) for the current satellite and epoch
- * have been received.
- * When completed, satellite ephemeris are extracted from words, scaled to working units, and stored into "broadcast orbit lines"
- * of the RinexData object.
+/**GALINTraits states how Galileo I/NAV navigation messages are handled by the collectEphemeris and collectCorrections templates.
  * For Galileo I/NAV, each page contains 2 page parts, even and odd, with a total of 2x114 = 228 bits, (sync & tail excluded)
  * that should be fit into 29 bytes, with MSB first (skip B229-B232).
- *
- * @param rinex	the class instance where data are stored
- * @param msgType the true type of the message
- * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
+ * Ephemeris are in word types 1 to 5, and corrections in word types 5, 6 and 10.
  */
-bool GNSSdataFromGRD::collectGALINEphemeris(RinexData &rinex, int msgType) {
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int wordNum;    //navigation message page number
-    int bom[BO_LINSTOTAL][BO_MAXCOLS];	//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
-    string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_GALIN message data
-    if (!readGALINNavMsg(constId, satNum, sfrmNum, wordNum, logMsg)) return false;
-    //check if all ephemerides have been received, that is:
-    //-message word types 1, 2, 3, 4 & 5 have data
-    //-and data in words 1 to 4 have the same IODnav (Issue Of Data)
-    GALINAVFrameData *psatFrame = &galInavSatFrame[satNum - 1];
-    bool allRec = psatFrame->hasData;
-    for (int i = 0; allRec && i < 5; ++i) allRec = allRec && psatFrame->pageWord[i].hasData;
-    if (allRec) logMsg += LOG_MSG_FRM;
-    //verify IOD of data received in word types 1 to 4
-    uint32_t iodNav = getBits(psatFrame->pageWord[0].data, GALIN_BIT(6), 10);
-    for (int i = 1; allRec && i < 4; i++) {
-        allRec = allRec && (iodNav == getBits(psatFrame->pageWord[i].data, GALIN_BIT(6), 10));
+struct GNSSdataFromGRD::GALINTraits {
+    typedef GALINAVFrameData Frame;
+    static const char SYS = 'E';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.galInavSatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.galLastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int sfrmNum, wordNum;
+        return g.readGALINNavMsg(constId, satNum, sfrmNum, wordNum, logMsg);
     }
-    if (allRec) {
-        //all ephemerides have been already received; extract and store them into the RINEX object
-        logMsg += LOG_MSG_IOD;
-        plog->fine(logMsg);
-        extractGALINEphemeris(satNum - 1, bom);
-        tTag = scaleGALEphemeris(bom, bo);
-        rinex.saveNavData('E', satNum, bo, tTag);
-        //clear satellite pageword storage
-        psatFrame->hasData = false;
-        for (int i = 0; i < GALINAV_MAXWORDS; ++i) psatFrame->pageWord[i].hasData = false;
-    }
-    else plog->finer(logMsg);
-    return true;
-}
-
-/**collectGALINCorrections gets from a GALILEO I/NAV raw data message the ionospheric, clock and leap corrections data
- * needed to generate some RINEX navigation files header records.
- * Satellite navigation messages are temporary stored until a page type 5, 6 or 10 has been received.
- * When received, corrections are extracted from pages, scaled to working units, and stored into header records of the RinexData object.
- * For Galileo I/NAV, each page contains 2 page parts, even and odd, with a total of 2x114 = 228 bits, (sync & tail excluded)
- * that should be fit into 29 bytes, with MSB first (skip B229-B232).
- *
- * @param rinex	the class instance where data are stored
- * @param msgType the true type of the message
- * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
- */
-bool GNSSdataFromGRD::collectGALINCorrections(RinexData &rinex, int msgType) {
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int wordNum;    //navigation message page number
-    int bom[BO_LINSTOTAL][BO_MAXCOLS];	//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
-    string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_GALIN message data
-    if (!readGALINNavMsg(constId, satNum, sfrmNum, wordNum, logMsg)) return false;
-    //check if corrections have been received, that is page words 5, 6 or 10 have data
-    GALINAVFrameData *psatFrame = &galInavSatFrame[satNum - 1];
-    if (psatFrame->hasData && (psatFrame->pageWord[4].hasData || psatFrame->pageWord[5].hasData || psatFrame->pageWord[9].hasData)) {
-        logMsg += LOG_MSG_CORR;
-        extractGALINEphemeris(satNum - 1, bom);
-        tTag = scaleGALEphemeris(bom, bo);
-        if (psatFrame->pageWord[4].hasData) {   //page word type 5 includes Az and GST
-            rinex.setHdLnData(rinex.IONC, rinex.IONC_GAL, bo[BO_LIN_IONOA], (int) bo[7][0], satNum);
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGALINEphemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleGALEphemeris(bom, bo); }
+    static void extractCorrections(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGALINCorrections(satNum - 1, bom); }
+    static void scaleCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { scaleGALCorrections(bom, bo); }
+    //ephemeris are complete when word types 1, 2, 3, 4 & 5 have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.hasData;
+        for (int i = 0; allRec && i < 5; ++i) allRec = allRec && f.pageWord[i].hasData;
+        return allRec;
+    }
+    //data in word types 1 to 4 shall have the same IODnav
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.pageWord[0].data, GALIN_BIT(6), 10);
+        bool sameIod = true;
+        for (int i = 1; sameIod && i < 4; i++) sameIod = iod == getBits(f.pageWord[i].data, GALIN_BIT(6), 10);
+        return sameIod;
+    }
+    //hash data in word types 1 to 4, and word type 5 up to WN (TOW changes in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        uint32_t hash = 0;
+        for (int i = 0; i < 4; ++i) hash = hashNavWords(hash, f.pageWord[i].data, GALINAV_DATAW);
+        uint32_t w5data[3];
+        w5data[0] = getBits(f.pageWord[4].data, GALIN_BIT(1), 32);
+        w5data[1] = getBits(f.pageWord[4].data, GALIN_BIT(33), 32);
+        w5data[2] = getBits(f.pageWord[4].data, GALIN_BIT(65), 20);
+        return hashNavWords(hash, w5data, 3);
+    }
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < GALINAV_MAXWORDS; ++i) f.pageWord[i].hasData = false;
+    }
+    //corrections are available when word types 5, 6 or 10 have data
+    static bool hasCorrections(Frame &f) {
+        return f.hasData && (f.pageWord[4].hasData || f.pageWord[5].hasData || f.pageWord[9].hasData);
+    }
+    static int saveCorrections(RinexData &rinex, Frame &f, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS], int satNum, string &logMsg) {
+        int corrSet = 0;
+        if (f.pageWord[4].hasData) {   //page word type 5 includes Az and GST
+            rinex.setHdLnData(rinex.IONC, rinex.IONC_GAL, bo[BO_LIN_IONOA], bom[7][0], satNum);
             logMsg += "IONA";
+            corrSet |= CORR_IONA;
         }
-        if (psatFrame->pageWord[5].hasData) {   //page word type 6 includes GST-UTC conversion parms.
+        if (f.pageWord[5].hasData) {   //page word type 6 includes GST-UTC conversion parms.
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GAUT, bo[BO_LIN_TIMEU], 0, satNum);
             rinex.setHdLnData(rinex.LEAP, (int) bo[BO_LIN_LEAPS][0], (int) bo[BO_LIN_LEAPS][1], (int) bo[BO_LIN_LEAPS][2], (int) bo[BO_LIN_LEAPS][3], 'E');
             logMsg += " TIMEU LEAPS";
+            corrSet |= CORR_TIMEU | CORR_LEAPS;
         }
-        if (psatFrame->pageWord[9].hasData) {   //page word type 10 includes GST-GPST conversion params.
+        if (f.pageWord[9].hasData) {   //page word type 10 includes GST-GPST conversion params.
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_GAGP, bo[BO_LIN_TIMEG], 0, satNum);
             logMsg += " TIMEG";
+            corrSet |= CORR_TIMEG;
         }
-        plog->fine(logMsg);
-        //clear satellite pageword storage
-        psatFrame->hasData = false;
-        for (int i = 0; i < GALINAV_MAXWORDS; ++i) psatFrame->pageWord[i].hasData = false;
+        return corrSet;
     }
-    else plog->finer(logMsg);
-    return true;
+    static void clearCorrections(Frame &f) { clearEphemeris(f); }
+};
+
+/**isGALINCrcOk verifies the CRC-24Q of a Galileo I/NAV page.
+ * The CRC protects the even page part (e/o, page type and data 1/2, 114 bits) and the odd page part up to the CRC
+ * (e/o, page type, data 2/2 and reserved 1, 82 bits). They are taken from the message bytes as laid out by
+ * readGALINNavMsg (with 6 tail bits between both parts), and packed into 25 bytes preceded by 4 zero bits, which do not
+ * change the CRC value.
+ *
+ * @param navMsg the message bytes of the page, as read from the raw data file
+ * @return true if the CRC computed matches the one in the page, false otherwise
+ */
+bool GNSSdataFromGRD::isGALINCrcOk(unsigned int (&navMsg)[GALINAV_MSGSIZE]) {
+    uint32_t stream[(GALINAV_MSGSIZE + 3) / 4] = {0};   //message bytes packed in words, MSB first
+    uint8_t buff[25];           //the 196 bits protected by the CRC, plus 4 leading zero bits
+    const int chunks[][2] = {{0, 32}, {32, 32}, {64, 32}, {96, 18}, {120, 32}, {152, 32}, {184, 18}};   //bit position and length
+    for (int i = 0; i < GALINAV_MSGSIZE; ++i) stream[i / 4] |= (navMsg[i] & 0xFF) << (24 - 8 * (i % 4));
+    uint64_t acc = 0;           //bits pending to be stored in buff
+    int nAcc = 4;               //number of bits pending, starting with the 4 zero bits
+    int n = 0;
+    for (const auto &chunk : chunks) {
+        acc = (acc << chunk[1]) | getBits(stream, chunk[0], chunk[1]);
+        for (nAcc += chunk[1]; nAcc >= 8; nAcc -= 8) buff[n++] = (uint8_t) (acc >> (nAcc - 8));
+    }
+    return crc24q(buff, n) == getBits(stream, 202, 24);
 }
 
 /**readGALINNavMsg read a Galileo I/NAV navigation message from the navigation raw data file.
@@ -1548,7 +2225,7 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
     unsigned int navMsg[GALINAV_MSGSIZE]; //to store GAL I/NAV message bytes from receiver
     try {
         //read MT_SATNAV_GAL_INAV message data
-        if (fscanf(grdFile, "%d;%c%d;%d;%d;%d", &status, &constId, &satNum, &wordNum, &sfrmNum, &msgSize) != 6
+        if (!readNavMsgHeader(status, constId, satNum, wordNum, sfrmNum, msgSize)
             || status < 1
             || constId != 'E'
             || satNum < GAL_MINPRN
@@ -1563,7 +2240,7 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
             return false;
         }
         for (int i = 0; i < GALINAV_MSGSIZE; ++i) {
-            if (fscanf(grdFile,";%X", navMsg+i) != 1) {
+            if (!readNavMsgByte(navMsg[i])) {
                 plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
                 return false;
             }
@@ -1575,6 +2252,10 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
         //  1 e/o + 1 pt + 112 data 1/2 + 6 tail (?) + 1 e/o + 1 pt + 16 data 2/2 + 64 reserved 1 + 24 CRC + 8 reserved ...
         //and we have to extract data 1/2 and data 2/2 into a contiguos 128 bit stream:
         //1st; skip first 1 e/o + 1 pt and extract the following 32 x 4 = 128 bits (it is repetitive)
+        if (!isGALINCrcOk(navMsg)) {
+            plog->fine(logMsg + LOG_MSG_CRC + LOG_MSG_NAVIG);
+            return false;
+        }
         GALINAVFrameData *psatFrame = &galInavSatFrame[satNum - 1];
         GALINAVpageData *pmsgWord = &psatFrame->pageWord[wordNum - 1];
         for (int i = 0, n=0; i < GALINAV_DATAW; i++, n+=4) {
@@ -1585,7 +2266,6 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
                                           | ((pmsgWord->data[GALINAV_DATAW-1] & 0x000000FF) << 8)
                                           | ((navMsg[16] & 0x3F) << 2)
                                           | ((navMsg[17] & 0xC0) >> 6);
-        //TODO analyse if CRC shall be checked (is it necessary or not?)
         psatFrame->hasData = true;
         pmsgWord->hasData = true;
         logMsg += " Word saved.";
@@ -1596,6 +2276,55 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
     return true;
 }
 
+//Galileo I/NAV ephemeris fields in word types 1 to 5, streams 0 to 4 respectively (see Galileo OS ICD)
+constexpr NavBitField GALIN_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{3, GALIN_BIT(54), 14}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{3, GALIN_BIT(68), 31}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{3, GALIN_BIT(99), 21}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{3, GALIN_BIT(120), 6}}},	//Af2
+    {1, 0, NAVF_UNSIGNED, {{0, GALIN_BIT(6), 10}}},	//IODnav
+    {1, 1, NAVF_TWOSCOMP, {{2, GALIN_BIT(104), 16}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{2, GALIN_BIT(40), 16}}},	//Delta n
+    {1, 3, NAVF_TWOSCOMP, {{0, GALIN_BIT(30), 32}}},	//M0
+    {2, 0, NAVF_TWOSCOMP, {{2, GALIN_BIT(56), 16}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{0, GALIN_BIT(62), 32}}},	//e
+    {2, 2, NAVF_TWOSCOMP, {{2, GALIN_BIT(72), 16}}},	//Cus
+    {2, 3, NAVF_UNSIGNED, {{0, GALIN_BIT(94), 32}}},	//sqrt(A)
+    {3, 0, NAVF_UNSIGNED, {{0, GALIN_BIT(16), 14}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{3, GALIN_BIT(22), 16}}},	//Cic
+    {3, 2, NAVF_TWOSCOMP, {{1, GALIN_BIT(16), 32}}},	//OMEGA0
+    {3, 3, NAVF_TWOSCOMP, {{3, GALIN_BIT(38), 16}}},	//CIS
+    {4, 0, NAVF_TWOSCOMP, {{1, GALIN_BIT(48), 32}}},	//i0
+    {4, 1, NAVF_TWOSCOMP, {{2, GALIN_BIT(88), 16}}},	//Crc
+    {4, 2, NAVF_TWOSCOMP, {{1, GALIN_BIT(80), 32}}},	//w (omega)
+    {4, 3, NAVF_TWOSCOMP, {{2, GALIN_BIT(16), 24}}},	//w dot
+    {5, 0, NAVF_TWOSCOMP, {{1, GALIN_BIT(112), 14}}},	//IDOT
+    {6, 0, NAVF_UNSIGNED, {{2, GALIN_BIT(120), 8}}},	//SISA
+    {6, 2, NAVF_TWOSCOMP, {{4, GALIN_BIT(47), 10}}},	//BGD E5a / E1
+    {6, 3, NAVF_TWOSCOMP, {{4, GALIN_BIT(57), 10}}},	//BGD E5b / E1
+};
+
+//Galileo I/NAV header corrections fields in word types 5, 6 and 10, streams 4, 5 and 9 respectively (see Galileo OS ICD)
+constexpr NavBitField GALIN_CORR_FIELDS[] = {
+    {5, 2, NAVF_UNSIGNED, {{4, GALIN_BIT(73), 12}}},	//GAL week# (GST week, weeks to 1st GPS roll over and GAL roll over added after extraction)
+    {7, 0, NAVF_UNSIGNED, {{4, GALIN_BIT(85), 20}}},	//Time of message: TOW from GST
+    {BO_LIN_IONOA, 0, NAVF_TWOSCOMP, {{4, GALIN_BIT(6), 11}}},	//Iono Ai0
+    {BO_LIN_IONOA, 1, NAVF_TWOSCOMP, {{4, GALIN_BIT(17), 11}}},	//Iono Ai1
+    {BO_LIN_IONOA, 2, NAVF_TWOSCOMP, {{4, GALIN_BIT(28), 14}}},	//Iono Ai2
+    {BO_LIN_TIMEU, 0, NAVF_UNSIGNED, {{5, GALIN_BIT(6), 32}}},	//GST - UTC correction A0
+    {BO_LIN_TIMEU, 1, NAVF_TWOSCOMP, {{5, GALIN_BIT(38), 24}}},	//GST - UTC correction A1
+    {BO_LIN_TIMEU, 2, NAVF_UNSIGNED, {{5, GALIN_BIT(70), 8}}},	//GST - UTC correction t0t
+    {BO_LIN_TIMEU, 3, NAVF_UNSIGNED, {{5, GALIN_BIT(78), 8}}},	//GST - UTC correction WN0t
+    {BO_LIN_TIMEG, 0, NAVF_TWOSCOMP, {{9, GALIN_BIT(86), 16}}},	//Time correction AG0
+    {BO_LIN_TIMEG, 1, NAVF_TWOSCOMP, {{9, GALIN_BIT(102), 12}}},	//Time correction AG1
+    {BO_LIN_TIMEG, 2, NAVF_UNSIGNED, {{9, GALIN_BIT(114), 8}}},	//ref time: t0G
+    {BO_LIN_TIMEG, 3, NAVF_UNSIGNED, {{9, GALIN_BIT(122), 6}}},	//ref week number: WN0G
+    {BO_LIN_LEAPS, 0, NAVF_TWOSCOMP, {{5, GALIN_BIT(62), 8}}},	//delta tLS (leap seconds)
+    {BO_LIN_LEAPS, 1, NAVF_TWOSCOMP, {{5, GALIN_BIT(97), 8}}},	//delta tLSF
+    {BO_LIN_LEAPS, 2, NAVF_UNSIGNED, {{5, GALIN_BIT(86), 8}}},	//WN_LSF
+    {BO_LIN_LEAPS, 3, NAVF_UNSIGNED, {{5, GALIN_BIT(94), 3}}},	//DN_LSF
+};
+
 /**extractGALINEphemeris extract satellite number and ephemeris from the given navigation message transmitted by GPS satellites.
  * <p>The navigation message data of interest here have been stored in GALILEO frame (galINAVSatFrame) message words.
  * Ephemeris are extracted from mesage words (see Galileo OS ICD for bit arrangement) and stored into a RINEX broadcast orbit like (bom) arrangement.
@@ -1608,78 +2337,34 @@ bool GNSSdataFromGRD::readGALINNavMsg(char &constId, int &satNum, int &sfrmNum,
  * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
  */
 void GNSSdataFromGRD::extractGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
-    //use pointers for convenience
-    GALINAVFrameData *pframe = &galInavSatFrame[satIdx];
-    uint32_t *pw1data = pframe->pageWord[0].data;
-    uint32_t *pw2data = pframe->pageWord[1].data;
-    uint32_t *pw3data = pframe->pageWord[2].data;
-    uint32_t *pw4data = pframe->pageWord[3].data;
-    uint32_t *pw5data = pframe->pageWord[4].data;
-    uint32_t *pw6data = pframe->pageWord[5].data;
-    uint32_t *pw10data = pframe->pageWord[9].data;
-    for (int i = 0; i < BO_LINSTOTAL; ++i) {
-        for (int j = 0; j < BO_MAXCOLS; ++j) {
-            bom[i][j] = 0;
-        }
-    }
-    //broadcast line 0
-    bom[0][0] = getBits(pw4data, GALIN_BIT(54), 14);                         //T0C
-    bom[0][1] = getTwosComplement(getBits(pw4data, GALIN_BIT(68), 31), 31);  //Af0
-    bom[0][2] = getTwosComplement(getBits(pw4data, GALIN_BIT(99), 21), 21);  //Af1
-    bom[0][3] = getTwosComplement(getBits(pw4data, GALIN_BIT(120), 6), 6);   //Af2
-    //broadcast line 1
-    bom[1][0] = getBits(pw1data, GALIN_BIT(6), 10);	                        //IODnav
-    bom[1][1] = getTwosComplement(getBits(pw3data, GALIN_BIT(104), 16), 16);//Crs
-    bom[1][2] = getTwosComplement(getBits(pw3data, GALIN_BIT(40), 16), 16);	//Delta n
-    bom[1][3] = getTwosComplement(getBits(pw1data, GALIN_BIT(30), 32),32);  //M0
-    //broadcast line 2
-    bom[2][0] = getTwosComplement(getBits(pw3data, GALIN_BIT(56), 16), 16);	//Cuc
-    bom[2][1] = getBits(pw1data, GALIN_BIT(62), 32);                        //e
-    bom[2][2] = getTwosComplement(getBits(pw3data, GALIN_BIT(72), 16), 16);	//Cus
-    bom[2][3] = getBits(pw1data, GALIN_BIT(94), 32);   	                    //sqrt(A)
-    //broadcast line 3
-    bom[3][0] = getBits(pw1data, GALIN_BIT(16), 14);       	                //Toe
-    bom[3][1] = getTwosComplement(getBits(pw4data, GALIN_BIT(22), 16), 16);	//Cic
-    bom[3][2] = getTwosComplement(getBits(pw2data, GALIN_BIT(16), 32), 32); //OMEGA0
-    bom[3][3] = getTwosComplement(getBits(pw4data, GALIN_BIT(38), 16), 16);	//CIS
-    //broadcast line 4
-    bom[4][0] = getTwosComplement(getBits(pw2data, GALIN_BIT(48), 32), 32); //i0
-    bom[4][1] = getTwosComplement(getBits(pw3data, GALIN_BIT(88), 16), 16);	//Crc
-    bom[4][2] = getTwosComplement(getBits(pw2data, GALIN_BIT(80), 32), 32); //w (omega)
-    bom[4][3] = getTwosComplement(getBits(pw3data, GALIN_BIT(16), 24), 24); //w dot
-    //broadcast line 5
-    bom[5][0] = getTwosComplement(getBits(pw2data, GALIN_BIT(112), 14), 14);	//IDOT
+    uint32_t *streams[GALINAV_MAXWORDS];
+    for (int i = 0; i < GALINAV_MAXWORDS; ++i) streams[i] = galInavSatFrame[satIdx].pageWord[i].data;
+    uint32_t *pw5data = streams[4];
+    extractGALINCorrections(satIdx, bom);
+    extractNavFields<GALIN_FIELDS, sizeof(GALIN_FIELDS) / sizeof(NavBitField)>(streams, bom, false);
     bom[5][1] = 0xA0400000;				        //data source: assumed non-exclusive and for E5b, E1
-    bom[5][2] = getBits(pw5data, GALIN_BIT(73), 12) + 1024 + nGALrollOver * 4096;  //GAL week# (GST week + weeks to 1st GPS roll over + GAL roll over
-    //broadcast line 6
-    bom[6][0] = getBits(pw3data, GALIN_BIT(120), 8);			    //SISA
     bom[6][1] = (getBits(pw5data, GALIN_BIT(72), 1) << 31)      //SV health: E1B DVS
                 | (getBits(pw5data, GALIN_BIT(69), 2) << 29)	//SV health: E1B HS
                 | (getBits(pw5data, GALIN_BIT(71), 1) << 25)    //SV health: E5b DVS
-                | (getBits(pw5data, GALIN_BIT(69), 2) << 23);   //SV health: E5b HS
-    bom[6][2] = getTwosComplement(getBits(pw5data, GALIN_BIT(47), 10), 10);    //BGD E5a / E1
-    bom[6][3] = getTwosComplement(getBits(pw5data, GALIN_BIT(57), 10), 10);    //BGD E5b / E1
-    //broadcast line 7
-    bom[7][0] = getBits(pw5data, GALIN_BIT(85), 20);	//Time of message: TOW from GST
-    //extract corrections data
-    bom[BO_LIN_IONOA][0] = getTwosComplement(getBits(pw5data, GALIN_BIT(6), 11), 11);   //Iono Ai0
-    bom[BO_LIN_IONOA][1] = getTwosComplement(getBits(pw5data, GALIN_BIT(17), 11), 11);  //Iono Ai1
-    bom[BO_LIN_IONOA][2] = getTwosComplement(getBits(pw5data, GALIN_BIT(28), 14), 14);  //Iono Ai2
-    bom[BO_LIN_TIMEU][0] = getBits(pw6data, GALIN_BIT(6), 32);                          //GST - UTC correction A0
-    bom[BO_LIN_TIMEU][1] = getTwosComplement(getBits(pw5data, GALIN_BIT(38), 24), 24);  //GST - UTC correction A1
-    bom[BO_LIN_TIMEU][2] = getBits(pw5data, GALIN_BIT(70), 8);   //GST - UTC correction t0t
-    bom[BO_LIN_TIMEU][3] = getBits(pw5data, GALIN_BIT(78), 8);   //GST - UTC correction WN0t
+                | (getBits(pw5data, GALIN_BIT(67), 2) << 23);   //SV health: E5b HS
+}
+
+/**extractGALINCorrections extract from the stored navigation message words of a Galileo satellite only the data needed
+ * for the header of navigation files: iono and time corrections, and UTC leap seconds (see extractGALINEphemeris).
+ * They are stored in the rows BO_LIN_IONOA, BO_LIN_TIMEx, and BO_LIN_LEAP, and the week number and time of message in
+ * lines 5 and 7.
+ *
+ * @param satIdx the satellite index in the galInavSatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ */
+void GNSSdataFromGRD::extractGALINCorrections(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[GALINAV_MAXWORDS];
+    for (int i = 0; i < GALINAV_MAXWORDS; ++i) streams[i] = galInavSatFrame[satIdx].pageWord[i].data;
+    extractNavFields<GALIN_CORR_FIELDS, sizeof(GALIN_CORR_FIELDS) / sizeof(NavBitField)>(streams, bom);
+    bom[5][2] += 1024 + nGALrollOver * 4096;    //GAL week# (GST week + weeks to 1st GPS roll over + GAL roll over
     bom[BO_LIN_TIMEU][3] |= bom[5][2] & (~MASK8b);       //put WNt as a continuous week number
-    bom[BO_LIN_TIMEG][0] = getTwosComplement(getBits(pw10data, GALIN_BIT(86), 16), 16);     //Time correction AG0
-    bom[BO_LIN_TIMEG][1] = getTwosComplement(getBits(pw10data, GALIN_BIT(102), 12), 12);    //Time correction AG1
-    bom[BO_LIN_TIMEG][2] = getBits(pw10data, GALIN_BIT(114), 8);      //ref time: t0G
-    bom[BO_LIN_TIMEG][3] = getBits(pw10data, GALIN_BIT(122), 6);      //ref week number: WN0G
     bom[BO_LIN_TIMEG][3] |= bom[5][2] & (~MASK8b);       //put WN0G as a continuous week number
-    bom[BO_LIN_LEAPS][0] = getTwosComplement(getBits(pw6data, GALIN_BIT(62), 8), 8);    //delta tLS (leap seconds)
-    bom[BO_LIN_LEAPS][1] = getTwosComplement(getBits(pw6data, GALIN_BIT(95), 8), 8);    //delta tLSF
-    bom[BO_LIN_LEAPS][2] = getBits(pw6data, GALIN_BIT(86), 8);    //WN_LSF
     bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
-    bom[BO_LIN_LEAPS][3] = getBits(pw6data, GALIN_BIT(92), 3);    //DN_LSF
 }
 
 /**scaleGALEphemeris apply scale factors to satellite ephemeris mantissas to obtain true satellite ephemeris and store them
@@ -1694,15 +2379,15 @@ void GNSSdataFromGRD::extractGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL]
  * @return the time tag of the satellite ephemeris as seconds from the GPS epoch
  */
 double GNSSdataFromGRD::scaleGALEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
-    for(int i=0; i<BO_LINSTOTAL; i++) {
+    for(int i=0; i<BO_MAXLINS; i++) {
         for(int j=0; j<BO_MAXCOLS; j++) {
             bo[i][j] = bom[i][j] * GAL_SCALEFACTOR[i][j];
         }
     }
+    scaleGALCorrections(bom, bo);
     //recompute the ones being 32 bits twos complement signed integers
     bo[2][1] = ((unsigned int) bom[2][1]) * GAL_SCALEFACTOR[2][1];  //e
     bo[2][3] = ((unsigned int) bom[2][3]) * GAL_SCALEFACTOR[2][3];  //sqrt(A)
-    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * GAL_SCALEFACTOR[BO_LIN_TIMEU][0];  //A0
     //compute SISA value
     double value;
     int sisa = bom[6][0];
@@ -1717,112 +2402,325 @@ double GNSSdataFromGRD::scaleGALEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS],
             bom[5][2],	//GAL week# referred to GPS epoch
             bo[0][0]);  //T0c
 }
+
+/**scaleGALCorrections apply Galileo scale factors to the mantissas of header corrections (rows BO_LIN_IONOA to BO_LIN_LEAPS)
+ * to obtain their true values.
+ *
+ * @param bom the mantissas of orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ * @param bo the orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ */
+void GNSSdataFromGRD::scaleGALCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    for(int i=BO_LIN_IONOA; i<BO_LINSTOTAL; i++) {
+        for(int j=0; j<BO_MAXCOLS; j++) {
+            bo[i][j] = bom[i][j] * GAL_SCALEFACTOR[i][j];
+        }
+    }
+    //recompute the ones being 32 bits twos complement signed integers
+    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * GAL_SCALEFACTOR[BO_LIN_TIMEU][0];  //A0
+}
 #undef GALIN_BIT
 
-//A macro to get bit position in a subframe from the bit position (BITNUMBER) in the message subframe stated in the GPS ICD
-//Each GPS 30 bits message word is stored in an uint32_t (aligned to the rigth)
-//Each GPS subframe, comprising 10 words, is tored in an stream of 10 uint32_t
-//BITNUMBER is the position in the subframe, GPSL1CA_BIT gets the position in the stream
-#define BDSD1_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+//methods for GALILEO F/NAV message processing
+//a macro to get bit position in a page stream (0 to 237) from what is bit position (1 to 238) stated in the Galileo ICD
+#define GALFN_BIT(BITNUMBER) (BITNUMBER-1)
 
-/**collectBDSD1Ephemeris gets BDS D1 navigation data from a raw message and store them to generate RINEX navigation files.
- * Satellite navigation messages are temporary stored until all needed subframes for the current satellite and epoch have been received.
- * When completed, satellite ephemeris are extracted from subframes, scaled to working units, and stored into "broadcast orbit lines"
- * of the RinexData object.
+/**GALFNTraits states how Galileo F/NAV navigation messages are handled by the collectEphemeris template.
+ * For Galileo F/NAV, each page contains 238 bits (sync & tail excluded) that should be fit into 30 bytes, with MSB first
+ * (skip B239-B240). Ephemeris are in page types 1 to 4.
+ */
+struct GNSSdataFromGRD::GALFNTraits {
+    typedef GALFNAVFrameData Frame;
+    static const char SYS = 'E';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.galFnavSatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.galFnavLastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int pageType;
+        return g.readGALFNNavMsg(constId, satNum, pageType, logMsg);
+    }
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractGALFNEphemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleGALEphemeris(bom, bo); }
+    //ephemeris are complete when page types 1, 2, 3 & 4 have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.hasData;
+        for (int i = 0; allRec && i < GALFNAV_MAXPAGES; ++i) allRec = allRec && f.pages[i].hasData;
+        return allRec;
+    }
+    //data in page types 1 to 4 shall have the same IODnav
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.pages[0].data, GALFN_BIT(13), 10);
+        bool sameIod = true;
+        for (int i = 1; sameIod && i < GALFNAV_MAXPAGES; i++) sameIod = iod == getBits(f.pages[i].data, GALFN_BIT(7), 10);
+        return sameIod;
+    }
+    //hash data in page types 1 to 4 up to WN (WN and TOW change in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        const int dataBits[GALFNAV_MAXPAGES] = {155, 182, 174, 189};
+        uint32_t hash = 0;
+        for (int i = 0; i < GALFNAV_MAXPAGES; ++i) hash = hashNavBits(hash, f.pages[i].data, GALFN_BIT(1), dataBits[i]);
+        return hash;
+    }
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < GALFNAV_MAXPAGES; ++i) f.pages[i].hasData = false;
+    }
+};
+
+/**readGALFNNavMsg read a Galileo F/NAV navigation message from the navigation raw data file.
+ * Data are stored in galFnavSatFrame of the corresponding satNum.
  *
- * @param rinex	the class instance where data are stored
- * @param msgType the true type of the message
- * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
+ * @param constId constellation identification (G, R, E, ...)
+ * @param satNum satellite number in the constellation
+ * @param pageType page type number
+ * @param logMsg is the loggin message
+ * @return true if data succesful read, false otherwise
  */
-bool GNSSdataFromGRD::collectBDSD1Ephemeris(RinexData &rinex, int msgType) {
-    //TODO test this method with real data
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int pageNum;    //navigation message page number
-    int bom[BO_LINSTOTAL][BO_MAXCOLS];		//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
-    BDSD1FrameData *pframe;
-    string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_BEIDOU_D1 message data
-    if (!readBDSD1NavMsg(constId, satNum, sfrmNum, pageNum, logMsg)) return false;
-    //check if all ephemerides have been received, that is, all subframes have data
-    pframe = &bdsSatFrame[satNum - 1];
-    bool allRec = pframe->bdsSatSubframes[0].hasData;
-    for (int i = 1; i < BDSD1_MAXSUBFRS; ++i) allRec = allRec && pframe->bdsSatSubframes[i].hasData;
-    if (allRec) {
-        logMsg += LOG_MSG_FRM;
-        //all ephemerides have been already received; extract and store them into the RINEX object
-        plog->fine(logMsg);
-        extractBDSD1Ephemeris(satNum - 1, bom);
-        tTag = scaleBDSEphemeris(bom, bo);
-        rinex.saveNavData('C', satNum, bo, tTag);
-        //clear satellite frame storage
-        pframe->hasData = false;
-        for (int i = 0; i < BDSD1_MAXSUBFRS; ++i) pframe->bdsSatSubframes[i].hasData = false;
-    } else plog->finer(logMsg);
+bool GNSSdataFromGRD::readGALFNNavMsg(char &constId, int &satNum, int &pageType, string &logMsg) {
+    int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
+    int msgSize;    //the message size in bytes
+    int sfrmNum;    //the subframe number
+    unsigned int navMsg[GALFNAV_MSGSIZE];   //to store GAL F/NAV message bytes from receiver
+    uint32_t data[GALFNAV_DATAW] = {0};     //the page bits packed from message bytes
+    try {
+        //read MT_SATNAV_GALILEO_FNAV message data
+        if (!readNavMsgHeader(status, constId, satNum, pageType, sfrmNum, msgSize)
+            || status < 1
+            || constId != 'E'
+            || satNum < GAL_MINPRN
+            || satNum > GAL_MAXPRN
+            || msgSize != GALFNAV_MSGSIZE) {
+            plog->warning(logMsg + LOG_MSG_INMP + LOG_MSG_OSIZ);
+            return false;
+        }
+        logMsg += " sat:" + to_string(satNum)+ " page:" + to_string(pageType) + " subfr:" + to_string(sfrmNum);
+        if (pageType < 1 || pageType > GALFNAV_MAXPAGES) {
+            plog->finer(logMsg + LOG_MSG_NAVIG);
+            return false;
+        }
+        for (int i = 0; i < GALFNAV_MSGSIZE; ++i) {
+            if (!readNavMsgByte(navMsg[i])) {
+                plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
+                return false;
+            }
+            data[i / 4] |= (navMsg[i] & 0xFF) << (24 - 8 * (i % 4));
+        }
+        if (!isNavCrcOk(data, GALFNAV_PAGEBITS)) {
+            plog->fine(logMsg + LOG_MSG_CRC + LOG_MSG_NAVIG);
+            return false;
+        }
+        if ((int) getBits(data, GALFN_BIT(1), 6) != pageType) {
+            plog->fine(logMsg + LOG_MSG_WTDIF + to_string(getBits(data, GALFN_BIT(1), 6)) + LOG_MSG_NAVIG);
+            return false;
+        }
+        GALFNAVpageData *ppage = &galFnavSatFrame[satNum - 1].pages[pageType - 1];
+        memcpy(ppage->data, data, sizeof(data));
+        ppage->hasData = true;
+        galFnavSatFrame[satNum - 1].hasData = true;
+        logMsg += " Page saved.";
+    } catch (int error) {
+        plog->severe(logMsg + LOG_MSG_ERRO + to_string((long long) error));
+        return false;
+    }
     return true;
 }
 
-/**collectBDSD1Corrections gets BDS D1 navigation data from raw data message the ionospheric, clock and leap corrections data
- * needed to generate some RINEX navigation files header records.
- * Satellite navigation messages are temporary stored until a subframe 1 or 5 (page 9 or 10) 10 has been received.
- * When received, corrections are extracted from pages, scaled to working units, and stored into header records of the RinexData object.
+//Galileo F/NAV fields in page types 1 to 4, streams 0 to 3 respectively (see Galileo OS ICD), placed as the I/NAV ones
+constexpr NavBitField GALFN_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{0, GALFN_BIT(23), 14}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{0, GALFN_BIT(37), 31}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{0, GALFN_BIT(68), 21}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{0, GALFN_BIT(89), 6}}},	//Af2
+    {1, 0, NAVF_UNSIGNED, {{0, GALFN_BIT(13), 10}}},	//IODnav
+    {1, 1, NAVF_TWOSCOMP, {{2, GALFN_BIT(145), 16}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{2, GALFN_BIT(81), 16}}},	//Delta n
+    {1, 3, NAVF_TWOSCOMP, {{1, GALFN_BIT(17), 32}}},	//M0
+    {2, 0, NAVF_TWOSCOMP, {{2, GALFN_BIT(97), 16}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{1, GALFN_BIT(73), 32}}},	//e
+    {2, 2, NAVF_TWOSCOMP, {{2, GALFN_BIT(113), 16}}},	//Cus
+    {2, 3, NAVF_UNSIGNED, {{1, GALFN_BIT(105), 32}}},	//sqrt(A)
+    {3, 0, NAVF_UNSIGNED, {{2, GALFN_BIT(161), 14}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{3, GALFN_BIT(17), 16}}},	//Cic
+    {3, 2, NAVF_TWOSCOMP, {{1, GALFN_BIT(137), 32}}},	//OMEGA0
+    {3, 3, NAVF_TWOSCOMP, {{3, GALFN_BIT(33), 16}}},	//CIS
+    {4, 0, NAVF_TWOSCOMP, {{2, GALFN_BIT(17), 32}}},	//i0
+    {4, 1, NAVF_TWOSCOMP, {{2, GALFN_BIT(129), 16}}},	//Crc
+    {4, 2, NAVF_TWOSCOMP, {{2, GALFN_BIT(49), 32}}},	//w (omega)
+    {4, 3, NAVF_TWOSCOMP, {{1, GALFN_BIT(49), 24}}},	//w dot
+    {5, 0, NAVF_TWOSCOMP, {{1, GALFN_BIT(169), 14}}},	//IDOT
+    {5, 2, NAVF_UNSIGNED, {{0, GALFN_BIT(156), 12}}},	//GAL week# (GST week, weeks to 1st GPS roll over and GAL roll over added after extraction)
+    {6, 0, NAVF_UNSIGNED, {{0, GALFN_BIT(95), 8}}},	//SISA
+    {6, 2, NAVF_TWOSCOMP, {{0, GALFN_BIT(144), 10}}},	//BGD E5a / E1
+    {7, 0, NAVF_UNSIGNED, {{0, GALFN_BIT(168), 20}}},	//Time of message: TOW from GST
+};
+
+/**extractGALFNEphemeris extract satellite ephemeris from the stored F/NAV pages transmitted by a Galileo satellite.
+ * <p>The navigation message data of interest here have been stored in GALILEO frame (galFnavSatFrame) pages.
+ * Ephemeris are extracted from pages (see Galileo OS ICD for bit arrangement) and stored into a RINEX broadcast orbit like (bom) arrangement.
+ * <p>This method stores the MANTISSA of each satellite ephemeris into a broadcast orbit array, without applying any scale factor.
  *
- * @param rinex	the class instance where data are stored
- * @param msgType the true type of the message
- * @return true if data properly extracted (data correctly read, correct parity status, relevant subframe), false otherwise
+ * @param satIdx the satellite index in the galFnavSatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
  */
-bool GNSSdataFromGRD::collectBDSD1Corrections(RinexData &rinex, int msgType) {
-    //TODO test this method with real data
-    int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
-    char constId;   //the constellation identifier this satellite belongs
-    int satNum;		//the satellite number this navigation message belongssatt
-    int sfrmNum;    //navigation message subframe number
-    int pageNum;    //navigation message page number
-    int msgSize;    //the message size in bytes
-    uint32_t wd[BDSD1_SUBFRWORDS];  //a place to store the subframe words
-    int bom[BO_LINSTOTAL][BO_MAXCOLS];		//a RINEX broadcats orbit like arrangement for satellite ephemeris mantissa
-    double bo[BO_LINSTOTAL][BO_MAXCOLS];	//the RINEX broadcats orbit arrangement for satellite ephemeris
-    double tTag;		//the time tag for ephemeris data
-    BDSD1SubframeData *psubframe;
-    BDSD1FrameData *pframe;
-    string logMsg = getMsgDescription(msgType);
-    //read MT_SATNAV_BEIDOU_D1 message data
-    if (!readBDSD1NavMsg(constId, satNum, sfrmNum, pageNum, logMsg)) return false;
-    //check if corrections have been received
-    pframe = &bdsSatFrame[satNum - 1];
-    if (pframe->hasData &&
-        (pframe->bdsSatSubframes[0].hasData
-        || pframe->bdsSatSubframes[3].hasData
-        || pframe->bdsSatSubframes[4].hasData)) {
-        logMsg += LOG_MSG_CORR;
-        extractBDSD1Ephemeris(satNum - 1, bom);
-        tTag = scaleBDSEphemeris(bom, bo);
-        if (pframe->bdsSatSubframes[0].hasData) {
+void GNSSdataFromGRD::extractGALFNEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[GALFNAV_MAXPAGES];
+    for (int i = 0; i < GALFNAV_MAXPAGES; ++i) streams[i] = galFnavSatFrame[satIdx].pages[i].data;
+    extractNavFields<GALFN_FIELDS, sizeof(GALFN_FIELDS) / sizeof(NavBitField)>(streams, bom);
+    bom[5][1] = 0x40800000;				        //data source: F/NAV E5a-I, and clock for E5a, E1
+    bom[5][2] += 1024 + nGALrollOver * 4096;    //GAL week# (GST week + weeks to 1st GPS roll over + GAL roll over
+    bom[6][1] = (getBits(streams[0], GALFN_BIT(188), 1) << 28)     //SV health: E5a DVS
+                | (getBits(streams[0], GALFN_BIT(154), 2) << 26);  //SV health: E5a HS
+}
+#undef GALFN_BIT
+
+//A macro to get bit position in a subframe from the bit position (BITNUMBER) in the message subframe stated in the GPS ICD
+//Each GPS 30 bits message word is stored in an uint32_t (aligned to the rigth)
+//Each GPS subframe, comprising 10 words, is tored in an stream of 10 uint32_t
+//BITNUMBER is the position in the subframe, GPSL1CA_BIT gets the position in the stream
+#define BDSD1_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+
+/**BDSD1Traits states how BDS D1 navigation messages are handled by the collectEphemeris and collectCorrections templates.
+ * Ephemeris are in subframes 1 to 3, and corrections in subframe 1 and subframe 5 pages 9 and 10.
+ */
+struct GNSSdataFromGRD::BDSD1Traits {
+    typedef BDSD1FrameData Frame;
+    static const char SYS = 'C';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.bdsSatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.bdsLastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int sfrmNum, pageNum;
+        return g.readBDSD1NavMsg(constId, satNum, sfrmNum, pageNum, logMsg);
+    }
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractBDSD1Ephemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleBDSEphemeris(bom, bo); }
+    static void extractCorrections(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractBDSD1Corrections(satNum - 1, bom); }
+    static void scaleCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { scaleBDSCorrections(bom, bo); }
+    //ephemeris are complete when all subframes have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.bdsSatSubframes[0].hasData;
+        for (int i = 1; i < BDSD1_MAXSUBFRS; ++i) allRec = allRec && f.bdsSatSubframes[i].hasData;
+        return allRec;
+    }
+    //the AODE in subframe 1 is the issue of data. There is no other IOD to match
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.bdsSatSubframes[0].words, BDSD1_BIT(288), 5);
+        return true;
+    }
+    //hash words 3 to 10 of subframes 1 to 3, and bits 43 to 52 of word 2 (SOW changes in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        uint32_t hash = 0;
+        uint32_t w2data;
+        for (int i = 0; i < 3; ++i) {
+            w2data = getBits(f.bdsSatSubframes[i].words, BDSD1_BIT(43), 10);
+            hash = hashNavWords(hash, &w2data, 1);
+            hash = hashNavWords(hash, f.bdsSatSubframes[i].words + 2, BDSD1_SUBFRWORDS - 2);
+        }
+        return hash;
+    }
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < BDSD1_MAXSUBFRS; ++i) f.bdsSatSubframes[i].hasData = false;
+    }
+    //corrections are available when subframes 1, 4 or 5 have data
+    static bool hasCorrections(Frame &f) {
+        return f.hasData && (f.bdsSatSubframes[0].hasData || f.bdsSatSubframes[3].hasData || f.bdsSatSubframes[4].hasData);
+    }
+    static int saveCorrections(RinexData &rinex, Frame &f, int (&)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS], int satNum, string &logMsg) {
+        int corrSet = 0;
+        if (f.bdsSatSubframes[0].hasData) {
             rinex.setHdLnData(rinex.IONC, rinex.IONC_BDSA, bo[BO_LIN_IONOA], 0, satNum);
             rinex.setHdLnData(rinex.IONC, rinex.IONC_BDSB, bo[BO_LIN_IONOB], 0, satNum);
             logMsg += "IONA&B";
+            corrSet |= CORR_IONA | CORR_IONB;
         }
-        if (pframe->bdsSatSubframes[4].hasData) {
+        if (f.bdsSatSubframes[4].hasData) {
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_BDUT, bo[BO_LIN_TIMEU], 0, satNum);
             logMsg += " TIMEU";
-            if (pframe->bdsSatSubframes[0].hasData) {
+            corrSet |= CORR_TIMEU;
+            if (f.bdsSatSubframes[0].hasData) {
                 rinex.setHdLnData(rinex.LEAP, (int) bo[BO_LIN_LEAPS][0], (int) bo[BO_LIN_LEAPS][1], (int) bo[BO_LIN_LEAPS][2], (int) bo[BO_LIN_LEAPS][3], 'C');
                 logMsg += " LEAPS";
+                corrSet |= CORR_LEAPS;
             }
         }
-        if (pframe->bdsSatSubframes[3].hasData) {
+        if (f.bdsSatSubframes[3].hasData) {
             rinex.setHdLnData(rinex.TIMC, rinex.TIMC_BDGP, bo[BO_LIN_TIMEG], 0, satNum);
-            pframe->bdsSatSubframes[3].hasData = false;
             logMsg += " TIMEG";
+            corrSet |= CORR_TIMEG;
         }
-        plog->fine(logMsg);
-        //clear satellite frame storage. Note that subframe flags are note reset because LEAPS needs subframes 1 and 5 page 10
-        pframe->hasData = false;
-    } else plog->finer(logMsg);
-    return true;
+        return corrSet;
+    }
+    //subframe 1 and 5 flags are not reset because LEAPS needs subframes 1 and 5 page 10
+    static void clearCorrections(Frame &f) {
+        f.hasData = false;
+        f.bdsSatSubframes[3].hasData = false;
+    }
+};
+
+//BCH(15,11) generator polynomial g(x) = x^4 + x + 1 (see BDS ICD 5.1.3)
+#define BCH1511_POLY 0x13
+//the error pattern in a BCH(15,11) codeword for each syndrome value (a single bit error, or none for syndrome 0)
+const uint32_t BCH1511_ERROR[16] = {0x0000, 0x0001, 0x0002, 0x0010, 0x0004, 0x0100, 0x0020, 0x0400,
+                                    0x0008, 0x4000, 0x0200, 0x0080, 0x0040, 0x2000, 0x0800, 0x1000};
+
+/**bch1511Correct computes the syndrome of a BCH(15,11) codeword and corrects the erroneous bit, if any.
+ *
+ * @param codeword the 15 bits codeword (11 information bits followed by 4 parity bits) aligned to the right
+ * @param nCorrected the counter of corrected bits, to be increased if a bit is corrected
+ * @return the codeword corrected
+ */
+uint32_t GNSSdataFromGRD::bch1511Correct(uint32_t codeword, int &nCorrected) {
+    uint32_t rem = codeword & 0x7FFF;
+    for (int i = 14; i >= 4; --i) if (rem & (1u << i)) rem ^= BCH1511_POLY << (i - 4);
+    if (rem != 0) nCorrected++;
+    return codeword ^ BCH1511_ERROR[rem];
+}
+
+/**decodeBDSD1Words decodes the BCH(15,11) codes in the words of a BDS D1 subframe, correcting single bit errors in
+ * each codeword.
+ * Word 1 has 15 bits not encoded followed by a codeword. Words 2 to 10 have two codewords, which are transmitted
+ * interleaved bit by bit. Words are stored de-interleaved: 22 information bits (11 from each codeword) followed
+ * by the 4 parity bits of each codeword, which is the arrangement assumed by BDSD1_BIT.
+ * Receivers may provide words as transmitted or already de-interleaved. The arrangement having more words with valid
+ * codewords is taken as the one used in the subframe (de-interleaved in case of tie).
+ *
+ * @param words the subframe words, each one with 30 bits aligned to the right. They are de-interleaved and corrected.
+ * @return the number of corrected bits
+ */
+int GNSSdataFromGRD::decodeBDSD1Words(uint32_t (&words)[BDSD1_SUBFRWORDS]) {
+    uint32_t cw1[BDSD1_SUBFRWORDS], cw2[BDSD1_SUBFRWORDS];   //codewords assuming words interleaved
+    int nCorrected = 0;
+    int nValid = 0;         //number of words with valid codewords as stored (de-interleaved)
+    int nValidIntl = 0;     //number of words with valid codewords if interleaved
+    words[0] &= 0x3FFFFFFF;
+    for (int i = 1; i < BDSD1_SUBFRWORDS; ++i) {
+        int n = 0;
+        words[i] &= 0x3FFFFFFF;
+        bch1511Correct(((words[i] >> 19) << 4) | ((words[i] >> 4) & 0xF), n);
+        bch1511Correct((((words[i] >> 8) & 0x7FF) << 4) | (words[i] & 0xF), n);
+        if (n == 0) nValid++;
+        cw1[i] = cw2[i] = 0;
+        for (int b = 29; b > 0; b -= 2) {
+            cw1[i] = (cw1[i] << 1) | ((words[i] >> b) & 1);
+            cw2[i] = (cw2[i] << 1) | ((words[i] >> (b - 1)) & 1);
+        }
+        n = 0;
+        bch1511Correct(cw1[i], n);
+        bch1511Correct(cw2[i], n);
+        if (n == 0) nValidIntl++;
+    }
+    uint32_t cw;
+    words[0] = (words[0] & 0x3FFF8000) | bch1511Correct(words[0] & 0x7FFF, nCorrected);
+    for (int i = 1; i < BDSD1_SUBFRWORDS; ++i) {
+        if (nValidIntl > nValid) {
+            words[i] = (cw1[i] >> 4) << 19 | (cw2[i] >> 4) << 8 | (cw1[i] & 0xF) << 4 | (cw2[i] & 0xF);
+        }
+        cw = bch1511Correct(((words[i] >> 19) << 4) | ((words[i] >> 4) & 0xF), nCorrected);
+        words[i] = (words[i] & 0x7FF0F) | (cw >> 4) << 19 | (cw & 0xF) << 4;
+        cw = bch1511Correct((((words[i] >> 8) & 0x7FF) << 4) | (words[i] & 0xF), nCorrected);
+        words[i] = (words[i] & 0x3FF800F0) | (cw >> 4) << 8 | (cw & 0xF);
+    }
+    return nCorrected;
 }
 
 /**
@@ -1846,11 +2744,12 @@ bool GNSSdataFromGRD::readBDSD1NavMsg(char &constId, int &satNum, int &sfrmNum,
     int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
     int msgSize;    //the message size in bytes
     unsigned int navMsg[BDSD1_MSGSIZE]; //to store BDS message bytes from receiver
+    uint32_t words[BDSD1_SUBFRWORDS];   //the subframe words packed from message bytes
     BDSD1SubframeData *psubframe;
     BDSD1FrameData *pframe;
     try {
         //read MT_SATNAV_BEIDOU_D1 message data
-        if (fscanf(grdFile, "%d;%c%d;%d;%d;%d", &status, &constId, &satNum, &sfrmNum, &pageNum, &msgSize) != 6
+        if (!readNavMsgHeader(status, constId, satNum, sfrmNum, pageNum, msgSize)
             || status < 1
             || constId != 'C'
             || satNum < BDS_MINPRN
@@ -1867,19 +2766,27 @@ bool GNSSdataFromGRD::readBDSD1NavMsg(char &constId, int &satNum, int &sfrmNum,
         }
         //read message bytes
         for (int i = 0; i < BDSD1_MSGSIZE; ++i) {
-            if (fscanf(grdFile,";%X", navMsg+i) != 1) {
+            if (!readNavMsgByte(navMsg[i])) {
                 plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
                 return false;
             }
         }
-        //pack message bytes into the ten words with navigation data
+        //pack message bytes into the ten words with navigation data, and decode their BCH codes before storing them
+        for (int i = 0, n=0; i < BDSD1_SUBFRWORDS; ++i, n+=4) {
+            words[i] = navMsg[n]<<24 | navMsg[n+1]<<16 | navMsg[n+2]<<8 | navMsg[n+3];
+        }
+        int nCorrected = decodeBDSD1Words(words);
+        if (nCorrected > 0) logMsg += LOG_MSG_BCHCORR + to_string(nCorrected);
+        //after decoding, the subframe ID (FraID, bits 16 to 18) shall be the one stated in the message
+        if ((int) getBits(words, BDSD1_BIT(16), 3) != sfrmNum) {
+            plog->fine(logMsg + LOG_MSG_BCHERR + LOG_MSG_NAVIG);
+            return false;
+        }
         pframe = &bdsSatFrame[satNum - 1];
         //set index for subframes:0 is subframe 1; 1 is 2; 2 is 3; 3 is subfr 5 page 9; 4 is subfr 5 page 10
         psubframe = &pframe->bdsSatSubframes[sfrmNum - 1];
         if (sfrmNum == 5 && pageNum == 9) psubframe = &pframe->bdsSatSubframes[3];
-        for (int i = 0, n=0; i < BDSD1_SUBFRWORDS; ++i, n+=4) {
-            psubframe->words[i] = navMsg[n]<<24 | navMsg[n+1]<<16 | navMsg[n+2]<<8 | navMsg[n+3];
-        }
+        memcpy(psubframe->words, words, sizeof(words));
         psubframe->hasData = true;
         pframe->hasData = true;
         logMsg += LOG_MSG_SFR;
@@ -1891,6 +2798,58 @@ bool GNSSdataFromGRD::readBDSD1NavMsg(char &constId, int &satNum, int &sfrmNum,
     return true;
 }
 
+//BDS D1 ephemeris fields in subframes 1, 2 and 3, streams 0 to 2 respectively (see BDS ICD)
+constexpr NavBitField BDSD1_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(74), 9}, {0, BDSD1_BIT(91), 8}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{0, BDSD1_BIT(226), 7}, {0, BDSD1_BIT(241), 17}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{0, BDSD1_BIT(258), 5}, {0, BDSD1_BIT(271), 17}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{0, BDSD1_BIT(215), 11}}},	//Af2
+    {1, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(288), 5}}},	//IODE (AODE)
+    {1, 1, NAVF_TWOSCOMP, {{1, BDSD1_BIT(225), 8}, {1, BDSD1_BIT(241), 10}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{1, BDSD1_BIT(43), 10}, {1, BDSD1_BIT(61), 6}}},	//Delta n
+    {1, 3, NAVF_UNSIGNED, {{1, BDSD1_BIT(93), 20}, {1, BDSD1_BIT(121), 12}}},	//M0
+    {2, 0, NAVF_TWOSCOMP, {{1, BDSD1_BIT(67), 16}, {1, BDSD1_BIT(91), 2}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{1, BDSD1_BIT(133), 10}, {1, BDSD1_BIT(151), 22}}},	//e
+    {2, 2, NAVF_TWOSCOMP, {{1, BDSD1_BIT(181), 18}}},	//Cus
+    {2, 3, NAVF_UNSIGNED, {{1, BDSD1_BIT(251), 12}, {1, BDSD1_BIT(271), 20}}},	//sqrt(A)
+    {3, 0, NAVF_UNSIGNED, {{1, BDSD1_BIT(291), 2}, {2, BDSD1_BIT(43), 10}, {2, BDSD1_BIT(61), 5}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{2, BDSD1_BIT(106), 7}, {2, BDSD1_BIT(121), 11}}},	//Cic
+    {3, 2, NAVF_UNSIGNED, {{2, BDSD1_BIT(212), 21}, {2, BDSD1_BIT(241), 11}}},	//OMEGA0
+    {3, 3, NAVF_TWOSCOMP, {{2, BDSD1_BIT(164), 9}, {2, BDSD1_BIT(181), 9}}},	//CIS
+    {4, 0, NAVF_UNSIGNED, {{2, BDSD1_BIT(66), 17}, {2, BDSD1_BIT(91), 15}}},	//i0
+    {4, 1, NAVF_TWOSCOMP, {{1, BDSD1_BIT(199), 4}, {1, BDSD1_BIT(211), 14}}},	//Crc
+    {4, 2, NAVF_UNSIGNED, {{2, BDSD1_BIT(252), 11}, {2, BDSD1_BIT(271), 21}}},	//w (omega)
+    {4, 3, NAVF_TWOSCOMP, {{2, BDSD1_BIT(132), 11}, {2, BDSD1_BIT(151), 13}}},	//w dot
+    {5, 0, NAVF_TWOSCOMP, {{2, BDSD1_BIT(190), 13}, {2, BDSD1_BIT(211), 1}}},	//IDOT
+    {6, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(49), 4}}},	//URA index
+    {6, 1, NAVF_UNSIGNED, {{0, BDSD1_BIT(43), 1}}},	//sat H1
+    {6, 2, NAVF_TWOSCOMP, {{0, BDSD1_BIT(99), 10}}},	//TGD1 B1/B3
+    {6, 3, NAVF_TWOSCOMP, {{0, BDSD1_BIT(109), 4}, {0, BDSD1_BIT(121), 6}}},	//TGD2 B2/B3
+    {7, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(19), 8}, {0, BDSD1_BIT(31), 12}}},	//Transmission time of message: SOW
+    {7, 1, NAVF_UNSIGNED, {{0, BDSD1_BIT(44), 5}}},	//IODC (AODC)
+};
+
+//BDS D1 header corrections fields in subframes 1, 5 (page 9) and 5 (page 10), streams 0, 3 and 4 respectively (see BDS ICD)
+constexpr NavBitField BDSD1_CORR_FIELDS[] = {
+    {5, 2, NAVF_UNSIGNED, {{0, BDSD1_BIT(61), 13}}},	//BDS week (roll over added after extraction)
+    {BO_LIN_IONOA, 0, NAVF_TWOSCOMP, {{0, BDSD1_BIT(127), 8}}},	//alfa0
+    {BO_LIN_IONOA, 1, NAVF_TWOSCOMP, {{0, BDSD1_BIT(135), 8}}},	//alfa1
+    {BO_LIN_IONOA, 2, NAVF_TWOSCOMP, {{0, BDSD1_BIT(151), 8}}},	//alfa2
+    {BO_LIN_IONOA, 3, NAVF_TWOSCOMP, {{0, BDSD1_BIT(159), 8}}},	//alfa3
+    {BO_LIN_IONOB, 0, NAVF_TWOSCOMP, {{0, BDSD1_BIT(167), 6}, {0, BDSD1_BIT(181), 2}}},	//beta0
+    {BO_LIN_IONOB, 1, NAVF_TWOSCOMP, {{0, BDSD1_BIT(183), 8}}},	//beta1
+    {BO_LIN_IONOB, 2, NAVF_TWOSCOMP, {{0, BDSD1_BIT(191), 8}}},	//beta2
+    {BO_LIN_IONOB, 3, NAVF_TWOSCOMP, {{0, BDSD1_BIT(199), 4}, {0, BDSD1_BIT(211), 4}}},	//beta3
+    {BO_LIN_TIMEU, 0, NAVF_UNSIGNED, {{4, BDSD1_BIT(91), 22}, {4, BDSD1_BIT(121), 10}}},	//Time correction A0UTC
+    {BO_LIN_TIMEU, 1, NAVF_TWOSCOMP, {{4, BDSD1_BIT(131), 12}, {4, BDSD1_BIT(151), 12}}},	//A1UTC
+    {BO_LIN_TIMEG, 0, NAVF_TWOSCOMP, {{3, BDSD1_BIT(97), 14}}},	//A0GPS
+    {BO_LIN_TIMEG, 1, NAVF_TWOSCOMP, {{3, BDSD1_BIT(111), 2}, {3, BDSD1_BIT(121), 14}}},	//A1GPS
+    {BO_LIN_LEAPS, 0, NAVF_TWOSCOMP, {{4, BDSD1_BIT(51), 2}, {4, BDSD1_BIT(61), 6}}},	//delta tLS (leap seconds)
+    {BO_LIN_LEAPS, 1, NAVF_TWOSCOMP, {{4, BDSD1_BIT(67), 8}}},	//delta tLSF
+    {BO_LIN_LEAPS, 2, NAVF_UNSIGNED, {{4, BDSD1_BIT(75), 8}}},	//WN_LSF
+    {BO_LIN_LEAPS, 3, NAVF_UNSIGNED, {{4, BDSD1_BIT(163), 8}}},	//DN_LSF
+};
+
 /**extractBDSD1Ephemeris extract satellite number and ephemeris from the given D1 navigation message transmitted by BDS satellites.
  * <p>The navigation message data of interest here have been stored in BDS frame (bdsSatFrame) data words (without parity).
  * Ephemeris are extracted from this array and stored into a RINEX broadcast orbit like (bom) arrangement.
@@ -1904,70 +2863,195 @@ bool GNSSdataFromGRD::readBDSD1NavMsg(char &constId, int &satNum, int &sfrmNum,
  */
 void GNSSdataFromGRD::extractBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
     //TODO test this method with real data
-    uint32_t *psubfr1data = bdsSatFrame[satIdx].bdsSatSubframes[0].words;
-    uint32_t *psubfr2data = bdsSatFrame[satIdx].bdsSatSubframes[1].words;
-    uint32_t *psubfr3data = bdsSatFrame[satIdx].bdsSatSubframes[2].words;
-    uint32_t *psubfr5_9data = bdsSatFrame[satIdx].bdsSatSubframes[3].words;   //subframe 5, page 9
-    uint32_t *psubfr5_10data = bdsSatFrame[satIdx].bdsSatSubframes[4].words;   //subframe 5, page 10
-    for (int i = 0; i < BO_LINSTOTAL; ++i) {
-        for (int j = 0; j < BO_MAXCOLS; ++j) {
-            bom[i][j] = 0;
+    uint32_t *streams[BDSD1_MAXSUBFRS];
+    for (int i = 0; i < BDSD1_MAXSUBFRS; ++i) streams[i] = bdsSatFrame[satIdx].bdsSatSubframes[i].words;
+    extractBDSD1Corrections(satIdx, bom);
+    extractNavFields<BDSD1_FIELDS, sizeof(BDSD1_FIELDS) / sizeof(NavBitField)>(streams, bom, false);
+}
+
+/**extractBDSD1Corrections extract from the stored D1 navigation subframes of a BDS satellite only the data needed for
+ * the header of navigation files: iono and time corrections, and UTC leap seconds (see extractBDSD1Ephemeris).
+ * They are stored in the rows BO_LIN_IONOA, BO_LIN_IONOB, BO_LIN_TIMEx, and BO_LIN_LEAP, and the week number in line 5.
+ *
+ * @param satIdx the satellite index in the bdsSatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ */
+void GNSSdataFromGRD::extractBDSD1Corrections(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[BDSD1_MAXSUBFRS];
+    for (int i = 0; i < BDSD1_MAXSUBFRS; ++i) streams[i] = bdsSatFrame[satIdx].bdsSatSubframes[i].words;
+    extractNavFields<BDSD1_CORR_FIELDS, sizeof(BDSD1_CORR_FIELDS) / sizeof(NavBitField)>(streams, bom);
+    bom[5][2] += nBDSrollOver * 8192;       //BDS week with roll over
+    bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
+}
+
+/**BDSD2Traits states how BDS D2 navigation messages, broadcast by GEO satellites, are handled by the collectEphemeris template.
+ * Subframes have the same arrangement of D1 ones, and ephemeris are in pages 1 to 10 of subframe 1.
+ */
+struct GNSSdataFromGRD::BDSD2Traits {
+    typedef BDSD2FrameData Frame;
+    static const char SYS = 'C';
+    static Frame &frame(GNSSdataFromGRD &g, int satNum) { return g.bdsD2SatFrame[satNum - 1]; }
+    static LastEphData &lastEph(GNSSdataFromGRD &g, int satNum) { return g.bdsD2LastEph[satNum - 1]; }
+    static bool read(GNSSdataFromGRD &g, int &satNum, string &logMsg) {
+        char constId;
+        int pageNum;
+        return g.readBDSD2NavMsg(constId, satNum, pageNum, logMsg);
+    }
+    static void extract(GNSSdataFromGRD &g, int satNum, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) { g.extractBDSD2Ephemeris(satNum - 1, bom); }
+    static double scale(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) { return scaleBDSEphemeris(bom, bo); }
+    //ephemeris are complete when all pages have data
+    static bool hasEphemeris(Frame &f) {
+        bool allRec = f.hasData;
+        for (int i = 0; allRec && i < BDSD2_MAXPAGES; ++i) allRec = allRec && f.bdsSatPages[i].hasData;
+        return allRec;
+    }
+    //the AODE in page 4 is the issue of data. As it is not in other pages, they shall belong to the same 30 seconds
+    //cycle: the SOW of page n shall be the one of page 1 plus 3 * (n - 1)
+    static bool getIod(Frame &f, uint32_t &iod) {
+        iod = getBits(f.bdsSatPages[3].words, BDSD1_BIT(92), 5);
+        uint32_t sow = sowOf(f, 0);
+        bool sameCycle = true;
+        for (int i = 1; sameCycle && i < BDSD2_MAXPAGES; ++i) sameCycle = sowOf(f, i) == sow + 3 * i;
+        return sameCycle;
+    }
+    static uint32_t sowOf(Frame &f, int page) {
+        return getBits(f.bdsSatPages[page].words, BDSD1_BIT(19), 8) << 12 | getBits(f.bdsSatPages[page].words, BDSD1_BIT(31), 12);
+    }
+    //hash words 3 to 10 of all pages, and bits 43 to 52 of word 2 (SOW changes in each rebroadcast)
+    static uint32_t hash(Frame &f) {
+        uint32_t hash = 0;
+        uint32_t w2data;
+        for (int i = 0; i < BDSD2_MAXPAGES; ++i) {
+            w2data = getBits(f.bdsSatPages[i].words, BDSD1_BIT(43), 10);
+            hash = hashNavWords(hash, &w2data, 1);
+            hash = hashNavWords(hash, f.bdsSatPages[i].words + 2, BDSD1_SUBFRWORDS - 2);
         }
+        return hash;
     }
-    //broadcast line 0
-    bom[0][0] = (getBits(psubfr1data, BDSD1_BIT(74), 9) << 8) | getBits(psubfr1data, BDSD1_BIT(91), 8); //T0C
-    bom[0][1] = getTwosComplement((getBits(psubfr1data, BDSD1_BIT(226), 7) << 17) | getBits(psubfr1data, BDSD1_BIT(241), 17), 24);	//Af0
-    bom[0][2] = getTwosComplement((getBits(psubfr1data, BDSD1_BIT(258), 5) << 17) | getBits(psubfr1data, BDSD1_BIT(241), 17), 22);	//Af1
-    bom[0][3] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(215), 11), 11);    	//Af2
-    //broadcast line 1
-    bom[1][0] = getBits(psubfr1data, BDSD1_BIT(288), 5);	                    //IODE (AODE)
-    bom[1][1] = getTwosComplement((getBits(psubfr2data, BDSD1_BIT(225), 4) << 10) | getBits(psubfr2data, BDSD1_BIT(241), 10), 14); //Crs
-    bom[1][2] = getTwosComplement((getBits(psubfr2data, BDSD1_BIT(43), 10) << 6) | getBits(psubfr2data, BDSD1_BIT(61), 6), 16);	//Delta n
-    bom[1][3] = (getBits(psubfr2data, BDSD1_BIT(93), 20) << 12) | getBits(psubfr2data, BDSD1_BIT(121), 12);//M0
-    //broadcast line 2
-    bom[2][0] = getTwosComplement((getBits(psubfr2data, BDSD1_BIT(67), 16) << 2) | getBits(psubfr2data, BDSD1_BIT(91), 2), 18); //Cuc
-    bom[2][1] = (getBits(psubfr2data, BDSD1_BIT(133), 10) << 22) | getBits(psubfr2data, BDSD1_BIT(151), 25);	//e
-    bom[2][2] = getTwosComplement(getBits(psubfr2data, BDSD1_BIT(181), 18), 18);                                //Cus
-    bom[2][3] = (getBits(psubfr2data, BDSD1_BIT(251), 12) << 20) | getBits(psubfr2data, BDSD1_BIT(271), 20);	//sqrt(A)
-    //broadcast line 3
-    bom[3][0] = (getBits(psubfr2data, BDSD1_BIT(291), 2) << 15) | (getBits(psubfr3data, BDSD1_BIT(43), 10) << 5) | getBits(psubfr3data, BDSD1_BIT(61), 5);                            //Toe
-    bom[3][1] = getTwosComplement((getBits(psubfr3data, BDSD1_BIT(106), 7) << 11) | getBits(psubfr3data, BDSD1_BIT(121), 11), 18);  //Cic
-    bom[3][2] = (getBits(psubfr3data, BDSD1_BIT(212), 21) << 11) | getBits(psubfr3data, BDSD1_BIT(241), 11);                     	//OMEGA0
-    bom[3][3] = getTwosComplement((getBits(psubfr3data, BDSD1_BIT(164), 9) << 9) | getBits(psubfr3data, BDSD1_BIT(181), 9), 18);	//CIS
-    //broadcast line 4
-    bom[4][0] = (getBits(psubfr3data, BDSD1_BIT(66), 17) << 15) | getBits(psubfr3data, BDSD1_BIT(91), 15);                          //i0
-    bom[4][1] = getTwosComplement((getBits(psubfr2data, BDSD1_BIT(199), 4) << 14) | getBits(psubfr2data, BDSD1_BIT(211), 14), 18);	//Crc
-    bom[4][2] = (getBits(psubfr3data, BDSD1_BIT(252), 11) << 21) | getBits(psubfr3data, BDSD1_BIT(271), 21);                    	//w (omega)
-    bom[4][3] = getTwosComplement((getBits(psubfr3data, BDSD1_BIT(132), 11) << 13) | getBits(psubfr3data, BDSD1_BIT(151), 13), 24); //w dot
-    //broadcast line 5
-    bom[5][0] = getTwosComplement((getBits(psubfr3data, BDSD1_BIT(190), 13) << 1) | getBits(psubfr3data, BDSD1_BIT(211), 1) , 14);	//IDOT
-    bom[5][2] = getBits(psubfr1data, BDSD1_BIT(61), 13) + nBDSrollOver * 8192; //BDS week
-    //broadcast line 6
-    bom[6][0] = getBits(psubfr1data, BDSD1_BIT(49), 4);			//URA index
-    bom[6][1] = getBits(psubfr1data, BDSD1_BIT(43), 1);      	//sat H1
-    bom[6][2] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(99), 10), 10);                                                     //TGD1 B1/B3
-    bom[6][3] = getTwosComplement((getBits(psubfr1data, BDSD1_BIT(109), 4) << 6) | getBits(psubfr1data, BDSD1_BIT(121), 6), 10);	//TGD2 B2/B3
-    //broadcast line 7
-    bom[7][0] = (getBits(psubfr1data, BDSD1_BIT(19), 8) << 12) | getBits(psubfr1data, BDSD1_BIT(31), 12); //Transmission time of message: SOW
-    bom[7][1] = getBits(psubfr1data, BDSD1_BIT(44), 5);			//IODC (AODC
-    //extract corrections data
-    bom[BO_LIN_IONOA][0] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(127), 8), 8);    //alfa0
-    bom[BO_LIN_IONOA][1] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(135), 8), 8);    //alfa1
-    bom[BO_LIN_IONOA][2] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(151), 8), 8);    //alfa2
-    bom[BO_LIN_IONOA][3] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(159), 8), 8);    //alfa3
-    bom[BO_LIN_IONOB][0] = getTwosComplement((getBits(psubfr1data, BDSD1_BIT(167), 6) << 2) | getBits(psubfr1data, BDSD1_BIT(181), 2), 8);   //beta0
-    bom[BO_LIN_IONOB][1] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(183), 8), 8);   //beta1
-    bom[BO_LIN_IONOB][2] = getTwosComplement(getBits(psubfr1data, BDSD1_BIT(191), 8), 8);   //beta2
-    bom[BO_LIN_IONOB][3] = getTwosComplement((getBits(psubfr1data, BDSD1_BIT(199), 4)<<4) | getBits(psubfr1data, BDSD1_BIT(211), 4), 8);   //beta3
-    bom[BO_LIN_TIMEU][0] = (getBits(psubfr5_10data, BDSD1_BIT(91), 22) << 10) | getBits(psubfr5_10data, BDSD1_BIT(121), 10);    //Time correction A0UTC
-    bom[BO_LIN_TIMEU][1] = getTwosComplement((getBits(psubfr5_10data, BDSD1_BIT(131), 12) << 12) | getBits(psubfr5_10data, BDSD1_BIT(151), 12), 24);    //A1UTC
-    bom[BO_LIN_TIMEG][0] = getTwosComplement(getBits(psubfr5_9data, BDSD1_BIT(97), 14), 14);      //A0GPS
-    bom[BO_LIN_TIMEG][1] = getTwosComplement((getBits(psubfr5_9data, BDSD1_BIT(111), 2) << 14) | getBits(psubfr5_9data, BDSD1_BIT(121), 14), 16);    //A1GPS
-    bom[BO_LIN_LEAPS][0] = getTwosComplement((getBits(psubfr5_10data, BDSD1_BIT(51), 2) << 6) | getBits(psubfr5_10data, BDSD1_BIT(61), 6) , 8);    //delta tLS (leap seconds)
-    bom[BO_LIN_LEAPS][1] = getTwosComplement(getBits(psubfr5_10data, BDSD1_BIT(67), 8), 8);    //delta tLSF
-    bom[BO_LIN_LEAPS][2] = getBits(psubfr5_10data, BDSD1_BIT(75), 8);    //WN_LSF
-    bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
-    bom[BO_LIN_LEAPS][3] = getBits(psubfr5_10data, BDSD1_BIT(163), 8);    //DN_LSF
+    static void clearEphemeris(Frame &f) {
+        f.hasData = false;
+        for (int i = 0; i < BDSD2_MAXPAGES; ++i) f.bdsSatPages[i].hasData = false;
+    }
+};
+
+/**
+ * readBDSD2NavMsg read a Beidou D2 navigation message from the navigation raw data file.
+ * Data are stored in bdsD2SatFrame of the corresponding satNum.
+ * For Beidou D2, each subframe of the navigation message contains 10 30-bit words, with the same arrangement of D1 ones.
+ * Only have interest pages 1 to 10 of subframe 1. The page number is taken from the message data.
+ *
+ * @param constId constellation identification (G, R, E, ...)
+ * @param satNum satellite number in the constellation
+ * @param pageNum page number
+ * @param logMsg is the loggin message
+ * @return true if data succesful read, false otherwise
+ */
+bool GNSSdataFromGRD::readBDSD2NavMsg(char &constId, int &satNum, int &pageNum, string &logMsg) {
+    int status;     //the status of the navigation message:0=UNKNOWN, 1=PARITY PASSED, 2=REBUILT
+    int msgSize;    //the message size in bytes
+    int sfrmNum;    //the subframe number
+    int frmNum;     //the frame number (1 to 120), not used
+    unsigned int navMsg[BDSD1_MSGSIZE]; //to store BDS message bytes from receiver
+    uint32_t words[BDSD1_SUBFRWORDS];   //the subframe words packed from message bytes
+    BDSD1SubframeData *ppage;
+    try {
+        //read MT_SATNAV_BEIDOU_D2 message data
+        if (!readNavMsgHeader(status, constId, satNum, sfrmNum, frmNum, msgSize)
+            || status < 1
+            || constId != 'C'
+            || satNum < BDS_MINPRN
+            || satNum > BDS_MAXPRN
+            || msgSize != BDSD1_MSGSIZE) {
+            plog->warning(logMsg + LOG_MSG_INMP + LOG_MSG_OSIZ);
+            return false;
+        }
+        logMsg += " sat:" + to_string(satNum) + " subfr:" + to_string(sfrmNum);
+        if (sfrmNum != 1) {
+            plog->finer(logMsg + LOG_MSG_NAVIG);
+            return false;
+        }
+        //read message bytes
+        for (int i = 0; i < BDSD1_MSGSIZE; ++i) {
+            if (!readNavMsgByte(navMsg[i])) {
+                plog->warning(logMsg + LOG_MSG_ERRO + LOG_MSG_INMP);
+                return false;
+            }
+        }
+        //pack message bytes into the ten words with navigation data, and decode their BCH codes before storing them
+        for (int i = 0, n=0; i < BDSD1_SUBFRWORDS; ++i, n+=4) {
+            words[i] = navMsg[n]<<24 | navMsg[n+1]<<16 | navMsg[n+2]<<8 | navMsg[n+3];
+        }
+        int nCorrected = decodeBDSD1Words(words);
+        if (nCorrected > 0) logMsg += LOG_MSG_BCHCORR + to_string(nCorrected);
+        //after decoding, the subframe ID (FraID, bits 16 to 18) shall be the one stated in the message
+        if ((int) getBits(words, BDSD1_BIT(16), 3) != sfrmNum) {
+            plog->fine(logMsg + LOG_MSG_BCHERR + LOG_MSG_NAVIG);
+            return false;
+        }
+        pageNum = getBits(words, BDSD1_BIT(43), 4);
+        logMsg += " pg:" + to_string(pageNum);
+        if (pageNum < 1 || pageNum > BDSD2_MAXPAGES) {
+            plog->finer(logMsg + LOG_MSG_NAVIG);
+            return false;
+        }
+        ppage = &bdsD2SatFrame[satNum - 1].bdsSatPages[pageNum - 1];
+        memcpy(ppage->words, words, sizeof(words));
+        ppage->hasData = true;
+        bdsD2SatFrame[satNum - 1].hasData = true;
+        logMsg += LOG_MSG_SFR;
+    } catch (int error) {
+        plog->severe(logMsg + LOG_MSG_ERRO + to_string((long long) error));
+        return false;
+    }
+    return true;
+}
+
+//BDS D2 fields in pages 1 to 10 of subframe 1, streams 0 to 9 respectively (see BDS ICD), placed as the D1 ones.
+//Most of them are split between consecutive pages
+constexpr NavBitField BDSD2_FIELDS[] = {
+    {0, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(78), 5}, {0, BDSD1_BIT(91), 12}}},	//T0C
+    {0, 1, NAVF_TWOSCOMP, {{2, BDSD1_BIT(101), 12}, {2, BDSD1_BIT(121), 12}}},	//Af0
+    {0, 2, NAVF_TWOSCOMP, {{2, BDSD1_BIT(133), 4}, {3, BDSD1_BIT(47), 6}, {3, BDSD1_BIT(61), 12}}},	//Af1
+    {0, 3, NAVF_TWOSCOMP, {{3, BDSD1_BIT(73), 10}, {3, BDSD1_BIT(91), 1}}},	//Af2
+    {1, 0, NAVF_UNSIGNED, {{3, BDSD1_BIT(92), 5}}},	//IODE (AODE)
+    {1, 1, NAVF_TWOSCOMP, {{7, BDSD1_BIT(92), 18}}},	//Crs
+    {1, 2, NAVF_TWOSCOMP, {{3, BDSD1_BIT(97), 16}}},	//Delta n
+    {1, 3, NAVF_UNSIGNED, {{4, BDSD1_BIT(51), 2}, {4, BDSD1_BIT(61), 22}, {4, BDSD1_BIT(91), 8}}},	//M0
+    {2, 0, NAVF_TWOSCOMP, {{3, BDSD1_BIT(121), 14}, {4, BDSD1_BIT(47), 4}}},	//Cuc
+    {2, 1, NAVF_UNSIGNED, {{4, BDSD1_BIT(125), 10}, {5, BDSD1_BIT(47), 6}, {5, BDSD1_BIT(61), 16}}},	//e
+    {2, 2, NAVF_TWOSCOMP, {{4, BDSD1_BIT(99), 14}, {4, BDSD1_BIT(121), 4}}},	//Cus
+    {2, 3, NAVF_UNSIGNED, {{5, BDSD1_BIT(77), 6}, {5, BDSD1_BIT(91), 22}, {5, BDSD1_BIT(121), 4}}},	//sqrt(A)
+    {3, 0, NAVF_UNSIGNED, {{6, BDSD1_BIT(81), 2}, {6, BDSD1_BIT(91), 15}}},	//Toe
+    {3, 1, NAVF_TWOSCOMP, {{5, BDSD1_BIT(125), 10}, {6, BDSD1_BIT(47), 6}, {6, BDSD1_BIT(61), 2}}},	//Cic
+    {3, 2, NAVF_UNSIGNED, {{8, BDSD1_BIT(52), 1}, {8, BDSD1_BIT(61), 22}, {8, BDSD1_BIT(91), 9}}},	//OMEGA0
+    {3, 3, NAVF_TWOSCOMP, {{6, BDSD1_BIT(63), 18}}},	//CIS
+    {4, 0, NAVF_UNSIGNED, {{6, BDSD1_BIT(106), 7}, {6, BDSD1_BIT(121), 14}, {7, BDSD1_BIT(47), 6}, {7, BDSD1_BIT(61), 5}}},	//i0
+    {4, 1, NAVF_TWOSCOMP, {{7, BDSD1_BIT(66), 17}, {7, BDSD1_BIT(91), 1}}},	//Crc
+    {4, 2, NAVF_UNSIGNED, {{8, BDSD1_BIT(100), 13}, {8, BDSD1_BIT(121), 14}, {9, BDSD1_BIT(47), 5}}},	//w (omega)
+    {4, 3, NAVF_TWOSCOMP, {{7, BDSD1_BIT(110), 3}, {7, BDSD1_BIT(121), 16}, {8, BDSD1_BIT(47), 5}}},	//w dot
+    {5, 0, NAVF_TWOSCOMP, {{9, BDSD1_BIT(52), 1}, {9, BDSD1_BIT(61), 13}}},	//IDOT
+    {5, 2, NAVF_UNSIGNED, {{0, BDSD1_BIT(65), 13}}},	//BDS week (roll over added after extraction)
+    {6, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(61), 4}}},	//URA index
+    {6, 1, NAVF_UNSIGNED, {{0, BDSD1_BIT(47), 1}}},	//sat H1
+    {6, 2, NAVF_TWOSCOMP, {{0, BDSD1_BIT(103), 10}}},	//TGD1 B1/B3
+    {6, 3, NAVF_TWOSCOMP, {{0, BDSD1_BIT(121), 10}}},	//TGD2 B2/B3
+    {7, 0, NAVF_UNSIGNED, {{0, BDSD1_BIT(19), 8}, {0, BDSD1_BIT(31), 12}}},	//Transmission time of message: SOW
+    {7, 1, NAVF_UNSIGNED, {{0, BDSD1_BIT(48), 5}}},	//IODC (AODC)
+};
+
+/**extractBDSD2Ephemeris extract satellite ephemeris from the stored D2 navigation pages transmitted by a BDS GEO satellite.
+ * <p>The navigation message data of interest here have been stored in BDS frame (bdsD2SatFrame) data words (without parity).
+ * Ephemeris are extracted from this array and stored into a RINEX broadcast orbit like (bom) arrangement.
+ * <p>This method stores the MANTISSA of each satellite ephemeris into a broadcast orbit array, without applying any scale factor.
+ *
+ * @param satIdx the satellite index in the bdsD2SatFrame
+ * @param bom an array of broadcats orbit data containing the mantissa of each satellite ephemeris
+ */
+void GNSSdataFromGRD::extractBDSD2Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *streams[BDSD2_MAXPAGES];
+    for (int i = 0; i < BDSD2_MAXPAGES; ++i) streams[i] = bdsD2SatFrame[satIdx].bdsSatPages[i].words;
+    extractNavFields<BDSD2_FIELDS, sizeof(BDSD2_FIELDS) / sizeof(NavBitField)>(streams, bom);
+    bom[5][2] += nBDSrollOver * 8192;       //BDS week with roll over
 }
 #undef BDSD1_BIT
 
@@ -1984,17 +3068,15 @@ void GNSSdataFromGRD::extractBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL]
  */
 double GNSSdataFromGRD::scaleBDSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
     //TODO test this method with real data
-    double aDouble;
-    int iodc = bom[6][3];
-    for(int i=0; i<BO_LINSTOTAL; i++) {
+    for(int i=0; i<BO_MAXLINS; i++) {
         for (int j = 0; j <BO_MAXCOLS; j++) {
             bo[i][j] = bom[i][j] * BDS_SCALEFACTOR[i][j];
         }
     }
+    scaleBDSCorrections(bom, bo);
     //recompute the ones being 32 bits twos complement signed integers
     bo[2][1] = ((unsigned int) bom[2][1]) * BDS_SCALEFACTOR[2][1];  //e
     bo[2][3] = ((unsigned int) bom[2][3]) * BDS_SCALEFACTOR[2][3];  //sqrt(A)
-    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * BDS_SCALEFACTOR[BO_LIN_TIMEU][0];  //A0
     //compute User Range Accuracy value
     if (bom[6][0] == 1) bo[6][0] = 2.8;
     else if (bom[6][0] == 3) bo[6][0] = 5.7;
@@ -2007,6 +3089,147 @@ double GNSSdataFromGRD::scaleBDSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS],
             bo[0][0]) + 14;     //T0c plus leap at BDS epoch
 }
 
+/**scaleBDSCorrections apply BDS scale factors to the mantissas of header corrections (rows BO_LIN_IONOA to BO_LIN_LEAPS)
+ * to obtain their true values.
+ *
+ * @param bom the mantissas of orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ * @param bo the orbital parameters and corrections data arranged as per RINEX broadcast orbit
+ */
+void GNSSdataFromGRD::scaleBDSCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    for(int i=BO_LIN_IONOA; i<BO_LINSTOTAL; i++) {
+        for (int j = 0; j <BO_MAXCOLS; j++) {
+            bo[i][j] = bom[i][j] * BDS_SCALEFACTOR[i][j];
+        }
+    }
+    //recompute the ones being 32 bits twos complement signed integers
+    bo[BO_LIN_TIMEU][0] = ((unsigned int) bom[BO_LIN_TIMEU][0]) * BDS_SCALEFACTOR[BO_LIN_TIMEU][0];  //A0
+}
+
+/**hashNavWords accumulates into the given hash value the content of a stream of navigation message words.
+ * It uses the FNV-1a algorithm, which is fast and good enough to detect changes in ephemeris payloads.
+ *
+ * @param hash the current hash value (0 to start a new one)
+ * @param words the stream of words to hash
+ * @param nWords the number of words in the stream
+ * @return the hash value updated with the words given
+ */
+uint32_t GNSSdataFromGRD::hashNavWords(uint32_t hash, uint32_t *words, int nWords) {
+    if (hash == 0) hash = 2166136261u;  //FNV offset basis
+    for (int i = 0; i < nWords; ++i) {
+        for (int j = 0; j < 32; j += 8) {
+            hash ^= (words[i] >> j) & 0xFF;
+            hash *= 16777619u;  //FNV prime
+        }
+    }
+    return hash;
+}
+
+/**hashNavBits accumulates into the given hash value the content of a chunk of bits in a navigation message stream.
+ * Bits are taken in 32 bits words (the last one aligned to the right) and hashed as in hashNavWords.
+ *
+ * @param hash the current hash value (0 to start a new one)
+ * @param stream the stream containing the bits to hash
+ * @param bitpos the position in the stream of the first bit to hash
+ * @param len the number of bits to hash
+ * @return the hash value updated with the bits given
+ */
+uint32_t GNSSdataFromGRD::hashNavBits(uint32_t hash, uint32_t *stream, int bitpos, int len) {
+    uint32_t word;
+    for (; len > 0; bitpos += 32, len -= 32) {
+        word = getBits(stream, bitpos, len < 32? len : 32);
+        hash = hashNavWords(hash, &word, 1);
+    }
+    return hash;
+}
+
+/**isEphRepeated checks if the ephemeris with the given IOD and payload hash were the last ones decoded for a satellite.
+ * If they are not, the given IOD and hash are kept as the last decoded ones.
+ *
+ * @param lastEph the data of the last ephemeris decoded for the satellite
+ * @param iod the Issue Of Data of the ephemeris received
+ * @param hash the hash of the ephemeris payload received
+ * @return true if the ephemeris are the same last decoded, false otherwise
+ */
+bool GNSSdataFromGRD::isEphRepeated(LastEphData &lastEph, uint32_t iod, uint32_t hash) {
+    if (lastEph.hasData && lastEph.iod == iod && lastEph.hash == hash) return true;
+    lastEph.hasData = true;
+    lastEph.iod = iod;
+    lastEph.hash = hash;
+    return false;
+}
+
+/**saveEphemeris saves the given satellite ephemeris into the RinexData object and the orbits container or, when
+ * decoding in a constellation thread, queues them to be saved in message order (waiting while the queue is full).
+ * The system is registered in the RINEX header when it has no SYS record yet (its navigation messages were not
+ * scanned when collecting header data), to avoid its ephemeris being dropped when filtered or printed.
+ *
+ * @param rinex the RinexData object where data will be saved
+ * @param sys the system identification
+ * @param sat the satellite number
+ * @param bom the mantissas of orbital parameters data arranged as per RINEX broadcast orbit
+ * @param scaler the function to scale the mantissas for the given system
+ */
+void GNSSdataFromGRD::saveEphemeris(RinexData &rinex, char sys, int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], RinexData::NavScaler scaler) {
+    if (navDecoding != NULL) {
+        unique_lock<mutex> lock(navDecoding->lock);
+        navDecoding->changed.wait(lock, [this]() { return decodedEph.size() < NAV_QUEUESIZE; });
+        decodedEph.push_back(DecodedEph(msgCount, sys, sat, bom, scaler));
+        navDecoding->changed.notify_all();
+        return;
+    }
+    vector<string> noObsTypes;
+    rinex.setHdLnData(RinexData::SYS, sys, noObsTypes);
+    rinex.saveNavData(sys, sat, bom, scaler);
+    addOrbitData(sys, sat, bom, scaler);
+}
+
+/**addOrbitData saves the given satellite ephemeris into the orbits container, to be used for computing satellite
+ * positions when filtering observations by elevation. Data are saved only when the elevation mask is active.
+ *
+ * @param sys the system identification
+ * @param sat the satellite number
+ * @param bom the mantissas of orbital parameters data arranged as per RINEX broadcast orbit
+ * @param scaler the function to scale the mantissas for the given system
+ */
+void GNSSdataFromGRD::addOrbitData(char sys, int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], RinexData::NavScaler scaler) {
+    double bo[BO_LINSTOTAL][BO_MAXCOLS];
+    if (elevMask <= 0.0) return;
+    double tTag = scaler(bom, bo);
+    orbits.addEphemeris(sys, sat, tTag, bo);
+}
+
+/**computeSatPositions computes the positions of satellites at the current epoch time, and gets the receiver
+ * approximate position from the APPROX POSITION XYZ header record, to allow filtering observations by elevation.
+ * The LEAP SECONDS header record, when present, gives the GPS - UTC difference used for GLONASS positions.
+ *
+ * @param rinex the RinexData object containing the current epoch time and header data
+ */
+void GNSSdataFromGRD::computeSatPositions(RinexData &rinex) {
+    int week, eFlag;
+    double tow, bias;
+    double tTag = rinex.getEpochTime(week, tow, bias, eFlag);
+    hasRxPosition = rinex.getHdLnData(rinex.APPXYZ, rxX, rxY, rxZ) && (rxX != 0.0 || rxY != 0.0 || rxZ != 0.0);
+    if (!hasRxPosition || orbits.isEmpty()) return;
+    int leapSecs;
+    if (rinex.getHdLnData(rinex.LEAP, leapSecs) && leapSecs > 0) orbits.setLeapSeconds(leapSecs);
+    int nSats = orbits.computePositions(tTag);
+    plog->finer("Satellite positions computed:" + to_string(nSats));
+}
+
+/**isBelowMask checks if the given satellite is below the elevation mask at the current epoch.
+ * When the receiver position or the satellite position are not known, the satellite is considered above the mask.
+ *
+ * @param constellId the system identification
+ * @param satNum the satellite number
+ * @return true if the satellite elevation is below the elevation mask, false otherwise
+ */
+bool GNSSdataFromGRD::isBelowMask(char constellId, int satNum) {
+    double elevation;
+    if (elevMask <= 0.0 || !hasRxPosition) return false;
+    if (!orbits.getElevation(constellId, satNum, rxX, rxY, rxZ, elevation)) return false;
+    return elevation < elevMask;
+}
+
 /**isGoodGRDver check if the given GRD type and version can be processed by the current version of the class.
  *
  * @param identification is the file type identification
@@ -2095,10 +3318,14 @@ bool GNSSdataFromGRD::trimBuffer(char* cstrToTrim, const char* unwanted) {
     return true;
 }
 
-/**skipToEOM skips data from input raw data file until END OF MESSAGE is found
+/**skipToEOM skips data from input raw data file, or from the message being decoded from memory, until END OF MESSAGE is found
  */
 void GNSSdataFromGRD::skipToEOM() {
     int c;
+    if (navMsgPos != NULL) {
+        navMsgPos += strcspn(navMsgPos, "\n");
+        return;
+    }
     do {
         c = fgetc(grdFile);
     } while ((c != '\n') && (c != EOF));
@@ -2307,7 +3534,7 @@ bool GNSSdataFromGRD::isPsAmbiguous(char constellId, char* signalId, int synchSt
  * @return true if the ADR state will allow computation of phase measurements, false otherwise
  *
  */
-bool GNSSdataFromGRD::isCarrierPhInvalid(char constellId, char* signalId, int carrierPhaseState) {
+bool GNSSdataFromGRD::isCarrierPhInvalid(char /*constellId*/, char* /*signalId*/, int carrierPhaseState) {
     return carrierPhaseState == ST_UNKNOWN;
 }
 
@@ -2362,12 +3589,153 @@ bool GNSSdataFromGRD::isKnownMeasur(char constellId, int satNum, char frqId, cha
  * @return an uint32_t with the extracted bits aligned to the right
  */
 uint32_t GNSSdataFromGRD::getBits(uint32_t *stream, int bitpos, int len) {
-    uint32_t bitMask;
-    uint32_t bits = 0;
-    for (int i = bitpos; i < bitpos + len; i++) {
-        bits = bits << 1;
-        bitMask = 0x01U << (31 - (i % 32));
-        if ((stream[i/32] & bitMask) != 0) bits |= 0x01;
-    }
-    return bits;
+    if (len <= 0) return 0;
+    int word = bitpos >> 5;
+    int offset = bitpos & 0x1F;
+    //put the word containing the first bit, and the next one only if needed, in a 64 bits window
+    uint64_t bits = ((uint64_t) stream[word]) << 32;
+    if (offset + len > 32) bits |= stream[word + 1];
+    return (uint32_t) ((bits << offset) >> (64 - len));
+}
+
+//CRC-24Q generator polynomial (see Galileo OS ICD and RTCM 10403)
+#define CRC24Q_POLY 0x1864CFB
+
+/**crc24q computes the CRC-24Q of a stream of bytes (MSB first, initial value 0).
+ * It uses the slicing-by-8 method: eight bytes are processed in each step using eight lookup tables, where table k gives
+ * the CRC of a byte followed by k zero bytes. Tables are computed only once, at first use.
+ *
+ * @param buff the stream of bytes
+ * @param len the number of bytes in the stream
+ * @return the CRC-24Q value computed
+ */
+uint32_t GNSSdataFromGRD::crc24q(const uint8_t *buff, int len) {
+    static const struct CRC24QTables {
+        uint32_t t[8][256];
+        CRC24QTables() {
+            for (int x = 0; x < 256; ++x) {
+                uint32_t crc = (uint32_t) x << 16;
+                for (int b = 0; b < 8; ++b) crc = (crc & 0x800000)? (crc << 1) ^ CRC24Q_POLY : crc << 1;
+                t[0][x] = crc & 0xFFFFFF;
+            }
+            for (int k = 1; k < 8; ++k) {
+                for (int x = 0; x < 256; ++x) t[k][x] = ((t[k-1][x] << 8) ^ t[0][t[k-1][x] >> 16]) & 0xFFFFFF;
+            }
+        }
+    } tables;
+    const uint32_t (*t)[256] = tables.t;
+    uint32_t crc = 0;
+    for (; len >= 8; len -= 8, buff += 8) {
+        crc = t[7][buff[0] ^ (crc >> 16)] ^ t[6][buff[1] ^ ((crc >> 8) & 0xFF)] ^ t[5][buff[2] ^ (crc & 0xFF)] ^ t[4][buff[3]]
+              ^ t[3][buff[4]] ^ t[2][buff[5]] ^ t[1][buff[6]] ^ t[0][buff[7]];
+    }
+    for (; len > 0; --len, ++buff) crc = ((crc << 8) ^ t[0][(crc >> 16) ^ *buff]) & 0xFFFFFF;
+    return crc;
+}
+
+/**isNavCrcOk verifies the CRC-24Q of a navigation message where the CRC follows the bits it protects, as in Galileo F/NAV
+ * pages and GPS CNAV messages. The protected bits are packed into bytes preceded by the zero bits needed to complete a
+ * byte, which do not change the CRC value.
+ *
+ * @param stream the message bits, starting at position 0 of the stream
+ * @param nBits the number of bits protected by the CRC, followed in the stream by the 24 bits CRC
+ * @return true if the CRC computed matches the one in the message, false otherwise
+ */
+bool GNSSdataFromGRD::isNavCrcOk(uint32_t *stream, int nBits) {
+    uint8_t buff[40];           //the bits protected by the CRC, plus the leading zero bits
+    int nZeros = (8 - nBits % 8) % 8;
+    int n = 0;
+    if (nBits + nZeros > 8 * (int) sizeof(buff)) return false;
+    buff[n++] = (uint8_t) getBits(stream, 0, 8 - nZeros);
+    for (int pos = 8 - nZeros; pos < nBits; pos += 8) buff[n++] = (uint8_t) getBits(stream, pos, 8);
+    return crc24q(buff, n) == getBits(stream, nBits, 24);
+}
+
+/**extractNavFields extracts the fields described in the given table from the navigation message streams, and stores
+ * their values in the broadcast orbit arrangement.
+ * The table is a template argument: the code extracting each field is generated at compile time from its table entry,
+ * having as constants the stream, position and length of each chunk, and the kind of value.
+ * Elements of the broadcast orbit arrangement not described in the table are set to 0, unless they are kept to add
+ * fields from other table.
+ *
+ * @param F the table describing fields to be extracted
+ * @param N the number of fields in the table
+ * @param streams the streams (subframes, strings or words) containing the navigation message
+ * @param bom the broadcast orbit arrangement where field values will be stored
+ * @param clear true to set to 0 the elements not described in the table, false to keep their values
+ */
+template <const NavBitField *F, int N>
+void GNSSdataFromGRD::extractNavFields(uint32_t *streams[], int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], bool clear) {
+    for (int i = 0; clear && i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            bom[i][j] = 0;
+        }
+    }
+    extractNavField<F, 0, N>(streams, bom, std::integral_constant<bool, (0 < N)>());
+}
+
+/**extractNavField extracts the field I of the table F, and then the following ones up to the last one in the table.
+ * The chunks of bits described for the field are concatenated (first chunk the most significant) and, if the field
+ * is signed, converted to int from its representation (two's complement or sign and magnitude).
+ *
+ * @param F the table describing fields to be extracted
+ * @param I the index in the table of the field to extract
+ * @param N the number of fields in the table
+ * @param streams the streams (subframes, strings or words) containing the navigation message
+ * @param bom the broadcast orbit arrangement where field values will be stored
+ */
+template <const NavBitField *F, int I, int N>
+void GNSSdataFromGRD::extractNavField(uint32_t *streams[], int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], std::true_type) {
+    bom[F[I].line][F[I].col] = getNavFieldValue(
+            getNavFieldBits<F, I, 0>(streams, 0, std::integral_constant<bool, (0 < navFieldChunks(F[I]))>()),
+            navFieldLen(F[I]), std::integral_constant<int, F[I].kind>());
+    extractNavField<F, I + 1, N>(streams, bom, std::integral_constant<bool, (I + 1 < N)>());
+}
+
+/**extractNavField ends the extraction when all fields in the table have been extracted.
+ */
+template <const NavBitField *F, int I, int N>
+void GNSSdataFromGRD::extractNavField(uint32_t *[], int (&)[BO_LINSTOTAL][BO_MAXCOLS], std::false_type) {
+}
+
+/**getNavFieldBits appends to the given value the bits of chunk C of the field I in table F, and then the ones of the
+ * following chunks of the field.
+ *
+ * @param F the table describing fields to be extracted
+ * @param I the index in the table of the field
+ * @param C the index of the chunk in the field
+ * @param streams the streams (subframes, strings or words) containing the navigation message
+ * @param value the bits of the previous chunks of the field
+ * @return the bits of the previous chunks followed by the ones of chunk C and the following ones
+ */
+template <const NavBitField *F, int I, int C>
+uint64_t GNSSdataFromGRD::getNavFieldBits(uint32_t *streams[], uint64_t value, std::true_type) {
+    value = (value << F[I].chunk[C].len) | getBits(streams[F[I].chunk[C].stream], F[I].chunk[C].pos, F[I].chunk[C].len);
+    return getNavFieldBits<F, I, C + 1>(streams, value, std::integral_constant<bool, (C + 1 < navFieldChunks(F[I]))>());
+}
+
+/**getNavFieldBits ends the concatenation when all chunks of the field have been appended.
+ */
+template <const NavBitField *F, int I, int C>
+uint64_t GNSSdataFromGRD::getNavFieldBits(uint32_t *[], uint64_t value, std::false_type) {
+    return value;
+}
+
+/**getNavFieldValue gives the value of a field from its bits, depending on the kind of value it contains: unsigned
+ * integer, signed integer in two's complement, or signed integer in sign and magnitude.
+ *
+ * @param value the bits of the field
+ * @param len the number of bits in the field
+ * @return the value of the field
+ */
+int GNSSdataFromGRD::getNavFieldValue(uint64_t value, int, std::integral_constant<int, NAVF_UNSIGNED>) {
+    return (uint32_t) value;
+}
+
+int GNSSdataFromGRD::getNavFieldValue(uint64_t value, int len, std::integral_constant<int, NAVF_TWOSCOMP>) {
+    return getTwosComplement((uint32_t) value, len);
+}
+
+int GNSSdataFromGRD::getNavFieldValue(uint64_t value, int len, std::integral_constant<int, NAVF_SIGNMAG>) {
+    return getSigned((uint32_t) value, len);
 }
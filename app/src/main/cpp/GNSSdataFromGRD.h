@@ -25,9 +25,16 @@
 #define GNSSDATAFROMOSP_H
 
 #include <math.h>
+#include <limits.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <type_traits>
 //from CommonClasses
 #include "Logger.h"
 #include "RinexData.h"
+#include "SatOrbits.h"
 #include "Utilities.h"
 
 //@cond DUMMY
@@ -38,6 +45,16 @@ const int MIN_ORD_FILE_VERSION = 2;
 const int MAX_ORD_FILE_VERSION = 2;
 const int MIN_NRD_FILE_VERSION = 2;
 const int MAX_NRD_FILE_VERSION = 2;
+//Corrections for the navigation file header got from navigation messages, and the ones provided by each constellation
+#define CORR_IONA 0x01
+#define CORR_IONB 0x02
+#define CORR_TIMEU 0x04
+#define CORR_TIMEG 0x08
+#define CORR_LEAPS 0x10
+#define CORR_ALL_GPS (CORR_IONA | CORR_IONB | CORR_TIMEU | CORR_LEAPS)
+#define CORR_ALL_GLO (CORR_TIMEU | CORR_TIMEG)
+#define CORR_ALL_GAL (CORR_IONA | CORR_TIMEU | CORR_TIMEG | CORR_LEAPS)
+#define CORR_ALL_BDS (CORR_IONA | CORR_IONB | CORR_TIMEU | CORR_TIMEG | CORR_LEAPS)
 
 //The type of messages that GNSS Raw Data files or setup arguments can contain
 #define MT_EPOCH 1     //Epoch data
@@ -71,6 +88,8 @@ const int MAX_NRD_FILE_VERSION = 2;
 #define MT_COMMENT 80
 #define MT_MARKER_NUM 81
 #define MT_CLKOFFS 82
+#define MT_ELEVMASK 83    //Elevation mask in degrees to filter observations
+#define MT_NAVTHREADS 84  //If navigation messages shall be decoded in one thread for each constellation or not
 #define MT_FIT 95       //If epoch interval shall fit the interval given or not
 #define MT_LOGLEVEL 96
 #define MT_CONSTELLATIONS 97
@@ -113,6 +132,8 @@ const MsgType msgTblTypes[] = {
 	{MT_COMMENT, "MT_COMMENT"},
 	{MT_MARKER_NUM, "MT_MARKER_NUM"},
 	{MT_CLKOFFS, "MT_CLKOFFS"},
+	{MT_ELEVMASK, "MT_ELEVMASK"},
+	{MT_NAVTHREADS, "MT_NAVTHREADS"},
 	{MT_FIT, "MT_FIT"},
 	{MT_LOGLEVEL, "MT_LOGLEVEL"},
 	{MT_CONSTELLATIONS, "MT_CONSTELLATIONS"},
@@ -151,7 +172,7 @@ const int MASK8b = 0xFF;    //a bit mask for 8 bits
 const double C1CADJ = 299792458.0;	//to adjust C1C (pseudorrange L1 in meters) = C1CADJ (the speed of light) * clkOff
 const double L1CADJ = 1575420000.0;	//to adjust L1C (carrier phase in cycles) =  L1CADJ (L1 carrier frequency) * clkOff
 */
-const double ThisPI = 3.1415926535898;
+constexpr double ThisPI = 3.1415926535898;
 const long long NUMBER_NANOSECONDS_DAY = 24LL * 60LL * 60LL * 1000000000LL;
 const long long NUMBER_NANOSECONDS_WEEK = 7LL * NUMBER_NANOSECONDS_DAY;
 const long long NUMBER_NANOSECONDS_3H =     3LL * 60LL * 60LL * 1000000000LL;
@@ -163,6 +184,7 @@ const long long NUMBER_NANOSECONDS_100MS =  100LL * 1000000LL;
 const double ECEF_A = 6378137.0;			//WGS-84 semi-major axis
 const double ECEF_E2 = 6.69437999014e-3;	//WGS-84 first eccentricity squared
 const double dgrToRads = ThisPI / 180.0;    //a factor to convert degrees to radiands
+const size_t NAV_QUEUESIZE = 256;   //maximum number of messages, or decoded ephemeris, queued for each navigation decoding thread
 //Log messages
 const string LOG_MSG_PARERR("Params error");
 const string LOG_MSG_ERROPEN("Error opening GRD file ");
@@ -173,9 +195,17 @@ const string LOG_MSG_INVM(" measurement ignored, invalid tracking or carrier pha
 const string LOG_MSG_UNK(" ignored, wrong satellite or signal identification");
 const string LOG_MSG_INMP("Invalid nav message parameters");
 const string LOG_MSG_CORR(" Corrections completed.");
+const string LOG_MSG_ALLCORR("All header corrections got. Scan ended at message ");
 const string LOG_MSG_FRM(" Frame completed.");
 const string LOG_MSG_SFR(" Subframe saved.");
+const string LOG_MSG_PARITY(" Parity error");
+const string LOG_MSG_CRC(" CRC error");
+const string LOG_MSG_BCHCORR(" BCH corrected bits:");
+const string LOG_MSG_BCHERR(" Decoded subframe ID differs");
+const string LOG_MSG_HAMMING(" Hamming code error");
 const string LOG_MSG_IOD(" IODs match.");
+const string LOG_MSG_REPEPH(" Ephemeris already decoded. Ignored");
+const string LOG_MSG_BELOWMASK(" measurement ignored, satellite below elevation mask");
 const string LOG_MSG_OSIZ(" or size");
 const string LOG_MSG_NAVIG(". Ignored");
 const string LOG_MSG_UNKSELSYS("Unknown selected sys ");
@@ -195,6 +225,11 @@ const string MSG_NOT_IMPL("NOT IMPLEMENTED");
 #define GPS_MINPRN 1
 #define GPS_MAXPRN 32
 #define GPS_MAXSATELLITES 32
+//For GPS L2 CNAV and L5 CNAV, each message contains 300 bits that should be fit into 38 bytes, with MSB first (skip B301-B304)
+#define GPSCNAV_MSGSIZE 38
+#define GPSCNAV_WORDS 10    //size in 32 bit unsig. int to store the 300 bits of a message
+#define GPSCNAV_MSGBITS 276 //bits before the CRC
+#define GPSCNAV_MAXMSGS 3   //message types 10, 11 and 30 contain ephemeris data
 ///GLONASS definitions related to navigation messages
 //Note: GLO_STRWORDS * 4 shall be > GLO_L1_CA_MSGSIZE
 #define GLO_L1_CA_MSGSIZE 11
@@ -222,6 +257,11 @@ const double GLO_SLOT_FRQ2 = 0.4375; //L2 frequency factor frq = 1246 + fcn * GL
 //the 228 bits are: 1 e/o + 1 pt + 112 data 1/2 + 1 e/o + 1 pt + 16 data 2/2 + 64 reserved 1 + 24 CRC + 8 reserved 2
 #define GALINAV_DATAW 4     //size in 32 bit unsig. int to store the 128 bits of a message word
 #define GALINAV_MAXWORDS 10  //message type 1 to 10 of any I/NAV subframe contain ephemeris data
+//For Galileo F/NAV, each page contains 238 bits (sync & tail excluded) that should be fit into 30 bytes, with MSB first (skip B239-B240)
+#define GALFNAV_MSGSIZE 30
+#define GALFNAV_DATAW 8     //size in 32 bit unsig. int to store the 238 bits of a page
+#define GALFNAV_PAGEBITS 214    //bits before the CRC
+#define GALFNAV_MAXPAGES 4  //page types 1 to 4 contain ephemeris data
 //GAL prn are in the range 1-32
 #define GAL_MINPRN 1
 #define GAL_MAXPRN 36
@@ -232,6 +272,8 @@ const double GLO_SLOT_FRQ2 = 0.4375; //L2 frequency factor frq = 1246 + fcn * GL
 #define BDSD1_MSGSIZE 40
 #define BDSD1_SUBFRWORDS 10
 #define BDSD1_MAXSUBFRS 5
+//BDS D2 messages have the same size and word arrangement of D1 ones. Ephemeris are in pages 1 to 10 of subframe 1
+#define BDSD2_MAXPAGES 10
 #define BDS_MINPRN 1
 #define BDS_MAXPRN 37
 #define BDS_MAXSATELLITES 37
@@ -247,6 +289,33 @@ const double GLO_SLOT_FRQ2 = 0.4375; //L2 frequency factor frq = 1246 + fcn * GL
 //IRNSS prn are in the range 1 - 14
 //#define IRNSS_MINPRN 193
 //#define IRNSS_MAXPRN 200
+///Descriptors of navigation message fields
+//Kind of value contained in a field
+#define NAVF_UNSIGNED 0     //unsigned integer
+#define NAVF_TWOSCOMP 1     //signed integer in two's complement
+#define NAVF_SIGNMAG 2      //signed integer in sign and magnitude (GLONASS)
+#define NAVF_MAXCHUNKS 4    //maximum number of chunks a field can be split into
+//A chunk of bits of a field: the stream (subframe, string or word) containing it, the position in the stream and the length
+struct NavBitChunk {
+    int stream;
+    int pos;
+    int len;
+};
+//A field as stated in the ICD: where it is stored in the broadcast orbit arrangement, the kind of value, and the
+//chunks (most significant first, unused ones with 0 length) that, concatenated, give its value
+struct NavBitField {
+    int line;
+    int col;
+    int kind;
+    NavBitChunk chunk[NAVF_MAXCHUNKS];
+};
+//The number of chunks, and the number of bits, of a field (computed at compile time from its table entry)
+constexpr int navFieldChunks(const NavBitField &field, int c = 0) {
+    return c < NAVF_MAXCHUNKS && field.chunk[c].len > 0? navFieldChunks(field, c + 1) : c;
+}
+constexpr int navFieldLen(const NavBitField &field, int c = 0) {
+    return c < NAVF_MAXCHUNKS && field.chunk[c].len > 0? field.chunk[c].len + navFieldLen(field, c + 1) : 0;
+}
 //@endcond
 
 /**GNSSdataFromOSP class defines data and methods used to acquire RINEX header and epoch data from a
@@ -283,6 +352,7 @@ public:
     void processFilterData(RinexData &);
     string getMsgDescription(int );
     int getMsgType(string );
+    friend class NavFieldsTest;     //the host test of navigation message fields extraction
 
 private:
     FILE* grdFile;  //GNSS raw data file
@@ -305,6 +375,56 @@ private:
     vector<string> selSatellites;
     vector<string> selObservables;
 	int clockDiscontinuityCount;
+    //Data to filter observations by satellite elevation
+    double elevMask;    //the elevation mask in radians. 0 if filtering is not active
+    SatOrbits orbits;   //ephemerides collected from navigation files to compute satellite positions
+    bool hasRxPosition; //true if the receiver position is known for the current epoch
+    double rxX, rxY, rxZ;   //the receiver approximate position (ECEF)
+    //Data to decode navigation messages in one thread for each constellation
+    bool navThreads;    //true if navigation messages shall be decoded in one thread for each constellation
+    //State shared by the thread reading messages, the constellation decoding threads, and the one saving their ephemeris
+    struct NavDecoding {
+        mutex lock;         //to guard the shared state, and the queues of each decoder
+        condition_variable changed;     //notified each time the shared state or a queue changes
+        int nRead;          //the number of messages read from the input file and queued
+        bool endRead;       //true when all messages have been read
+        NavDecoding() {
+            nRead = 0;
+            endRead = false;
+        }
+    };
+    NavDecoding *navDecoding;   //the state shared with other threads when decoding in a constellation thread, or NULL
+    //Messages of a constellation queued for its decoding thread, with their numbers in the input file
+    struct QueuedNavMsg {
+        int msgNum;
+        string msg;
+        QueuedNavMsg(int n, const string &m) {
+            msgNum = n;
+            msg = m;
+        }
+    };
+    deque<QueuedNavMsg> navMsgQueue;
+    int navMsgDecoding;     //the number of the message being decoded by a constellation thread, or 0 if none
+    const char *navMsgPos;  //the position in the message being decoded from memory, or NULL if messages are read from grdFile
+    //Ephemeris decoded by a constellation thread, queued with the message number they were completed in, to be saved
+    //into the RinexData object in the same order as if decoded serially
+    struct DecodedEph {
+        int msgNum;
+        char sys;
+        int sat;
+        int bom[BO_LINSTOTAL][BO_MAXCOLS];
+        RinexData::NavScaler scaler;
+        DecodedEph(int n, char sy, int sa, int (&bm)[BO_LINSTOTAL][BO_MAXCOLS], RinexData::NavScaler sc) {
+            msgNum = n;
+            sys = sy;
+            sat = sa;
+            memcpy(bom, bm, sizeof(bom));
+            scaler = sc;
+        }
+    };
+    deque<DecodedEph> decodedEph;
+    //For each constellation having navigation messages, the header corrections already got (CORR_xxx flags)
+    map<char, int> navCorrSet;
 	//Data structures to capture GPS navigation messages
 	struct GPSSubframeData {
 		bool hasData;
@@ -315,6 +435,17 @@ private:
 		GPSSubframeData gpsSatSubframes[GPS_MAXSUBFRS];
 	};
 	GPSFrameData gpsSatFrame[GPS_MAXSATELLITES];
+    //Data structures to capture GPS CNAV navigation messages. L2 and L5 messages have the same data and share storage
+    struct GPSCNAVmsgData {
+        bool hasData;
+        uint32_t words[GPSCNAV_WORDS];
+    };
+    struct GPSCNAVFrameData {
+        bool hasData;
+        //index for messages: 0 is message type 10; 1 is type 11; 2 is type 30
+        GPSCNAVmsgData gpsSatMsgs[GPSCNAV_MAXMSGS];
+    };
+    GPSCNAVFrameData gpsCnavSatFrame[GPS_MAXSATELLITES];
 	//number of GPS weeks roll over
 	int nGPSrollOver;
 	//Data structures to capture GLONASS navigation messages
@@ -361,6 +492,16 @@ private:
         GALINAVpageData pageWord[GALINAV_MAXWORDS];
     };
     GALINAVFrameData galInavSatFrame[GAL_MAXSATELLITES];
+    //Data structures to capture Galileo F/NAV navigation messages
+    struct GALFNAVpageData {
+        bool hasData;
+        uint32_t data[GALFNAV_DATAW];
+    };
+    struct GALFNAVFrameData {
+        bool hasData;
+        GALFNAVpageData pages[GALFNAV_MAXPAGES];
+    };
+    GALFNAVFrameData galFnavSatFrame[GAL_MAXSATELLITES];
     //number of GAL weeks roll over
     int nGALrollOver;
     //Data structures to capture BDS navigation messages
@@ -374,46 +515,97 @@ private:
         BDSD1SubframeData bdsSatSubframes[BDSD1_MAXSUBFRS];
     };
     BDSD1FrameData bdsSatFrame[BDS_MAXSATELLITES];
+    //BDS D2 (GEO satellites) subframe 1 pages 1 to 10, stored as D1 subframes
+    struct BDSD2FrameData {
+        bool hasData;
+        BDSD1SubframeData bdsSatPages[BDSD2_MAXPAGES];
+    };
+    BDSD2FrameData bdsD2SatFrame[BDS_MAXSATELLITES];
     //number of BDS weeks roll over
     int nBDSrollOver;
+    //Data structure to keep, for each satellite, the IOD and a hash of the ephemeris payload last decoded.
+    //When a new frame is completed with the same IOD and payload, it is a rebroadcast of data already stored,
+    //and extraction and scaling are skipped.
+    struct LastEphData {
+        bool hasData;
+        uint32_t iod;
+        uint32_t hash;
+    };
+    LastEphData gpsLastEph[GPS_MAXSATELLITES];
+    LastEphData galLastEph[GAL_MAXSATELLITES];
+    LastEphData bdsLastEph[BDS_MAXSATELLITES];
+    LastEphData gpsCnavLastEph[GPS_MAXSATELLITES];
+    LastEphData galFnavLastEph[GAL_MAXSATELLITES];
+    LastEphData bdsD2LastEph[BDS_MAXSATELLITES];
     //Constant data used to convert to RINEX broadcast orbit ephemeris values the broadcast orbit navigation data from satellite messages which contains only mantissas
+    //They are constant tables computed at compile time and shared by all instances, also to allow RinexData to scale mantissas when printing (see RinexData::NavScaler)
     //Note: BO_xxxx constant values defined in RinexData.h
-    double GPS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to GPS broadcast orbit data to obtain ephemeris (see GPS ICD)
-    double GLO_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to GLONASS broadcast orbit data to obtain ephemeris (see GLONASS ICD)
-    double GAL_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to Galileo broadcast orbit data to obtain ephemeris (see Galileo OS ICD)
-    double BDS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to BDS broadcast orbit data to obtain ephemeris (see BDS ICD)
-    double GPS_URA[16];			    //the User Range Accuracy values corresponding to URA index in the GPS SV broadcast data (see GPS ICD)
-    double BDS_URA[16];			    //the User Range Accuracy values corresponding to URA index in the BDS SV broadcast data (see BDS ICD)
+    static const double GPS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to GPS broadcast orbit data to obtain ephemeris (see GPS ICD)
+    static const double GLO_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to GLONASS broadcast orbit data to obtain ephemeris (see GLONASS ICD)
+    static const double GAL_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to Galileo broadcast orbit data to obtain ephemeris (see Galileo OS ICD)
+    static const double BDS_SCALEFACTOR[BO_LINSTOTAL][BO_MAXCOLS];	//the scale factors to apply to BDS broadcast orbit data to obtain ephemeris (see BDS ICD)
+    static const double GPS_URA[16];			    //the User Range Accuracy values corresponding to URA index in the GPS SV broadcast data (see GPS ICD)
+    static const double BDS_URA[16];			    //the User Range Accuracy values corresponding to URA index in the BDS SV broadcast data (see BDS ICD)
     //Logger
     Logger* plog;		//the place to send logging messages
     bool dynamicLog;	//true when created dynamically here, false when provided externally
     void setInitValues();
 
-    bool collectGPSL1CAEphemeris(RinexData &rinex, int msgType);
-    bool collectGPSL1CACorrections(RinexData &rinex, int msgType);
+    //Constellation traits for the navigation messages sharing the same frame handling (GPS L1 C/A and CNAV, Galileo I/NAV
+    //and F/NAV, BDS D1 and D2).
+    //Each one states the frame storage, the completeness, IOD and rebroadcast checks, and the functions to read, extract
+    //and scale data, to be used by the collectEphemeris and collectCorrections templates (see their definitions).
+    struct GPSL1CATraits;
+    struct GALINTraits;
+    struct BDSD1Traits;
+    struct GPSCNAVTraits;
+    struct GALFNTraits;
+    struct BDSD2Traits;
+    template <class Traits> bool collectEphemeris(RinexData &rinex, int msgType);
+    template <class Traits> bool collectCorrections(RinexData &rinex, int msgType);
+
     bool readGPSL1CANavMsg(char &constId, int &satNum, int &strnum, int &frame, string &logMsg);
+    static bool isGPSL1CAParityOk(const uint32_t (&words)[GPS_SUBFRWORDS]);
     void extractGPSL1CAEphemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
-    double scaleGPSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static double scaleGPSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void extractGPSL1CACorrections(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static void scaleGPSCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+
+    bool readGPSCNAVNavMsg(char &constId, int &satNum, int &msgType, string &logMsg);
+    void extractGPSCNAVEphemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static double scaleGPSCNAVEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
 
     bool collectGLOL1CAEphemeris(RinexData &rinex, int msgType);
     bool collectGLOL1CACorrections(RinexData &rinex, int msgType);
     bool readGLOL1CANavMsg(char &constId, int &satNum, int &satIdx, int &strnum, int &frame, string &logMsg);
+    static bool isGLOL1CAHammingOk(uint32_t (&wd)[GLO_STRWORDS], bool &corrected);
     void extractGLOL1CAEphemeris(int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slot);
-    double scaleGLOEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static double scaleGLOEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void extractGLOL1CACorrections(int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slot);
+    static void scaleGLOCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
     int gloSatIdx(int);
     int gloOSN(int satNum, char band = '1', double carrFrq = 0.0, bool updTbl = false);
 
-    bool collectGALINEphemeris(RinexData &rinex, int msgType);
-    bool collectGALINCorrections(RinexData &rinex, int msgType);
 	bool readGALINNavMsg(char &constId, int &satNum, int &strnum, int &frame, string &logMsg);
+    static bool isGALINCrcOk(unsigned int (&navMsg)[GALINAV_MSGSIZE]);
 	void extractGALINEphemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
-    double scaleGALEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static double scaleGALEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void extractGALINCorrections(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static void scaleGALCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+
+    bool readGALFNNavMsg(char &constId, int &satNum, int &pageType, string &logMsg);
+    void extractGALFNEphemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
 
-    bool collectBDSD1Ephemeris(RinexData &rinex, int msgType);
-    bool collectBDSD1Corrections(RinexData &rinex, int msgType);
     bool readBDSD1NavMsg(char &constId, int &satNum, int &strnum, int &frame, string &logMsg);
+    static int decodeBDSD1Words(uint32_t (&words)[BDSD1_SUBFRWORDS]);
+    static uint32_t bch1511Correct(uint32_t codeword, int &nCorrected);
     void extractBDSD1Ephemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
-    double scaleBDSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static double scaleBDSEphemeris(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void extractBDSD1Corrections(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static void scaleBDSCorrections(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+
+    bool readBDSD2NavMsg(char &constId, int &satNum, int &pageNum, string &logMsg);
+    void extractBDSD2Ephemeris(int sv, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
 
     bool isGoodGRDver(string extension, int version);
     bool addSignal(char system, string signal);
@@ -426,6 +618,36 @@ private:
     bool isPsAmbiguous(char constellId, char* signalId, int synchState, double tRx, double &tRxGNSS, long long &tTx);
     bool isCarrierPhInvalid (char constellId, char* signalId, int carrierPhaseState);
     bool isKnownMeasur(char constellId, int satNum, char frqId, char attribute);
-    uint32_t getBits(uint32_t *stream, int bitpos, int len);
+    static uint32_t getBits(uint32_t *stream, int bitpos, int len);
+    static uint32_t crc24q(const uint8_t *buff, int len);
+    static bool isNavCrcOk(uint32_t *stream, int nBits);
+    template <const NavBitField *F, int N> static void extractNavFields(uint32_t *streams[], int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], bool clear = true);
+    template <const NavBitField *F, int I, int N> static void extractNavField(uint32_t *streams[], int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], std::true_type);
+    template <const NavBitField *F, int I, int N> static void extractNavField(uint32_t *streams[], int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], std::false_type);
+    template <const NavBitField *F, int I, int C> static uint64_t getNavFieldBits(uint32_t *streams[], uint64_t value, std::true_type);
+    template <const NavBitField *F, int I, int C> static uint64_t getNavFieldBits(uint32_t *streams[], uint64_t value, std::false_type);
+    static int getNavFieldValue(uint64_t value, int len, std::integral_constant<int, NAVF_UNSIGNED>);
+    static int getNavFieldValue(uint64_t value, int len, std::integral_constant<int, NAVF_TWOSCOMP>);
+    static int getNavFieldValue(uint64_t value, int len, std::integral_constant<int, NAVF_SIGNMAG>);
+    static uint32_t hashNavWords(uint32_t hash, uint32_t *words, int nWords);
+    static uint32_t hashNavBits(uint32_t hash, uint32_t *stream, int bitpos, int len);
+    bool isEphRepeated(LastEphData &lastEph, uint32_t iod, uint32_t hash);
+    void saveEphemeris(RinexData &rinex, char sys, int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], RinexData::NavScaler scaler);
+    bool readNavMsgHeader(int &status, char &constId, int &satNum, int &num1, int &num2, int &msgSize);
+    bool readNavMsgByte(unsigned int &byte);
+    bool decodeNavMsg(RinexData &rinex, int msgType);
+    bool decodeNavData(RinexData &rinex);
+    bool decodeNavDataThreaded(RinexData &rinex);
+    void copyNavState(const GNSSdataFromGRD &from, char sys);
+    void queueNavMsgs(GNSSdataFromGRD *decoder[]);
+    bool decodeQueuedNavMsgs(RinexData &rinex);
+    int navMsgsDecoded();
+    void saveDecodedEph(RinexData &rinex, GNSSdataFromGRD *decoder[]);
+    static char navMsgSystem(int msgType);
+    bool hasAllCorrections();
+    bool hasAllGLOSlots();
+    void addOrbitData(char sys, int sat, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], RinexData::NavScaler scaler);
+    void computeSatPositions(RinexData &rinex);
+    bool isBelowMask(char constellId, int satNum);
     };
 #endif
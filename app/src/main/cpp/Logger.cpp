@@ -191,6 +191,7 @@ void Logger::logMsg(logLevel msgLevel, string msg) {
 	struct tm * timeinfo;
 	char txtBuf[80];
 
+	lock_guard<mutex> lock(logMutex);
 	time (&rawtime);
 	timeinfo = localtime (&rawtime);
 	if (msgLevel == SEVERE) strftime(txtBuf, sizeof txtBuf, " %Y-%m-%d %H:%M:%S ", timeinfo);
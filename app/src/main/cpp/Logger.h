@@ -24,6 +24,7 @@
 #include <time.h>
 #include <stdio.h>
 #include <string.h>
+#include <mutex>
 
 using namespace std;
 
@@ -60,6 +61,7 @@ private:
 	string program;		//program name to tag logs
 	logLevel levelSet;	//maximum level to log
 	FILE * fileLog;
+	mutex logMutex;		//to avoid mixing messages logged from several threads
 
 	void logMsg(logLevel msgLevel, string msg);
 	logLevel identifyLevel(string level);
@@ -7,8 +7,16 @@
 #include <stdio.h>
 #include <math.h>
 #include <cstdio>
+#include <climits>
+#include <thread>
+#include <functional>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 //from CommonClasses
 #include "Utilities.h"
+#include "RinexDecoder.h"
 
 /**RinexData constructor providing only the minimum data required: the RINEX file version to be generated.
  *
@@ -85,6 +93,10 @@ RinexData::RinexData(RINEXversion ver, string prg, string rby, Logger* plogger)
 /**Destructor.
  */
 RinexData::~RinexData(void) {
+#ifndef _WIN32
+	if (mapData != NULL) munmap((void*) mapData, mapSize);
+#endif
+	delete inDecoder;
 	if (dynamicLog) delete plog;
 }
 
@@ -140,7 +152,7 @@ bool RinexData::setHdLnData(RINEXlabel rl, RINEXlabel a, const string &b) {
 	case COMM:
 		for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
 			if((it->labelID == a) || (it->labelID == EOH)) {
-				lastRecordSet = labelDef.insert(it, LABELdata(b));
+				lastRecordSet = insertComment(it, b);
 				return true;
 			}
 		return false;
@@ -789,7 +801,7 @@ bool  RinexData::getHdLnData(RINEXlabel rl, RINEXlabel &a, double (&b)[4], int &
             //check if data requested exists; index is here the position in the list of a given type position
             for (vector<CORRECTION>::iterator it = corrections.begin(); it != corrections.end(); it++) {
                 if ((it->corrType == a) || (a == NOLABEL)) order++;
-                if (order == index) {
+                if (order == (int) index) {
                     a = it->corrType;
                     for (int i = 0; i < 4; ++i) b[i] = it->corrValues[i];
                     c = (int) it->corrValues[4];
@@ -1342,6 +1354,63 @@ bool RinexData::getHdLnData(RINEXlabel rl, string &a, double &b, unsigned int in
 			throw errorLabelMis + idTOlbl(rl) + msgGetHdLn;
 	}
 }
+/**getHdSystems gives the range of GNSS systems defined in "SYS / # / OBS TYPES" or "# / TYPES OF OBSERV" records.
+ * For each system, all its obsTypes are contained, including the ones not selected: only those having the sel flag set
+ * are contained in the record (as given by the indexed getHdLnData).
+ * It allows iterating over all systems without the searching and copying made by the indexed getHdLnData.
+ *
+ * @return the range of systems, empty if the record has no data
+ */
+RinexData::DataRange<RinexData::GNSSsystem> RinexData::getHdSystems() {
+	if (!getLabelFlag(SYS)) return DataRange<GNSSsystem>(systems.end(), systems.end());
+	return DataRange<GNSSsystem>(systems.begin(), systems.end());
+}
+
+/**getHdGloSlots gives the range of slot and frequency numbers defined in "GLONASS SLOT / FRQ #" records.
+ *
+ * @return the range of slot and frequency numbers, empty if the record has no data
+ */
+RinexData::DataRange<RinexData::GLSLTfrq> RinexData::getHdGloSlots() {
+	if (!getLabelFlag(GLSLT)) return DataRange<GLSLTfrq>(gloSltFrq.end(), gloSltFrq.end());
+	return DataRange<GLSLTfrq>(gloSltFrq.begin(), gloSltFrq.end());
+}
+
+/**getHdPrnObs gives the range of satellite data defined in "PRN / # OF OBS" records.
+ *
+ * @return the range of satellite data, empty if the record has no data
+ */
+RinexData::DataRange<RinexData::PRNobsnum> RinexData::getHdPrnObs() {
+	if (!getLabelFlag(PRNOBS)) return DataRange<PRNobsnum>(prnObsNum.end(), prnObsNum.end());
+	return DataRange<PRNobsnum>(prnObsNum.begin(), prnObsNum.end());
+}
+
+/**getHdCorrections gives the range of ionospheric and time corrections defined in "IONOSPHERIC CORR" and
+ * "TIME SYSTEM CORR" records (or their V2 equivalent ones). The corrType of each one states its type.
+ *
+ * @return the range of corrections
+ */
+RinexData::DataRange<RinexData::CORRECTION> RinexData::getHdCorrections() {
+	return DataRange<CORRECTION>(corrections.begin(), corrections.end());
+}
+
+/**getHdComment gets the COMMENT record following the given position in the header.
+ * Iteration over all comments starts with pos = 0, and pos is updated in each call to continue with the next one.
+ *
+ * @param pos the position in the header where the search for the comment starts. It is updated for the next call
+ * @param a is the label identifier in the position following the comment
+ * @return a pointer to the comment contents, or NULL if there are not more comments
+ */
+const string *RinexData::getHdComment(unsigned int &pos, RINEXlabel &a) {
+	if (labelPos[COMM] == LABEL_NOPOS) return NULL;
+	if (pos < labelPos[COMM]) pos = labelPos[COMM];
+	for (; pos < labelDef.size() && labelDef[pos].labelID != EOH; pos++) {
+		if (labelDef[pos].hasData && (labelDef[pos].labelID == COMM)) {
+			a = labelDef[pos + 1].labelID;
+			return &labelDef[pos++].comment;
+		}
+	}
+	return NULL;
+}
 #undef GET_1PARAM
 #undef GET_2PARAM
 #undef GET_3PARAM
@@ -1366,9 +1435,8 @@ RinexData::RINEXlabel RinexData::lblTOid(string label) {
  * @return the label name corresponding to the identifier passed, or an empty string if does not exist
 */
 string RinexData::idTOlbl(RINEXlabel id) {
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if (it->labelID == id) return string(it->labelVal);
-	return string();
+	if (labelPos[id] == LABEL_NOPOS) return string();
+	return string(labelDef[labelPos[id]].labelVal);
 }
 
 /**get1stLabelId gives the first label identifier of the first record in the RINEX header having data (should be VERSION).
@@ -1518,6 +1586,56 @@ bool RinexData::getObsData(char &sys, int &sat, string &obsTp, double &value, in
 	return true;
 }
 
+/**getObsEpoch gives the range of observable data stored for the current epoch, to be iterated without copying them.
+ * The system and the observable type of each one can be obtained using getObsSystem and getObsCode.
+ *
+ * @return the range of observable data in the current epoch
+ */
+RinexData::DataRange<RinexData::SatObsData> RinexData::getObsEpoch() {
+	return DataRange<SatObsData>(epochObs.begin(), epochObs.end());
+}
+
+/**getObsSystem gives the system identification of the given observable data.
+ *
+ * @param obs the observable data in the current epoch
+ * @return the system identification (G, S, ...)
+ */
+char RinexData::getObsSystem(const SatObsData &obs) {
+	return systems[obs.sysIndex].system;
+}
+
+/**getObsCode gives the observable type of the given observable data, packed as an ObsCode.
+ *
+ * @param obs the observable data in the current epoch
+ * @return the packed code of the observable type (C1C, L1C, D1C, ...)
+ */
+RinexData::ObsCode RinexData::getObsCode(const SatObsData &obs) {
+	return systems[obs.sysIndex].obsTypes[obs.obsTypeIndex].code;
+}
+
+/**packObsCode packs the given observable type in an ObsCode, one character per byte from the least significant one.
+ * Only the first four characters are taken into account.
+ *
+ * @param obsType the observable type (C1C, L1C, D1C, ...)
+ * @return the packed code
+ */
+RinexData::ObsCode RinexData::packObsCode(const string &obsType) {
+	ObsCode code = 0;
+	for (unsigned int i = 0; i < obsType.size() && i < sizeof(ObsCode); i++) code |= (ObsCode) (unsigned char) obsType[i] << (8 * i);
+	return code;
+}
+
+/**unpackObsCode gives the observable type packed in the given ObsCode.
+ *
+ * @param code the packed code
+ * @return the observable type (C1C, L1C, D1C, ...)
+ */
+string RinexData::unpackObsCode(ObsCode code) {
+	string obsType;
+	for (; code != 0; code >>= 8) obsType += (char) (code & 0xFF);
+	return obsType;
+}
+
 /**setFilter set the selected values for systems, satellites and observables to filter header, observation and navigation data.
  * Filtering data are reset (to 'no filter') and values passed (if any) will be used to filter epoch data in the following way:
  * - an empty list of selected satellites means that data from all satellites will pass the filter.
@@ -1538,7 +1656,7 @@ bool RinexData::getObsData(char &sys, int &sat, string &obsTp, double &value, in
  */
 bool RinexData::setFilter(vector<string> selSat, vector<string> selObs) {
 #define SET_OBS_SELECTED \
-    for (obsIdx = 0; obsIdx < systems[sysIdx].obsTypes.size(); obsIdx++) { \
+    for (obsIdx = 0; obsIdx < (int) systems[sysIdx].obsTypes.size(); obsIdx++) { \
         if (systems[sysIdx].obsTypes[obsIdx].id.compare((*itSelObs).substr(1)) == 0) { \
             selectedObs.push_back(SELobs(sysIdx, obsIdx)); \
             found = true; \
@@ -1575,8 +1693,8 @@ bool RinexData::setFilter(vector<string> selSat, vector<string> selObs) {
     vector<GNSSsystem>::iterator itsys;
     vector<int> inxSysObs;
     vector<int> inxObsSys;
-    char s, b[5];
-    int sysIdx, obsIdx, n, o;
+    char s;
+    int sysIdx, obsIdx, n;
     bool found;
     string aStr;
     plog->info(msgFilterStated);
@@ -1604,7 +1722,7 @@ bool RinexData::setFilter(vector<string> selSat, vector<string> selObs) {
         if ((sysIdx = systemIndex((*itSelObs).at(0))) >= 0) {
             SET_OBS_SELECTED
         } else if ((*itSelObs).at(0) == 'M') {
-            for (sysIdx = 0; sysIdx < systems.size(); sysIdx++) {
+            for (sysIdx = 0; sysIdx < (int) systems.size(); sysIdx++) {
                 SET_OBS_SELECTED
             }
         }
@@ -1667,17 +1785,18 @@ bool RinexData::setFilter(vector<string> selSat, vector<string> selObs) {
  * @return true when it remains any epoch data after filtering, false when no data remain
  */
 bool RinexData::filterObsData(bool removeNotPrt) {
-	vector<SatObsData>::iterator it;
-	it = epochObs.begin();
-	while (it != epochObs.end()) {
+	//data kept are moved to the beginning of epochObs, and the rest removed at the end
+	vector<SatObsData>::iterator kept = epochObs.begin();
+	for (vector<SatObsData>::iterator it = epochObs.begin(); it != epochObs.end(); it++) {
         //check if its system, observable or satellite is not selected, or if requested, the observable will not be printed
 		if (!systems[it->sysIndex].selSystem ||
 					!systems[it->sysIndex].obsTypes[it->obsTypeIndex].sel ||
 					!isSatSelected(it->sysIndex, it->satellite) ||
-                    (removeNotPrt && !systems[it->sysIndex].obsTypes[it->obsTypeIndex].prt)) {
-			it = epochObs.erase(it);
-		} else it++;
+                    (removeNotPrt && !systems[it->sysIndex].obsTypes[it->obsTypeIndex].prt)) continue;
+		if (kept != it) *kept = *it;
+		kept++;
 	}
+	epochObs.erase(kept, epochObs.end());
 	return !epochObs.empty();
 }
 
@@ -1709,13 +1828,63 @@ bool RinexData::saveNavData(char sys, int sat, double bo[BO_MAXLINS][BO_MAXCOLS]
 	try {
 		epochNav.push_back(SatNavData(tTag, sys, sat, bo));
 		plog->fine(logmsg + msgSaved);
+		if (ephStoreEnabled) storeEphemeris(epochNav.back());
+	} catch (std::bad_alloc& ba) {
+		plog->warning(logmsg + msgNoMem + ba.what());
+		return true;
+	}
+	if (navStreamOut != NULL) {
+		//keep the heap ordering and print epochs falling behind the streaming window
+		push_heap(epochNav.begin(), epochNav.end(), isNavLater);
+		if (tTag < navStreamPrinted) plog->warning(logmsg + msgBehindWin);
+		if (tTag > navStreamNewest) navStreamNewest = tTag;
+		flushNavStream(navStreamNewest - navStreamWindow);
+	}
+	return true;
+}
+
+/**saveNavData saves navigation data for a given satellite in a compact way: the mantissas of the broadcast orbit data
+ * and the function to scale them, which is applied when data are printed or got.
+ * Data are not saved if they already exist: same system, satellite and mantissas. They are looked for by system,
+ * satellite and ephemeris reference time, comparing the integer mantissas, without scaling them.
+ * Data are kept as mantissas also while streaming navigation epochs (see startNavStream), and scaled only when printed.
+ *
+ * @param sys the satellite system identifier (G,E,R, ...)
+ * @param sat the satellite PRN the navigation data belongs
+ * @param bom the mantissas of the broadcast orbit data with the eight lines of RINEX navigation data with four parameters each
+ * @param scaler the function to apply to mantissas to obtain broadcast orbit data and their time tag
+ * @return true if data have been saved, false otherwise
+ */
+bool RinexData::saveNavData(char sys, int sat, int bom[BO_MAXLINS][BO_MAXCOLS], NavScaler scaler) {
+	//check if this sat epoch data already exists: same satellite and mantissas
+	NavMantKey key(sys, sat, bom);
+	if (epochNavMantKeys.find(key) != epochNavMantKeys.end()) {
+		plog->fine(msgEpheSat+ string(1,sys) + to_string(sat) + msgAlrEx);
+		return false;
+	}
+	SatNavMantissa navMant(sys, sat, bom, scaler);
+	string logmsg = msgEpheSat+ string(1,sys) + to_string(sat) + msgTimeTag + to_string(navMant.navTimeTag);
+	try {
+		epochNavMant.push_back(navMant);
+		epochNavMantKeys.insert(key);
+		plog->fine(logmsg + msgSaved);
+		if (ephStoreEnabled) storeEphemeris(navMant.toSatNavData());
 	} catch (std::bad_alloc& ba) {
 		plog->warning(logmsg + msgNoMem + ba.what());
+		return true;
+	}
+	if (navStreamOut != NULL) {
+		//keep the heap ordering and print epochs falling behind the streaming window
+		push_heap(epochNavMant.begin(), epochNavMant.end(), isNavMantLater);
+		if (navMant.navTimeTag < navStreamPrinted) plog->warning(logmsg + msgBehindWin);
+		if (navMant.navTimeTag > navStreamNewest) navStreamNewest = navMant.navTimeTag;
+		flushNavStream(navStreamNewest - navStreamWindow);
 	}
 	return true;
 }
 
 /**getNavData extract from current epoch storage navigation data in the given index position.
+ * Data saved as mantissas follow the ones saved scaled, and are scaled when got.
  *
  * @param sys the satellite system identifier (G,E,R, ...)
  * @param sat the satellite PRN the navigation data belongs
@@ -1725,7 +1894,18 @@ bool RinexData::saveNavData(char sys, int sat, double bo[BO_MAXLINS][BO_MAXCOLS]
  * @return true if data have been saved, false otherwise
  */
 bool RinexData::getNavData(char& sys, int &sat, double (&bo)[BO_MAXLINS][BO_MAXCOLS], double &tTag, unsigned int index) {
-	if (epochNav.size() <= index) return false;
+	if (epochNav.size() + epochNavMant.size() <= index) return false;
+	if (index >= epochNav.size()) {
+		vector<SatNavMantissa>::iterator itm = epochNavMant.begin() + (index - epochNav.size());
+		double bos[BO_LINSTOTAL][BO_MAXCOLS];
+		sys = itm->systemId;
+		sat = itm->satellite;
+		tTag = itm->scale(bos);
+		for (int i = 0; i < BO_MAXLINS; i++)
+			for (int j = 0; j < BO_MAXCOLS; j++)
+				bo[i][j] = bos[i][j];
+		return true;
+	}
 	vector<SatNavData>::iterator it = epochNav.begin() + index;
 	sys = it->systemId;
 	sat = it->satellite;
@@ -1736,18 +1916,36 @@ bool RinexData::getNavData(char& sys, int &sat, double (&bo)[BO_MAXLINS][BO_MAXC
 	return true;
 }
 
+/**getNavEpoch gives the range of navigation data stored for the current epoch, to be iterated without copying them.
+ * As the range gives scaled data, navigation data saved as mantissas are scaled and moved to the scaled storage before.
+ * To keep data as mantissas, use getNavData instead.
+ *
+ * @return the range of navigation data in the current epoch
+ */
+RinexData::DataRange<RinexData::SatNavData> RinexData::getNavEpoch() {
+	scaleNavMantissas();
+	return DataRange<SatNavData>(epochNav.begin(), epochNav.end());
+}
+
 /**filterNavData if filtering data have been stated using setFilter method, removes from current epoch data on system or satellites not selected.
  *
  * @return true when it remains any epoch data after filtering, false when no data remain
  */
 bool RinexData::filterNavData() {
 	vector<SatNavData>::iterator it;
+	vector<SatNavMantissa>::iterator itm = epochNavMant.begin();
+	while (itm != epochNavMant.end()) {
+        if (!isSatSelected(systemIndex(itm->systemId), itm->satellite)) {
+            epochNavMantKeys.erase(NavMantKey(itm->systemId, itm->satellite, itm->broadcastOrbitM));
+            itm = epochNavMant.erase(itm);
+        } else itm++;
+	}
 	it = epochNav.begin();
 	while (it != epochNav.end()) {
         if (!isSatSelected(systemIndex(it->systemId), it->satellite)) it = epochNav.erase(it);
         else it++;
 	}
-	return !epochNav.empty();
+	return !epochNav.empty() || !epochNavMant.empty();
 }
 
 /**clearNavData clears all epoch navigation data on satellites and ephemeris previously saved.
@@ -1755,6 +1953,8 @@ bool RinexData::filterNavData() {
  */
 void RinexData::clearNavData() {
 	epochNav.clear();
+	epochNavMant.clear();
+	epochNavMantKeys.clear();
 }
 
 /**getObsFileName constructs a standard RINEX observation file name from the given prefix and current header data.
@@ -1785,6 +1985,7 @@ string RinexData::getObsFileName(string prefix, string country) {
  * For V2.1 RINEX file names, the given prefix and suffix parameters data are used.
  * Additionally, for V3.04 the file name includes data from MARKER NUMBER, REC # / TYPE / VERS, TIME OF FIRST OBS and TIME OF LAST OBS,
  * and SYS / # / OBS TYPES header records (if defin3ed) and country parameter.
+ * The file time is the one of the oldest navigation epoch saved or already streamed, if any.
  *
  * @param prefix the file name prefix as 4-character station name designator
  * @param country the 3-char ISO 3166-1 country code, or "---" by default
@@ -1804,10 +2005,13 @@ string RinexData::getNavFileName(string prefix, string country) {
 		week = firstObsWeek;
 		tow = firstObsTOW;
 	}
-	if (!epochNav.empty()) {
-		sort(epochNav.begin(), epochNav.end());
-		week = getWeekGNSSinstant(epochNav[0].navTimeTag);
-		tow = getTowGNSSinstant(epochNav[0].navTimeTag);
+	if (!epochNav.empty() || !epochNavMant.empty() || navStreamFirst != 0.0) {
+		double firstTag = HUGE_VAL;
+		if (!epochNav.empty()) firstTag = min_element(epochNav.begin(), epochNav.end())->navTimeTag;
+		if (!epochNavMant.empty()) firstTag = min(firstTag, min_element(epochNavMant.begin(), epochNavMant.end())->navTimeTag);
+		if (navStreamFirst != 0.0) firstTag = min(firstTag, navStreamFirst);
+		week = getWeekGNSSinstant(firstTag);
+		tow = getTowGNSSinstant(firstTag);
 	}
 	switch(version) {
 	case V304:
@@ -1844,7 +2048,7 @@ void RinexData::printObsHeader(FILE* out) {
         vector<bool> aVectorBool;
         aVectorBool.insert(aVectorBool.begin(), numberV2ObsTypes, false);
         for (vector<GNSSsystem>::iterator itsys = systems.begin(); itsys != systems.end(); itsys++) {
-            for (int i = 0; i < numberV2ObsTypes; i++) {
+            for (unsigned int i = 0; i < numberV2ObsTypes; i++) {
                 itsys->obsTypes[i].prt = itsys->obsTypes[i].sel;
                 aVectorBool[i] = aVectorBool[i] || itsys->obsTypes[i].prt;
             }
@@ -1854,12 +2058,12 @@ void RinexData::printObsHeader(FILE* out) {
         for (vector<GNSSsystem>::iterator itsys = systems.begin(); itsys != systems.end(); itsys++) {
             //check if this system has any obsType to print
             isAny = false;
-            for (int i = 0; i < numberV2ObsTypes; i++) if (itsys->obsTypes[i].prt) { isAny = true; break; }
+            for (unsigned int i = 0; i < numberV2ObsTypes; i++) if (itsys->obsTypes[i].prt) { isAny = true; break; }
             if (isAny) {
                 //obsType shall be printed using a common pattern for all systems
-                for (int i = 0; i < numberV2ObsTypes; i++) itsys->obsTypes[i].prt = aVectorBool[i];
+                for (unsigned int i = 0; i < numberV2ObsTypes; i++) itsys->obsTypes[i].prt = aVectorBool[i];
             }
-            for (int i = numberV2ObsTypes; i < itsys->obsTypes.size(); i++) itsys->obsTypes[i].prt = false;
+            for (size_t i = numberV2ObsTypes; i < itsys->obsTypes.size(); i++) itsys->obsTypes[i].prt = false;
         }
 		setLabelFlag(SYS, false);
 		setLabelFlag(TOBS);
@@ -1957,20 +2161,23 @@ void RinexData::printObsEpoch(FILE* out) {
 			}
 			if (clkOffsetPrinted) fprintf(out, "\n");
 			else fprintf(out, "%s\n", clkOffsetBuffer);
-			//for each satellite in this epoch, print their observables and remove them from epochObs
-			while (printSatObsValues(out, V210))
+			//for each satellite in this epoch, print their observables
+			it = epochObs.begin();
+			while (printSatObsValues(out, V210, it))
 			    ;
 	 		break;
 		case V304:	//RINEX version 3.04
-            fprintf(out, "%s  %1d%3d%5c%s%3c\n", timeBuffer, epochFlag, nSatsEpoch, ' ', clkOffsetBuffer, ' ');
-			//for each satellite in this epoch,  print a line with their measurements (they are removed just after printed)
+            fprintf(out, "%s  %1d%3d%6c%s%3c\n", timeBuffer, epochFlag, nSatsEpoch, ' ', clkOffsetBuffer, ' ');
+			//for each satellite in this epoch,  print a line with their measurements
+			it = epochObs.begin();
 			do {
-				fprintf(out, "%1c%02d", systems[epochObs[0].sysIndex].system, epochObs[0].satellite);
- 			} while (printSatObsValues(out, V304));
+				fprintf(out, "%1c%02d", systems[it->sysIndex].system, it->satellite);
+ 			} while (printSatObsValues(out, V304, it));
  			break;
 		default:
 		     break;
  		}
+		epochObs.clear();	//remove printed data
 		break;
 	case 2:	//start moving antenna event
 	case 3:	//new site occupation event
@@ -2017,7 +2224,6 @@ void RinexData::printObsEpoch(FILE* out) {
 void RinexData::printNavHeader(FILE* out) {
 	///Before printing, set VERSION data record which depends on the version to be printed.
 	const string msgNotNav("No system selected to generate navigation file");
-	int n = 0;
 	if (version == VTBD) version = inFileVer;
 	if (version == VTBD) throw msgVerTBD;
     try {
@@ -2052,86 +2258,126 @@ void RinexData::printNavHeader(FILE* out) {
  */
 void RinexData::printNavEpochs(FILE* out) {
     const string msgNavEpochsSys("Navigation epochs for system=");
-    const string msgNavEpochIgn("Ignored epoch for system, satellite=");
-    const string msgNavEpochPrn("Printed epoch for system, satellite=");
-	char timeBuffer[80];
-	int nBroadcastOrbits, nEphemeris;
-	const char* timeFormat;
-	const char* secondsFormat;
-	int lineStartSpaces;
-	vector<SatNavData>::iterator it;
 
 #ifdef _WIN32
 	//MS VS specific!!
 	_set_output_format(_TWO_DIGIT_EXPONENT);
 #endif
-	if(epochNav.empty()) return;
-	//set version constants
-	switch (version) {
-	case V210:
-		timeFormat = "%y %m %d %H %M";
-		secondsFormat = " %4.1f";
-		lineStartSpaces = 3;
-		break;
-	case V304:
-		timeFormat = "%Y %m %d %H %M %S";
-		secondsFormat = "";
-		lineStartSpaces = 4;
-		break;
-	default:
-		throw msgVerTBD;
-	}
+	if(epochNav.empty() && epochNavMant.empty()) return;
+	if (version != V210 && version != V304) throw msgVerTBD;
 	//filter nav epochs available
 	//if (!filterNavData()) return;
 	//sort epochs available by time tag, system, and satellite
 	sort(epochNav.begin(), epochNav.end());
+	sort(epochNavMant.begin(), epochNavMant.end());
 	plog->finest(msgNavEpochsSys + string(1, sysToPrintId) + msgColon);
-	for (vector<SatNavData>::iterator it = epochNav.begin(); it != epochNav.end(); it++) {
-	    if (isSatSelected(systemIndex(it->systemId), it->satellite)) {
-            plog->finest(msgNavEpochPrn + string(1, it->systemId) + msgComma + to_string(it->satellite));
-            //print epoch first line
-            formatGPStime (timeBuffer, sizeof timeBuffer, timeFormat, secondsFormat, getWeekGNSSinstant(it->navTimeTag), getTowGNSSinstant(it->navTimeTag));
-            switch (version) {	//print satellite and epoch time
-                case V210:
-                    fprintf(out, "%02d %s", it->satellite, timeBuffer);
-                    if (it->systemId == 'R') {	//in V2 GLONASS tk to print is daily, not weekly
-                        it->broadcastOrbit[0][3] = fmod(it->broadcastOrbit[0][3], 86400);
-                    }
-                    break;
-                case V304:
-                    fprintf(out, "%1c%02d %s", it->systemId, it->satellite, timeBuffer);
-                    break;
-                default:
-                    break;
-            }
-            for (int i=1; i<BO_MAXCOLS; i++)	//add the Af0, Af1 & Af2 values
-                fprintf(out, "%19.12E", it->broadcastOrbit[0][i]);
-            fprintf(out, "\n");
-            //print the rest of broadcast orbit data lines
-            switch (it->systemId) {
-                //set values for nBroadcastOrbits and nEphemeris as stated in RINEX 3.04 doc
-                case 'G': nBroadcastOrbits = BO_MAXLINS_GPS; nEphemeris = BO_TOTEPHE_GPS; break;
-                case 'R': nBroadcastOrbits = BO_MAXLINS_GLO; nEphemeris = BO_TOTEPHE_GLO; break;
-                case 'E': nBroadcastOrbits = BO_MAXLINS_GAL; nEphemeris = BO_TOTEPHE_GAL; break;
-				case 'C': nBroadcastOrbits = BO_MAXLINS_BDS; nEphemeris = BO_TOTEPHE_BDS; break;
-                case 'S': nBroadcastOrbits = BO_MAXLINS_SBAS; nEphemeris = BO_TOTEPHE_SBAS; break;
-                default: throw msgSysUnk + string(1, it->systemId);
-            }
-            for (int i = 1; (i < nBroadcastOrbits) && (nEphemeris > 0); i++) {
-                for (int j = 0; j < lineStartSpaces; j++) fputc(' ', out);
-                for (int j = 0; j < BO_MAXCOLS; j++) {
-                    if (nEphemeris > 0) fprintf(out, "%19.12E", it->broadcastOrbit[i][j]);
-                    else fprintf(out, "%19c", ' ');
-                    nEphemeris--;
-                }
-                fprintf(out, "\n");
-            }
-	    } else {
-            plog->finest(msgNavEpochIgn + string(1,it->systemId) + msgComma + to_string(it->satellite));
-	    }
+	//merge scaled data and data saved as mantissas (scaling them only when printed)
+	vector<SatNavData>::iterator it = epochNav.begin();
+	vector<SatNavMantissa>::iterator itm = epochNavMant.begin();
+	bool mantFirst;
+	while (it != epochNav.end() || itm != epochNavMant.end()) {
+		mantFirst = (itm != epochNavMant.end()) && ((it == epochNav.end()) || isMantBefore(*itm, *it));
+		if (mantFirst) {
+			SatNavData nav = itm->toSatNavData();
+			printSelSatNavData(out, nav);
+			itm++;
+		} else {
+			printSelSatNavData(out, *it);
+			it++;
+		}
 	}
 }
 
+/**startNavStream starts the streaming of navigation epochs to the given file.
+ *<p>While streaming, navigation data saved using saveNavData are kept in storage only while their time tag is inside
+ *the time window given, counted back from the newest time tag saved. When data fall behind this window they are printed
+ *in time tag, system and satellite order, and removed from the storage. As navigation messages arrive approximately in time order,
+ *the output is the same printed by printNavEpochs, but memory used remains bounded.
+ *<p>The navigation file header shall be printed (using printNavHeader) before the streamed epochs: in the same file before
+ *starting the streaming, or in the final file before appending the epochs streamed to a temporary one. endNavStream shall
+ *be called after saving the last navigation data to print the ones remaining in the storage.
+ *
+ * @param out the already open print file where RINEX navigation epochs will be printed
+ * @param window the time span in seconds of the navigation data kept in storage (by default NAV_STREAMWINDOW)
+ * @throws error message string when the version to print is not defined
+ */
+void RinexData::startNavStream(FILE* out, double window) {
+#ifdef _WIN32
+	//MS VS specific!!
+	_set_output_format(_TWO_DIGIT_EXPONENT);
+#endif
+	if (version != V210 && version != V304) throw msgVerTBD;
+	navStreamOut = out;
+	navStreamWindow = window;
+	navStreamNewest = navStreamPrinted = navStreamFirst = 0.0;
+	//data already saved are arranged as heaps to continue streaming from them
+	make_heap(epochNav.begin(), epochNav.end(), isNavLater);
+	make_heap(epochNavMant.begin(), epochNavMant.end(), isNavMantLater);
+	if (!epochNav.empty()) navStreamNewest = max_element(epochNav.begin(), epochNav.end())->navTimeTag;
+	if (!epochNavMant.empty()) navStreamNewest = max(navStreamNewest, max_element(epochNavMant.begin(), epochNavMant.end())->navTimeTag);
+}
+
+/**endNavStream prints the navigation epochs remaining in the storage and ends the streaming started with startNavStream.
+ *
+ * @throws error message string when epoch cannot be printed
+ */
+void RinexData::endNavStream() {
+	if (navStreamOut == NULL) return;
+	flushNavStream(HUGE_VAL);
+	navStreamOut = NULL;
+}
+
+/**setEphemerisStore enables or disables the ephemeris store.
+ * When enabled, navigation data saved (using saveNavData) or read (using readNavEpoch) are also stored indexed by system-satellite
+ * and time tag, to allow getting the ephemeris valid for a given time using getBestEphemeris.
+ * Unlike the epoch navigation data storage, the ephemeris store is not cleared when printing or reading epochs.
+ * When disabled, the ephemeris store is cleared.
+ *
+ * @param enable true to enable the ephemeris store, false to disable and clear it
+ */
+void RinexData::setEphemerisStore(bool enable) {
+	ephStoreEnabled = enable;
+	if (!enable) ephStore.clear();
+}
+
+/**getBestEphemeris gets from the ephemeris store the ephemeris of the given satellite valid for the given time,
+ * that is, the ones having the nearest time tag to the given one, if not farther than the maximum age stated.
+ * The look up has logarithmic complexity on the number of ephemeris stored for the satellite.
+ *
+ * @param sys the satellite system identifier (G,E,R, ...)
+ * @param sat the satellite PRN
+ * @param tTag the time (seconds from the GPS epoch, as per time tags) for which ephemeris are requested
+ * @param bo the broadcast orbit data found with the eight lines of RINEX navigation data with four parameters each
+ * @param ephTag the time tag of the ephemeris found
+ * @param maxAge the maximum time distance in seconds between tTag and the ephemeris time tag. If 0 or less, a default value
+ *  for the system is used (EPH_MAXAGE, EPH_MAXAGE_GLO or EPH_MAXAGE_SBAS)
+ * @return true if valid ephemeris have been found, false otherwise
+ */
+bool RinexData::getBestEphemeris(char sys, int sat, double tTag, double (&bo)[BO_MAXLINS][BO_MAXCOLS], double &ephTag, double maxAge) {
+	map <pair<char, int>, map<double, SatNavData> >::iterator itSat = ephStore.find(make_pair(sys, sat));
+	if (itSat == ephStore.end() || itSat->second.empty()) return false;
+	if (maxAge <= 0.0) {
+		switch (sys) {
+		case 'R': maxAge = EPH_MAXAGE_GLO; break;
+		case 'S': maxAge = EPH_MAXAGE_SBAS; break;
+		default: maxAge = EPH_MAXAGE; break;
+		}
+	}
+	//the candidates are the first ephemeris not before tTag and the previous one
+	map<double, SatNavData> &satEph = itSat->second;
+	map<double, SatNavData>::iterator itBest = satEph.lower_bound(tTag);
+	if (itBest == satEph.end()) itBest--;
+	else if (itBest != satEph.begin()) {
+		map<double, SatNavData>::iterator itPrev = itBest;
+		itPrev--;
+		if (tTag - itPrev->first <= itBest->first - tTag) itBest = itPrev;
+	}
+	if (fabs(itBest->first - tTag) > maxAge) return false;
+	ephTag = itBest->first;
+	memcpy(bo, itBest->second.broadcastOrbit, sizeof(bo));
+	return true;
+}
+
 /**
  * hasNavEpochs checks if it exists navigation data saved in the RINEX object for the given constellation.
  *
@@ -2144,9 +2390,172 @@ bool RinexData::hasNavEpochs(char sys) {
         if (it->systemId == sys) return true;
         it++;
     }
+    vector<SatNavMantissa>::iterator itm = epochNavMant.begin();
+    while (itm != epochNavMant.end()) {
+        if (itm->systemId == sys) return true;
+        itm++;
+    }
     return false;
 }
 
+/**mapInputFile maps in memory the given RINEX input file, to read it without the copies made by stdio.
+ *<p>While mapped, readRinexHeader, readObsEpoch and readNavEpoch called with this input file read lines from
+ * the mapped area, starting from the current position in the file. Observation records are extracted directly
+ * from the mapped area, without copying them. Mapped observation files can be read in parallel (see setObsReadThreads).
+ *<p>unmapInputFile shall be called to end the mapping and to continue reading the input file using stdio.
+ * The input file shall not be modified while mapped.
+ *
+ * @param input the already open input stream with the RINEX file to map
+ * @return true if the file has been mapped, false otherwise (it will be read using stdio)
+ */
+bool RinexData::mapInputFile(FILE* input) {
+	unmapInputFile();
+	if ((inDecoder != NULL) && (input == inDecoder->getFile())) return false;
+#ifdef _WIN32
+	return false;
+#else
+	struct stat fileStat;
+	long start = ftell(input);
+	if ((start < 0) || (fstat(fileno(input), &fileStat) != 0) || !S_ISREG(fileStat.st_mode)
+		|| (fileStat.st_size <= start)) return false;
+	void* area = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileno(input), 0);
+	if (area == MAP_FAILED) return false;
+	madvise(area, fileStat.st_size, MADV_SEQUENTIAL);
+	mapFile = input;
+	mapData = (const char*) area;
+	mapSize = fileStat.st_size;
+	mapPos = start;
+	return true;
+#endif
+}
+
+/**unmapInputFile ends the mapping of the input file started with mapInputFile.
+ * The input file position is set after the last line read from the mapped area.
+ */
+void RinexData::unmapInputFile() {
+	if (mapFile == NULL) return;
+	fseek(mapFile, getInputPos(mapFile), SEEK_SET);
+	obsReadAhead.clear();
+#ifndef _WIN32
+	munmap((void*) mapData, mapSize);
+#endif
+	mapFile = NULL;
+	mapData = NULL;
+	mapSize = mapPos = 0;
+}
+
+/**openInputDecoder identifies if the given RINEX input file is compressed using gzip and/or the Compact RINEX format
+ * (Hatanaka compression), to decompress it while reading.
+ *<p>When the file is compressed, readRinexHeader, readObsEpoch and readNavEpoch called with this input file read lines
+ * from the decompressed data, without intermediate files. Compressed files can be read only sequentially: they cannot be
+ * mapped, indexed or read in parallel.
+ *<p>closeInputDecoder shall be called to end decoding before closing the input file.
+ *
+ * @param input the already open input stream with the RINEX file, positioned at its beginning
+ * @return true if the file is compressed and will be decoded, false otherwise (it will be read as plain text)
+ */
+bool RinexData::openInputDecoder(FILE* input) {
+	closeInputDecoder();
+	long start = ftell(input);
+	inDecoder = new RinexDecoder(input, plog);
+	if (inDecoder->isCompressed()) return true;
+	closeInputDecoder();
+	fseek(input, start, SEEK_SET);
+	return false;
+}
+
+/**closeInputDecoder ends the decoding of the compressed input file started with openInputDecoder.
+ */
+void RinexData::closeInputDecoder() {
+	delete inDecoder;
+	inDecoder = NULL;
+}
+
+/**indexObsEpochs builds an index of the epochs in the given RINEX observation file, to allow reading them from
+ * any epoch using seekObsEpoch. The index contains the time tag and the position in the file of each epoch line.
+ *<p>Epochs are indexed from the current position in the input file (after reading its header) to its end, and the
+ * position is restored after indexing. Epoch lines of V3 files (starting with '>') are identified without parsing
+ * observation records. V2 files are indexed reading their epochs with another object, to keep here the current epoch
+ * data and the header data, which could be changed by the header records in events.
+ * In both versions all epochs having a date are indexed, including events. Events without date are not indexed.
+ *
+ * @param input the already open input stream with the RINEX observation file
+ * @return the number of epochs indexed (0 for compressed files)
+ */
+int RinexData::indexObsEpochs(FILE* input) {
+	RinexLine line;
+	char epochLine[32];
+	int year, month, day, hour, minute, week;
+	double second, tow;
+	long startPos = getInputPos(input);
+	long pos = startPos;
+	obsEpochIndex.clear();
+	if ((inDecoder != NULL) && (input == inDecoder->getFile())) return 0;
+	switch (inFileVer) {
+	case V210: {
+		//epochs are read by another object, to not store here the header records in events.
+		//The time tag is not set when reading epochs without date
+		RinexData reader(version, plog);
+		setObsReader(reader, startPos);
+		for (reader.epochTimeTag = -1.0; reader.readV2ObsEpoch(input) != 0; reader.epochTimeTag = -1.0) {
+			if (reader.epochTimeTag >= 0.0) obsEpochIndex.push_back(make_pair(reader.epochTimeTag, pos));
+			pos = reader.getInputPos(input);
+		}
+		reader.mapFile = NULL;
+		reader.mapData = NULL;
+		break;
+	}
+	case V304:
+		while (!readRinexLine(line, input)) {
+			if (line.data[0] == '>') {
+				memcpy(epochLine, line.data, line.width(0, sizeof epochLine - 1));
+				epochLine[line.width(0, sizeof epochLine - 1)] = '\0';
+				if (sscanf(epochLine+2, "%4d %2d %2d %2d %2d%11lf", &year, &month, &day, &hour, &minute, &second) == 6) {
+					getWeekTowGPSdate(year, month, day, hour, minute, second, week, tow);
+					obsEpochIndex.push_back(make_pair(getInstantGNSStime(week, tow), pos));
+				}
+			}
+			pos = getInputPos(input);
+		}
+		break;
+	default:
+		break;
+	}
+	setInputPos(input, startPos);
+	return obsEpochIndex.size();
+}
+
+/**seekObsEpoch sets the position in the input file to read (using readObsEpoch) from the first epoch having a time tag
+ * equal or later than the given one. The input file shall be indexed before using indexObsEpochs.
+ *
+ * @param input the already open input stream with the RINEX observation file
+ * @param tTag the time tag of the epoch to seek
+ * @return true if the position has been set, false if there is not any epoch at or after the given time tag
+ */
+bool RinexData::seekObsEpoch(FILE* input, double tTag) {
+	vector<pair<double, long> >::iterator it = lower_bound(obsEpochIndex.begin(), obsEpochIndex.end(), make_pair(tTag, LONG_MIN));
+	if (it == obsEpochIndex.end()) return false;
+	setInputPos(input, it->second);
+	return true;
+}
+
+/**setObsReadThreads sets the number of threads used by readObsEpoch to read observation files mapped in memory
+ * (see mapInputFile).
+ *<p>When more than one thread is set, readObsEpoch splits the file from the current position in chunks starting at
+ * epoch lines ('>' lines in V3, and lines having the epoch line format in V2). Each thread reads the epochs in one
+ * chunk, and epochs are delivered in order in successive calls to readObsEpoch. A chunk is used only when it starts
+ * where the previous one ended, otherwise reading continues from the end of the previous one.
+ * Epochs with events are read again when delivered, to store here the header records they may contain.
+ *<p>The file header shall be read before (using readRinexHeader), as all threads use the systems and observable
+ * types defined in it.
+ *
+ * @param nThreads the number of threads to use (1 to read without threads)
+ */
+void RinexData::setObsReadThreads(int nThreads) {
+	obsReadThreads = nThreads > 1 ? nThreads : 1;
+	obsReadAhead.clear();
+}
+
 /**readRinexHeader read the RINEX file header extracting its data and storing them into to the class members.
  * As a well formed RINEX head shall terminate with the "END OF HEADER" line, the normal return for the method would be EOH.
  * If the order of the header records is not compliant with what is stated in the RINEX definition, the error is logged.
@@ -2250,6 +2659,7 @@ RinexData::RINEXlabel RinexData::readRinexHeader(FILE* input) {
  *		- (9)	Unknown input file version
  */
 int RinexData::readObsEpoch(FILE* input) {
+	if ((obsReadThreads > 1) && (input == mapFile)) return readObsEpochAhead(input);
 	epochObs.clear();
 	switch(inFileVer) {
 	case V210:
@@ -2284,11 +2694,11 @@ int RinexData::readNavEpoch(FILE* input) {
 		}
 ///a macro to get data for broadcast orbit in LINE_I COL_J
 #define GET_BO(LINE_I, COL_J) \
-		if (sscanf(startPos1st, "%19lf", &bo[LINE_I][COL_J]) != 1) { \
+		if (!getFixedDouble(startPos1st, NAV_FIELDWIDTH, bo[LINE_I][COL_J])) { \
 			retCode = 5; \
 			msgPrfx += msgErrBO + to_string((long long) LINE_I) + string("][") + to_string((long long) COL_J) + string("]."); \
 		} \
-		startPos1st += 19;
+		startPos1st += NAV_FIELDWIDTH;
 
 	char sysSat;
     char lineBuffer[100];
@@ -2300,6 +2710,8 @@ int RinexData::readNavEpoch(FILE* input) {
 	int retCode;
 
 	epochNav.clear();
+	epochNavMant.clear();
+	epochNavMantKeys.clear();
 	//read epoch 1st line and extract data and set specific line parameter
 	if (readRinexRecord(lineBuffer, sizeof lineBuffer, input)) return 0;
 	string msgPrfx =  msgEpoch + string(lineBuffer, 32) + msgBrak;
@@ -2313,16 +2725,16 @@ int RinexData::readNavEpoch(FILE* input) {
 			LOG_ERR_AND_RETURN(msgWrongDate, 4)
 		if (year >= 80) year += 1900;
 		else year += 2000;
-		startPos1st = lineBuffer + 22;	//start position of SV clock data in the 1st line
-		startPosBO = lineBuffer + 3;	//start position of broadcat orbit data
+		startPosBO = lineBuffer + NAV_BOSTART_V2;	//start position of broadcat orbit data
+		startPos1st = startPosBO + NAV_FIELDWIDTH;	//start position of SV clock data in the 1st line
 		break;
 	case V304:
 		if (sscanf(lineBuffer, "%1c%2d", &sysSat, &prnSat) != 2) LOG_ERR_AND_RETURN(msgWrongSysPRN, 3)
 		if (sscanf(lineBuffer+4, "%4d %2d %2d %2d %2d %2d", &year, &month, &day, &hour, &minute, &anInt) != 6)
 			LOG_ERR_AND_RETURN(msgWrongDate, 4)
 		second = (double) anInt;
-		startPos1st = lineBuffer + 22;	//start position of SV clock data in the 1st line
-		startPosBO = lineBuffer + 4;	//start position of broadcat orbit data
+		startPosBO = lineBuffer + NAV_BOSTART_V3;	//start position of broadcat orbit data
+		startPos1st = startPosBO + NAV_FIELDWIDTH;	//start position of SV clock data in the 1st line
 		break;
 	default: LOG_ERR_AND_RETURN(msgWrongInFile, 9)
 	}
@@ -2360,8 +2772,9 @@ int RinexData::readNavEpoch(FILE* input) {
 		msgPrfx += msgNewEp;
 	}
 	try {
-		epochNav.push_back(SatNavData(attag, sysToPrintId, prnSat, bo));
+		epochNav.push_back(SatNavData(attag, sysSat, prnSat, bo));
 		msgPrfx += msgStored;
+		if (ephStoreEnabled) storeEphemeris(epochNav.back());
 	} catch (std::bad_alloc& ba) {
 		LOG_ERR_AND_RETURN(msgNoMem + ba.what(), 10)
 	}
@@ -2371,8 +2784,591 @@ int RinexData::readNavEpoch(FILE* input) {
 #undef GET_BO
 }
 
+/**convertObsFile converts the given RINEX observation file to the version of this object, printing the result in the given output file.
+ *<p>The input header is read and printed in the version to print. Then epochs are read and printed one by one, keeping in memory
+ * only data of the current epoch. Special event epochs are printed with the header records following them.
+ *<p>Observables not printable in the version to print (or not selected) are not stored when reading: the position of each
+ * observable in input records is mapped once to the observable types to print.
+ *<p>Compressed input files are decompressed while reading (see openInputDecoder), and plain ones are mapped in memory (see mapInputFile).
+ *
+ * @param input the already open input stream with the RINEX observation file, positioned at its beginning
+ * @param output the already open print stream where the converted RINEX file will be printed
+ * @param selSat the list of selected systems and / or satellites (see setFilter). By default all of them
+ * @param selObs the list of selected observables (see setFilter). By default all of them
+ * @return the number of epochs converted (including special event epochs)
+ * @throws error message string when the header or epochs cannot be printed
+ */
+int RinexData::convertObsFile(FILE* input, FILE* output, vector<string> selSat, vector<string> selObs) {
+	const string msgNotObs("Input file is not a RINEX observation file");
+	int nEpochs = 0;
+	if (!openInputDecoder(input)) mapInputFile(input);
+	readRinexHeader(input);
+	if ((inFileVer == VTBD) || (fileType != 'O')) {
+		plog->warning(msgNotObs);
+		unmapInputFile();
+		closeInputDecoder();
+		return 0;
+	}
+	setFilter(selSat, selObs);
+	printObsHeader(output);
+	//observables not printed are skipped when reading records
+	for (vector<GNSSsystem>::iterator itsys = systems.begin(); itsys != systems.end(); itsys++)
+		for (vector<int>::iterator itidx = itsys->inObsIdx.begin(); itidx != itsys->inObsIdx.end(); itidx++)
+			if ((*itidx >= 0) && !itsys->obsTypes[*itidx].prt) *itidx = -1;
+	//header data are cleared to print in special events only the records read with them
+	clearHeaderData();
+	for (bool eof = false; !eof; ) {
+		switch (readObsEpoch(input)) {
+		case 0:		//EOF
+		case 9:		//unknown input file version
+			eof = true;
+			break;
+		case 1:		//observation data
+		case 3:		//observation data with errors (wrong observables stored as empty ones)
+			printObsEpoch(output);
+			nEpochs++;
+			break;
+		case 2:		//special event (with or without errors in their records)
+		case 5:
+		case 6:
+		case 7:
+			printObsEpoch(output);
+			clearHeaderData();
+			nEpochs++;
+			break;
+		default:	//epoch data not stored
+			break;
+		}
+	}
+	unmapInputFile();
+	closeInputDecoder();
+	return nEpochs;
+}
+
+/**convertNavFile converts the given RINEX navigation file to the version of this object, printing the result in the given output file.
+ *<p>The input header is read and printed in the version to print. Then satellite ephemeris are read and printed one by one, in the
+ * input file order, keeping in memory only the current ones.
+ *<p>Note that V2.10 navigation files contain data for only one system: when converting mixed navigation files to V2.10, the system
+ * to convert shall be selected (using selSat). By default, the first system is converted.
+ *<p>Compressed input files are decompressed while reading (see openInputDecoder), and plain ones are mapped in memory (see mapInputFile).
+ *
+ * @param input the already open input stream with the RINEX navigation file, positioned at its beginning
+ * @param output the already open print stream where the converted RINEX file will be printed
+ * @param selSat the list of selected systems and / or satellites (see setFilter). By default all of them
+ * @param selObs the list of selected observables (see setFilter). Not used for navigation data
+ * @return the number of satellite ephemeris converted
+ * @throws error message string when the header cannot be printed
+ */
+int RinexData::convertNavFile(FILE* input, FILE* output, vector<string> selSat, vector<string> selObs) {
+	const string msgNotNavFile("Input file is not a RINEX navigation file");
+	const char navSystems[] = "GRECJS";		//systems which navigation data can be read
+	int nEpochs = 0;
+	int status;
+	if (!openInputDecoder(input)) mapInputFile(input);
+	readRinexHeader(input);
+	if ((inFileVer == VTBD) || (fileType != 'N')) {
+		plog->warning(msgNotNavFile);
+		unmapInputFile();
+		closeInputDecoder();
+		return 0;
+	}
+	//mixed navigation files do not state their systems in the header: all systems are defined to convert their data
+	if (sysToPrintId == 'M') {
+		for (const char* s = navSystems; *s != 0; s++)
+			if (systemIndex(*s) < 0) systems.push_back(GNSSsystem(*s, vector<string>()));
+	}
+	setFilter(selSat, selObs);
+	printNavHeader(output);
+	//a V2.10 navigation file can include data for only one system: the first selected
+	char onlySys = 0;
+	if (version == V210) {
+		for (vector<GNSSsystem>::iterator it = systems.begin(); it != systems.end(); it++) {
+			if (it->selSystem) {
+				onlySys = it->system;
+				break;
+			}
+		}
+	}
+	while (((status = readNavEpoch(input)) != 0) && (status != 9)) {
+		for (vector<SatNavData>::iterator it = epochNav.begin(); it != epochNav.end(); it++) {
+			if ((onlySys != 0) && (it->systemId != onlySys)) continue;
+			try {
+				printSelSatNavData(output, *it);
+				nEpochs++;
+			} catch (string error) {
+				plog->warning(error);
+			}
+		}
+	}
+	epochNav.clear();
+	unmapInputFile();
+	closeInputDecoder();
+	return nEpochs;
+}
+
+/**mergeObsFiles merges the given RINEX observation files in one file of the version of this object, printing their epochs in time order.
+ *<p>Input files are read concurrently, one epoch each time, using a RinexData object for each one. The next epoch to print is the
+ * earliest one in a min-heap containing the time tag of the current epoch of each input, and only these epochs are kept in memory.
+ *<p>The header printed is the one of the first input file, with the systems and observable types of all the inputs, and with the
+ * time of first and last observation of all of them. Observation epochs having the same time tag in several inputs are printed
+ * as one epoch: when a satellite has data in several of them, the ones of the first input having it are printed.
+ *<p>Special events with header records (new site and header information events) only apply to the input file containing them
+ * and are not printed. Other events are printed without their special records.
+ *<p>Compressed input files are decompressed while reading (see openInputDecoder), and plain ones are mapped in memory (see mapInputFile).
+ *
+ * @param inputs the already open input streams with the RINEX observation files, positioned at their beginning
+ * @param output the already open print stream where the merged RINEX file will be printed
+ * @param selSat the list of selected systems and / or satellites (see setFilter). By default all of them
+ * @param selObs the list of selected observables (see setFilter). By default all of them
+ * @return the number of epochs printed (including special event epochs)
+ * @throws error message string when the header or epochs cannot be printed
+ */
+int RinexData::mergeObsFiles(vector<FILE*> inputs, FILE* output, vector<string> selSat, vector<string> selObs) {
+	const string msgNotObs("Input file is not a RINEX observation file, not merged: ");
+	vector<RinexData*> readers;
+	vector<bool> isObs;		//for each input, if it is an observation file to be merged
+	vector<vector<int> > sysMap;		//for each input and system, its index in systems
+	vector<vector<vector<int> > > obsMap;	//for each input, system and observable type, its index in obsTypes
+	vector<pair<double, int> > heap;	//min-heap with the time tag of the current epoch of each input and the input index
+	map<pair<unsigned int, int>, int> satInput;		//for each satellite in the current epoch, the input its data come from
+	int nEpochs = 0;
+	if (inputs.empty()) return 0;
+	//the header of the first input is read here, and the reading of its epochs continues in its reader object
+	if (!openInputDecoder(inputs[0])) mapInputFile(inputs[0]);
+	readRinexHeader(inputs[0]);
+	if ((inFileVer == VTBD) || (fileType != 'O')) {
+		plog->warning(msgNotObs + to_string((long long) 0));
+		unmapInputFile();
+		closeInputDecoder();
+		return 0;
+	}
+	for (unsigned int i = 0; i < inputs.size(); i++) {
+		RinexData* reader = new RinexData(version, plog);
+		reader->setObsReadThreads(obsReadThreads);
+		readers.push_back(reader);
+		if (i == 0) {
+			reader->inFileVer = inFileVer;
+			reader->sysToPrintId = sysToPrintId;
+			reader->systems = systems;
+			reader->lastRecordSet = reader->labelDef.begin() + reader->labelPos[EOH];
+			reader->inDecoder = inDecoder;
+			reader->mapFile = mapFile;
+			reader->mapData = mapData;
+			reader->mapSize = mapSize;
+			reader->mapPos = mapPos;
+			inDecoder = NULL;
+			mapFile = NULL;
+			mapData = NULL;
+			mapSize = mapPos = 0;
+		} else {
+			if (!reader->openInputDecoder(inputs[i])) reader->mapInputFile(inputs[i]);
+			reader->readRinexHeader(inputs[i]);
+			if ((reader->inFileVer == VTBD) || (reader->fileType != 'O')) {
+				plog->warning(msgNotObs + to_string((long long) i));
+				isObs.push_back(false);
+				sysMap.push_back(vector<int>());
+				obsMap.push_back(vector<vector<int> >());
+				continue;
+			}
+			//the merged file covers the observation times of all inputs
+			if (reader->getLabelFlag(TOFO) && getLabelFlag(TOFO)
+				&& (getInstantGNSStime(reader->firstObsWeek, reader->firstObsTOW) < getInstantGNSStime(firstObsWeek, firstObsTOW))) {
+				firstObsWeek = reader->firstObsWeek;
+				firstObsTOW = reader->firstObsTOW;
+			}
+			if (reader->getLabelFlag(TOLO) && getLabelFlag(TOLO)
+				&& (getInstantGNSStime(reader->lastObsWeek, reader->lastObsTOW) > getInstantGNSStime(lastObsWeek, lastObsTOW))) {
+				lastObsWeek = reader->lastObsWeek;
+				lastObsTOW = reader->lastObsTOW;
+			}
+		}
+		isObs.push_back(true);
+		//add to systems the ones in this input and their observable types, mapping them
+		sysMap.push_back(vector<int>());
+		obsMap.push_back(vector<vector<int> >());
+		for (vector<GNSSsystem>::iterator itsys = reader->systems.begin(); itsys != reader->systems.end(); itsys++) {
+			int sysIx = systemIndex(itsys->system);
+			if (sysIx < 0) {
+				systems.push_back(GNSSsystem(itsys->system, vector<string>()));
+				sysIx = systems.size() - 1;
+			}
+			sysMap.back().push_back(sysIx);
+			obsMap.back().push_back(vector<int>());
+			for (vector<OBSmeta>::iterator itobs = itsys->obsTypes.begin(); itobs != itsys->obsTypes.end(); itobs++) {
+				vector<OBSmeta> &obsTypes = systems[sysIx].obsTypes;
+				unsigned int obsIx;
+				for (obsIx = 0; (obsIx < obsTypes.size()) && (obsTypes[obsIx].code != itobs->code); obsIx++);
+				if (obsIx == obsTypes.size()) obsTypes.push_back(OBSmeta(itobs->id, itobs->sel, false));
+				else if (itobs->sel) obsTypes[obsIx].sel = true;
+				obsMap.back().back().push_back(obsIx);
+			}
+		}
+	}
+	//records describing satellites of the first input only are not printed
+	setLabelFlag(SATS, false);
+	setLabelFlag(PRNOBS, false);
+	try {
+		setFilter(selSat, selObs);
+		printObsHeader(output);
+		clearHeaderData();
+		//observables not printed are skipped when reading records, and the first epoch of each input is read
+		for (unsigned int i = 0; i < readers.size(); i++) {
+			if (!isObs[i]) continue;
+			for (unsigned int s = 0; s < readers[i]->systems.size(); s++) {
+				vector<int> &inObsIdx = readers[i]->systems[s].inObsIdx;
+				for (vector<int>::iterator itidx = inObsIdx.begin(); itidx != inObsIdx.end(); itidx++)
+					if ((*itidx >= 0) && !systems[sysMap[i][s]].obsTypes[obsMap[i][s][*itidx]].prt) *itidx = -1;
+			}
+			if (readers[i]->readMergeEpoch(inputs[i])) heap.push_back(make_pair(readers[i]->epochTimeTag, i));
+		}
+		make_heap(heap.begin(), heap.end(), greater<pair<double, int> >());
+		while (!heap.empty()) {
+			//take the earliest epoch, and append the ones at the same time in other inputs (except events)
+			epochObs.clear();
+			satInput.clear();
+			for (bool first = true; !heap.empty() && (heap.front().first == epochTimeTag || first); first = false) {
+				int i = heap.front().second;
+				RinexData* reader = readers[i];
+				if (first) {
+					epochWeek = reader->epochWeek;
+					epochTOW = reader->epochTOW;
+					epochTimeTag = reader->epochTimeTag;
+					epochClkOffset = reader->epochClkOffset;
+					epochFlag = reader->epochFlag;
+				} else if ((epochFlag > 1) || (reader->epochFlag > 1)) break;
+				pop_heap(heap.begin(), heap.end(), greater<pair<double, int> >());
+				heap.pop_back();
+				for (vector<SatObsData>::iterator it = reader->epochObs.begin(); it != reader->epochObs.end(); it++) {
+					pair<unsigned int, int> sat = make_pair((unsigned int) sysMap[i][it->sysIndex], it->satellite);
+					map<pair<unsigned int, int>, int>::iterator its = satInput.find(sat);
+					if (its == satInput.end()) its = satInput.insert(make_pair(sat, i)).first;
+					if (its->second != i) continue;
+					epochObs.push_back(*it);
+					epochObs.back().sysIndex = sat.first;
+					epochObs.back().obsTypeIndex = obsMap[i][it->sysIndex][it->obsTypeIndex];
+				}
+				if (reader->readMergeEpoch(inputs[i])) {
+					heap.push_back(make_pair(reader->epochTimeTag, i));
+					push_heap(heap.begin(), heap.end(), greater<pair<double, int> >());
+				}
+			}
+			printObsEpoch(output);
+			nEpochs++;
+		}
+	} catch (string error) {
+		for (unsigned int i = 0; i < readers.size(); i++) {
+			readers[i]->unmapInputFile();
+			readers[i]->closeInputDecoder();
+			delete readers[i];
+		}
+		throw;
+	}
+	for (unsigned int i = 0; i < readers.size(); i++) {
+		readers[i]->unmapInputFile();
+		readers[i]->closeInputDecoder();
+		delete readers[i];
+	}
+	return nEpochs;
+}
+
 //Class private methods
 //=====================
+/**printSatNavData prints the navigation data lines (epoch line and broadcast orbit lines) of the given satellite epoch.
+ *
+ * @param out the already open print file where RINEX epoch will be printed
+ * @param nav the satellite navigation data to print
+ * @throws error message string when epoch cannot be printed
+ */
+void RinexData::printSatNavData(FILE* out, SatNavData &nav) {
+    const string msgNavEpochPrn("Printed epoch for system, satellite=");
+	char timeBuffer[80];
+	int nBroadcastOrbits, nEphemeris;
+	const char* timeFormat;
+	const char* secondsFormat;
+	int lineStartSpaces;
+	//set version constants
+	switch (version) {
+	case V210:
+		timeFormat = "%y %m %d %H %M";
+		secondsFormat = " %4.1f";
+		lineStartSpaces = NAV_BOSTART_V2;
+		break;
+	case V304:
+		timeFormat = "%Y %m %d %H %M %S";
+		secondsFormat = "";
+		lineStartSpaces = NAV_BOSTART_V3;
+		break;
+	default:
+		throw msgVerTBD;
+	}
+    plog->finest(msgNavEpochPrn + string(1, nav.systemId) + msgComma + to_string(nav.satellite));
+    //print epoch first line
+    formatGPStime (timeBuffer, sizeof timeBuffer, timeFormat, secondsFormat, getWeekGNSSinstant(nav.navTimeTag), getTowGNSSinstant(nav.navTimeTag));
+    switch (version) {	//print satellite and epoch time
+        case V210:
+            fprintf(out, "%02d %s", nav.satellite, timeBuffer);
+            if (nav.systemId == 'R') {	//in V2 GLONASS tk to print is daily, not weekly
+                nav.broadcastOrbit[0][3] = fmod(nav.broadcastOrbit[0][3], 86400);
+            }
+            break;
+        case V304:
+            fprintf(out, "%1c%02d %s", nav.systemId, nav.satellite, timeBuffer);
+            break;
+        default:
+            break;
+    }
+    for (int i=1; i<BO_MAXCOLS; i++)	//add the Af0, Af1 & Af2 values
+        fprintf(out, "%19.12E", nav.broadcastOrbit[0][i]);
+    fprintf(out, "\n");
+    //print the rest of broadcast orbit data lines
+    switch (nav.systemId) {
+        //set values for nBroadcastOrbits and nEphemeris as stated in RINEX 3.04 doc
+        case 'G': nBroadcastOrbits = BO_MAXLINS_GPS; nEphemeris = BO_TOTEPHE_GPS; break;
+        case 'R': nBroadcastOrbits = BO_MAXLINS_GLO; nEphemeris = BO_TOTEPHE_GLO; break;
+        case 'E': nBroadcastOrbits = BO_MAXLINS_GAL; nEphemeris = BO_TOTEPHE_GAL; break;
+        case 'C': nBroadcastOrbits = BO_MAXLINS_BDS; nEphemeris = BO_TOTEPHE_BDS; break;
+        case 'S': nBroadcastOrbits = BO_MAXLINS_SBAS; nEphemeris = BO_TOTEPHE_SBAS; break;
+        default: throw msgSysUnk + string(1, nav.systemId);
+    }
+    for (int i = 1; (i < nBroadcastOrbits) && (nEphemeris > 0); i++) {
+        for (int j = 0; j < lineStartSpaces; j++) fputc(' ', out);
+        for (int j = 0; j < BO_MAXCOLS; j++) {
+            if (nEphemeris > 0) fprintf(out, "%19.12E", nav.broadcastOrbit[i][j]);
+            else fprintf(out, "%19c", ' ');
+            nEphemeris--;
+        }
+        fprintf(out, "\n");
+    }
+}
+
+/**printSelSatNavData prints the navigation data of the given satellite epoch if the system-satellite is selected.
+ *
+ * @param out the already open print file where RINEX epoch will be printed
+ * @param nav the satellite navigation data to print
+ * @throws error message string when epoch cannot be printed
+ */
+void RinexData::printSelSatNavData(FILE* out, SatNavData &nav) {
+    const string msgNavEpochIgn("Ignored epoch for system, satellite=");
+	if (isSatSelected(systemIndex(nav.systemId), nav.satellite)) {
+		printSatNavData(out, nav);
+	} else {
+		plog->finest(msgNavEpochIgn + string(1, nav.systemId) + msgComma + to_string(nav.satellite));
+	}
+}
+
+/**scaleNavMantissas moves the navigation data saved as mantissas to the storage of scaled navigation data, applying their scale factors.
+ */
+void RinexData::scaleNavMantissas() {
+	for (vector<SatNavMantissa>::iterator itm = epochNavMant.begin(); itm != epochNavMant.end(); itm++) {
+		epochNav.push_back(itm->toSatNavData());
+	}
+	epochNavMant.clear();
+	epochNavMantKeys.clear();
+}
+
+/**storeEphemeris stores the given navigation data into the ephemeris store, indexed by system-satellite and time tag.
+ * Data already stored for the same satellite and time tag are replaced.
+ *
+ * @param nav the satellite navigation data to store
+ */
+void RinexData::storeEphemeris(const SatNavData &nav) {
+	map<double, SatNavData> &satEph = ephStore[make_pair(nav.systemId, nav.satellite)];
+	map<double, SatNavData>::iterator it = satEph.find(nav.navTimeTag);
+	if (it != satEph.end()) it->second = nav;
+	else satEph.insert(make_pair(nav.navTimeTag, nav));
+}
+
+/**flushNavStream prints to the streaming file, in time order, the navigation epochs stored having a time tag older than the given limit.
+ * Epochs saved scaled and the ones saved as mantissas are merged from their heaps, scaling mantissas only when printed.
+ * Printed epochs (and the ones of non selected systems-satellites) are removed from the storage.
+ *
+ * @param limit the time tag limit: epochs older than it are printed
+ * @throws error message string when epoch cannot be printed
+ */
+void RinexData::flushNavStream(double limit) {
+	bool navDue, mantDue;
+	for (;;) {
+		navDue = !epochNav.empty() && epochNav.front().navTimeTag < limit;
+		mantDue = !epochNavMant.empty() && epochNavMant.front().navTimeTag < limit;
+		if (mantDue && (!navDue || isMantBefore(epochNavMant.front(), epochNav.front()))) {
+			pop_heap(epochNavMant.begin(), epochNavMant.end(), isNavMantLater);
+			SatNavData nav = epochNavMant.back().toSatNavData();
+			printSelSatNavData(navStreamOut, nav);
+			navStreamPrinted = nav.navTimeTag;
+			if (navStreamFirst == 0.0 || nav.navTimeTag < navStreamFirst) navStreamFirst = nav.navTimeTag;
+			epochNavMantKeys.erase(NavMantKey(nav.systemId, nav.satellite, epochNavMant.back().broadcastOrbitM));
+			epochNavMant.pop_back();
+		} else if (navDue) {
+			pop_heap(epochNav.begin(), epochNav.end(), isNavLater);
+			SatNavData &nav = epochNav.back();
+			printSelSatNavData(navStreamOut, nav);
+			navStreamPrinted = nav.navTimeTag;
+			if (navStreamFirst == 0.0 || nav.navTimeTag < navStreamFirst) navStreamFirst = nav.navTimeTag;
+			epochNav.pop_back();
+		} else break;
+	}
+}
+
+/**isNavLater compares navigation data to arrange them in a min-heap by time tag, system and satellite.
+ *
+ * @param a the first navigation data to compare
+ * @param b the second navigation data to compare
+ * @return true if a is later than b
+ */
+bool RinexData::isNavLater(const SatNavData &a, const SatNavData &b) {
+	return b < a;
+}
+
+/**isNavMantLater compares navigation data saved as mantissas to arrange them in a min-heap by time tag, system and satellite.
+ *
+ * @param a the first navigation data to compare
+ * @param b the second navigation data to compare
+ * @return true if a is later than b
+ */
+bool RinexData::isNavMantLater(const SatNavMantissa &a, const SatNavMantissa &b) {
+	return b < a;
+}
+
+/**isMantBefore compares navigation data saved as mantissas with scaled ones, to print them in time tag, system and satellite order.
+ *
+ * @param m the navigation data saved as mantissas
+ * @param nav the scaled navigation data
+ * @return true if m shall be printed before nav
+ */
+bool RinexData::isMantBefore(const SatNavMantissa &m, const SatNavData &nav) {
+	if (m.navTimeTag != nav.navTimeTag) return m.navTimeTag < nav.navTimeTag;
+	if (m.systemId != nav.systemId) return m.systemId < nav.systemId;
+	return m.satellite < nav.satellite;
+}
+
+/**hashPoly computes at compile time or at run time the polynomial hash (base 31) of the label characters.
+ *
+ * @param label the label characters
+ * @param len the number of characters of the label
+ * @param h the hash of the characters preceding label
+ * @return the hash value
+ */
+constexpr uint32_t RinexData::hashPoly(const char *label, int len, uint32_t h) {
+	return len <= 0 ? h : hashPoly(label + 1, len - 1, h * 31 + (unsigned char) *label);
+}
+
+/**hashLabel computes the hash of a label value, used to index the labelHash table.
+ * It is the polynomial hash (base 31) of the label characters, scrambled with a multiplicative hash to get its most
+ * significant bits.
+ *
+ * @param label the label characters
+ * @param len the number of characters of the label
+ * @return the hash value, in the range 0 to LABEL_HASHSIZE - 1
+ */
+constexpr unsigned int RinexData::hashLabel(const char *label, int len) {
+	return (uint32_t) (hashPoly(label, 0 < len ? len : 0, 0) * LABEL_HASHMULT) >> 24;
+}
+
+//the definition of each RINEX label, with the hash of its value computed at compile time. Order is relevant.
+#define LABEL_KEY(id, val, ver, type) {id, val, ver, type, hashLabel(val, sizeof(val) - 1)}
+constexpr RinexData::LABELkey RinexData::labelTable[] = {
+	LABEL_KEY(VERSION,	"RINEX VERSION / TYPE",	VALL, OBSOBL + NAVOBL),
+	LABEL_KEY(RUNBY,		"PGM / RUN BY / DATE",	VALL, OBSOBL + NAVOBL),
+	LABEL_KEY(COMM,		"COMMENT",				VALL, OBSOPT + NAVOPT),
+	LABEL_KEY(MRKNAME,	"MARKER NAME",			VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(MRKNUMBER,	"MARKER NUMBER",		VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(MRKTYPE,	"MARKER TYPE",			V304, OBSOBL + NAVNAP),
+	LABEL_KEY(AGENCY,	"OBSERVER / AGENCY",	VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(RECEIVER,	"REC # / TYPE / VERS",	VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(ANTTYPE,	"ANT # / TYPE",			VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(APPXYZ,	"APPROX POSITION XYZ",	VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(ANTHEN,	"ANTENNA: DELTA H/E/N",	VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(ANTXYZ,	"ANTENNA: DELTA X/Y/Z",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(ANTPHC,	"ANTENNA: PHASECENTER",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(ANTBS,		"ANTENNA: B.SIGHT XYZ",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(ANTZDAZI,	"ANTENNA: ZERODIR AZI",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(ANTZDXYZ,	"ANTENNA: ZERODIR XYZ",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(COFM,		"CENTER OF MASS XYZ",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(WVLEN,		"WAVELENGTH FACT L1/2",	V210, OBSOBL + NAVNAP),
+	LABEL_KEY(TOBS,		"# / TYPES OF OBSERV",	V210, OBSOBL + NAVNAP),
+	LABEL_KEY(SYS,		"SYS / # / OBS TYPES",	V304, OBSOBL + NAVNAP),
+	LABEL_KEY(SIGU,		"SIGNAL STRENGTH UNIT",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(INT,		"INTERVAL",				VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(TOFO,		"TIME OF FIRST OBS",	VALL, OBSOBL + NAVNAP),
+	LABEL_KEY(TOLO,		"TIME OF LAST OBS",		VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(CLKOFFS,	"RCV CLOCK OFFS APPL",	VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(DCBS,		"SYS / DCBS APPLIED",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(PCVS,		"SYS / PCVS APPLIED",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(SCALE,		"SYS / SCALE FACTOR",	V304, OBSOPT + NAVNAP),
+	LABEL_KEY(PHSH,		"SYS / PHASE SHIFTS",	V304, OBSOBL + NAVNAP),
+	LABEL_KEY(GLSLT,		"GLONASS SLOT / FRQ #",	V304, OBSOBL + NAVNAP),
+	LABEL_KEY(GLPHS,     "GLONASS COD/PHS/BIS",  V304, OBSOBL + NAVNAP),
+	LABEL_KEY(SATS,		"# OF SATELLITES",		VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(PRNOBS,	"PRN / # OF OBS",		VALL, OBSOPT + NAVNAP),
+	LABEL_KEY(IONA,		"ION ALPHA",			V210, OBSNAP + NAVOPT),
+	LABEL_KEY(IONB,		"ION BETA",				V210, OBSNAP + NAVOPT),
+	LABEL_KEY(IONC,		"IONOSPHERIC CORR",		V304, OBSNAP + NAVOPT),
+	LABEL_KEY(DUTC,		"DELTA-UTC: A0,A1,T,W",	V210, OBSNAP + NAVOPT),
+	LABEL_KEY(CORRT,		"CORR TO SYSTEM TIME",	V210, OBSNAP + NAVOPT),
+	LABEL_KEY(GEOT,		"D-UTC A0,A1,T,W,S,U",	V210, OBSNAP + NAVOPT),
+	LABEL_KEY(TIMC,		"TIME SYSTEM CORR",		V304, OBSNAP + NAVOPT),
+	LABEL_KEY(LEAP,		"LEAP SECONDS",			VALL, OBSOPT + NAVOPT),
+	LABEL_KEY(EOH,		"END OF HEADER",		VALL, OBSOBL + NAVOBL),
+
+	LABEL_KEY(IONC_GAL,   "GAL ",	VALL, NAP),
+	LABEL_KEY(IONC_GPSA,  "GPSA",	VALL, NAP),
+	LABEL_KEY(IONC_GPSB,  "GPSB",	VALL, NAP),
+	LABEL_KEY(IONC_QZSA,  "QZSA",	VALL, NAP),
+	LABEL_KEY(IONC_QZSB,  "QZSB",	VALL, NAP),
+	LABEL_KEY(IONC_BDSA,  "BDSA",	VALL, NAP),
+	LABEL_KEY(IONC_BDSB,  "BDSB",	VALL, NAP),
+	LABEL_KEY(IONC_IRNA,  "IRNA",	VALL, NAP),
+	LABEL_KEY(IONC_IRNB,  "IRNB",	VALL, NAP),
+	LABEL_KEY(TIMC_GPUT,  "GPUT",	VALL, NAP),
+	LABEL_KEY(TIMC_GLUT,  "GLUT",	VALL, NAP),
+	LABEL_KEY(TIMC_GAUT,  "GAUT",	VALL, NAP),
+	LABEL_KEY(TIMC_BDUT,  "BDUT",	VALL, NAP),
+	LABEL_KEY(TIMC_BDGP,  "BDGP",	VALL, NAP),
+	LABEL_KEY(TIMC_QZUT,  "QZUT",	VALL, NAP),
+	LABEL_KEY(TIMC_IRUT,  "IRUT",	VALL, NAP),
+	LABEL_KEY(TIMC_SBUT,  "SBUT",	VALL, NAP),
+	LABEL_KEY(TIMC_GLGP,  "GLGP",	VALL, NAP),
+	LABEL_KEY(TIMC_GAGP,  "GAGP",	VALL, NAP),
+	LABEL_KEY(TIMC_QZGP,  "QZGP",	VALL, NAP),
+	LABEL_KEY(TIMC_IRGP,  "IRGP",	VALL, NAP),
+
+	LABEL_KEY(NOLABEL,	"No label detected",	VALL, NAP),
+	LABEL_KEY(DONTMATCH,	"Incorrect label for this RINEX version", VALL, NAP),
+	LABEL_KEY(LASTONE,	"Last item",	VALL, NAP)
+};
+
+/**labelWithHash finds at compile time the identifier of the label having the given hash, to fill the labelHash table.
+ * Only labels which can be found in RINEX header lines and correction types are considered.
+ *
+ * @param h the hash value
+ * @param i the index in labelTable where the search starts
+ * @return the label identifier, or NOLABEL if no label from the given index has the given hash
+ */
+constexpr RinexData::RINEXlabel RinexData::labelWithHash(unsigned int h, unsigned int i) {
+	return i >= sizeof labelTable / sizeof labelTable[0] ? NOLABEL
+		: (labelTable[i].hash == h && labelTable[i].labelID != NOLABEL && labelTable[i].labelID < INFILEVER) ? labelTable[i].labelID
+		: labelWithHash(h, i + 1);
+}
+
+/**hasUniqueHashes checks at compile time that labels in labelTable have a hash different from the ones following them.
+ *
+ * @param i the index in labelTable of the first label to check
+ * @return true if labels from the given index on have unique hashes, false otherwise
+ */
+constexpr bool RinexData::hasUniqueHashes(unsigned int i) {
+	return i >= sizeof labelTable / sizeof labelTable[0]
+		|| ((labelWithHash(labelTable[i].hash, i) != labelTable[i].labelID || labelWithHash(labelTable[i].hash, i + 1) == NOLABEL)
+			&& hasUniqueHashes(i + 1));
+}
+
+//the table to recognize header labels and correction types by their hash, filled at compile time
+#define LABEL_HASH4(h) labelWithHash(h, 0), labelWithHash(h + 1, 0), labelWithHash(h + 2, 0), labelWithHash(h + 3, 0)
+#define LABEL_HASH16(h) LABEL_HASH4(h), LABEL_HASH4(h + 4), LABEL_HASH4(h + 8), LABEL_HASH4(h + 12)
+#define LABEL_HASH64(h) LABEL_HASH16(h), LABEL_HASH16(h + 16), LABEL_HASH16(h + 32), LABEL_HASH16(h + 48)
+constexpr RinexData::RINEXlabel RinexData::labelHash[LABEL_HASHSIZE] = {
+	LABEL_HASH64(0), LABEL_HASH64(64), LABEL_HASH64(128), LABEL_HASH64(192)
+};
+
 /**setDefValues sets default values to optional RINEX data members, generation parameters, and
  * GPS navigation data constans (like scale factors and data).
  *
@@ -2390,6 +3386,17 @@ void RinexData::setDefValues(RINEXversion v, Logger *p) {
 	epochWeek = 0;
 	epochTOW = epochTimeTag = epochClkOffset = 0.0;
 	epochFlag = 0;
+	//Navigation epochs streaming
+	navStreamOut = NULL;
+	navStreamWindow = NAV_STREAMWINDOW;
+	navStreamNewest = navStreamPrinted = navStreamFirst = 0.0;
+	ephStoreEnabled = false;
+	//Input file mapping and parallel reading
+	mapFile = NULL;
+	mapData = NULL;
+	mapSize = mapPos = 0;
+	obsReadThreads = 1;
+	inDecoder = NULL;
 	//LEAP SECONDS
 	//1st element in vector allways GPS, and default values set to 18 secs as per 2019
     leapSecs.push_back(LEAPsecs(18,0,0,0,'G'));
@@ -2403,76 +3410,13 @@ void RinexData::setDefValues(RINEXversion v, Logger *p) {
 	sysDescript.push_back(SYSdescript('I', "IRN", ": IRNSS"));
 	sysDescript.push_back(SYSdescript('S', "GPS", ": SBAS payload"));
     sysDescript.push_back(SYSdescript(' ', "GPS", ": GPS"));
-	//fill vector with label definitions. Order is relevant.
-	labelDef.push_back(LABELdata(VERSION,	"RINEX VERSION / TYPE",	VALL, OBSOBL + NAVOBL));
-	labelDef.push_back(LABELdata(RUNBY,		"PGM / RUN BY / DATE",	VALL, OBSOBL + NAVOBL));
-	labelDef.push_back(LABELdata(COMM,		"COMMENT",				VALL, OBSOPT + NAVOPT));
-	labelDef.push_back(LABELdata(MRKNAME,	"MARKER NAME",			VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(MRKNUMBER,	"MARKER NUMBER",		VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(MRKTYPE,	"MARKER TYPE",			V304, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(AGENCY,	"OBSERVER / AGENCY",	VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(RECEIVER,	"REC # / TYPE / VERS",	VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(ANTTYPE,	"ANT # / TYPE",			VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(APPXYZ,	"APPROX POSITION XYZ",	VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(ANTHEN,	"ANTENNA: DELTA H/E/N",	VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(ANTXYZ,	"ANTENNA: DELTA X/Y/Z",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(ANTPHC,	"ANTENNA: PHASECENTER",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(ANTBS,		"ANTENNA: B.SIGHT XYZ",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(ANTZDAZI,	"ANTENNA: ZERODIR AZI",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(ANTZDXYZ,	"ANTENNA: ZERODIR XYZ",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(COFM,		"CENTER OF MASS XYZ",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(WVLEN,		"WAVELENGTH FACT L1/2",	V210, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(TOBS,		"# / TYPES OF OBSERV",	V210, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(SYS,		"SYS / # / OBS TYPES",	V304, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(SIGU,		"SIGNAL STRENGTH UNIT",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(INT,		"INTERVAL",				VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(TOFO,		"TIME OF FIRST OBS",	VALL, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(TOLO,		"TIME OF LAST OBS",		VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(CLKOFFS,	"RCV CLOCK OFFS APPL",	VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(DCBS,		"SYS / DCBS APPLIED",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(PCVS,		"SYS / PCVS APPLIED",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(SCALE,		"SYS / SCALE FACTOR",	V304, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(PHSH,		"SYS / PHASE SHIFTS",	V304, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(GLSLT,		"GLONASS SLOT / FRQ #",	V304, OBSOBL + NAVNAP));
-    labelDef.push_back(LABELdata(GLPHS,     "GLONASS COD/PHS/BIS",  V304, OBSOBL + NAVNAP));
-	labelDef.push_back(LABELdata(SATS,		"# OF SATELLITES",		VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(PRNOBS,	"PRN / # OF OBS",		VALL, OBSOPT + NAVNAP));
-	labelDef.push_back(LABELdata(IONA,		"ION ALPHA",			V210, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(IONB,		"ION BETA",				V210, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(IONC,		"IONOSPHERIC CORR",		V304, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(DUTC,		"DELTA-UTC: A0,A1,T,W",	V210, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(CORRT,		"CORR TO SYSTEM TIME",	V210, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(GEOT,		"D-UTC A0,A1,T,W,S,U",	V210, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(TIMC,		"TIME SYSTEM CORR",		V304, OBSNAP + NAVOPT));
-	labelDef.push_back(LABELdata(LEAP,		"LEAP SECONDS",			VALL, OBSOPT + NAVOPT));
-	labelDef.push_back(LABELdata(EOH,		"END OF HEADER",		VALL, OBSOBL + NAVOBL));
-
-	labelDef.push_back(LABELdata(IONC_GAL,   "GAL ",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_GPSA,  "GPSA",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_GPSB,  "GPSB",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_QZSA,  "QZSA",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_QZSB,  "QZSB",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_BDSA,  "BDSA",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_BDSB,  "BDSB",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_IRNA,  "IRNA",	VALL, NAP));
-	labelDef.push_back(LABELdata(IONC_IRNB,  "IRNB",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_GPUT,  "GPUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_GLUT,  "GLUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_GAUT,  "GAUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_BDUT,  "BDUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_BDGP,  "BDGP",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_QZUT,  "QZUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_IRUT,  "IRUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_SBUT,  "SBUT",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_GLGP,  "GLGP",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_GAGP,  "GAGP",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_QZGP,  "QZGP",	VALL, NAP));
-	labelDef.push_back(LABELdata(TIMC_IRGP,  "IRGP",	VALL, NAP));
-
-	labelDef.push_back(LABELdata(NOLABEL,	"No label detected",	VALL, NAP));
-	labelDef.push_back(LABELdata(DONTMATCH,	"Incorrect label for this RINEX version", VALL, NAP));
-	labelDef.push_back(LABELdata(LASTONE,	"Last item",	VALL, NAP));
+	//fill vector with label definitions, in the order given in labelTable
+	for (unsigned int i = 0; i < sizeof labelTable / sizeof labelTable[0]; i++)
+		labelDef.push_back(LABELdata(labelTable[i].labelID, labelTable[i].labelVal, labelTable[i].ver, labelTable[i].type));
 	labelIdIdx = 0;
+	//set the position of each label in labelDef (it changes when comments are inserted)
+	for (int i = 0; i <= LASTONE; i++) labelPos[i] = LABEL_NOPOS;
+	for (unsigned int i = 0; i < labelDef.size(); i++) labelPos[labelDef[i].labelID] = i;
     for (numberV2ObsTypes = 0; !v3obsTypes[numberV2ObsTypes].empty(); numberV2ObsTypes++);
 }
 
@@ -2587,7 +3531,7 @@ string RinexData::fmtRINEXv2name(string designator, int week, double tow) {
  * @return the RINEX observation file name in the standard format (f.e.; PRFXdddamm.yyO)
  */
 string RinexData::fmtRINEXv3name(string designator, int week, double tow, string country) {
-	char buffer[50], startTime[20];
+	char buffer[80], startTime[20];
 	//set value for field <SITE/STATION/MONUMENT/RECEIVER/COUNTRY/> (XXXXMRCCC) if not given
 	if (designator.length() != 9) {
 		strcpy(buffer, ((designator + "------").substr(0, 6) + (country + "---").substr(0, 3)).c_str());	//set  buffer to XXXX--CCC
@@ -2662,13 +3606,12 @@ string RinexData::fmtRINEXv3name(string designator, int week, double tow, string
  * @param flagVal is the value to set (by default true)
  */
 void RinexData::setLabelFlag(RINEXlabel label, bool flagVal) {
-	lastRecordSet = labelDef.end();
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if(it->labelID == label) {
-			it->hasData = flagVal;
-			lastRecordSet = it;
-			return;
-		}
+	if (labelPos[label] == LABEL_NOPOS) {
+		lastRecordSet = labelDef.end();
+		return;
+	}
+	lastRecordSet = labelDef.begin() + labelPos[label];
+	lastRecordSet->hasData = flagVal;
 }
 
 /**sgetLabelFlag gets the hasData flag value of the given label
@@ -2677,40 +3620,61 @@ void RinexData::setLabelFlag(RINEXlabel label, bool flagVal) {
  * @return the value stored in the hasData flag for this labelId, or false if the label does not exist
  */
 bool RinexData::getLabelFlag(RINEXlabel label) {
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if(it->labelID == label) return it->hasData;
-	return false;
+	if (labelPos[label] == LABEL_NOPOS) return false;
+	return labelDef[labelPos[label]].hasData;
 }
 
 /**checkLabel checks if the RINEX line passed ends with a correct RINEX header label for the input file version
  * Note that RINEX header lines contain label in columns 61 to 80 (index 60 to 79).
+ * The label is recognized using the hash of the label field (without trailing blanks or end of line), which is
+ * unique for each label.
  *
  * @param line is a null terminated char sequence containing the RINEX line to analyze
  * @return the RINEX label identification, NOLABEL has not a valid RINEX lable, or DONTMATCH if the label is not valid for the stated RINEX version 
  */
 RinexData::RINEXlabel RinexData::checkLabel(char *line) {
+	static_assert(hasUniqueHashes(0), "LABEL_HASHMULT does not give a perfect hash for the labels defined");
 	//label shall be in columns 61 to 80 (index 60 to 79)
 	if (strlen(line) < 61) return NOLABEL;
 	char *label = &line[60];
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if (strncmp(label, it->labelVal, strlen(it->labelVal)) == 0) {
-			if ((it->ver == VALL) || (it->ver == inFileVer)) return it->labelID;
-			else return DONTMATCH;
-		}
-	return NOLABEL;
+	int len = 0;
+	for (int i = 0; i < 20 && label[i] != '\0' && label[i] != '\n' && label[i] != '\r'; i++)
+		if (label[i] != ' ') len = i + 1;
+	RINEXlabel id = labelHash[hashLabel(label, len)];
+	if (id == NOLABEL) return NOLABEL;
+	LABELdata &ld = labelDef[labelPos[id]];
+	if (strncmp(label, ld.labelVal, strlen(ld.labelVal)) != 0) return NOLABEL;
+	if ((ld.ver == VALL) || (ld.ver == inFileVer)) return id;
+	return DONTMATCH;
 }
 
-/**findLabelId finds for the label passed the corresponding identifier
+/**findLabelId finds for the correction type passed the corresponding label identifier.
+ * Correction types (4 characters) are recognized using their hash.
  *
- * @param line is a null terminated char sequence containing the RINEX label to identify
+ * @param line is a null terminated char sequence starting with the correction type to identify
  * @return the RINEX label identification, NOLABEL has not a valid RINEX lable,
  */
 RinexData::RINEXlabel RinexData::findLabelId(char *label) {
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if (strncmp(label, it->labelVal, strlen(it->labelVal)) == 0) return it->labelID;
+	if (strlen(label) < 4) return NOLABEL;
+	RINEXlabel id = labelHash[hashLabel(label, 4)];
+	if (id != NOLABEL && strncmp(label, labelDef[labelPos[id]].labelVal, strlen(labelDef[labelPos[id]].labelVal)) == 0) return id;
 	return NOLABEL;
 }
 
+/**insertComment inserts a COMMENT record in labelDef, at the given position, updating the positions of labels.
+ *
+ * @param pos the position where the comment record will be inserted
+ * @param comment the comment contents
+ * @return the position of the inserted comment record
+ */
+vector<RinexData::LABELdata>::iterator RinexData::insertComment(vector<LABELdata>::iterator pos, const string &comment) {
+	unsigned int idx = pos - labelDef.begin();
+	for (int i = 0; i <= LASTONE; i++)
+		if (labelPos[i] != LABEL_NOPOS && labelPos[i] >= idx) labelPos[i]++;
+	if (labelPos[COMM] > idx) labelPos[COMM] = idx;
+	return labelDef.insert(pos, LABELdata(comment));
+}
+
 /**valueLabel gives the sting value for the RINEXlabel passed
  * 
  * @param labelId is the label identifier
@@ -2718,12 +3682,9 @@ RinexData::RINEXlabel RinexData::findLabelId(char *label) {
  */
 string RinexData::valueLabel(RINEXlabel labelId, string toAppend) {
     const string msgErrUnkLabel("Unknown label identifier");
-	for (vector<LABELdata>::iterator it = labelDef.begin() ; it != labelDef.end(); ++it)
-		if(it->labelID == labelId) {
-			if (toAppend.empty()) return string(it->labelVal);
-			else return string(it->labelVal) + msgColon + toAppend;
-		}
-	return msgErrUnkLabel;
+	if (labelPos[labelId] == LABEL_NOPOS) return msgErrUnkLabel;
+	if (toAppend.empty()) return string(labelDef[labelPos[labelId]].labelVal);
+	else return string(labelDef[labelPos[labelId]].labelVal) + msgColon + toAppend;
 }
 
 /**readV2ObsEpoch reads from the RINEX version 2.1 observation file data lines of an epoch.
@@ -2748,7 +3709,7 @@ int RinexData::readV2ObsEpoch(FILE* input) {
     const string msgEOFinCont(" EOF in epoch cont. line.");
     const string msgUnexpEOF2("Unexpected EOF in observation continuation record");
 	char lineBuffer[100];
-	int posPRN, nObs, posObs;
+	int posPRN, nObs, posObs, obsIdx;
 	unsigned int sysInEpoch[64];
 	int prnInEpoch[64];
 	double valObs;
@@ -2790,8 +3751,7 @@ int RinexData::readV2ObsEpoch(FILE* input) {
 			badEpoch = true;
 			msgPrfx += msgWrongNsats;
 		}
-		if (isBlank(lineBuffer + 68, 12)) epochClkOffset = 0.0;
-		else epochClkOffset = stod(string(lineBuffer + 68, 12));
+		if (!getFixedDouble(lineBuffer + 68, 12, epochClkOffset)) epochClkOffset = 0.0;
 		//get satellites from epoch 1st line and eventual continuation lines (max 12 sat id in each one)
 		for (i=0; i<nSatsEpoch; i+=12) {
 			for(j=0, posPRN = 32; j<12 && i+j<nSatsEpoch; j++, posPRN += 3) {
@@ -2824,20 +3784,26 @@ int RinexData::readV2ObsEpoch(FILE* input) {
 				plog->warning(msgPrfx + msgUnexpObsEOF);
 				return 3;
 			}
-			nObs = systems[sysInEpoch[i]].obsTypes.size();
+			//observables in the record are in the input file order. inObsIdx gives their position in obsTypes
+			const vector<int> &inObsIdx = systems[sysInEpoch[i]].inObsIdx;
+			nObs = inObsIdx.size();
 			//for each observable type in this satellite extracts its data from the record
 			//each record can have data for 5 observable types (or less). Continuation records are used when needed 
 			for (j=0; j<nObs; j+=5) {
 				for (k=0, posObs = 0; k<5 && j+k<nObs; k++, posObs += 16) {
+					if ((obsIdx = inObsIdx[j+k]) < 0) continue;	//observable not stored
 					if (isBlank(lineBuffer + posObs, 14)) {	//empty observable
-						epochObs.push_back(SatObsData(epochTimeTag, sysInEpoch[i], prnInEpoch[i], j+k, 0.0, 0, 0));
+						epochObs.push_back(SatObsData(epochTimeTag, sysInEpoch[i], prnInEpoch[i], obsIdx, 0.0, 0, 0));
 					} else {
-						valObs = stod(string(lineBuffer+posObs, 14));
-						if (lineBuffer[posObs+14] == ' ') lliObs = 0;
-						else lliObs = (int) (lineBuffer[posObs+14] - '0');
-						if (lineBuffer[posObs+15] == ' ') strgObs = 0;
-						else strgObs = (int) (lineBuffer[posObs+15] - '0');
-						epochObs.push_back(SatObsData(epochTimeTag, sysInEpoch[i], prnInEpoch[i], j+k, valObs, lliObs, strgObs ));
+						if (!getFixedDouble(lineBuffer+posObs, 14, valObs)
+								|| !getFixedDigit(lineBuffer[posObs+14], lliObs) || !getFixedDigit(lineBuffer[posObs+15], strgObs)) {
+							//wrong data: values are considered 0
+							valObs = 0.0;
+							lliObs = strgObs = 0;
+							badEpoch = true;
+							msgPrfx += msgWrongObs;
+						}
+						epochObs.push_back(SatObsData(epochTimeTag, sysInEpoch[i], prnInEpoch[i], obsIdx, valObs, lliObs, strgObs ));
 					}
 				}
 				if (j+k < nObs) {
@@ -2848,6 +3814,10 @@ int RinexData::readV2ObsEpoch(FILE* input) {
 				}
 			}
 		}
+		if (badEpoch) {
+			plog->warning(msgPrfx);
+			return 3;
+		}
 		plog->fine(msgPrfx);
 		return 1;
 	case 2:
@@ -2879,8 +3849,9 @@ int RinexData::readV2ObsEpoch(FILE* input) {
  */
 int RinexData::readV3ObsEpoch(FILE* input) {
     const string msgWrongStart(" Wrong start of epoch. Line skip");
-	char lineBuffer[1300]; //enough big to allocate 3 + 2 + 19 x 4 measurements x 16 chars= 1221
-	int nObs, posObs;
+	char lineBuffer[RINEX_MAXLINE];
+	RinexLine obsLine;	//the observation record of each satellite
+	int nObs, posObs, obsIdx;
 	unsigned int sysIdx;
 	int prnSat;
 	double valObs;
@@ -2924,30 +3895,36 @@ int RinexData::readV3ObsEpoch(FILE* input) {
 			plog->warning(msgPrfx);
 			return 4;
 		}
-		if (isBlank(lineBuffer + 41, 15)) epochClkOffset = 0.0;
-		else epochClkOffset = stod(string(lineBuffer + 41, 15));
-		//get the observation record for each satellite and extract data
+		if (!getFixedDouble(lineBuffer + 41, 15, epochClkOffset)) epochClkOffset = 0.0;
+		//get the observation record for each satellite and extract data (directly from the line read, without copying it)
 		for (i = 0; i < nSatsEpoch; i++) {
-			if (readRinexRecord(lineBuffer, sizeof lineBuffer, input)) {
+			if (readRinexLine(obsLine, input)) {
 				plog->warning(msgPrfx + msgUnexpObsEOF);
 				return 3;
 			}
 			try {
-				sysIdx = getSysIndex(lineBuffer[0]);
-				if (sscanf(lineBuffer+1, "%2d", &prnSat) == 1) {
-					//for each observable type in the system of this satellite
-					nObs = systems[sysIdx].obsTypes.size();
+				sysIdx = getSysIndex(obsLine.at(0));
+				if ((obsLine.at(2) >= '0') && (obsLine.at(2) <= '9')
+					&& ((obsLine.at(1) == ' ') || ((obsLine.at(1) >= '0') && (obsLine.at(1) <= '9')))) {
+					prnSat = (obsLine.at(1) == ' ' ? 0 : (obsLine.at(1) - '0') * 10) + obsLine.at(2) - '0';
+					//for each observable type in the system of this satellite (in the input file order)
+					const vector<int> &inObsIdx = systems[sysIdx].inObsIdx;
+					nObs = inObsIdx.size();
 					for (j = 0, posObs = 3; j < nObs; j++, posObs += 16) {
-						if (isBlank(lineBuffer + posObs, 14)) {
+						if ((obsIdx = inObsIdx[j]) < 0) continue;	//observable not stored
+						if (obsLine.isBlank(posObs, 14)) {
 							//empty observable: values are considered 0
-							epochObs.push_back(SatObsData(epochTimeTag, sysIdx, prnSat, j, 0.0, 0, 0));
+							epochObs.push_back(SatObsData(epochTimeTag, sysIdx, prnSat, obsIdx, 0.0, 0, 0));
 						} else {
-							valObs = stod(string(lineBuffer+posObs, 14));
-							if (lineBuffer[posObs+14] == ' ') lliObs = 0;
-							else lliObs = stoi(string(lineBuffer+posObs+14, 1));
-							if (lineBuffer[posObs+15] == ' ') strgObs = 0;
-							else strgObs = stoi(string(lineBuffer+posObs+15, 1));
-							epochObs.push_back(SatObsData(epochTimeTag, sysIdx, prnSat, j,  valObs, lliObs, strgObs));
+							if (!getFixedDouble(obsLine.data + posObs, obsLine.width(posObs, 14), valObs)
+									|| !getFixedDigit(obsLine.at(posObs+14), lliObs) || !getFixedDigit(obsLine.at(posObs+15), strgObs)) {
+								//wrong data: values are considered 0
+								valObs = 0.0;
+								lliObs = strgObs = 0;
+								badEpoch = true;
+								msgPrfx += msgWrongObs;
+							}
+							epochObs.push_back(SatObsData(epochTimeTag, sysIdx, prnSat, obsIdx, valObs, lliObs, strgObs));
 						}
 					}
 				} else {
@@ -3072,14 +4049,11 @@ void RinexData::printHdLineData(FILE* out, vector<LABELdata>::iterator lbIter) {
  		}
 
     const string msgUnkSys("Unknown satellite system=");
-	unsigned int i, j, k, n;
+	unsigned int i, j, k, n = 0;
 	char timeBuffer[80], cnsId;
 	string aStr;
 	vector<string> aVectorStr;
 	vector<bool> aVectorBool;
-	int year, month, day;
-
-    double instant;
 
 	RINEXlabel labelId = lbIter->labelID;
 	switch (labelId) {
@@ -3162,10 +4136,14 @@ void RinexData::printHdLineData(FILE* out, vector<LABELdata>::iterator lbIter) {
         if (systems.empty()) return;
 		//Note that only V210 obsTypes are taken into account
         //copy into aVectorStr the V210 obsTypes identifiers to be printed
-        //note that all systems have the same observables to print
+        //note that all systems having observables to print have the same ones
         aVectorStr.clear();
         for (i = 0; i < numberV2ObsTypes; i++)
-            if (systems[0].obsTypes[i].prt) aVectorStr.push_back(v2obsTypes[i]);
+            for (vector<GNSSsystem>::iterator itsys = systems.begin(); itsys != systems.end(); itsys++)
+                if (itsys->obsTypes[i].prt) {
+                    aVectorStr.push_back(v2obsTypes[i]);
+                    break;
+                }
         PRINT_SYSREC(aVectorStr,
     	        9,
         	    fprintf(out, "%6u", k),
@@ -3265,8 +4243,8 @@ void RinexData::printHdLineData(FILE* out, vector<LABELdata>::iterator lbIter) {
 	case GLPHS:	//"GLONASS COD/PHS/BIS"
 		PRINT_SYSREC(gloPhsBias,
 					 4,
-					 fprintf(out, ""),
-					 fprintf(out, ""),
+					 0,
+					 0,
 					 fprintf(out, " %-3.3s %8.3lf", gloPhsBias[j].obsCode.c_str(), gloPhsBias[j].obsCodePhaseBias),
 					 fprintf(out, "%13c", ' ') )
 		return;
@@ -3403,25 +4381,26 @@ void RinexData::printHdLineData(FILE* out, vector<LABELdata>::iterator lbIter) {
 	#undef PRINT_SYSREC
 }
 
-/**printSatObsValues prints a line or lines with observable values of the first satellite in epochObs.
+/**printSatObsValues prints a line or lines with observable values of the satellite in the given position of epochObs.
  * If the number of observables to print is greather than the maximum number of observable values to be printed
  * in one line, one or several continuation lines would be necessary.
- * After printing observation data of this first satellite, they are removed from the storage.
+ * After printing observation data of this satellite, the position is advanced to the data of the next one
+ * (printed data are not removed from the storage).
  * It is assumed that values in the observables storage  belong to the same epoch and are sorted by system,
  * satellite PRN and observable type.
  *
  * @param out the already open print stream where RINEX epoch data will be printed
  * @param ver the RINEX version being printed
+ * @param itobs the position in epochObs of the first observable of the satellite to print
  * @return true if they remain observables belonging to the current epoch, false when no data remains to print.
  */
-bool RinexData::printSatObsValues(FILE* out, RINEXversion ver) {
+bool RinexData::printSatObsValues(FILE* out, RINEXversion ver, vector<SatObsData>::iterator &itobs) {
 	double valueToPrint;
 	int lli;
-    vector <SatObsData>::iterator itobs;
-	if (epochObs.empty()) return false;
-	//satellite data to print are those of the firts satellite in epochObs
-	int sysToPrint = epochObs[0].sysIndex;
-	int satToPrint = epochObs[0].satellite;
+	if (itobs == epochObs.end()) return false;
+	//satellite data to print are those of the satellite in the given position
+	int sysToPrint = itobs->sysIndex;
+	int satToPrint = itobs->satellite;
     int maxPerLine;         //maximum observables to print per line
     switch (ver) {
         case V210: maxPerLine = 5; break;
@@ -3430,12 +4409,11 @@ bool RinexData::printSatObsValues(FILE* out, RINEXversion ver) {
     bool printObs;          //a flag computed to know if current obsType shall be printed or not
     int nObsPrinted = 0;    //number of observables already printed in the current line
     //for all observables of the given system, print values if printable and data available
-    for (int i = 0; i < systems[sysToPrint].obsTypes.size(); i++) {
+    for (unsigned int i = 0; i < systems[sysToPrint].obsTypes.size(); i++) {
         //check is value for obsType in position i shall be printed or not
         printObs = systems[sysToPrint].obsTypes[i].prt;
         //Check if there are data to print and belongs to the system, satellite and obsType
-        itobs = epochObs.begin();
-        if (!epochObs.empty() && (itobs->sysIndex == sysToPrint) && (itobs->satellite == satToPrint) && (itobs->obsTypeIndex == i)) {
+        if ((itobs != epochObs.end()) && (itobs->sysIndex == (unsigned int) sysToPrint) && (itobs->satellite == satToPrint) && (itobs->obsTypeIndex == i)) {
             if (printObs) {
                 //normal case: there are data for this observable and shall be printed
                 valueToPrint = itobs->obsValue;
@@ -3455,7 +4433,7 @@ bool RinexData::printSatObsValues(FILE* out, RINEXversion ver) {
                               + msgComma + string(1,systems[sysToPrint].system) + to_string((long long) satToPrint)
                               + msgComma + string(systems[sysToPrint].obsTypes[itobs->obsTypeIndex].id));
             }
-            epochObs.erase(epochObs.begin());    //remove printed data
+            itobs++;
         } else if (printObs) {
             //there are no data for this observable, but shall be printed
             fprintf(out, "%14.3lf  ", (double) 0.0);
@@ -3467,7 +4445,7 @@ bool RinexData::printSatObsValues(FILE* out, RINEXversion ver) {
         }
     }
     if ((nObsPrinted % maxPerLine) != 0) fprintf(out, "\n");
-    return !epochObs.empty();
+    return itobs != epochObs.end();
 }
 
 /**readHdLineData reads a line from input RINEX file identifying the header line type, extracting data contained and storing them into the class members.
@@ -3480,7 +4458,10 @@ bool RinexData::printSatObsValues(FILE* out, RINEXversion ver) {
 RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 	///a macro to read continuation lines of a given header record (identified through its label)
 	#define READ_CONT_LINE(GIVEN_LABEL, BLANK_SPACE) \
-				if (fgets(lineBuffer, sizeof lineBuffer, input) == NULL) return LASTONE;	\
+				if (readRinexLine(contLine, input)) return LASTONE;	\
+				contLen = contLine.width(0, sizeof lineBuffer - 1);	\
+				memcpy(lineBuffer, contLine.data, contLen);	\
+				lineBuffer[contLen] = '\0';	\
 				if (checkLabel(lineBuffer) != GIVEN_LABEL) {	\
 					plog->warning(valueLabel(GIVEN_LABEL, msgContExp + string(lineBuffer+61, 20)));	\
 					return GIVEN_LABEL; \
@@ -3497,6 +4478,8 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 			}
 
     char lineBuffer[100], aChar;
+	RinexLine contLine;		//continuation lines read
+	unsigned int contLen;
 	RINEXlabel labelId;
 	PRNobsnum prnobs;
 	string error, aStr;
@@ -3579,7 +4562,7 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 	case COMM:		//"COMMENT"
 		//the comment read is inserted as a new label (header record) after the lastRecordSet (last record read)
 		//it is used the LABELdata constructor for COMM records
-		lastRecordSet = labelDef.insert(lastRecordSet + 1, LABELdata(string(lineBuffer, 60)));
+		lastRecordSet = insertComment(lastRecordSet + 1, string(lineBuffer, 60));
 		plog->finer(valueLabel(COMM, string(lineBuffer, 60)));
 		return COMM;
 	case MRKNAME:	//"MARKER NAME"
@@ -3670,16 +4653,16 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 		    strList.clear();
 			strList = getTokens(string(lineBuffer+6, 54), ' ');
 			for (vector<string>::iterator it = strList.begin(); it != strList.end(); ++it) {
-			    for (i=0; !v2obsTypes[i].empty() && (v2obsTypes[i].compare(*it) != 0); i++);
+				for (i=0; !v2obsTypes[i].empty() && (v2obsTypes[i].compare(*it) != 0); i++);
 				if (v2obsTypes[i].empty()) plog->warning(valueLabel(TOBS, (*it) + msgObsNoTrans));
-				else obsTypeIds.push_back(v3obsTypes[i]);
+				obsTypeIds.push_back(v3obsTypes[i]);	//empty if not translated, to skip its values when reading
 			}
 			n -= 9;
 			if (n > 0) {	//read a continuation line and verify its label
 				READ_CONT_LINE(TOBS, 6)
 			}
 		}
-		if (k != obsTypeIds.size()) plog->warning(valueLabel(TOBS, msgMisCode));
+		if (k != (int) obsTypeIds.size()) plog->warning(valueLabel(TOBS, msgMisCode));
 		//	store data on observable types
 		if (sysToPrintId == 'M') {
 		    //when data come from multiple systems, add obsTypeIds for each system in V210
@@ -3703,7 +4686,7 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 				READ_CONT_LINE(SYS, 6)
 			}
 		}
-		if (k != obsTypeIds.size()) plog->warning(valueLabel(SYS, msgMisCode));
+		if (k != (int) obsTypeIds.size()) plog->warning(valueLabel(SYS, msgMisCode));
 		//store data on observable types
 		systems.push_back(GNSSsystem(lineBuffer[0], obsTypeIds));
 		plog->finer(valueLabel(SYS, to_string((long long) k) + msgTypes));
@@ -3759,7 +4742,7 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 				}
 			}
 		}
-		if (j != obsTypeIds.size()) plog->warning(valueLabel(SCALE, msgMisCode));
+		if (j != (int) obsTypeIds.size()) plog->warning(valueLabel(SCALE, msgMisCode));
 		//store data on observable types
 		obsScaleFact.push_back(OSCALEfact(i, k, obsTypeIds));
 		plog->finer(valueLabel(SCALE, to_string((long long) k) + " scale for " + to_string((long long) j) + msgTypes));
@@ -3780,7 +4763,7 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 				}
 			}
 		}
-		if (j != obsTypeIds.size()) plog->warning(valueLabel(PHSH, msgMisCode));
+		if (j != (int) obsTypeIds.size()) plog->warning(valueLabel(PHSH, msgMisCode));
 		//store data on observable types
 		phshCorrection.push_back(PHSHcorr(i, string(lineBuffer+2, 3), aDouble, obsTypeIds));
 		plog->finer(valueLabel(PHSH, msgPhPerType + to_string((long double) aDouble) + msgComma + to_string((long long) j)));
@@ -3800,7 +4783,7 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
 				}
 			}
 		}
-		if (j != gloSltFrq.size()) plog->warning(valueLabel(GLSLT, msgMisSlots));
+		if (j != (int) gloSltFrq.size()) plog->warning(valueLabel(GLSLT, msgMisSlots));
 		plog->finer(valueLabel(GLSLT, to_string((long long) j) + msgSlots));
 		break;
 	case LEAP :		//"LEAP SECONDS"
@@ -3951,12 +4934,265 @@ RinexData::RINEXlabel RinexData::readHdLineData (FILE* input) {
  * @return true if EOF happens when reading, false otherwise
  */
 bool RinexData::readRinexRecord(char* rinexRec, int recSize, FILE* input) {
-	size_t obsLen;
+	RinexLine line;
+	if (readRinexLine(line, input)) return true;
+	unsigned int recLen = line.width(0, recSize - 1);
+	memcpy(rinexRec, line.data, recLen);
+	memset(rinexRec + recLen, ' ', recSize - 1 - recLen);
+	rinexRec[recSize - 1] = '\0';
+	return false;
+}
+
+/**getInputPos gives the position in the input file of the next line to read.
+ *
+ * @param  input the already open input stream
+ * @return the position in the file
+ */
+long RinexData::getInputPos(FILE* input) {
+	if (input == mapFile) return obsReadAhead.empty() ? mapPos : obsReadAhead.front().pos;
+	return ftell(input);
+}
+
+/**setInputPos sets the position in the input file of the next line to read.
+ *
+ * @param  input the already open input stream
+ * @param pos the position in the file
+ */
+void RinexData::setInputPos(FILE* input, long pos) {
+	if (input == mapFile) {
+		obsReadAhead.clear();
+		mapPos = pos;
+	} else fseek(input, pos, SEEK_SET);
+}
+
+/**readObsEpochAhead delivers the next epoch read ahead in parallel, storing its data as readObsEpoch does.
+ * When there are not epochs read ahead, it reads in parallel the next chunks of the input file.
+ *
+ * @param input the input stream mapped in memory
+ * @return the status of the epoch read (as per readObsEpoch)
+ */
+int RinexData::readObsEpochAhead(FILE* input) {
+	int status;
+	long aheadPos;
+	if (obsReadAhead.empty()) fillObsReadAhead();
+	if (obsReadAhead.empty()) return 0;
+	ObsEpochRead &epoch = obsReadAhead.front();
+	if ((epoch.flag >= 2) && (epoch.flag <= 5)) {
+		//read again the event to store here the header records it may contain
+		aheadPos = mapPos;
+		mapPos = epoch.pos;
+		epochObs.clear();
+		status = (inFileVer == V210) ? readV2ObsEpoch(input) : readV3ObsEpoch(input);
+		mapPos = aheadPos;
+	} else {
+		epochObs.swap(epoch.obs);
+		epochWeek = epoch.week;
+		epochTOW = epoch.tow;
+		epochTimeTag = epoch.timeTag;
+		epochClkOffset = epoch.clkOffset;
+		epochFlag = epoch.flag;
+		nSatsEpoch = epoch.nSats;
+		status = epoch.status;
+	}
+	obsReadAhead.pop_front();
+	return status;
+}
+
+/**fillObsReadAhead reads in parallel epochs from the current position in the mapped input file.
+ * The file is split in obsReadThreads chunks of about OBS_READCHUNK bytes starting at epoch lines, and each chunk is read
+ * by a thread using a RinexData object having the systems and observable types defined here.
+ * Epochs read are stored in obsReadAhead while chunks are consistent (each one starts where the previous one ended), and
+ * up to the first event that may contain header records (new site or header information).
+ */
+void RinexData::fillObsReadAhead() {
+	long start = mapPos;
+	if (start >= (long) mapSize) return;
+	//set chunk limits and read them in parallel
+	vector<long> limits(1, start);
+	for (int i = 1; i <= obsReadThreads; i++)
+		limits.push_back(findObsEpochStart(max(limits.back(), min(start + (long) i * OBS_READCHUNK, (long) mapSize))));
+	vector<RinexData*> readers;
+	vector<vector<ObsEpochRead> > chunks(obsReadThreads);
+	vector<thread> threads;
+	for (int i = 0; i < obsReadThreads && limits[i] < limits[i + 1]; i++) {
+		RinexData* reader = new RinexData(version, plog);
+		setObsReader(*reader, limits[i]);
+		readers.push_back(reader);
+		threads.push_back(thread(&RinexData::readObsChunk, reader, limits[i + 1], ref(chunks[i])));
+	}
+	for (unsigned int i = 0; i < threads.size(); i++) threads[i].join();
+	for (unsigned int i = 0; i < readers.size(); i++) {
+		readers[i]->mapFile = NULL;
+		readers[i]->mapData = NULL;
+		delete readers[i];
+	}
+	//store the epochs read while chunks are consistent
+	long end = start;
+	for (unsigned int i = 0; i < chunks.size(); i++) {
+		for (vector<ObsEpochRead>::iterator it = chunks[i].begin(); it != chunks[i].end(); it++) {
+			if (it->pos != end) {
+				mapPos = end;
+				return;
+			}
+			end = it->endPos;
+			obsReadAhead.push_back(move(*it));
+			if ((obsReadAhead.back().flag == 3) || (obsReadAhead.back().flag == 4)) {
+				mapPos = end;
+				return;
+			}
+		}
+	}
+	mapPos = end;
+}
+
+/**setObsReader sets the given RinexData object to read observation epochs of the input file with the systems and
+ * observable types defined here. Header records in events read by the reader are stored there, not here.
+ * When the input file is mapped in memory, the reader shares the mapped area, and shall release it before being deleted
+ * (setting its mapFile and mapData to NULL).
+ *
+ * @param reader the RinexData object to set
+ * @param pos the position in the mapped input file where the reader starts reading
+ */
+void RinexData::setObsReader(RinexData &reader, long pos) {
+	reader.inFileVer = inFileVer;
+	reader.sysToPrintId = sysToPrintId;
+	reader.systems = systems;
+	reader.mapFile = mapFile;
+	reader.mapData = mapData;
+	reader.mapSize = mapSize;
+	reader.mapPos = pos;
+	//header records in events are inserted after the last one set (as after reading a header)
+	reader.lastRecordSet = reader.labelDef.begin() + reader.labelPos[EOH];
+}
+
+/**readObsChunk reads the epochs in the mapped input file from the current position up to the given one.
+ * It is executed by the threads reading the file in parallel.
+ *
+ * @param endPos the position in the file where the chunk ends
+ * @param epochs the epochs read, in file order
+ */
+void RinexData::readObsChunk(long endPos, vector<ObsEpochRead> &epochs) {
+	ObsEpochRead epoch;
+	while ((long) mapPos < endPos) {
+		epoch.pos = mapPos;
+		if ((epoch.status = readObsEpoch(mapFile)) == 0) break;
+		epoch.endPos = mapPos;
+		epoch.week = epochWeek;
+		epoch.tow = epochTOW;
+		epoch.timeTag = epochTimeTag;
+		epoch.clkOffset = epochClkOffset;
+		epoch.flag = epochFlag;
+		epoch.nSats = nSatsEpoch;
+		epoch.obs.swap(epochObs);
+		epochs.push_back(move(epoch));
+		epoch.obs.clear();
+	}
+}
+
+/**findObsEpochStart finds in the mapped input file the first epoch line starting at or after the given position.
+ * Epoch lines are the ones starting with '>' in V3 files. In V2 files they are identified by their format: date and
+ * time fields separated by blanks, the decimal point of seconds in column 19, and the epoch flag in column 29.
+ * Blank lines before the epoch line are skipped when reading its epoch (see readRinexLine), and the epoch starts at them.
+ *
+ * @param pos the position in the file where the search starts
+ * @return the position of the epoch found, or the file size if none is found
+ */
+long RinexData::findObsEpochStart(long pos) {
+	RinexLine line;
+	const char* eol;
+	bool isEpoch;
+	//skip the rest of the line containing the given position
+	if ((pos > 0) && (pos < (long) mapSize) && (mapData[pos - 1] != '\n')) {
+		eol = (const char*) memchr(mapData + pos, '\n', mapSize - pos);
+		pos = (eol == NULL) ? mapSize : eol - mapData + 1;
+	}
+	while (pos < (long) mapSize) {
+		line.data = mapData + pos;
+		eol = (const char*) memchr(line.data, '\n', mapSize - pos);
+		line.len = (eol == NULL) ? mapSize - pos : eol - line.data;
+		if (inFileVer == V304) isEpoch = line.at(0) == '>';
+		else {
+			isEpoch = (line.at(18) == '.') && (line.at(28) >= '0') && (line.at(28) <= '6');
+			for (int i = 0; isEpoch && i < 15; i += 3)
+				isEpoch = (line.at(i) == ' ') && ((line.at(i + 1) == ' ') || ((line.at(i + 1) >= '0') && (line.at(i + 1) <= '9')))
+					&& (line.at(i + 2) >= '0') && (line.at(i + 2) <= '9');
+		}
+		if (isEpoch) {
+			while (pos > 0) {
+				//find the start of the previous line, and check if it is blank
+				long prev = pos - 1;
+				while ((prev > 0) && (mapData[prev - 1] != '\n')) prev--;
+				const char* c = mapData + prev;
+				while ((*c == ' ') || (*c == '\r')) c++;
+				if (c != mapData + pos - 1) break;
+				pos = prev;
+			}
+			return pos;
+		}
+		pos += (eol == NULL) ? line.len : line.len + 1;
+	}
+	return mapSize;
+}
+
+/**readMergeEpoch reads from the given input file the next epoch to be merged (see mergeObsFiles).
+ * Epochs with errors and special events with header records (new site and header information events) are skipped.
+ *
+ * @param input the input stream being read
+ * @return true when an epoch has been read, false at the end of file
+ */
+bool RinexData::readMergeEpoch(FILE* input) {
+	const string msgEventNotMerged("Event with header records not merged. Time tag=");
+	for (;;) {
+		switch (readObsEpoch(input)) {
+		case 0:		//EOF
+		case 9:		//unknown input file version
+			return false;
+		case 1:		//observation data
+		case 3:		//observation data with errors
+			return true;
+		case 2:		//special event
+		case 5:
+		case 6:
+		case 7:
+			//special records read only apply to this input
+			clearHeaderData();
+			if ((epochFlag != 3) && (epochFlag != 4)) return true;
+			plog->info(msgEventNotMerged + to_string((long double) epochTimeTag));
+			break;
+		default:	//epoch data not stored
+			break;
+		}
+	}
+}
+
+/**readRinexLine reads a line from the RINEX input, giving a view of it without the EOL.
+ * If the input file is mapped, the view points to the mapped area. If it is compressed, the view points to the data
+ * decompressed by inDecoder. Otherwise the line is read into inLine.
+ * The view remains valid until the next line is read. Empty lines are skipped.
+ *
+ * @param line the view of the line read
+ * @param  input the already open print stream where RINEX line will be read
+ * @return true if EOF happens when reading, false otherwise
+ */
+bool RinexData::readRinexLine(RinexLine &line, FILE* input) {
+	const char* eol;
 	do {
-		if (fgets(rinexRec, recSize, input) == NULL) return true;
-		obsLen = strlen(rinexRec) - 1;
-		memset(rinexRec + obsLen, ' ', recSize - obsLen);
-	} while (isBlank(rinexRec, recSize-1));
+		if (input == mapFile) {
+			if (mapPos >= mapSize) return true;
+			line.data = mapData + mapPos;
+			eol = (const char*) memchr(line.data, '\n', mapSize - mapPos);
+			line.len = (eol == NULL) ? mapSize - mapPos : eol - line.data;
+			mapPos += (eol == NULL) ? line.len : line.len + 1;
+		} else if ((inDecoder != NULL) && (input == inDecoder->getFile())) {
+			if (inDecoder->readLine(line.data, line.len)) return true;
+		} else {
+			if (fgets(inLine, sizeof inLine, input) == NULL) return true;
+			line.data = inLine;
+			line.len = strlen(inLine);
+			if ((line.len > 0) && (inLine[line.len - 1] == '\n')) line.len--;
+		}
+		if ((line.len > 0) && (line.data[line.len - 1] == '\r')) line.len--;
+	} while (line.isBlank(0, line.len));
 	return false;
 }
 
@@ -4006,7 +5242,7 @@ unsigned int RinexData::getSysIndex(char sysId) {
 string RinexData::getSysDes(char s) {
     for (vector<SYSdescript>::iterator it = sysDescript.begin() ; it != sysDescript.end(); ++it)
         if (it->sysId == s) return it->sysDes;
-	return string();
+    return string();
 }
 
 /**getSysId provides the system identification for a given system time description
@@ -27,11 +27,17 @@
 #define RINEXDATA_H
 
 #include <vector>
+#include <map>
+#include <set>
+#include <deque>
 #include <string>
 #include <algorithm>
+#include <cstdint>
 
 #include "Logger.h"	//from CommonClasses
 
+class RinexDecoder;
+
 using namespace std;
 
 //@cond DUMMY
@@ -61,6 +67,24 @@ using namespace std;
 #define BO_TOTEPHE_SBAS 12
 //Number of Broadcast Orbit lines to print for each QZSS satellite epoch
 #define BO_MAXLINS_QZSS 4
+//Default time window (seconds of TOC) of navigation epochs kept in memory when streaming them to the output file
+#define NAV_STREAMWINDOW 14400.0
+//Default maximum time distance (seconds) between an epoch and the ephemeris time tag to consider the ephemeris valid for it
+#define EPH_MAXAGE 7200.0
+#define EPH_MAXAGE_GLO 900.0
+#define EPH_MAXAGE_SBAS 360.0
+//Size of the table to recognize labels by their hash, and the multiplier used to compute it. The multiplier has been
+//chosen to obtain a perfect hash (without collisions) for all header labels and correction types defined
+#define LABEL_HASHSIZE 256
+#define LABEL_HASHMULT 0x8082D3EF
+#define LABEL_NOPOS 0xFFFFFFFF	//the position in labelDef of labels not defined there
+#define RINEX_MAXLINE 1300	//maximum length of lines read from RINEX files: 3 + 2 + 19 x 4 measurements x 16 chars= 1221
+#define OBS_READCHUNK 1048576	//bytes of the observation file read by each thread when reading in parallel
+//Columns of navigation epoch lines: broadcast orbit data start after NAV_BOSTART_Vx blanks, and each value takes
+//NAV_FIELDWIDTH (D19.12). In the first line the satellite and epoch time take the first field, followed by SV clock data
+#define NAV_BOSTART_V2 3
+#define NAV_BOSTART_V3 4
+#define NAV_FIELDWIDTH 19
 //Other related constants
 const string IONO_GAL_DES("GAL");
 const string IONO_GPSA_DES("GPSA");
@@ -108,6 +132,7 @@ const string msgVerTBD("Undefined version to print");
 const string msgWrongDate("Wrong date-time");
 const string msgWrongFlag(" Wrong flag");
 const string msgWrongPRN("Wrong PRN");
+const string msgWrongObs(" Wrong observable value, LLI or signal strength.");
 const string msgNoLabel("No header label found in ");
 const string msgWrongLabel(" cannot be used in this RINEX version");
 const string msgProcessV210("File processed as per V2.1");
@@ -150,13 +175,14 @@ const string msgTimeTag(" time tag ");
 const string msgAlrEx(". ALREADY EXIST");
 const string msgSaved(". SAVED");
 const string msgNoMem(". NOT SAVED:");
+const string msgBehindWin(". Behind the streaming window");
 const string msgNoBO("Error Broad.Orb. less than expected");
 const string msgBadFileName("Output file name cannot be set");
 const string msgWrongVer("Wrong data in RINEX VERSION / TYPE record");
 
 const string errorLabelMis("Internal error. Wrong argument types in RINEX label identifier=");
 //time constant
-const struct tm UTCepoch = {.tm_year = 70,.tm_mon = 0,.tm_mday = 1,.tm_hour = 0,.tm_min = 0,.tm_sec = 0,.tm_isdst = -1};
+const struct tm UTCepoch = {.tm_sec = 0,.tm_min = 0,.tm_hour = 0,.tm_mday = 1,.tm_mon = 0,.tm_year = 70,.tm_isdst = -1};
 
 //@endcond
 
@@ -193,6 +219,11 @@ const struct tm UTCepoch = {.tm_year = 70,.tm_mon = 0,.tm_mday = 1,.tm_hour = 0,
  * -# Set navigation data for the epoch to be printed using setEpochTime first and saveNavData repeatedly for each system/satellite for this epoch
  * -# Print the RINEX epoch data using the printNavEpoch method.
  * -# Repeat steps 5 & 6 while epoch data exist.
+ *<p>Alternatively, to keep bounded the memory used for long data collections, navigation data can be streamed to the file:
+ *after printing the header, startNavStream is called, navigation data are saved using saveNavData, and endNavStream is called
+ *when no more data exist. Data are printed in time order when they fall behind the streaming window.
+ *When the header depends on the data collected, epochs can be streamed to a temporary file and appended to the RINEX file
+ *after printing its header. The file name given by getNavFileName takes into account the epochs already streamed.
  *<p>As per above case, input data can be obtained from another RINEX navigation file. In this case:
  * - The method readRinexHeader is used in step 3 to read from another RINEX file header records data and store them into the RinexData object.
  * - The method readNavEpoch is used in step 5 to read an epoch data from another RINEX navigation file.
@@ -213,6 +244,14 @@ const struct tm UTCepoch = {.tm_year = 70,.tm_mon = 0,.tm_mday = 1,.tm_hour = 0,
  * -# Use method readNavEpoch to read a satellite epoch data from the input RINEX navigation file.
  * -# Get needed navigation data from this epoch using getNavData
  * -# Repeat former two steps while epoch data exist.
+ *<p>Existing RINEX observation or navigation files can be converted to the version of a RinexData object using convertObsFile or
+ *convertNavFile, which read and print the input file epoch by epoch.
+ *Several RINEX observation files can be merged in one, printing their epochs in time order, using mergeObsFiles.
+ *<p>Input RINEX files compressed with gzip and/or in Compact RINEX format can be read directly, decompressing them while reading:
+ *after opening the file, openInputDecoder is called before readRinexHeader. Compressed files are read sequentially only.
+ *<p>When ephemeris for a satellite at a given time are needed (f.e. to compute orbits), the ephemeris store can be enabled using
+ *setEphemerisStore. Then all navigation data saved or read are indexed by system-satellite and time, and getBestEphemeris
+ *gives the ones valid for a given time.
  *<p>Finally, the class provides the possibility to filter observation or navigation data stored into a class object using methods to:
  * - Set the filtering criteria (select an epoch time period, a system/satellite/observation) using the setFilter method
  * - Discard from saved data these not belonging to the selected time period or systems/satellites/observations using the filterObsData or filterNavData.
@@ -303,6 +342,176 @@ public:
 		DONTMATCH,	///< Label do not match with RINEX version (to manage error messages)
 		LASTONE		///< Las item: last RINEXlabel. Also EOF found when reading.
 		};
+	/// A function to apply scale factors to broadcast orbit mantissas to obtain ephemeris values. It returns their time tag.
+	typedef double (*NavScaler)(int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+	/// A lightweight range over stored records (multi-record header lines or epoch data), to be iterated without copying them
+	template <class T> class DataRange {
+	public:
+		typedef typename vector<T>::const_iterator const_iterator;
+		DataRange(const_iterator b, const_iterator e) : first(b), last(e) {};
+		const_iterator begin() const { return first; };
+		const_iterator end() const { return last; };
+		size_t size() const { return last - first; };
+		bool empty() const { return first == last; };
+	private:
+		const_iterator first, last;
+	};
+	/// Observable type codes (C1C, L1C, ...) packed in an integer, one character per byte from the least significant one
+	typedef uint32_t ObsCode;
+	//types of the records of multi-record header lines, accessible using DataRange
+    struct OBSmeta {    //Defines metadata to manage observables
+        string id;  //identifier of each obsType type: C1C, L1C, D1C, S1C... (see RINEX V304 document: 5.1 Observation codes)
+        bool sel;   //if true, the obsType is selected, that is, their data will be taken into account
+        bool prt;   //if true, the obsType will be printed (it is selected and its printable in the current version)
+        ObsCode code;   //the identifier packed as an ObsCode
+        //constructor
+        OBSmeta (string identifier, bool selected, bool printable) {
+            id = identifier;
+            code = packObsCode(identifier);
+            sel = selected;
+            prt = printable;
+        }
+    };
+	struct GNSSsystem {	//Defines data for each GNSS system that can provide data to the RINEX file. Used for all versions
+		char system;	//system identification: G (GPS), R (GLONASS), S (SBAS), E (Galileo). See RINEX V304 document: 3.5 Satellite numbers
+		bool selSystem;	//a flag stating if the system is selected (will pass filtering or not)
+        vector <OBSmeta> obsTypes;
+        vector <int> selSat;       //the list of selected satelites to be printed. If empty all of them will be printed
+        vector <int> inObsIdx;     //for each observable in input file records (in file order), its index in obsTypes, or -1 if not stored
+		//constructor
+		//GNSSsystem (char sys, const vector<string> &obsT) {
+        GNSSsystem (char sys, vector<string> obsT) {
+			system = sys;
+			selSystem = true;
+			//insert all obsType having equivalence in RINEX V2, initially set to NOT SELECTED and NOT PRINTABLE
+            for (int i = 0;  !v3obsTypes[i].empty() ; i++) obsTypes.push_back(OBSmeta(v3obsTypes[i], false, false));
+            //for each obsTypes passed in argument, it already inserted set it as SELECTED
+            //if not, insert it as SELECTED and NOT PRINTABLE
+            //empty obsTypes passed (not translatable ones) are not inserted
+            vector <OBSmeta> ::iterator itobs;
+            for (vector<string>::iterator iti = obsT.begin(); iti != obsT.end(); iti++) {
+                if ((*iti).empty()) {
+                    inObsIdx.push_back(-1);
+                    continue;
+                }
+                for (itobs = obsTypes.begin(); (itobs != obsTypes.end()) && ((*iti).compare(itobs->id) != 0); itobs++);
+                inObsIdx.push_back(itobs - obsTypes.begin());
+                if (itobs != obsTypes.end()) itobs->sel = true;
+                else obsTypes.push_back(OBSmeta(*iti, true, false));
+            }
+        };
+	};
+	struct GLSLTfrq {	//defines Glonass slot and frequency numbers
+		int slot;		//slot
+		int frqNum;		//Frequency numbers (-7...+6)
+		//constructor
+		GLSLTfrq (int sl, int fr) {
+			slot = sl;
+			frqNum = fr;
+		};
+	};
+	struct PRNobsnum {	//defines prn and number of observables for each observable type
+		char sysPrn;	//the system the satellite prn belongs
+		int	satPrn;		//the prn number of the satellite
+		vector <int> obsNum;	//the number of observables for each observable type
+		//constructors
+		PRNobsnum () {
+		};
+		PRNobsnum (char s, int p, const vector<int> &o) {
+			sysPrn = s;
+			satPrn = p;
+			obsNum = o;
+		};
+	};
+	struct CORRECTION {	//defines ionospheric and time corrections
+        RINEXlabel  corrType;	//Correction type: IONO_XXX or TIME_YYYY defined above
+        double corrValues[6];   //Correction values depend on the correction type:
+            /* For IONO_XXXX:
+                  -[0 - 3] are the parameters (alpha0-alpha3, beta0-beta3, ai0-ai2 ...)
+                  -[4] the Time mark (time of week)
+                  -[5] source: satellite number
+               For TIME_XXXX:
+                  -[0 - 1] are the a0 and a1 coefficients of linear polynomial
+                  -[2] the Reference time (time of week)
+                  -[3] the Refernece week number
+                  -[4] the UTC identifier
+                  -[5] source: MEO satellite number (if < 100), or SBAS satnumber if MT12, or
+                    if MT17, 1000 = WAAS, 1001 = EGNOS, 1002 = MSAS, ...*/
+		//constructorS
+        CORRECTION () {
+        }
+        //TODO CORRECTION (RINEXlabel ct, double* ionoParOrtimeCoefAndRef, int timeMarkOrIdUTC, int sourceId) {
+        CORRECTION (RINEXlabel ct, const double (&ionoParOrtimeCoefAndRef)[4], int timeMarkOrIdUTC, int sourceId) {
+            corrType = ct;
+            for (int i = 0; i < 4; ++i) {
+                //TODO corrValues[i] = *(ionoParOrtimeCoefAndRef + i);
+                corrValues[i] = ionoParOrtimeCoefAndRef[i];
+            }
+            //TODO verify
+//            memcpy(corrValues, ionoParOrtimeCoefAndRef, sizeof(double) * 4);
+            corrValues[4] = timeMarkOrIdUTC;
+            corrValues[5] = sourceId;
+        }
+	};
+	//types of epoch data records, accessible using DataRange
+	struct SatObsData {	//defines data storage for a satellite observable (pseudorrange, phase, ...) in an epoch.
+		unsigned int sysIndex;		//the system this observable belongs: its index in systems vector (see above)
+		int satellite;		//the satellite this observable belongs: PRN of satellite
+		unsigned int obsTypeIndex;	//the observable type: its index in obsType vector (inside the GNSSsystem object referred by sysIndex)
+ 		double obsValue;	//the value of this observable
+		int lossOfLock;		//if loss of lock happened when observable was taken
+		int strength;		//the signal strength when observable was taken
+		//constructor
+		SatObsData (double /*obsTag*/, unsigned int sysIdx, int sat, unsigned int obsIdx, double obsVal, int lol, int str) {
+			sysIndex = sysIdx;
+			satellite = sat;
+			obsTypeIndex = obsIdx;
+			obsValue = obsVal;
+			lossOfLock = lol;
+			strength = str;
+		};
+		//define operator for comparisons and sorting
+		bool operator < (const SatObsData& param) const {
+			if (sysIndex < param.sysIndex) return true;
+			if (sysIndex > param.sysIndex) return false;
+			//same system
+			if (satellite < param.satellite) return true;
+			if (satellite > param.satellite) return false;
+			//same system and satellite
+			if (obsTypeIndex <= param.obsTypeIndex) return true;
+			return false;
+		};
+	};
+	struct SatNavData {	//defines storage for navigation data for a given GNSS satellite
+		double navTimeTag;	//a time tag to identify the epoch of this data:
+            //for GPS: seconds from GPS epoch, or GPS_week_number * 604800 + time_of_week. Week without roll-over. Seconds without leap seconds.
+            //for GAL: seconds from GPS epoch, or (GAL_week_number + 1024) * 604800 + time_of_week. Week without roll-over. Seconds without leap seconds.
+            //      The GAL epoch is the 1st GPS roll over, or 22/8/1999 00:00:00 UTC minus 13s., or 21/8/1999 23:59:47 UTC)
+            //for BDS: seconds from GPS epoch, or (BDS week_number + 1356) * 604800 + time_of_week + 14. Week without roll-over. Seconds without leap seconds.
+            //      The BDS epoch (1/1/2006 00:00:00 UTC) is GPS week 1356 tow 14
+            //for GLO: UTC seconds from GPS epoch plus 3h. It includes leap seconds.
+		char systemId;	//the system identification (G, E, R, ...)
+		int satellite;	//the PRN of the satellite navigation data belong
+		double broadcastOrbit[BO_MAXLINS][BO_MAXCOLS];	//the eigth lines of RINEX navigation data, with four parameters each
+		//constructor
+		SatNavData(double tT, char sys, int sat, double bo[][BO_MAXCOLS]) {
+			navTimeTag = tT;
+			systemId = sys;
+			satellite = sat;
+			memcpy(broadcastOrbit, bo, sizeof(broadcastOrbit));
+		};
+		//define operator for comparisons and sorting
+		bool operator < (const SatNavData &param) const {
+			if(navTimeTag < param.navTimeTag) return true;
+			if(navTimeTag > param.navTimeTag) return false;
+			//same time tag
+			if (systemId < param.systemId) return true;
+			if (systemId > param.systemId) return false;
+			//same time tag and system
+			if (satellite < param.satellite) return true;
+			return false;
+		};
+	};
 	//constructors & destructor
 	RinexData(RINEXversion ver, Logger* plogger);
 	RinexData(RINEXversion ver);
@@ -345,6 +554,12 @@ public:
 	bool getHdLnData(RINEXlabel rl, string &a, string &b);
 	bool getHdLnData(RINEXlabel rl, string &a, string &b, string &c);
 	bool getHdLnData(RINEXlabel rl, string &a, double &b, unsigned int index = 0);
+	//methods to iterate over multi-record header lines data without copying them
+	DataRange<GNSSsystem> getHdSystems();
+	DataRange<GLSLTfrq> getHdGloSlots();
+	DataRange<PRNobsnum> getHdPrnObs();
+	DataRange<CORRECTION> getHdCorrections();
+	const string *getHdComment(unsigned int &pos, RINEXlabel &a);
 	//methods to process header records data
 	RINEXlabel lblTOid(string label);
 	string idTOlbl(RINEXlabel id);
@@ -356,11 +571,18 @@ public:
 	bool saveObsData(char sys, int sat, string obsType, double value, int lol, int strg, double tTag);
 	double getEpochTime(int &weeks, double &secs, double &bias, int &eFlag);
 	bool getObsData(char &sys, int &sat, string &obsType, double &value, int &lol, int &strg, unsigned int index = 0);
+	DataRange<SatObsData> getObsEpoch();
+	char getObsSystem(const SatObsData &obs);
+	ObsCode getObsCode(const SatObsData &obs);
+	static ObsCode packObsCode(const string &obsType);
+	static string unpackObsCode(ObsCode code);
 	bool setFilter(vector<string> selSat, vector<string> selObs);
 	bool filterObsData(bool removeNotPrt = false);
 	void clearObsData();
 	bool saveNavData(char sys, int sat, double bo[BO_MAXLINS][BO_MAXCOLS], double tTag);
+	bool saveNavData(char sys, int sat, int bom[BO_MAXLINS][BO_MAXCOLS], NavScaler scaler);
 	bool getNavData(char& sys, int &sat, double (&bo)[BO_MAXLINS][BO_MAXCOLS], double &tTag, unsigned int index = 0);
+	DataRange<SatNavData> getNavEpoch();
 	bool filterNavData();
 	void clearNavData();
 	//methods to print RINEX files
@@ -372,10 +594,28 @@ public:
 	void printNavHeader(FILE* out);
 	void printNavEpochs(FILE* out);
 	bool hasNavEpochs(char sys);
+	void startNavStream(FILE* out, double window = NAV_STREAMWINDOW);
+	void endNavStream();
+	//methods to index ephemeris by satellite and time, and to look up them
+	void setEphemerisStore(bool enable);
+	bool getBestEphemeris(char sys, int sat, double tTag, double (&bo)[BO_MAXLINS][BO_MAXCOLS], double &ephTag, double maxAge = 0.0);
 	//methods to collect data from existing RINEX files
+	bool mapInputFile(FILE* input);
+	void unmapInputFile();
+	bool openInputDecoder(FILE* input);
+	void closeInputDecoder();
+	int indexObsEpochs(FILE* input);
+	bool seekObsEpoch(FILE* input, double tTag);
+	void setObsReadThreads(int nThreads);
 	RINEXlabel readRinexHeader(FILE* input);
 	int readObsEpoch(FILE* input);
 	int readNavEpoch(FILE* input);
+	//methods to convert existing RINEX files to the version of this object
+	int convertObsFile(FILE* input, FILE* output, vector<string> selSat = vector<string>(), vector<string> selObs = vector<string>());
+	int convertNavFile(FILE* input, FILE* output, vector<string> selSat = vector<string>(), vector<string> selObs = vector<string>());
+	//methods to merge existing RINEX files
+	int mergeObsFiles(vector<FILE*> inputs, FILE* output, vector<string> selSat = vector<string>(), vector<string> selObs = vector<string>());
+	friend class ObsReadTest;	//the host test of observation files reading
 
 private:
 	struct LABELdata {	        //A template for data related to each defined RINEX label and related record
@@ -403,7 +643,17 @@ private:
 			comment = c;
 		}
 	};
+	struct LABELkey {	//The definition of a RINEX label, with the hash of its value, known at compile time
+		RINEXlabel labelID;
+		const char* labelVal;
+		RINEXversion ver;
+		unsigned int type;
+		unsigned int hash;	//The hash of labelVal (see hashLabel)
+	};
+	static const LABELkey labelTable[];		//The definition of all RINEX labels, in the order they are stored in labelDef
+	static const RINEXlabel labelHash[LABEL_HASHSIZE];	//label identifiers indexed by the hash of their label value
 	vector <LABELdata> labelDef;	//A place to store data for all RINEX header labels
+	unsigned int labelPos[LASTONE + 1];		//for each label identifier, the position in labelDef of its (first) record
 	unsigned int labelIdIdx;		//an index to iterater over labelDef with get1stLabelId and getNextLabelId 
     struct SYSdescript {     //A template to define a table containing descriptions related to syste identification
         char sysId;         //the system identification (G, R, E, C, ...)
@@ -496,39 +746,6 @@ private:
 	vector <WVLNfactor> wvlenFactor;
 	//"# / TYPES OF OBSERV"		V210
 	//"SYS / # / OBS TYPES"		V304
-    struct OBSmeta {    //Defines metadata to manage observables
-        string id;  //identifier of each obsType type: C1C, L1C, D1C, S1C... (see RINEX V304 document: 5.1 Observation codes)
-        bool sel;   //if true, the obsType is selected, that is, their data will be taken into account
-        bool prt;   //if true, the obsType will be printed (it is selected and its printable in the current version)
-        //constructor
-        OBSmeta (string identifier, bool selected, bool printable) {
-            id = identifier;
-            sel = selected;
-            prt = printable;
-        }
-    };
-	struct GNSSsystem {	//Defines data for each GNSS system that can provide data to the RINEX file. Used for all versions
-		char system;	//system identification: G (GPS), R (GLONASS), S (SBAS), E (Galileo). See RINEX V304 document: 3.5 Satellite numbers
-		bool selSystem;	//a flag stating if the system is selected (will pass filtering or not)
-        vector <OBSmeta> obsTypes;
-        vector <int> selSat;       //the list of selected satelites to be printed. If empty all of them will be printed
-		//constructor
-		//GNSSsystem (char sys, const vector<string> &obsT) {
-        GNSSsystem (char sys, vector<string> obsT) {
-			system = sys;
-			selSystem = true;
-			//insert all obsType having equivalence in RINEX V2, initially set to NOT SELECTED and NOT PRINTABLE
-            for (int i = 0;  !v3obsTypes[i].empty() ; i++) obsTypes.push_back(OBSmeta(v3obsTypes[i], false, false));
-            //for each obsTypes passed in argument, it already inserted set it as SELECTED
-            //if not, insert it as SELECTED and NOT PRINTABLE
-            vector <OBSmeta> ::iterator itobs;
-            for (vector<string>::iterator iti = obsT.begin(); iti != obsT.end(); iti++) {
-                for (itobs = obsTypes.begin(); (itobs != obsTypes.end()) && ((*iti).compare(itobs->id) != 0); itobs++);
-                if (itobs != obsTypes.end()) itobs->sel = true;
-                else obsTypes.push_back(OBSmeta(*iti, true, false));
-            }
-        };
-	};
 	vector <GNSSsystem> systems;
 	//"* SIGNAL STRENGTH UNIT"	V304
 	string signalUnit;
@@ -590,15 +807,6 @@ private:
 	};
 	vector <PHSHcorr> phshCorrection;
 	//* GLONASS SLOT / FRQ #
-	struct GLSLTfrq {	//defines Glonass slot and frequency numbers
-		int slot;		//slot
-		int frqNum;		//Frequency numbers (-7...+6)
-		//constructor
-		GLSLTfrq (int sl, int fr) {
-			slot = sl;
-			frqNum = fr;
-		};
-	};
 	vector <GLSLTfrq> gloSltFrq;
 	//* GLONASS COD/PHS/BIS
     struct GLPHSbias {
@@ -637,52 +845,9 @@ private:
 	//"* # OF SATELLITES"		VALL
 	int numOfSat;
 	//"* PRN / # OF OBS"			VALL
-	struct PRNobsnum {	//defines prn and number of observables for each observable type
-		char sysPrn;	//the system the satellite prn belongs
-		int	satPrn;		//the prn number of the satellite
-		vector <int> obsNum;	//the number of observables for each observable type
-		//constructors
-		PRNobsnum () {
-		};
-		PRNobsnum (char s, int p, const vector<int> &o) {
-			sysPrn = s;
-			satPrn = p;
-			obsNum = o;
-		};
-	};
 	vector <PRNobsnum> prnObsNum;
     //"* IONOSPHERIC CORR		(in GNSS NAV version V304)
 	//"* TIME SYSTEM CORR		(in GNSS NAV version V304)
-	struct CORRECTION {	//defines ionospheric and time corrections
-        RINEXlabel  corrType;	//Correction type: IONO_XXX or TIME_YYYY defined above
-        double corrValues[6];   //Correction values depend on the correction type:
-            /* For IONO_XXXX:
-                  -[0 - 3] are the parameters (alpha0-alpha3, beta0-beta3, ai0-ai2 ...)
-                  -[4] the Time mark (time of week)
-                  -[5] source: satellite number
-               For TIME_XXXX:
-                  -[0 - 1] are the a0 and a1 coefficients of linear polynomial
-                  -[2] the Reference time (time of week)
-                  -[3] the Refernece week number
-                  -[4] the UTC identifier
-                  -[5] source: MEO satellite number (if < 100), or SBAS satnumber if MT12, or
-                    if MT17, 1000 = WAAS, 1001 = EGNOS, 1002 = MSAS, ...*/
-		//constructorS
-        CORRECTION () {
-        }
-        //TODO CORRECTION (RINEXlabel ct, double* ionoParOrtimeCoefAndRef, int timeMarkOrIdUTC, int sourceId) {
-        CORRECTION (RINEXlabel ct, const double (&ionoParOrtimeCoefAndRef)[4], int timeMarkOrIdUTC, int sourceId) {
-            corrType = ct;
-            for (int i = 0; i < 4; ++i) {
-                //TODO corrValues[i] = *(ionoParOrtimeCoefAndRef + i);
-                corrValues[i] = ionoParOrtimeCoefAndRef[i];
-            }
-            //TODO verify
-//            memcpy(corrValues, ionoParOrtimeCoefAndRef, sizeof(double) * 4);
-            corrValues[4] = timeMarkOrIdUTC;
-            corrValues[5] = sourceId;
-        }
-	};
 	vector <CORRECTION> corrections;
 	//Epoch time parameters
 	int epochWeek;			//Extended (0 to NO LIMIT) GPS/GAL week number of current epoch
@@ -692,67 +857,118 @@ private:
 	int epochFlag;		//The type of data following this epoch record (observation, event, ...). See RINEX definition
 	int nSatsEpoch;		//Number of satellites or special records in current epoch
 	double epochTimeTag;	//A tag to identify the measurements of a given epoch. Could be the estimated time of current epoch before fix
-	struct SatObsData {	//defines data storage for a satellite observable (pseudorrange, phase, ...) in an epoch.
-		unsigned int sysIndex;		//the system this observable belongs: its index in systems vector (see above)
-		int satellite;		//the satellite this observable belongs: PRN of satellite
-		unsigned int obsTypeIndex;	//the observable type: its index in obsType vector (inside the GNSSsystem object referred by sysIndex)
- 		double obsValue;	//the value of this observable
-		int lossOfLock;		//if loss of lock happened when observable was taken
-		int strength;		//the signal strength when observable was taken
-		//constructor
-		SatObsData (double obsTag, unsigned int sysIdx, int sat, unsigned int obsIdx, double obsVal, int lol, int str) {
-			sysIndex = sysIdx;
-			satellite = sat;
-			obsTypeIndex = obsIdx;
-			obsValue = obsVal;
-			lossOfLock = lol;
-			strength = str;
-		};
-		//define operator for comparisons and sorting
-		bool operator < (const SatObsData& param) const {
-			if (sysIndex < param.sysIndex) return true;
-			if (sysIndex > param.sysIndex) return false;
-			//same system
-			if (satellite < param.satellite) return true;
-			if (satellite > param.satellite) return false;
-			//same system and satellite
-			if (obsTypeIndex <= param.obsTypeIndex) return true;
-			return false;
-		};
-	};
 	vector <SatObsData> epochObs;	//A place to store observable data (pseudorange, phase, ...) for one epoch
 	//Epoch navigation data
-	struct SatNavData {	//defines storage for navigation data for a given GNSS satellite
-		double navTimeTag;	//a time tag to identify the epoch of this data:
-            //for GPS: seconds from GPS epoch, or GPS_week_number * 604800 + time_of_week. Week without roll-over. Seconds without leap seconds.
-            //for GAL: seconds from GPS epoch, or (GAL_week_number + 1024) * 604800 + time_of_week. Week without roll-over. Seconds without leap seconds.
-            //      The GAL epoch is the 1st GPS roll over, or 22/8/1999 00:00:00 UTC minus 13s., or 21/8/1999 23:59:47 UTC)
-            //for BDS: seconds from GPS epoch, or (BDS week_number + 1356) * 604800 + time_of_week + 14. Week without roll-over. Seconds without leap seconds.
-            //      The BDS epoch (1/1/2006 00:00:00 UTC) is GPS week 1356 tow 14
-            //for GLO: UTC seconds from GPS epoch plus 3h. It includes leap seconds.
+	struct SatNavMantissa {	//defines compact storage for navigation data mantissas of a given GNSS satellite. They are scaled when used
+		double navTimeTag;	//a time tag to identify the epoch of this data (as per SatNavData)
 		char systemId;	//the system identification (G, E, R, ...)
 		int satellite;	//the PRN of the satellite navigation data belong
-		double broadcastOrbit[BO_MAXLINS][BO_MAXCOLS];	//the eigth lines of RINEX navigation data, with four parameters each
+		NavScaler scaler;	//the function to apply to mantissas to obtain broadcast orbit data
+		int broadcastOrbitM[BO_MAXLINS][BO_MAXCOLS];	//the mantissas of the eigth lines of RINEX navigation data, with four parameters each
 		//constructor
-		SatNavData(double tT, char sys, int sat, double bo[][BO_MAXCOLS]) {
-			navTimeTag = tT;
+		SatNavMantissa(char sys, int sat, int bom[][BO_MAXCOLS], NavScaler sc) {
+			double bo[BO_LINSTOTAL][BO_MAXCOLS];
 			systemId = sys;
 			satellite = sat;
-			memcpy(broadcastOrbit, bo, sizeof(broadcastOrbit));
+			scaler = sc;
+			memcpy(broadcastOrbitM, bom, sizeof(broadcastOrbitM));
+			navTimeTag = scale(bo);
 		};
-		//define operator for comparisons and sorting
-		bool operator < (const SatNavData &param) const {
+		//apply scale factors to mantissas to obtain broadcast orbit data. It returns the time tag
+		double scale(double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) const {
+			int bom[BO_LINSTOTAL][BO_MAXCOLS];
+			memset(bom, 0, sizeof(bom));
+			memcpy(bom, broadcastOrbitM, sizeof(broadcastOrbitM));
+			return scaler(bom, bo);
+		};
+		//get the scaled navigation data
+		SatNavData toSatNavData() const {
+			double bo[BO_LINSTOTAL][BO_MAXCOLS];
+			double tTag = scale(bo);
+			return SatNavData(tTag, systemId, satellite, bo);
+		};
+		//define operator for comparisons and sorting (as per SatNavData)
+		bool operator < (const SatNavMantissa &param) const {
 			if(navTimeTag < param.navTimeTag) return true;
 			if(navTimeTag > param.navTimeTag) return false;
-			//same time tag
 			if (systemId < param.systemId) return true;
 			if (systemId > param.systemId) return false;
-			//same time tag and system
 			if (satellite < param.satellite) return true;
 			return false;
 		};
 	};
+	struct NavMantKey {	//identifies navigation data saved as mantissas, to find duplicates comparing integers only
+		char systemId;	//the system identification (G, E, R, ...)
+		int satellite;	//the PRN of the satellite navigation data belong
+		int broadcastOrbitM[BO_MAXLINS][BO_MAXCOLS];	//the mantissas, being broadcastOrbitM[0][0] the ephemeris reference time
+		//constructor
+		NavMantKey(char sys, int sat, const int bom[][BO_MAXCOLS]) {
+			systemId = sys;
+			satellite = sat;
+			memcpy(broadcastOrbitM, bom, sizeof(broadcastOrbitM));
+		};
+		//order by system, satellite and reference time, and then by the rest of mantissas
+		bool operator < (const NavMantKey &param) const {
+			if (systemId != param.systemId) return systemId < param.systemId;
+			if (satellite != param.satellite) return satellite < param.satellite;
+			if (broadcastOrbitM[0][0] != param.broadcastOrbitM[0][0]) return broadcastOrbitM[0][0] < param.broadcastOrbitM[0][0];
+			return memcmp(broadcastOrbitM, param.broadcastOrbitM, sizeof(broadcastOrbitM)) < 0;
+		};
+	};
 	vector <SatNavData> epochNav;		//A place to store navigation data for one epoch
+	vector <SatNavMantissa> epochNavMant;	//A place to store navigation data saved as mantissas
+	set <NavMantKey> epochNavMantKeys;	//The keys of the data in epochNavMant, to find duplicates
+	//An ephemeris store indexed by system-satellite and by time tag. It is filled only when enabled
+	bool ephStoreEnabled;
+	map <pair<char, int>, map<double, SatNavData> > ephStore;
+	//Streaming of navigation epochs: when active, epochNav and epochNavMant are min-heaps by time tag
+	FILE* navStreamOut;			//the file where navigation epochs are streamed, or NULL if not streaming
+	double navStreamWindow;		//the time span of navigation epochs kept in epochNav before printing them
+	double navStreamNewest;		//the newest time tag saved while streaming
+	double navStreamPrinted;	//the time tag of the last navigation epoch printed while streaming
+	double navStreamFirst;		//the oldest time tag printed while streaming, or 0 if none printed
+	//Input RINEX file mapped in memory: lines are read from it without copying them
+	struct RinexLine {	//defines a view of a line read. Columns beyond its end are considered blanks
+		const char* data;	//the first char of the line
+		unsigned int len;	//the line length, without end of line chars
+		//get the char in the given column
+		char at(unsigned int col) const {
+			return col < len ? data[col] : ' ';
+		};
+		//get the width of the field starting in the given column that is inside the line
+		unsigned int width(unsigned int col, unsigned int w) const {
+			if (col >= len) return 0;
+			return col + w > len ? len - col : w;
+		};
+		//check if the field starting in the given column is blank
+		bool isBlank(unsigned int col, unsigned int w) const {
+			for (unsigned int i = col; i < col + w && i < len; i++) if (data[i] != ' ') return false;
+			return true;
+		};
+	};
+	FILE* mapFile;			//the input file mapped in memory, or NULL if none
+	const char* mapData;	//the start of the mapped area (the whole file)
+	size_t mapSize;			//the size of the mapped area
+	size_t mapPos;			//the position in the mapped area of the next line to read
+	char inLine[RINEX_MAXLINE];	//the buffer for lines read from files not mapped
+	RinexDecoder* inDecoder;	//the decoder of the compressed input file, or NULL if none
+	//Index of epochs in the input observation file: time tag and position in the file of each epoch line
+	vector <pair<double, long> > obsEpochIndex;
+	//Parallel reading of the input observation file: epochs are read ahead by several threads and delivered in order
+	struct ObsEpochRead {	//defines data of an epoch read ahead
+		long pos;			//the position in the file of the epoch
+		long endPos;		//the position in the file after the epoch
+		int status;			//the status returned by readObsEpoch
+		int week;			//epoch time, clock offset, flag and number of satellites (as per epochWeek, ...)
+		double tow;
+		double timeTag;
+		double clkOffset;
+		int flag;
+		int nSats;
+		vector <SatObsData> obs;	//the observable data
+	};
+	int obsReadThreads;		//the number of threads used to read observation files (1 when reading is not made in parallel)
+	deque <ObsEpochRead> obsReadAhead;	//epochs read ahead and not delivered yet
 	//A state variable used to store reference to the label of the last record which data has been modified
 	vector<LABELdata>::iterator lastRecordSet;
 	unsigned int numberV2ObsTypes;
@@ -768,14 +984,36 @@ private:
 	bool getLabelFlag(RINEXlabel);
 	RINEXlabel checkLabel(char *);
 	RINEXlabel findLabelId(char *);
+	static constexpr uint32_t hashPoly(const char *label, int len, uint32_t h);
+	static constexpr unsigned int hashLabel(const char *label, int len);
+	static constexpr RINEXlabel labelWithHash(unsigned int h, unsigned int i);
+	static constexpr bool hasUniqueHashes(unsigned int i);
+	vector<LABELdata>::iterator insertComment(vector<LABELdata>::iterator pos, const string &comment);
 	string valueLabel(RINEXlabel label, string toAppend = string());
 	int readV2ObsEpoch(FILE* input);
 	int readV3ObsEpoch(FILE* input);
 	int readObsEpochEvent(FILE* input, bool wrongDate);
 	void printHdLineData (FILE* out, vector<LABELdata>::iterator lbIter);
-	bool printSatObsValues(FILE* out, RINEXversion ver);
+	bool printSatObsValues(FILE* out, RINEXversion ver, vector<SatObsData>::iterator &itobs);
+	void printSatNavData(FILE* out, SatNavData &nav);
+	void printSelSatNavData(FILE* out, SatNavData &nav);
+	void scaleNavMantissas();
+	void storeEphemeris(const SatNavData &nav);
+	void flushNavStream(double limit);
+	static bool isNavLater(const SatNavData &a, const SatNavData &b);
+	static bool isNavMantLater(const SatNavMantissa &a, const SatNavMantissa &b);
+	static bool isMantBefore(const SatNavMantissa &m, const SatNavData &nav);
 	RINEXlabel readHdLineData(FILE* input);
 	bool readRinexRecord(char* rinexRec, int recSize, FILE* input);
+	bool readRinexLine(RinexLine &line, FILE* input);
+	long getInputPos(FILE* input);
+	void setInputPos(FILE* input, long pos);
+	int readObsEpochAhead(FILE* input);
+	void fillObsReadAhead();
+	void setObsReader(RinexData &reader, long pos);
+	void readObsChunk(long endPos, vector<ObsEpochRead> &epochs);
+	long findObsEpochStart(long pos);
+	bool readMergeEpoch(FILE* input);
 	bool isSatSelected(int sysIx, int sat);
     unsigned int getSysIndex(char sysId);
 	int systemIndex(char sysCode);
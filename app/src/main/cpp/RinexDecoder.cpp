@@ -0,0 +1,422 @@
+/** @file RinexDecoder.cpp
+ * Contains the implementation of the RinexDecoder class.
+ */
+#include "RinexDecoder.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+/**RinexDecoder constructor identifies the compression used in the given input file, reading its first data.
+ * gzip files are identified by their magic number, and Compact RINEX files by the label of their first line.
+ *
+ * @param input the already open input stream with the RINEX file, positioned at its beginning
+ * @param plogger a pointer to a Logger to be used to record logging messages
+ */
+RinexDecoder::RinexDecoder(FILE* input, Logger* plogger) {
+    const char* data;
+    unsigned int len;
+    inFile = input;
+    plog = plogger;
+    gzipped = gzipEnd = rawEof = false;
+    rawPos = rawLen = 0;
+    rawBuf.resize(DEC_RAWBUFSIZE);
+    crxVersion = 0;
+    crxHeader = false;
+    ntypesV2 = 0;
+    outPos = 0;
+    memset(&zStream, 0, sizeof zStream);
+    zStream.next_in = inBuf;
+    zStream.avail_in = fread(inBuf, 1, sizeof inBuf, inFile);
+    if ((zStream.avail_in >= 2) && (inBuf[0] == 0x1f) && (inBuf[1] == 0x8b)) {
+        //windowBits 15 + 32 to inflate gzip data with automatic header detection
+        gzipped = inflateInit2(&zStream, 15 + 32) == Z_OK;
+        if (gzipped) plog->info(msgDecGzip);
+    }
+    if (!gzipped) {
+        memcpy(&rawBuf[0], inBuf, zStream.avail_in);
+        rawLen = zStream.avail_in;
+        zStream.avail_in = 0;
+    }
+    //the first line is read to identify Compact RINEX files, and left pending to be read
+    if (!readRawLine(data, len) && (len > 60) && (strncmp(data + 60, "CRINEX VERS   / TYPE", 20) == 0)) {
+        string version(data, 20);
+        version.erase(version.find_last_not_of(' ') + 1);
+        switch (atoi(version.c_str())) {
+        case 1:
+        case 3:
+            crxVersion = atoi(version.c_str());
+            crxHeader = true;
+            plog->info(msgDecCrx + version);
+            break;
+        default:
+            plog->warning(msgDecCrxVer + version);
+            break;
+        }
+    }
+    rawPos = 0;
+}
+
+/**RinexDecoder destructor
+ */
+RinexDecoder::~RinexDecoder() {
+    if (gzipped) inflateEnd(&zStream);
+}
+
+/**isCompressed tells if the input file is compressed (gzip and/or Compact RINEX).
+ *
+ * @return true if the input file is compressed, false if it is a plain text file
+ */
+bool RinexDecoder::isCompressed() {
+    return gzipped || (crxVersion != 0);
+}
+
+/**isGzip tells if the input file is gzip compressed.
+ *
+ * @return true if the input file is gzip compressed, false otherwise
+ */
+bool RinexDecoder::isGzip() {
+    return gzipped;
+}
+
+/**isCompact tells if the input file is in Compact RINEX format.
+ *
+ * @return true if the input file is a Compact RINEX one, false otherwise
+ */
+bool RinexDecoder::isCompact() {
+    return crxVersion != 0;
+}
+
+/**getFile gives the input file decoded.
+ *
+ * @return the input stream given when the object was created
+ */
+FILE* RinexDecoder::getFile() {
+    return inFile;
+}
+
+/**readLine reads the next line of the decompressed RINEX file, giving a view of it without the EOL.
+ * The view remains valid until the next line is read.
+ *
+ * @param data the pointer to the first character in the line
+ * @param len the number of characters in the line
+ * @return true if EOF happens when reading, false otherwise
+ */
+bool RinexDecoder::readLine(const char* &data, unsigned int &len) {
+    if (crxVersion == 0) return readRawLine(data, len);
+    while (outPos >= outText.size()) {
+        outText.clear();
+        outPos = 0;
+        if (!decodeRecord()) return true;
+    }
+    size_t eol = outText.find('\n', outPos);
+    data = outText.data() + outPos;
+    len = eol - outPos;
+    outPos = eol + 1;
+    return false;
+}
+
+/**fillRaw appends to the raw data buffer the next data from the input file, inflating them for gzip files.
+ * Data already used in the buffer are removed, and the buffer is enlarged when full.
+ *
+ * @return true if data have been appended, false if there are not more data in the file
+ */
+bool RinexDecoder::fillRaw() {
+    if (rawEof) return false;
+    if (rawPos > 0) {
+        memmove(&rawBuf[0], &rawBuf[rawPos], rawLen - rawPos);
+        rawLen -= rawPos;
+        rawPos = 0;
+    }
+    if (rawLen == rawBuf.size()) rawBuf.resize(rawBuf.size() * 2);
+    size_t start = rawLen;
+    if (!gzipped) rawLen += fread(&rawBuf[rawLen], 1, rawBuf.size() - rawLen, inFile);
+    while (gzipped && !gzipEnd && (rawLen == start)) {
+        if (zStream.avail_in == 0) {
+            zStream.next_in = inBuf;
+            zStream.avail_in = fread(inBuf, 1, sizeof inBuf, inFile);
+            if (zStream.avail_in == 0) {
+                plog->warning(msgDecGzipErr + msgDecGzipEof);
+                gzipEnd = true;
+                break;
+            }
+        }
+        zStream.next_out = (Bytef*) &rawBuf[rawLen];
+        zStream.avail_out = rawBuf.size() - rawLen;
+        int ret = inflate(&zStream, Z_NO_FLUSH);
+        rawLen = rawBuf.size() - zStream.avail_out;
+        if (ret == Z_STREAM_END) {
+            //other gzip members may follow
+            if (zStream.avail_in == 0) {
+                zStream.next_in = inBuf;
+                zStream.avail_in = fread(inBuf, 1, sizeof inBuf, inFile);
+            }
+            if (zStream.avail_in == 0) gzipEnd = true;
+            else inflateReset(&zStream);
+        } else if ((ret != Z_OK) && (ret != Z_BUF_ERROR)) {
+            plog->warning(msgDecGzipErr + (zStream.msg == NULL ? to_string(ret) : string(zStream.msg)));
+            gzipEnd = true;
+        }
+    }
+    if (rawLen == start) rawEof = true;
+    return rawLen > start;
+}
+
+/**readRawLine reads the next line from the raw data (decompressed gzip or plain data), giving a view of it without the EOL.
+ * The view remains valid until the next line is read.
+ *
+ * @param data the pointer to the first character in the line
+ * @param len the number of characters in the line
+ * @return true if EOF happens when reading, false otherwise
+ */
+bool RinexDecoder::readRawLine(const char* &data, unsigned int &len) {
+    const char* eol;
+    while ((eol = (const char*) memchr(rawBuf.data() + rawPos, '\n', rawLen - rawPos)) == NULL) {
+        if (!fillRaw()) {
+            if (rawPos >= rawLen) return true;
+            eol = rawBuf.data() + rawLen;
+            break;
+        }
+    }
+    data = rawBuf.data() + rawPos;
+    len = eol - data;
+    rawPos = (rawPos + len < rawLen) ? rawPos + len + 1 : rawLen;
+    if ((len > 0) && (data[len - 1] == '\r')) len--;
+    return false;
+}
+
+/**decodeRecord restores from the Compact RINEX input the next header line or the next epoch with its observation records,
+ * appending the RINEX lines restored to outText.
+ * Epoch lines contain the text differences with the previous epoch line, followed by a line with the receiver clock offset,
+ * and a line for each satellite in the epoch with its observables and flags.
+ *
+ * @return true if a record has been decoded (it could give no lines), false if there are not more records
+ */
+bool RinexDecoder::decodeRecord() {
+    const char* data;
+    unsigned int len;
+    if (readRawLine(data, len)) return false;
+    string line(data, len);
+    if (crxHeader) {
+        //Compact RINEX header lines are removed, and the rest of lines are given unchanged
+        if ((len > 60) && (strncmp(data + 60, "CRINEX ", 7) == 0)) return true;
+        setObsTypes(data, len);
+        if ((len > 60) && (strncmp(data + 60, "END OF HEADER", 13) == 0)) crxHeader = false;
+        appendLine(outText, line);
+        return true;
+    }
+    //restore the epoch line. Satellites in the epoch are appended to it
+    if ((crxVersion == 1 && data[0] == '&') || (crxVersion == 3 && data[0] == '>')) {
+        epochLine = line;
+        if (crxVersion == 1) epochLine[0] = ' ';
+    } else if (epochLine.empty()) {
+        plog->warning(msgDecCrxEpoch + line);
+        return true;
+    } else applyTextDiff(epochLine, data, len);
+    size_t flagPos = (crxVersion == 1) ? 28 : 31;
+    size_t satPos = (crxVersion == 1) ? 32 : 41;
+    if (epochLine.size() < satPos) epochLine.resize(satPos, ' ');
+    int flag = (epochLine[flagPos] >= '0' && epochLine[flagPos] <= '9') ? epochLine[flagPos] - '0' : 0;
+    int nsats = atoi(epochLine.substr(flagPos + 1, 3).c_str());
+    string rec = epochLine.substr(0, (crxVersion == 1) ? satPos : flagPos + 4);
+    if (flag > 1 && flag < 6) {
+        //special event: the following records are given unchanged, and next epoch line shall be initialised
+        appendLine(outText, rec);
+        for (int i = 0; (i < nsats) && !readRawLine(data, len); i++) {
+            setObsTypes(data, len);
+            appendLine(outText, string(data, len));
+        }
+        epochLine.clear();
+        return true;
+    }
+    string sats = epochLine.substr(satPos);
+    sats.resize(nsats * 3, ' ');
+    //restore the receiver clock offset. It has 9 decimals in V2 files and 12 in V3 files
+    bool hasClock = false;
+    if (readRawLine(data, len)) return false;
+    if (len == 0) clockArc.valid = false;
+    else hasClock = clockArc.update(data, len);
+    if (crxVersion == 1) {
+        for (int i = 0; (i == 0) || (i < nsats); i += 12) {
+            if (i > 0) rec.assign(satPos, ' ');
+            rec.append(sats, i * 3, 36);
+            if ((i == 0) && hasClock) {
+                rec.resize(68, ' ');
+                appendFixed(rec, clockArc.y[0], 12, 9);
+            }
+            appendLine(outText, rec);
+        }
+    } else {
+        if (hasClock) {
+            rec.resize(41, ' ');
+            appendFixed(rec, clockArc.y[0], 15, 12);
+        }
+        appendLine(outText, rec);
+    }
+    //restore satellite observations. Data of satellites not in this epoch are removed
+    map<string, SatData> epochSats;
+    for (int i = 0; i < nsats; i++) {
+        string sat = sats.substr(i * 3, 3);
+        SatData &satEpoch = epochSats[sat];
+        map<string, SatData>::iterator it = satData.find(sat);
+        if (it != satData.end()) {
+            satEpoch.arcs.swap(it->second.arcs);
+            satEpoch.flags.swap(it->second.flags);
+        }
+        if (!decodeSatellite(sat, satEpoch)) break;
+    }
+    satData.swap(epochSats);
+    return true;
+}
+
+/**decodeSatellite reads the Compact RINEX line with observables and flags of a satellite, and appends to outText
+ * the RINEX records restored.
+ * Observable fields are separated by a space. Empty fields are missing observables, fields with '&' start a new arc
+ * of data giving its order of differences and the initial value, and the rest of fields are the differences of
+ * the given order. Flags (LLI and signal strength) follow the last field as text differences.
+ *
+ * @param sat the satellite identification as given in the epoch line
+ * @param data the data arcs and flags of the satellite from previous epochs, to be updated
+ * @return true if the line has been read, false if EOF happens
+ */
+bool RinexDecoder::decodeSatellite(const string &sat, SatData &data) {
+    const char* line;
+    unsigned int len, pos, end;
+    if (readRawLine(line, len)) return false;
+    int ntypes = getNumTypes(sat[0]);
+    if ((int) data.arcs.size() != ntypes) {
+        data.arcs.assign(ntypes, DiffArc());
+        data.flags.assign(ntypes * 2, ' ');
+    }
+    pos = 0;
+    for (int i = 0; i < ntypes; i++) {
+        if (pos > len) {
+            data.arcs[i].valid = false;
+            continue;
+        }
+        for (end = pos; (end < len) && (line[end] != ' '); end++);
+        if (end == pos) data.arcs[i].valid = false;
+        else if (!data.arcs[i].update(line + pos, end - pos)) plog->warning(msgDecCrxArc + sat);
+        pos = end + 1;
+    }
+    if (pos < len) applyTextDiff(data.flags, line + pos, len - pos);
+    data.flags.resize(ntypes * 2, ' ');
+    //V3 records start with the satellite. V2 records have up to 5 observables per line
+    string rec;
+    if (crxVersion == 3) rec = sat;
+    for (int i = 0; i < ntypes; i++) {
+        if ((crxVersion == 1) && (i > 0) && (i % 5 == 0)) {
+            appendLine(outText, rec);
+            rec.clear();
+        }
+        if (data.arcs[i].valid) appendFixed(rec, data.arcs[i].y[0], 14, 3);
+        else rec.append(14, ' ');
+        rec.append(data.flags, i * 2, 2);
+    }
+    appendLine(outText, rec);
+    return true;
+}
+
+/**update restores the current value of a data arc from the given Compact RINEX field.
+ * Values are integers (the RINEX value without its decimal point).
+ *
+ * @param field the field with the arc initialisation (order&value) or the difference of the arc order
+ * @param len the length of the field
+ * @return true if the value has been restored, false if the arc has not been initialised
+ */
+bool RinexDecoder::DiffArc::update(const char* field, unsigned int len) {
+    const char* end = field + len;
+    const char* amp = (const char*) memchr(field, '&', len);
+    if (amp != NULL) {
+        maxOrder = 0;
+        for (; field < amp; field++) if (*field >= '0' && *field <= '9') maxOrder = maxOrder * 10 + *field - '0';
+        if (maxOrder > DEC_MAXORDER) maxOrder = DEC_MAXORDER;
+        order = 0;
+        valid = true;
+        field = amp + 1;
+    } else if (!valid) return false;
+    else if (order < maxOrder) order++;
+    bool negative = (field < end) && (*field == '-');
+    if (negative) field++;
+    long long value = 0;
+    for (; field < end; field++) if (*field >= '0' && *field <= '9') value = value * 10 + *field - '0';
+    y[order] = negative ? -value : value;
+    for (int i = order; i > 0; i--) y[i - 1] += y[i];
+    return true;
+}
+
+/**setObsTypes updates the number of observation types per system when the given header line defines them.
+ *
+ * @param data the header line
+ * @param len the length of the line
+ */
+void RinexDecoder::setObsTypes(const char* data, unsigned int len) {
+    if (len <= 60) return;
+    if ((strncmp(data + 60, "# / TYPES OF OBSERV", 19) == 0) && (strspn(data, " ") < 6)) {
+        ntypesV2 = atoi(string(data, 6).c_str());
+    } else if ((strncmp(data + 60, "SYS / # / OBS TYPES", 19) == 0) && (data[0] != ' ')) {
+        ntypesV3[data[0]] = atoi(string(data + 3, 3).c_str());
+    }
+}
+
+/**getNumTypes gives the number of observation types for the given system.
+ *
+ * @param sys the system identification character
+ * @return the number of observation types defined in the header for the system, or 0 if not defined
+ */
+int RinexDecoder::getNumTypes(char sys) {
+    if (crxVersion == 1) return ntypesV2;
+    map<char, int>::iterator it = ntypesV3.find(sys);
+    if (it != ntypesV3.end()) return it->second;
+    plog->warning(msgDecCrxTypes + string(1, sys));
+    ntypesV3[sys] = 0;
+    return 0;
+}
+
+/**applyTextDiff updates the given text with the differences given.
+ * A space in the differences means no change, '&' means a space, and any other character replaces the existing one.
+ *
+ * @param text the text to update
+ * @param diff the text differences
+ * @param len the length of the differences
+ */
+void RinexDecoder::applyTextDiff(string &text, const char* diff, unsigned int len) {
+    if (text.size() < len) text.resize(len, ' ');
+    for (unsigned int i = 0; i < len; i++) {
+        if (diff[i] == '&') text[i] = ' ';
+        else if (diff[i] != ' ') text[i] = diff[i];
+    }
+}
+
+/**appendFixed appends to the given text a fixed point value right justified in the given width.
+ *
+ * @param text the text where value will be appended
+ * @param value the value as an integer without decimal point
+ * @param width the width of the field
+ * @param decimals the number of decimal digits in the value
+ */
+void RinexDecoder::appendFixed(string &text, long long value, int width, int decimals) {
+    char digits[24], field[32];
+    int n = 0, m = 0;
+    unsigned long long absValue = value < 0 ? 0ULL - (unsigned long long) value : value;
+    do {
+        digits[n++] = '0' + absValue % 10;
+        absValue /= 10;
+    } while ((absValue > 0) || (n <= decimals));
+    if (value < 0) field[m++] = '-';
+    for (int i = n - 1; i >= decimals; i--) field[m++] = digits[i];
+    field[m++] = '.';
+    for (int i = decimals - 1; i >= 0; i--) field[m++] = digits[i];
+    if (m < width) text.append(width - m, ' ');
+    text.append(field, m);
+}
+
+/**appendLine appends to the given text a line without trailing blanks and its EOL.
+ *
+ * @param text the text where line will be appended
+ * @param line the line to append
+ */
+void RinexDecoder::appendLine(string &text, const string &line) {
+    size_t end = line.find_last_not_of(' ');
+    if (end != string::npos) text.append(line, 0, end + 1);
+    text.push_back('\n');
+}
@@ -0,0 +1,109 @@
+/** @file RinexDecoder.h
+ * Contains RinexDecoder class definition.
+ * A RinexDecoder object reads lines from compressed RINEX input files (gzip and Compact RINEX) decompressing
+ * them while reading.
+ *
+ *Copyright 2015, 2021 by Francisco Cancillo & Luis Cancillo
+ *<p>
+ *This file is part of the toRINEX tool.
+ *<p>
+ *<p>Ver.	|Date	|Reason for change
+ *<p>---------------------------------
+ *<p>V1.0	|10/2026|First release
+ */
+#ifndef RINEXDECODER_H
+#define RINEXDECODER_H
+
+#include <stdio.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <zlib.h>
+
+#include "Logger.h"
+
+using namespace std;
+
+//@cond DUMMY
+#define DEC_INBUFSIZE 65536     //size of the buffer for compressed data read from the input file
+#define DEC_RAWBUFSIZE 262144   //initial size of the buffer for decompressed (gzip) or plain data
+#define DEC_MAXORDER 9          //maximum order of differences in Compact RINEX data arcs
+//messages
+const string msgDecGzip("Input file is gzip compressed");
+const string msgDecCrx("Input file is in Compact RINEX format version ");
+const string msgDecGzipErr("Error decompressing gzip input: ");
+const string msgDecGzipEof("unexpected end of file");
+const string msgDecCrxVer("Unsupported Compact RINEX version: ");
+const string msgDecCrxEpoch("Compact RINEX epoch not initialized: ");
+const string msgDecCrxArc("Compact RINEX data arc not initialized for satellite ");
+const string msgDecCrxTypes("Compact RINEX observation types not defined for satellite ");
+//@endcond
+
+/**RinexDecoder class decompresses RINEX files while reading them, giving their lines as they would be read from
+ * the uncompressed RINEX file.
+ * <p>Two compressions are handled, which can be combined:
+ * - gzip (.gz files): data are inflated using zlib while read from the input file. Files with several gzip members
+ *   are decompressed as a whole.
+ * - Compact RINEX (Hatanaka compression) versions 1.0 (for RINEX V2 observation files) and 3.0 (for RINEX V3
+ *   observation files): epoch and observation records are restored from the text differences and the arithmetic
+ *   differences kept by the format, and given with the RINEX V2 or V3 layout.
+ * <p>The constructor identifies the compression used from the first data in the input file. The object shall be
+ * used only if isCompressed tells that the file is compressed. Lines are read sequentially using readLine, and
+ * positioning in the input file is not possible.
+ */
+class RinexDecoder {
+public:
+    RinexDecoder(FILE* input, Logger* plogger);
+    ~RinexDecoder();
+    bool isCompressed();
+    bool isGzip();
+    bool isCompact();
+    FILE* getFile();
+    bool readLine(const char* &data, unsigned int &len);
+    friend class DecoderTest;       //the host test of compressed files decoding
+
+private:
+    FILE* inFile;
+    Logger* plog;
+    //gzip decompression
+    bool gzipped;
+    bool gzipEnd;               //the last gzip member has been inflated
+    z_stream zStream;
+    unsigned char inBuf[DEC_INBUFSIZE];
+    //decompressed (or plain) data pending to be split in lines
+    vector<char> rawBuf;
+    size_t rawPos, rawLen;
+    bool rawEof;
+    //Compact RINEX decoding
+    int crxVersion;             //1 or 3 for Compact RINEX files, 0 otherwise
+    bool crxHeader;             //the header is being read
+    int ntypesV2;               //number of observation types in V2 files
+    map<char, int> ntypesV3;    //number of observation types for each system in V3 files
+    struct DiffArc {            //data to restore values from their differences
+        bool valid;
+        int order;
+        int maxOrder;
+        long long y[DEC_MAXORDER + 1];
+        DiffArc() { valid = false; order = maxOrder = 0; }
+        bool update(const char* field, unsigned int len);
+    } clockArc;
+    struct SatData {            //data arcs and flags of each satellite
+        vector<DiffArc> arcs;
+        string flags;
+    };
+    map<string, SatData> satData;
+    string epochLine;           //the Compact RINEX epoch line restored
+    string outText;             //RINEX lines restored pending to be given
+    size_t outPos;
+
+    bool fillRaw();
+    bool readRawLine(const char* &data, unsigned int &len);
+    bool decodeRecord();
+    void setObsTypes(const char* data, unsigned int len);
+    int getNumTypes(char sys);
+    bool decodeSatellite(const string &sat, SatData &data);
+    static void applyTextDiff(string &text, const char* diff, unsigned int len);
+    static void appendFixed(string &text, long long value, int width, int decimals);
+    static void appendLine(string &text, const string &line);
+};
+#endif //RINEXDECODER_H
@@ -0,0 +1,399 @@
+/** @file SatOrbits.cpp
+ * Contains the implementation of the SatOrbits class.
+ */
+#include "SatOrbits.h"
+
+#include <algorithm>
+#include <math.h>
+
+//@cond DUMMY
+const double ORB_WGS84_E2 = 6.69437999014e-3;   //WGS-84 first eccentricity squared
+const double ORB_PI = 3.1415926535898;
+const double ORB_GEO_INCL = -5.0 * ORB_PI / 180.0;  //rotation angle for BDS GEO satellites
+//@endcond
+
+/**SatOrbits constructor creates an empty container of ephemerides.
+ */
+SatOrbits::SatOrbits() {
+    leapSeconds = ORB_LEAPSECONDS;
+    clear();
+}
+
+/**SatOrbits destructor
+ */
+SatOrbits::~SatOrbits() {
+}
+
+/**clear removes all ephemerides and computed positions stored in the object.
+ */
+void SatOrbits::clear() {
+    kepler.clear();
+    glonass.clear();
+    satIndex.clear();
+    selKepler.clear();
+    selGlonass.clear();
+    posX.clear();
+    posY.clear();
+    posZ.clear();
+    posIndex.clear();
+}
+
+/**isEmpty tells if there are ephemerides stored in the object.
+ *
+ * @return true if no ephemeris has been stored, false otherwise
+ */
+bool SatOrbits::isEmpty() {
+    return satIndex.empty();
+}
+
+/**setLeapSeconds sets the difference between GPS time and UTC, used to compute positions of GLONASS satellites,
+ * which ephemerides have UTC time tags. By default it is ORB_LEAPSECONDS.
+ *
+ * @param leap the GPS - UTC difference in seconds
+ */
+void SatOrbits::setLeapSeconds(double leap) {
+    leapSeconds = leap;
+}
+
+/**addEphemeris stores the given broadcast orbit data of a satellite for further computation of its positions.
+ * Broadcast orbit data shall be arranged as per RINEX navigation files, with data in actual units (already scaled).
+ * Ephemerides already stored for the same satellite and time tag are ignored.
+ *
+ * @param sys the system identification (G, R, E or C)
+ * @param sat the satellite PRN number (slot number for GLONASS)
+ * @param tTag the time tag of the ephemeris as seconds from the GPS epoch
+ * @param bo the broadcast orbit data as per RINEX navigation files
+ * @return true if ephemeris has been stored, false if they were already stored or the system is not supported
+ */
+bool SatOrbits::addEphemeris(char sys, int sat, double tTag, double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    double toeOffset;
+    vector<double> *ptTags;
+    switch (sys) {
+        case 'G':
+        case 'E':
+        case 'C':
+            ptTags = &kepler.tTag;
+            break;
+        case 'R':
+            ptTags = &glonass.tTag;
+            break;
+        default:
+            return false;
+    }
+    //find the position to insert the new ephemeris in the satellite index, sorted by time tag
+    vector<size_t> &idx = satIndex[make_pair(sys, sat)];
+    vector<size_t>::iterator it = idx.begin();
+    while (it != idx.end() && (*ptTags)[*it] < tTag) ++it;
+    if (it != idx.end() && (*ptTags)[*it] == tTag) return false;
+    if (sys == 'R') {
+        idx.insert(it, glonass.size());
+        glonass.sat.push_back(sat);
+        glonass.tTag.push_back(tTag);
+        glonass.x.push_back(bo[1][0]);
+        glonass.vx.push_back(bo[1][1]);
+        glonass.ax.push_back(bo[1][2]);
+        glonass.y.push_back(bo[2][0]);
+        glonass.vy.push_back(bo[2][1]);
+        glonass.ay.push_back(bo[2][2]);
+        glonass.z.push_back(bo[3][0]);
+        glonass.vz.push_back(bo[3][1]);
+        glonass.az.push_back(bo[3][2]);
+        return true;
+    }
+    idx.insert(it, kepler.size());
+    kepler.sys.push_back(sys);
+    kepler.sat.push_back(sat);
+    kepler.tTag.push_back(tTag);
+    //Toe as seconds from the GPS epoch, taking into account a possible week crossover between Toc and Toe
+    toeOffset = bo[3][0] - bo[0][0];
+    if (toeOffset > 302400.0) toeOffset -= 604800.0;
+    else if (toeOffset < -302400.0) toeOffset += 604800.0;
+    kepler.toe.push_back(tTag + toeOffset);
+    kepler.toeSow.push_back(bo[3][0]);
+    kepler.mu.push_back(sys == 'G'? ORB_GPS_MU : ORB_GAL_MU);
+    kepler.omegaE.push_back(sys == 'C'? ORB_BDS_OMEGAE : ORB_GPS_OMEGAE);
+    kepler.geo.push_back((sys == 'C' && (sat <= 5 || sat >= 59))? 1.0 : 0.0);
+    kepler.crs.push_back(bo[1][1]);
+    kepler.deltaN.push_back(bo[1][2]);
+    kepler.m0.push_back(bo[1][3]);
+    kepler.cuc.push_back(bo[2][0]);
+    kepler.e.push_back(bo[2][1]);
+    kepler.cus.push_back(bo[2][2]);
+    kepler.sqrtA.push_back(bo[2][3]);
+    kepler.cic.push_back(bo[3][1]);
+    kepler.omega0.push_back(bo[3][2]);
+    kepler.cis.push_back(bo[3][3]);
+    kepler.i0.push_back(bo[4][0]);
+    kepler.crc.push_back(bo[4][1]);
+    kepler.omega.push_back(bo[4][2]);
+    kepler.omegaDot.push_back(bo[4][3]);
+    kepler.idot.push_back(bo[5][0]);
+    return true;
+}
+
+/**computePositions computes the positions at the given instant of all satellites having ephemeris
+ * for that instant. For each satellite it is used the ephemeris with time tag closest to the given one, if its
+ * age is not greater than the maximum stated.
+ *
+ * @param tTag the instant as seconds from the GPS epoch
+ * @param maxAge the maximum age of ephemeris to be used (seconds). If 0, default values per constellation are used
+ * @return the number of satellite positions computed
+ */
+int SatOrbits::computePositions(double tTag, double maxAge) {
+    size_t selected;
+    double tUTC = tTag - leapSeconds;   //GLONASS ephemerides have UTC time tags
+    selKepler.clear();
+    selGlonass.clear();
+    posIndex.clear();
+    for (map<pair<char,int>, vector<size_t> >::iterator it = satIndex.begin(); it != satIndex.end(); ++it) {
+        if (it->first.first == 'R') {
+            if (selectEphemeris(it->second, glonass.tTag, tUTC, maxAge > 0.0? maxAge : ORB_MAXAGE_GLO, selected))
+                selGlonass.push_back(selected);
+        } else {
+            if (selectEphemeris(it->second, kepler.tTag, tTag, maxAge > 0.0? maxAge : ORB_MAXAGE, selected))
+                selKepler.append(kepler, selected);
+        }
+    }
+    posX.resize(selKepler.size() + selGlonass.size());
+    posY.resize(posX.size());
+    posZ.resize(posX.size());
+    computeKepler(tTag, 0);
+    computeGlonass(tUTC, selKepler.size());
+    for (size_t k = 0; k < selKepler.size(); k++)
+        posIndex[make_pair(selKepler.sys[k], selKepler.sat[k])] = k;
+    for (size_t k = 0; k < selGlonass.size(); k++)
+        posIndex[make_pair('R', glonass.sat[selGlonass[k]])] = selKepler.size() + k;
+    return (int) posX.size();
+}
+
+/**getPosition provides the position of the given satellite computed in the last call to computePositions.
+ *
+ * @param sys the system identification
+ * @param sat the satellite number
+ * @param x the ECEF x coordinate of the satellite in meters
+ * @param y the ECEF y coordinate of the satellite in meters
+ * @param z the ECEF z coordinate of the satellite in meters
+ * @return true if the satellite position was computed, false otherwise
+ */
+bool SatOrbits::getPosition(char sys, int sat, double &x, double &y, double &z) {
+    map<pair<char,int>, size_t>::iterator it = posIndex.find(make_pair(sys, sat));
+    if (it == posIndex.end()) return false;
+    x = posX[it->second];
+    y = posY[it->second];
+    z = posZ[it->second];
+    return true;
+}
+
+/**getElevation provides the elevation of the given satellite as seen from the given receiver position, using
+ * the satellite position computed in the last call to computePositions.
+ *
+ * @param sys the system identification
+ * @param sat the satellite number
+ * @param rxX the ECEF x coordinate of the receiver in meters
+ * @param rxY the ECEF y coordinate of the receiver in meters
+ * @param rxZ the ECEF z coordinate of the receiver in meters
+ * @param elevation the elevation of the satellite in radians
+ * @return true if the satellite position was computed and elevation obtained, false otherwise
+ */
+bool SatOrbits::getElevation(char sys, int sat, double rxX, double rxY, double rxZ, double &elevation) {
+    double x, y, z;
+    if (!getPosition(sys, sat, x, y, z)) return false;
+    //up direction at the receiver position (geodetic latitude approximated in one step)
+    double p = sqrt(rxX * rxX + rxY * rxY);
+    double lat = atan2(rxZ, p * (1.0 - ORB_WGS84_E2));
+    double lon = atan2(rxY, rxX);
+    double upX = cos(lat) * cos(lon);
+    double upY = cos(lat) * sin(lon);
+    double upZ = sin(lat);
+    x -= rxX;
+    y -= rxY;
+    z -= rxZ;
+    double range = sqrt(x * x + y * y + z * z);
+    if (range <= 0.0) return false;
+    elevation = asin((x * upX + y * upY + z * upZ) / range);
+    return true;
+}
+
+//PRIVATE METHODS
+//===============
+
+/**clear removes all data in the Keplerian ephemeris set
+ */
+void SatOrbits::KeplerSet::clear() {
+    sys.clear();
+    sat.clear();
+    tTag.clear();
+    toe.clear();
+    toeSow.clear();
+    mu.clear();
+    omegaE.clear();
+    geo.clear();
+    sqrtA.clear(); e.clear(); m0.clear(); deltaN.clear(); omega0.clear(); omegaDot.clear(); i0.clear(); idot.clear(); omega.clear();
+    cuc.clear(); cus.clear(); crc.clear(); crs.clear(); cic.clear(); cis.clear();
+}
+
+/**append adds to this Keplerian ephemeris set the ephemeris in the given position of other set.
+ *
+ * @param from the set containing the ephemeris to add
+ * @param i the position of the ephemeris in the given set
+ */
+void SatOrbits::KeplerSet::append(const KeplerSet &from, size_t i) {
+    sys.push_back(from.sys[i]);
+    sat.push_back(from.sat[i]);
+    tTag.push_back(from.tTag[i]);
+    toe.push_back(from.toe[i]);
+    toeSow.push_back(from.toeSow[i]);
+    mu.push_back(from.mu[i]);
+    omegaE.push_back(from.omegaE[i]);
+    geo.push_back(from.geo[i]);
+    sqrtA.push_back(from.sqrtA[i]); e.push_back(from.e[i]); m0.push_back(from.m0[i]); deltaN.push_back(from.deltaN[i]);
+    omega0.push_back(from.omega0[i]); omegaDot.push_back(from.omegaDot[i]); i0.push_back(from.i0[i]); idot.push_back(from.idot[i]);
+    omega.push_back(from.omega[i]);
+    cuc.push_back(from.cuc[i]); cus.push_back(from.cus[i]); crc.push_back(from.crc[i]); crs.push_back(from.crs[i]);
+    cic.push_back(from.cic[i]); cis.push_back(from.cis[i]);
+}
+
+/**clear removes all data in the GLONASS ephemeris set
+ */
+void SatOrbits::GlonassSet::clear() {
+    sat.clear();
+    tTag.clear();
+    x.clear(); y.clear(); z.clear();
+    vx.clear(); vy.clear(); vz.clear();
+    ax.clear(); ay.clear(); az.clear();
+}
+
+/**selectEphemeris selects among the ephemerides of a satellite the one closest in time to the given instant.
+ *
+ * @param idx the indexes of the satellite ephemerides, sorted by time tag
+ * @param tTags the time tags of the ephemerides in the set
+ * @param tTag the instant as seconds from the GPS epoch
+ * @param maxAge the maximum age of ephemeris to be selected (seconds)
+ * @param selected the index in the set of the ephemeris selected
+ * @return true if an ephemeris has been selected, false otherwise
+ */
+bool SatOrbits::selectEphemeris(const vector<size_t> &idx, const vector<double> &tTags, double tTag, double maxAge, size_t &selected) {
+    if (idx.empty()) return false;
+    size_t lo = 0, hi = idx.size();
+    //binary search of the first ephemeris with time tag not less than the given one
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (tTags[idx[mid]] < tTag) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo == idx.size()) selected = idx[lo - 1];
+    else if (lo == 0) selected = idx[0];
+    else if (tTag - tTags[idx[lo - 1]] <= tTags[idx[lo]] - tTag) selected = idx[lo - 1];
+    else selected = idx[lo];
+    return fabs(tTags[selected] - tTag) <= maxAge;
+}
+
+/**computeKepler computes positions of satellites with Keplerian ephemeris selected, as per GPS, Galileo and BDS ICDs.
+ * Ephemerides selected are in contiguous arrays, and the loop has no branches: the rotation of BDS GEO satellites is
+ * computed for all satellites and applied through the geo mask.
+ * Positions are stored in the position arrays from the given index.
+ *
+ * @param tTag the instant as seconds from the GPS epoch
+ * @param first the index in the position arrays where results for the first ephemeris selected shall be stored
+ */
+void SatOrbits::computeKepler(double tTag, size_t first) {
+    const double cosGeo = cos(ORB_GEO_INCL);
+    const double sinGeo = sin(ORB_GEO_INCL);
+    const size_t n = selKepler.size();
+    const double *toe = selKepler.toe.data(), *toeSow = selKepler.toeSow.data();
+    const double *mu = selKepler.mu.data(), *omegaE = selKepler.omegaE.data(), *geo = selKepler.geo.data();
+    const double *sqrtA = selKepler.sqrtA.data(), *e = selKepler.e.data(), *m0 = selKepler.m0.data();
+    const double *deltaN = selKepler.deltaN.data(), *omega0 = selKepler.omega0.data(), *omegaDot = selKepler.omegaDot.data();
+    const double *i0 = selKepler.i0.data(), *idot = selKepler.idot.data(), *omega = selKepler.omega.data();
+    const double *cuc = selKepler.cuc.data(), *cus = selKepler.cus.data(), *crc = selKepler.crc.data();
+    const double *crs = selKepler.crs.data(), *cic = selKepler.cic.data(), *cis = selKepler.cis.data();
+    double *px = posX.data() + first, *py = posY.data() + first, *pz = posZ.data() + first;
+    for (size_t k = 0; k < n; k++) {
+        double a = sqrtA[k] * sqrtA[k];
+        double tk = tTag - toe[k];
+        double nk = sqrt(mu[k] / (a * a * a)) + deltaN[k];
+        double mk = m0[k] + nk * tk;
+        //solve the Kepler equation with a fixed number of iterations
+        double ek = mk;
+        for (int iter = 0; iter < ORB_KEPLER_ITER; iter++) ek = mk + e[k] * sin(ek);
+        double vk = atan2(sqrt(1.0 - e[k] * e[k]) * sin(ek), cos(ek) - e[k]);
+        double phik = vk + omega[k];
+        double sin2phi = sin(2.0 * phik);
+        double cos2phi = cos(2.0 * phik);
+        double uk = phik + cus[k] * sin2phi + cuc[k] * cos2phi;
+        double rk = a * (1.0 - e[k] * cos(ek)) + crs[k] * sin2phi + crc[k] * cos2phi;
+        double ik = i0[k] + idot[k] * tk + cis[k] * sin2phi + cic[k] * cos2phi;
+        double xk = rk * cos(uk);
+        double yk = rk * sin(uk);
+        //the Earth rotation during tk is not applied to BDS GEO satellites here, but in their rotation below
+        double omegak = omega0[k] + omegaDot[k] * tk - omegaE[k] * toeSow[k] - (1.0 - geo[k]) * omegaE[k] * tk;
+        double x = xk * cos(omegak) - yk * cos(ik) * sin(omegak);
+        double y = xk * sin(omegak) + yk * cos(ik) * cos(omegak);
+        double z = yk * sin(ik);
+        //BDS GEO: rotate from the user defined inertial frame to the BDCS
+        double yr = cosGeo * y + sinGeo * z;
+        double zr = - sinGeo * y + cosGeo * z;
+        double rot = omegaE[k] * tk;
+        double xg = cos(rot) * x + sin(rot) * yr;
+        double yg = - sin(rot) * x + cos(rot) * yr;
+        px[k] = x + geo[k] * (xg - x);
+        py[k] = y + geo[k] * (yg - y);
+        pz[k] = z + geo[k] * (zr - z);
+    }
+}
+
+/**computeGlonass computes positions of GLONASS satellites with ephemeris selected, integrating the equations of
+ * motion (GLONASS ICD, appendix J) with a fourth order Runge-Kutta method.
+ * Positions are stored in the position arrays from the given index.
+ *
+ * @param tTag the instant as seconds from the GPS epoch
+ * @param first the index in the position arrays where results for the first ephemeris selected shall be stored
+ */
+void SatOrbits::computeGlonass(double tTag, size_t first) {
+    double s[6], acc[3], k1[6], k2[6], k3[6], k4[6], tmp[6];
+    for (size_t k = 0; k < selGlonass.size(); k++) {
+        size_t i = selGlonass[k];
+        s[0] = glonass.x[i]; s[1] = glonass.y[i]; s[2] = glonass.z[i];
+        s[3] = glonass.vx[i]; s[4] = glonass.vy[i]; s[5] = glonass.vz[i];
+        acc[0] = glonass.ax[i]; acc[1] = glonass.ay[i]; acc[2] = glonass.az[i];
+        double remaining = tTag - glonass.tTag[i];
+        double step = remaining < 0.0? -ORB_GLO_STEP : ORB_GLO_STEP;
+        while (fabs(remaining) > 1E-9) {
+            double h = fabs(remaining) < ORB_GLO_STEP? remaining : step;
+            gloDerivatives(s, acc, k1);
+            for (int j = 0; j < 6; j++) tmp[j] = s[j] + k1[j] * h / 2.0;
+            gloDerivatives(tmp, acc, k2);
+            for (int j = 0; j < 6; j++) tmp[j] = s[j] + k2[j] * h / 2.0;
+            gloDerivatives(tmp, acc, k3);
+            for (int j = 0; j < 6; j++) tmp[j] = s[j] + k3[j] * h;
+            gloDerivatives(tmp, acc, k4);
+            for (int j = 0; j < 6; j++) s[j] += (k1[j] + 2.0 * k2[j] + 2.0 * k3[j] + k4[j]) * h / 6.0;
+            remaining -= h;
+        }
+        //from km to meters
+        posX[first + k] = s[0] * 1000.0;
+        posY[first + k] = s[1] * 1000.0;
+        posZ[first + k] = s[2] * 1000.0;
+    }
+}
+
+/**gloDerivatives computes the derivatives of the GLONASS satellite state vector in the PZ-90 rotating frame.
+ *
+ * @param s the state vector: position (km) and velocity (km/s)
+ * @param acc the lunisolar accelerations given in the ephemeris (km/s2)
+ * @param d the derivatives of the state vector: velocity (km/s) and acceleration (km/s2)
+ */
+void SatOrbits::gloDerivatives(const double (&s)[6], const double (&acc)[3], double (&d)[6]) {
+    double r2 = s[0] * s[0] + s[1] * s[1] + s[2] * s[2];
+    double r = sqrt(r2);
+    double muR3 = ORB_GLO_MU / (r2 * r);
+    double j2Term = 1.5 * ORB_GLO_J2 * ORB_GLO_MU * ORB_GLO_AE * ORB_GLO_AE / (r2 * r2 * r);
+    double z2r2 = 5.0 * s[2] * s[2] / r2;
+    double w2 = ORB_GLO_OMEGAE * ORB_GLO_OMEGAE;
+    d[0] = s[3];
+    d[1] = s[4];
+    d[2] = s[5];
+    d[3] = - muR3 * s[0] - j2Term * s[0] * (1.0 - z2r2) + w2 * s[0] + 2.0 * ORB_GLO_OMEGAE * s[4] + acc[0];
+    d[4] = - muR3 * s[1] - j2Term * s[1] * (1.0 - z2r2) + w2 * s[1] - 2.0 * ORB_GLO_OMEGAE * s[3] + acc[1];
+    d[5] = - muR3 * s[2] - j2Term * s[2] * (3.0 - z2r2) + acc[2];
+}
@@ -0,0 +1,113 @@
+/** @file SatOrbits.h
+ * Contains SatOrbits class definition.
+ * A SatOrbits object stores broadcast ephemerides and computes from them satellite positions and elevations
+ * for a given epoch.
+ *
+ *Copyright 2015, 2021 by Francisco Cancillo & Luis Cancillo
+ *<p>
+ *This file is part of the toRINEX tool.
+ *<p>
+ *<p>Ver.	|Date	|Reason for change
+ *<p>---------------------------------
+ *<p>V1.0	|10/2026|First release
+ */
+#ifndef SATORBITS_H
+#define SATORBITS_H
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "RinexData.h"
+
+using namespace std;
+
+//@cond DUMMY
+#define ORB_MAXAGE 7200.0       //default maximum age (seconds) of Keplerian ephemeris used to compute positions
+#define ORB_MAXAGE_GLO 1800.0   //default maximum age (seconds) of GLONASS ephemeris used to compute positions
+#define ORB_GLO_STEP 60.0       //integration step (seconds) for GLONASS orbits
+#define ORB_KEPLER_ITER 10      //number of iterations to solve the Kepler equation
+//Earth and constellation constants
+const double ORB_GPS_MU = 3.986005E14;          //GPS value of Earth gravitational constant (m3/s2)
+const double ORB_GAL_MU = 3.986004418E14;       //Galileo and BDS value of Earth gravitational constant (m3/s2)
+const double ORB_GPS_OMEGAE = 7.2921151467E-5;  //GPS and Galileo value of Earth rotation rate (rad/s)
+const double ORB_BDS_OMEGAE = 7.292115E-5;      //BDS value of Earth rotation rate (rad/s)
+const double ORB_GLO_MU = 398600.4418;          //PZ-90 Earth gravitational constant (km3/s2)
+const double ORB_GLO_AE = 6378.136;             //PZ-90 Earth equatorial radius (km)
+const double ORB_GLO_J2 = 1.08262575E-3;        //PZ-90 second zonal harmonic
+const double ORB_GLO_OMEGAE = 7.292115E-5;      //PZ-90 Earth rotation rate (rad/s)
+const double ORB_LEAPSECONDS = 18.0;            //default difference between GPS time and UTC (s)
+//@endcond
+
+/**SatOrbits class defines a container for broadcast ephemerides and the methods to compute satellite
+ * positions from them.
+ * <p>Ephemerides are saved using addEphemeris with the broadcast orbit data arranged as per RINEX
+ * navigation files (the same arrangement used in RinexData). GPS, Galileo and BDS ephemerides are
+ * Keplerian ones, and satellite positions are computed using the algorithms stated in their ICDs. GLONASS
+ * ephemerides contain position, velocity and lunisolar accelerations at the reference time, and
+ * positions are computed integrating the equations of motion with a fourth order Runge-Kutta method.
+ * <p>Ephemeris parameters are stored in arrays for each parameter (structure of arrays), and
+ * computePositions evaluates in one pass the positions of all satellites having ephemeris valid for the
+ * given epoch, using the ephemeris closest in time for each satellite. Keplerian ephemerides selected are
+ * first gathered in contiguous arrays, and positions are computed from them in a loop without branches:
+ * iterations to solve the Kepler equation are fixed, and the BDS GEO specific computations are applied
+ * through a mask. This allows the compiler to vectorize the loop.
+ * <p>After computing positions, getElevation provides the elevation of a given satellite as seen from a
+ * receiver position, which allows filtering of observations below a given elevation mask.
+ * <p>All time tags are seconds from the GPS epoch. GLONASS time tags are given in UTC as in RinexData,
+ * and the GPS - UTC difference (leap seconds, see setLeapSeconds) is applied to compute their positions.
+ */
+class SatOrbits {
+public:
+    SatOrbits();
+    ~SatOrbits();
+    void clear();
+    bool isEmpty();
+    void setLeapSeconds(double leap);
+    bool addEphemeris(char sys, int sat, double tTag, double (&bo)[BO_LINSTOTAL][BO_MAXCOLS]);
+    int computePositions(double tTag, double maxAge = 0.0);
+    bool getPosition(char sys, int sat, double &x, double &y, double &z);
+    bool getElevation(char sys, int sat, double rxX, double rxY, double rxZ, double &elevation);
+
+private:
+    //Keplerian ephemerides (GPS, Galileo, BDS) stored as a structure of arrays
+    struct KeplerSet {
+        vector<char> sys;
+        vector<int> sat;
+        vector<double> tTag;    //time tag (Toc) of the ephemeris
+        vector<double> toe;     //Toe as seconds from the GPS epoch
+        vector<double> toeSow;  //Toe as seconds of week
+        vector<double> mu;      //Earth gravitational constant used by the constellation
+        vector<double> omegaE;  //Earth rotation rate used by the constellation
+        vector<double> geo;     //1.0 for BDS GEO satellites and 0.0 for others: a mask to compute positions without branches
+        vector<double> sqrtA, e, m0, deltaN, omega0, omegaDot, i0, idot, omega;
+        vector<double> cuc, cus, crc, crs, cic, cis;
+        void clear();
+        void append(const KeplerSet &from, size_t i);
+        size_t size() { return tTag.size(); }
+    } kepler;
+    //GLONASS ephemerides stored as a structure of arrays. Position, velocity and accelerations in km, km/s, km/s2
+    struct GlonassSet {
+        vector<int> sat;
+        vector<double> tTag;
+        vector<double> x, y, z, vx, vy, vz, ax, ay, az;
+        void clear();
+        size_t size() { return tTag.size(); }
+    } glonass;
+    //for each satellite, the indexes of its ephemerides in the above sets sorted by time tag
+    map<pair<char,int>, vector<size_t> > satIndex;
+    //ephemerides selected in the last call to computePositions (Keplerian ones gathered in contiguous arrays),
+    //and satellite positions (meters, ECEF) computed
+    KeplerSet selKepler;
+    vector<size_t> selGlonass;
+    vector<double> posX, posY, posZ;
+    //for each satellite, the index of its position in the above arrays
+    map<pair<char,int>, size_t> posIndex;
+    double leapSeconds; //the GPS - UTC difference in seconds, to compute GLONASS positions
+
+    bool selectEphemeris(const vector<size_t> &idx, const vector<double> &tTags, double tTag, double maxAge, size_t &selected);
+    void computeKepler(double tTag, size_t first);
+    void computeGlonass(double tTag, size_t first);
+    static void gloDerivatives(const double (&s)[6], const double (&acc)[3], double (&d)[6]);
+};
+#endif //SATORBITS_H
@@ -5,6 +5,8 @@
 #include <sstream>
 #include <algorithm>
 #include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 #include <math.h>
 
@@ -34,6 +36,93 @@ bool isBlank (char* buffer, int n) {
     return true;
 }
 
+/**getFixedDouble converts to double the decimal number contained in a fixed width field (as per Fortran Fn.m,
+ * En.m or Dn.m formats), without allocating memory or depending on locale.
+ * Leading and trailing blanks are allowed, and a blank field is converted to 0.0. The exponent (if any) can be
+ * stated with E or D.
+ * Conversion is exact for numbers having up to 15 significant digits and a decimal exponent in the range -22 to 22,
+ * which is the case of RINEX observables (F14.3) and broadcast orbit data (D19.12). Other numbers are converted
+ * using strtod.
+ *
+ * @param field the array of chars containing the field
+ * @param width the field width
+ * @param value the value converted
+ * @return true if the field contains a valid number or blanks, false otherwise
+ */
+bool getFixedDouble (const char* field, int width, double &value) {
+    static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const char *pos = field;
+    const char *end = field + width;
+    unsigned long long mantissa = 0;
+    int nDigits = 0, nSignificant = 0, scale = 0, exponent = 0;
+    bool negative = false, negExponent = false;
+    //skip leading blanks and get sign
+    while (pos < end && *pos == ' ') pos++;
+    if (pos == end || *pos == '\0') {
+        value = 0.0;
+        return true;
+    }
+    if (*pos == '-' || *pos == '+') negative = *(pos++) == '-';
+    //get integer and fractional digits
+    for (; pos < end && *pos >= '0' && *pos <= '9'; pos++, nDigits++) {
+        if (nSignificant < 19) {
+            mantissa = mantissa * 10 + (*pos - '0');
+            if (mantissa != 0) nSignificant++;
+        } else scale++;
+    }
+    if (pos < end && *pos == '.') {
+        for (pos++; pos < end && *pos >= '0' && *pos <= '9'; pos++, nDigits++) {
+            if (nSignificant < 19) {
+                mantissa = mantissa * 10 + (*pos - '0');
+                if (mantissa != 0) nSignificant++;
+                scale--;
+            }
+        }
+    }
+    if (nDigits == 0) return false;
+    //get exponent
+    if (pos < end && (*pos == 'E' || *pos == 'e' || *pos == 'D' || *pos == 'd')) {
+        pos++;
+        if (pos < end && (*pos == '-' || *pos == '+')) negExponent = *(pos++) == '-';
+        if (pos == end || *pos < '0' || *pos > '9') return false;
+        for (; pos < end && *pos >= '0' && *pos <= '9'; pos++) if (exponent < 1000) exponent = exponent * 10 + (*pos - '0');
+        scale += negExponent ? -exponent : exponent;
+    }
+    //only trailing blanks are allowed
+    while (pos < end && *pos == ' ') pos++;
+    if (pos < end && *pos != '\0') return false;
+    if (nSignificant <= 15 && scale >= -22 && scale <= 22) {
+        value = scale < 0 ? (double) mantissa / pow10[-scale] : (double) mantissa * pow10[scale];
+    } else {
+        //convert using a copy of the field with the exponent in C format
+        char buffer[64];
+        int n = 0;
+        for (pos = field; pos < end && *pos != '\0' && n < (int) sizeof buffer - 1; pos++)
+            buffer[n++] = (*pos == 'D' || *pos == 'd') ? 'E' : *pos;
+        buffer[n] = '\0';
+        value = fabs(strtod(buffer, NULL));
+    }
+    if (negative) value = -value;
+    return true;
+}
+
+/**getFixedDigit converts to int the one digit number contained in a one character field (as per Fortran I1 format),
+ * like the RINEX loss of lock and signal strength indicators. A blank field is converted to 0.
+ *
+ * @param field the char in the field
+ * @param value the value converted, or 0 if the field does not contain a digit or a blank
+ * @return true if the field contains a digit or a blank, false otherwise
+ */
+bool getFixedDigit (char field, int &value) {
+    if (field >= '0' && field <= '9') {
+        value = field - '0';
+        return true;
+    }
+    value = 0;
+    return field == ' ';
+}
+
 /**strToUpper gets a string containing the given string with characters converted to upper case.
  *
  * @param strToConvert the string to convert to upper case
@@ -56,7 +145,7 @@ string strToUpper(string strToConvert) {
  */
 int getTwosComplement(unsigned int number, int nbits) {
     int value = number;
-    if ((nbits >= sizeof(number)*8) || (nbits <= 0)) return value;	//the conversion is imposible or not necessary
+    if ((nbits >= (int) sizeof(number)*8) || (nbits <= 0)) return value;	//the conversion is imposible or not necessary
     if (number < ((unsigned int) 1 << (nbits-1))) return value;	    //the number is positive, it do not need conversion
     return value - (1 << nbits);
 }
@@ -73,7 +162,7 @@ int getTwosComplement(unsigned int number, int nbits) {
 int getSigned(unsigned int number, int nbits) {
     unsigned int signMask;
     int value = number;
-    if ((nbits <= sizeof(number)*8) && (nbits > 0)) {		//the conversion is possible
+    if ((nbits <= (int) sizeof(number)*8) && (nbits > 0)) {		//the conversion is possible
         signMask =  0x01U << (nbits-1);
         if ((number & signMask) != 0) value = - (int)(number & ~signMask); //the number is negative
     }
@@ -98,6 +187,19 @@ unsigned int reverseWord(unsigned int wordToReverse, int nBits) {
     return reversed;
 }
 
+/**getBitCount counts the bits set in the given 32 bits word (its population count).
+ * It is computed adding bits in parallel, without compiler specific builtins.
+ *
+ * @param word the word containing the bits to count
+ * @return the number of bits set to 1 in the word
+ */
+int getBitCount(unsigned int word) {
+    word = word - ((word >> 1) & 0x55555555U);
+    word = (word & 0x33333333U) + ((word >> 2) & 0x33333333U);
+    word = (word + (word >> 4)) & 0x0F0F0F0FU;
+    return (int) ((word * 0x01010101U) >> 24);
+}
+
 /**getFirstDigit gets the fist digit of an integer number in the given string, or the default char if the string is not a number
  *
  * @param intNum contains the integer number
@@ -111,9 +213,9 @@ char getFirstDigit(string intNum, char defChar) {
         if (n < 0) return defChar;
         return to_string(n).at(0);
 
-    } catch (invalid_argument) {
+    } catch (const invalid_argument &) {
         return defChar;
-    } catch (out_of_range) {
+    } catch (const out_of_range &) {
         return defChar;
     }
 }
@@ -272,7 +374,6 @@ int getMjdFromGPST(int week, double tow) {
  */
 void formatGPStime (char* buffer,  size_t bufferSize, const char* fmtYtoM, const char* fmtSec, int week, double tow) {
     #define _ISLEAP(y) (((y) % 4) == 0 && (((y) % 100) != 0 || (((y)+1900) % 400) == 0))
-    double d;
     //use tm only for formatting time data
     //mktime is avoided due to adjust it introduces (dayligth, UTC rollover, etc.)
     struct tm gpsEphe = { 0 };
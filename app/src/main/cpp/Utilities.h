@@ -29,10 +29,13 @@ using namespace std;
 
 vector<string> getTokens (string source, char separator);
 bool isBlank (char* buffer, int n);
+bool getFixedDouble (const char* field, int width, double &value);
+bool getFixedDigit (char field, int &value);
 string strToUpper(string strToConvert);
 int getTwosComplement(unsigned int number, int nbits);
 int getSigned(unsigned int number, int nbits);
 unsigned int reverseWord(unsigned int wordToReverse, int nBits=32);
+int getBitCount(unsigned int word);
 char getFirstDigit(string intNum, char defChar = ' ');
 
 void formatUTCtime(char* buffer,  size_t bufferSize, const char* fmt);
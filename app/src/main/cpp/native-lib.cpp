@@ -43,6 +43,7 @@ const string LOG_MSG_NAVFNS = "Navigation files not selected";
 const string LOG_MSG_NAVVER = "Nav version set to 2.10 by default";
 const string LOG_MSG_INFILENOK = "Cannot open file ";
 const string LOG_MSG_OUTFILENOK = "Cannot create file ";
+const string LOG_MSG_NAVAPPNOK = "Cannot append navigation epochs to file ";
 const string LOG_MSG_LITE = "Function not implemented in This LITE version";
 const string MSG_NEW_SITE = "         --> THIS IS THE START OF A NEW SITE <--";
 const string MSG_SRC_FILE = "Source file: ";
@@ -59,8 +60,9 @@ const unsigned int RET_ERR_CRENAV = 16;
 const unsigned int RET_ERR_WRINAV = 32;
 //defined below
 bool extractRinexHeaderData(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger* plog, vector<string> rnxPar, int inFileNum = 0, int inFileLast = 0);
-unsigned int printNavFiles(RinexData* prinex,  Logger* plog, string outfilesFullPath, string markName);
+unsigned int printNavFiles(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger* plog, string infilesFullPath, vector<string> inNavFileNames, string outfilesFullPath, string markName);
 unsigned int printOneNavFile(RinexData* prinex, Logger* plog, vector<string> selSys, string outfilesFullPath, string markName);
+void collectNavFilesData(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger* plog, string infilesFullPath, vector<string> inNavFileNames);
 /**
  * generateRinexFilesJNI is the interface routine with the Java application toRINEX.
  * It is called to generate RINEX files using data acquired from the GNSS receiver (which
@@ -129,9 +131,9 @@ JNIEXPORT jstring JNICALL Java_com_gnssapps_acq_torinex_GenerateRinex_generateRi
     // Note that V2.10 defines only formats for GPS, GLONASS and SBAS
     if (!inNavFileNames.empty()) {
         log.info(LOG_MSG_GENNAV);
-        /// 4.1 -extract from raw data files header and navigation data
+        /// 4.1 -extract from raw data files header data
         prinex = new RinexData(RinexData::V210, &log);
-        //extract from input files RINEX header and navigation data
+        vector<string> navFilesOk;  //the raw data files with header data extracted
         n = inNavFileNames.size();
         dataAvailable = false;
         for (int i = 0; i < n; ++i) {
@@ -140,9 +142,7 @@ JNIEXPORT jstring JNICALL Java_com_gnssapps_acq_torinex_GenerateRinex_generateRi
                 if (extractRinexHeaderData(prinex, pgnssRaw, &log, vrinexParams, i, n - 1)) {
                     dataAvailable = true;
                     prinex->setHdLnData(RinexData::COMM, RinexData::COMM, MSG_SRC_FILE + inNavFileNames[i]);
-                    pgnssRaw->rewindInputGRD();
-                    log.info(LOG_MSG_NAVFROM);
-                    pgnssRaw->collectNavData(*prinex);
+                    navFilesOk.push_back(inNavFileNames[i]);
                 }
                 pgnssRaw->closeInputGRD();
             } else {
@@ -150,10 +150,11 @@ JNIEXPORT jstring JNICALL Java_com_gnssapps_acq_torinex_GenerateRinex_generateRi
                 retError |= RET_ERR_OPENRAW;
             }
         }
+        /// 4.2 -extract from raw data files navigation data and print them
         if (dataAvailable) {
             prinex->getHdLnData(RinexData::MRKNAME, markName);
             if (markName.length() == 0) markName = inNavFileNames[0].substr(0, inNavFileNames[0].find('.'));
-            retError |= printNavFiles(prinex, &log, outfilesFullPath, markName);
+            retError |= printNavFiles(prinex, pgnssRaw, &log, infilesFullPath, navFilesOk, outfilesFullPath, markName);
         } else retError |= RET_ERR_READRAW;
         delete prinex;
     } else log.info(LOG_MSG_NAVFNS);
@@ -163,7 +164,7 @@ JNIEXPORT jstring JNICALL Java_com_gnssapps_acq_torinex_GenerateRinex_generateRi
         log.info(LOG_MSG_GENOBS);
         if((int) filesToPrint == 0) {
             /// 5.1 -create one RINEX file for each ORD file
-            for (int i = 0; i < inObsFileNames.size(); ++i) {
+            for (size_t i = 0; i < inObsFileNames.size(); ++i) {
                 prinex = new RinexData(RinexData::V210, &log);
                 //open input raw data file
                 if (pgnssRaw->openInputGRD(infilesFullPath, inObsFileNames[i])) {
@@ -233,7 +234,7 @@ JNIEXPORT jstring JNICALL Java_com_gnssapps_acq_torinex_GenerateRinex_generateRi
                 if ((outFile = fopen((outfilesFullPath + outFileName).c_str(), "w")) != NULL) {
                     //print RINEX file header and iterate over existing input raw data files to print observation data
                     prinex->printObsHeader(outFile);
-                    for (int i = 0; i < inObsFileNames.size(); ++i) {
+                    for (size_t i = 0; i < inObsFileNames.size(); ++i) {
                         if (!inObsFileNames[i].empty()) {
                             if (pgnssRaw->openInputGRD(infilesFullPath, inObsFileNames[i])) {
                                 log.info(LOG_MSG_OBSFROM + infilesFullPath + inObsFileNames[i]);
@@ -318,23 +319,35 @@ bool extractRinexHeaderData(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger
     return pgnssRaw->collectHeaderData(*prinex, inFileNum, inFileLast);
 }
 /**
- * printNavFiles conducts the printing of the RINEX navigation file or files for the navigation
- * data already collected from the raw data files.
+ * printNavFiles conducts the collection of navigation data from the raw data files and the printing of
+ * the RINEX navigation file or files.
  * Note that depending on the RINEX version to be printed it should be printed a unique file, if
  * version 3 requested, or one file for each constellation, if version 2 requested.
+ * When a unique file is printed, navigation data are streamed to a temporary file while they are collected,
+ * keeping in memory only the ones inside the streaming window. Once collected, the RINEX file is named after
+ * the first epoch, and its header printed with all data collected, followed by the streamed epochs. Otherwise, all navigation data are
+ * collected before printing the file for each constellation.
  *
- * @param prinex pointer to the rinex object where header records will be stored
+ * @param prinex pointer to the rinex object where header records are already stored
+ * @param pgnssRaw pointer to the GNSS raw data object with data to be extracted
  * @param plog a pointer to the logger
+ * @param infilesFullPath is the path name where the input files are placed
+ * @param inNavFileNames the names of the raw data files to process
  * @param outfilesFullPath is the path name where the output file will be created
  * @param markName the position mark name to be used to name the output file
  * @return 0 if no error occurred, or a code (in the set RET_ERR_xxxx values) identifying the error
  */
-unsigned int printNavFiles(RinexData* prinex,  Logger* plog, string outfilesFullPath, string markName) {
+unsigned int printNavFiles(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger* plog, string infilesFullPath, vector<string> inNavFileNames, string outfilesFullPath, string markName) {
     double rinexVersion;
     char rinexType;
     char constellationToPrint;
     vector<string> selSys;
     vector<string> selObs;
+    string outFileName;	//the output file name for RINEX files
+    FILE* outFile;		//the RINEX file where data will be printed
+    FILE* epochsFile;	//the temporary file where navigation epochs are streamed
+    char buffer[BUFSIZ];
+    size_t n;
     unsigned int retCode = 0;
     try {
         //set RINEX version to be printed
@@ -346,22 +359,70 @@ unsigned int printNavFiles(RinexData* prinex,  Logger* plog, string outfilesFull
             prinex->setHdLnData(RinexData::VERSION, rinexVersion);
         }
         if (rinexVersion < 3.0) {
-            //print a RINEX file for each existing constellation
-            for (unsigned int i=0; prinex->getHdLnData(RinexData::SYS, constellationToPrint, selObs, i); i++) {
+            //collect all navigation data and print a RINEX file for each existing constellation
+            collectNavFilesData(prinex, pgnssRaw, plog, infilesFullPath, inNavFileNames);
+            RinexData::DataRange<RinexData::GNSSsystem> hdSystems = prinex->getHdSystems();
+            for (RinexData::DataRange<RinexData::GNSSsystem>::const_iterator it = hdSystems.begin(); it != hdSystems.end(); it++) {
                 selSys.clear();
                 selObs.clear();
-                selSys.push_back(string(1, constellationToPrint));
+                selSys.push_back(string(1, it->system));
                 retCode = retCode | printOneNavFile(prinex, plog, selSys, outfilesFullPath, markName);
             }
         } else {
-            //print one RINEX file for all constellations
-            retCode = printOneNavFile(prinex, plog, selSys, outfilesFullPath, markName);
+            //print one RINEX file for all constellations streaming navigation data while collected to a temporary file.
+            //The file name and header depend on the data collected: they are printed after, and epochs appended to the header
+            prinex->setFilter(selSys, selObs);
+            if ((epochsFile = tmpfile()) != NULL) {
+                try {
+                    prinex->startNavStream(epochsFile);
+                    collectNavFilesData(prinex, pgnssRaw, plog, infilesFullPath, inNavFileNames);
+                    prinex->endNavStream();
+                } catch (string error) {
+                    plog->severe(error);
+                    retCode = RET_ERR_WRINAV;
+                }
+                outFileName = prinex->getNavFileName(markName);
+                if (retCode == 0) {
+                    if ((outFile = fopen((outfilesFullPath + outFileName).c_str(), "w")) != NULL) {
+                        try {
+                            prinex->printNavHeader(outFile);
+                            rewind(epochsFile);
+                            while ((n = fread(buffer, 1, sizeof buffer, epochsFile)) > 0)
+                                if (fwrite(buffer, 1, n, outFile) != n) throw LOG_MSG_NAVAPPNOK + outFileName;
+                        } catch (string error) {
+                            plog->severe(error);
+                            retCode = RET_ERR_WRINAV;
+                        }
+                        fclose(outFile);
+                    } else retCode = RET_ERR_CRENAV;
+                }
+                fclose(epochsFile);
+            }
+            else retCode = RET_ERR_CRENAV;
         }
     } catch (string error) {
         plog->severe(error);
     }
     return retCode;
 }
+/**
+ * collectNavFilesData collects navigation data from the given raw data files and saves them into the rinex object.
+ *
+ * @param prinex pointer to the rinex object where navigation data will be saved
+ * @param pgnssRaw pointer to the GNSS raw data object with data to be extracted
+ * @param plog a pointer to the logger
+ * @param infilesFullPath is the path name where the input files are placed
+ * @param inNavFileNames the names of the raw data files to process
+ */
+void collectNavFilesData(RinexData* prinex, GNSSdataFromGRD* pgnssRaw, Logger* plog, string infilesFullPath, vector<string> inNavFileNames) {
+    for (unsigned int i = 0; i < inNavFileNames.size(); ++i) {
+        if (pgnssRaw->openInputGRD(infilesFullPath, inNavFileNames[i])) {
+            plog->info(LOG_MSG_NAVFROM + " " + inNavFileNames[i]);
+            pgnssRaw->collectNavData(*prinex);
+            pgnssRaw->closeInputGRD();
+        }
+    }
+}
 /**
  * printOneNavFile print one navigaation file for the selected systems in the path passed in arguments.
  * It is assumed coherence between the systems to be included and the RINEX version to be printed.
@@ -0,0 +1,458 @@
+/** @file DecoderTest.cpp
+ * Contains a host test of the decoding of compressed RINEX input files: gzip files (including the ones having several
+ * gzip members) and Compact RINEX files versions 1.0 and 3.0, also gzip compressed.
+ * Lines given by RinexDecoder shall be the ones of the plain RINEX file, and epochs read by readObsEpoch from the
+ * compressed file (see openInputDecoder) the ones read from the plain file. Compact RINEX fixtures cover header lines
+ * removal, epoch lines given by their text differences, receiver clock offset arcs, and data arcs of different orders
+ * started, broken by missing observables, and initialised again.
+ */
+#include "RinexData.h"
+#include "RinexDecoder.h"
+#include "Utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+//@cond DUMMY
+#define TST_LARGEEPOCHS 6000    //number of epochs in the large file generated
+//@endcond
+
+//A RINEX 2.11 observation file
+static const char PLAIN_V2[] =
+    "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "     6    C1    L1    D1    S1    P2    L2                  # / TYPES OF OBSERV\n"
+    "    30.000                                                  INTERVAL\n"
+    "                                                            END OF HEADER\n"
+    " 21  1  1  0  0  0.0000000  0  3G01G05G12                            0.000123456\n"
+    "  20000999.995 7 105106999.993 7     -1235.576 7        45.259 7  20001002.995 7\n"
+    "  81904999.993\n"
+    "  20005000.007 7 105134999.997 7     -1239.580 7        45.327 7  20005003.007 7\n"
+    "  81924999.997\n"
+    "  20012000.028 7 105184000.004 7     -1246.587 7        45.446 7  20012003.028 7\n"
+    "  81960000.004\n"
+    " 21  1  1  0  0 30.0000000  0  3G01G05G12                            0.000123486\n"
+    "  20001030.010 7 105107157.711 7     -1235.557 7        45.270 7  20001033.020 7\n"
+    "  81905122.893 6\n"
+    "  20005030.026 7                     -1239.557 7        45.338 7  20005033.036 7\n"
+    "  81925122.901 6\n"
+    "  20012030.054 7 105184157.733 7     -1246.557 7        45.457 7  20012033.064 7\n"
+    "  81960122.915 6\n"
+    " 21  1  1  0  0 45.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    " 21  1  1  0  1  0.0000000  0  3G01G12G20\n"
+    "  20001060.031 7 105107315.437 7     -1235.545 7        45.276 7  20001063.042 7\n"
+    "  81905245.792\n"
+    "  20012060.086 7 105184315.47017     -1246.534 7        45.463 7  20012063.097 7\n"
+    "  81960245.825\n"
+    "  20020060.126 7 105240315.494 7     -1254.526 7        45.599 7  20020063.137 7\n"
+    "  82000245.849\n"
+    " 21  1  1  0  1 30.0000000  0  4G01G05G12G20                        -0.000000012\n"
+    "  20001090.041 7 105107473.137 7     -1235.523 7        45.277 7  20001093.061 7\n"
+    "  81905368.673 6\n"
+    "  20005090.065 7 105135473.153 7     -1239.515 7        45.345 7  20005093.085 7\n"
+    "  81925368.689 6\n"
+    "  20012090.107 7 105184473.181 7     -1246.501 7        45.464 7  20012093.127 7\n"
+    "  81960368.717 6\n"
+    "  20020090.155 7 105240473.213 7                        45.600 7\n"
+    "  82000368.749 6\n"
+    " 21  1  1  0  2  0.0000000  0  3G01G12G20                           -0.000000015\n"
+    "  20006120.057 7 105107630.862 7     -1235.508 7        45.290 7  20001123.077 7\n"
+    "  81905491.570\n"
+    "  20012120.134 7 105184630.917 7     -1246.475 7        45.477 7  20012123.154 7\n"
+    "  81960491.625\n"
+    "  20020120.190 7 105240630.957 7     -1254.451 7        45.613 7  20020123.210 7\n"
+    "  82000491.665\n"
+    " 21  1  1  0  2 30.0000000  0  3G01G12G20                           -0.000000019\n"
+    "  20001150.062 7 105107788.578 7     -1235.500 7        45.298 7  20001153.090 7\n"
+    "  81905614.466 6\n"
+    "  20012150.150 7 105184788.644 7     -1246.456 7        45.485 7  20012153.178 7\n"
+    "  81960614.532 6\n"
+    "  20020150.214 7 105240788.692 7     -1254.424 7        45.621 7  20020153.242 7\n"
+    "  82000614.580 6\n";
+
+//PLAIN_V2 in Compact RINEX 1.0 format
+static const char COMPACT_V1[] =
+    "1.0                 COMPACT RINEX FORMAT                    CRINEX VERS   / TYPE\n"
+    "RNX2CRX ver.4.1.0                       16-Oct-26 12:00     CRINEX PROG / DATE\n"
+    "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "     6    C1    L1    D1    S1    P2    L2                  # / TYPES OF OBSERV\n"
+    "    30.000                                                  INTERVAL\n"
+    "                                                            END OF HEADER\n"
+    "&21  1  1  0  0  0.0000000  0  3G01G05G12\n"
+    "2&123456\n"
+    "3&20000999995 3&105106999993 3&-1235576 3&45259 3&20001002995 3&81904999993  7 7 7 7 7\n"
+    "3&20005000007 3&105134999997 3&-1239580 3&45327 3&20005003007 3&81924999997  7 7 7 7 7\n"
+    "3&20012000028 3&105184000004 3&-1246587 3&45446 3&20012003028 3&81960000004  7 7 7 7 7\n"
+    "                3\n"
+    "30\n"
+    "30015 157718 19 11 30025 122900            6\n"
+    "30019  23 11 30029 122904    &       6\n"
+    "30026 157729 30 11 30036 122911            6\n"
+    "&21  1  1  0  0 45.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    "&21  1  1  0  1  0.0000000  0  3G01G12G20\n"
+    "\n"
+    "6 8 -7 -5 -3 -1            &\n"
+    "6 8 -7 -5 -3 -1   1        &\n"
+    "3&20020060126 3&105240315494 3&-1254526 3&45599 3&20020063137 3&82000245849  7 7 7 7 7\n"
+    "                3              4    05 12G20\n"
+    "2&-12\n"
+    "-17 -34 17 0 0 -17            6\n"
+    "3&20005090065 3&105135473153 3&-1239515 3&45345 3&20005093085 3&81925368689  7 7 7 7 7 6\n"
+    "-17 -34 17 0 0 -17   &        6\n"
+    "30029 157719  1  122900      &   & 6\n"
+    "              2 &              3    12 20&&&\n"
+    "-3\n"
+    "3&20006120057 51 -17 17 0 34            &\n"
+    "17 51 -17 17 0 34            &\n"
+    "6 25 3&-1254451 12 3&20020123210 16      7   7 &\n"
+    "                3\n"
+    "-1\n"
+    "-4969995 -34 0 -17 0 -17            6\n"
+    "-17 -34 0 -17 0 -17            6\n"
+    "-17 -34 27 -17 30032 -17            6\n";
+
+//A RINEX 3.04 observation file
+static const char PLAIN_V3[] =
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+    "E    2 C1X L1X                                              SYS / # / OBS TYPES\n"
+    "    30.000                                                  INTERVAL\n"
+    "                                                            END OF HEADER\n"
+    "> 2021 01 01 00 00  0.0000000  0  3       0.000123456789\n"
+    "E11  21011000.025 7 110177000.003\n"
+    "G01  21000999.995 7 110106999.993 7     -2235.576 7        41.259\n"
+    "G05  21005000.007 7 110134999.997 7     -2239.580 7        41.327\n"
+    "> 2021 01 01 00 00 30.0000000  0  3       0.000123486789\n"
+    "E11  21010970.006 7 110176842.283 6\n"
+    "G01  21000969.986 7 110106842.283 7     -2235.559 7\n"
+    "G05  21004969.994 7 110134842.283 7     -2239.559 7        41.336 6\n"
+    "> 2021 01 01 00 00 45.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    "> 2021 01 01 00 01  0.0000000  0  3\n"
+    "E11  21010939.99317 110176684.571\n"
+    "G01  21000939.983 7 110106684.581 7     -2235.549 7        41.272\n"
+    "G12  21011939.994 7 110183684.570 7     -2246.538 7        41.459\n"
+    "> 2021 01 01 00 01 30.0000000  0  4      -0.000000012345\n"
+    "E04  21003909.969 7 110127526.847 6\n"
+    "E11  21010909.969 7 110176526.833 6\n"
+    "G01  21000909.969 7 110106526.853 7     -2235.529 7        41.271 6\n"
+    "G12  21011909.969 7 110183526.831 7     -2246.507 7        41.458 6\n"
+    "> 2021 01 01 00 02  0.0000000  0  3      -0.000000012375\n"
+    "E11  21010879.951 7 110176369.120\n"
+    "G01  21000879.961 7 110106369.150 7     -2235.516 7        41.282\n"
+    "G12  21011879.950 7 110183369.117 7     -2246.483 7        41.469\n"
+    "> 2021 01 01 00 02 30.0000000  0  3      -0.000000012399\n"
+    "E11  21010849.922 7 110176211.398 6\n"
+    "G01  21000849.942 7 110106211.438 7     -2235.510 7        41.288 6\n"
+    "G12  21011849.920 7 110183211.394 7     -2246.466 7        41.475 6\n";
+
+//PLAIN_V3 in Compact RINEX 3.0 format
+static const char COMPACT_V3[] =
+    "3.0                 COMPACT RINEX FORMAT                    CRINEX VERS   / TYPE\n"
+    "RNX2CRX ver.4.1.0                       16-Oct-26 12:00     CRINEX PROG / DATE\n"
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+    "E    2 C1X L1X                                              SYS / # / OBS TYPES\n"
+    "    30.000                                                  INTERVAL\n"
+    "                                                            END OF HEADER\n"
+    "> 2021 01 01 00 00  0.0000000  0  3      E11G01G05\n"
+    "2&123456789\n"
+    "3&21011000025 3&110177000003  7\n"
+    "3&21000999995 3&110106999993 3&-2235576 3&41259  7 7 7\n"
+    "3&21005000007 3&110134999997 3&-2239580 3&41327  7 7 7\n"
+    "                   3\n"
+    "30000\n"
+    "-30019 -157720    6\n"
+    "-30009 -157710 17 \n"
+    "-30013 -157714 21 9        6\n"
+    "> 2021 01 01 00 00 45.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    "> 2021 01 01 00 01  0.0000000  0  3      E11G01G12\n"
+    "\n"
+    "6 8 1  &\n"
+    "6 8 -7 3&41272\n"
+    "3&21011939994 3&110183684570 3&-2246538 3&41459  7 7 7\n"
+    "                   3              4       04E1  01G12\n"
+    "2&-12345\n"
+    "3&21003909969 3&110127526847  7 6\n"
+    "-17 -34 &  6\n"
+    "-17 -34 17 -1        6\n"
+    "-30025 -157739 31 -1        6\n"
+    "                 2 &              3       11G0  12&&&\n"
+    "-30\n"
+    "17 51    &\n"
+    "17 51 -17 12        &\n"
+    "6 25 -7 12        &\n"
+    "                   3\n"
+    "6\n"
+    "-17 -34    6\n"
+    "-17 -34 0 -17        6\n"
+    "-17 -34 0 -17        6\n";
+
+/**DecoderTest class contains the test cases.
+ */
+class DecoderTest {
+public:
+    DecoderTest();
+    int run();
+
+private:
+    Logger log;
+    int failures;
+
+    void checkDiffArc();
+    void checkLines(const char *name, const string &input, int members, bool compact, const string &expected);
+    void checkEpochs(const char *name, const string &input, int members, const string &expected);
+    string largeObsText();
+    FILE* inputFile(const char *name, const string &text, int members);
+    vector<string> readObsEpochs(FILE *file, bool decode);
+};
+
+DecoderTest::DecoderTest() {
+    failures = 0;
+}
+
+/**run performs all the checks.
+ *
+ * @return the number of failed checks
+ */
+int DecoderTest::run() {
+    checkDiffArc();
+    checkLines("gzip V2", PLAIN_V2, 1, false, PLAIN_V2);
+    checkLines("gzip V3 in 3 members", PLAIN_V3, 3, false, PLAIN_V3);
+    checkLines("Compact RINEX 1.0", COMPACT_V1, 0, true, PLAIN_V2);
+    checkLines("Compact RINEX 3.0", COMPACT_V3, 0, true, PLAIN_V3);
+    checkLines("gzip Compact RINEX 1.0", COMPACT_V1, 1, true, PLAIN_V2);
+    checkLines("gzip Compact RINEX 3.0 in 2 members", COMPACT_V3, 2, true, PLAIN_V3);
+    string large = largeObsText();
+    checkLines("large gzip in 3 members", large, 3, false, large);
+    checkEpochs("Compact RINEX 1.0 epochs", COMPACT_V1, 0, PLAIN_V2);
+    checkEpochs("gzip Compact RINEX 3.0 epochs", COMPACT_V3, 2, PLAIN_V3);
+    checkEpochs("large gzip epochs", large, 3, large);
+    return failures;
+}
+
+/**checkDiffArc checks the values restored by DiffArc::update from arc initialisations and differences of increasing
+ * order, up to the maximum order of the arc.
+ */
+void DecoderTest::checkDiffArc() {
+    const char *fields[] = {"3&1000", "10", "5", "-2", "1", "2&-50", "7", "-3", "-3"};
+    const long long expected[] = {1000, 1010, 1025, 1043, 1065, -50, -43, -39, -38};
+    RinexDecoder::DiffArc arc;
+    if (arc.update("5", 1)) {
+        printf("data arc: difference applied to a not initialised arc\n");
+        failures++;
+    }
+    for (size_t i = 0; i < sizeof expected / sizeof expected[0]; ++i) {
+        if (!arc.update(fields[i], strlen(fields[i])) || arc.y[0] != expected[i]) {
+            printf("data arc: field %s gives %lld, expected %lld\n", fields[i], arc.y[0], expected[i]);
+            failures++;
+        }
+    }
+}
+
+/**checkLines decodes the given input with RinexDecoder, and checks that the compression is identified and that the lines
+ * read are the expected ones.
+ *
+ * @param name the check name, for messages
+ * @param input the input file content
+ * @param members the number of gzip members to compress the input, or 0 if it is not gzip compressed
+ * @param compact true if the input is a Compact RINEX one
+ * @param expected the content of the plain RINEX file
+ */
+void DecoderTest::checkLines(const char *name, const string &input, int members, bool compact, const string &expected) {
+    const char *data;
+    unsigned int len;
+    FILE *file = inputFile(name, input, members);
+    if (file == NULL) return;
+    RinexDecoder decoder(file, &log);
+    if (decoder.isGzip() != (members > 0) || decoder.isCompact() != compact) {
+        printf("%s: compression not identified\n", name);
+        failures++;
+        fclose(file);
+        return;
+    }
+    size_t pos = 0;
+    int nline = 0;
+    bool mismatch = false;
+    while (!mismatch && !decoder.readLine(data, len)) {
+        size_t eol = expected.find('\n', pos);
+        ++nline;
+        if (eol == string::npos) {
+            printf("%s: line %d read after the end of file\n", name, nline);
+            mismatch = true;
+        }
+        if (expected.compare(pos, eol - pos, data, len) != 0) {
+            printf("%s: line %d\n read     %s\n expected %s\n", name, nline, string(data, len).c_str(),
+                   expected.substr(pos, eol - pos).c_str());
+            mismatch = true;
+        }
+        pos = eol + 1;
+    }
+    if (!mismatch && pos < expected.size()) {
+        printf("%s: end of file read at line %d\n", name, nline + 1);
+        mismatch = true;
+    }
+    if (mismatch) failures++;
+    fclose(file);
+}
+
+/**checkEpochs reads with readObsEpoch the epochs in the given input decoded using openInputDecoder, and checks that
+ * they are the ones read from the plain RINEX file.
+ *
+ * @param name the check name, for messages
+ * @param input the input file content
+ * @param members the number of gzip members to compress the input, or 0 if it is not gzip compressed
+ * @param expected the content of the plain RINEX file
+ */
+void DecoderTest::checkEpochs(const char *name, const string &input, int members, const string &expected) {
+    FILE *file = inputFile(name, input, members);
+    if (file == NULL) return;
+    FILE *plain = inputFile(name, expected, 0);
+    if (plain == NULL) {
+        fclose(file);
+        return;
+    }
+    vector<string> read = readObsEpochs(file, true);
+    vector<string> plainRead = readObsEpochs(plain, false);
+    if (read.size() != plainRead.size()) {
+        printf("%s: %d epochs read, expected %d\n", name, (int) read.size(), (int) plainRead.size());
+        failures++;
+    } else {
+        for (size_t i = 0; i < read.size(); ++i) {
+            if (read[i] != plainRead[i]) {
+                printf("%s: epoch %d\n read     %s\n expected %s\n", name, (int) i, read[i].c_str(), plainRead[i].c_str());
+                failures++;
+                break;
+            }
+        }
+    }
+    fclose(plain);
+    fclose(file);
+}
+
+/**largeObsText generates a RINEX 3.04 observation file larger than the decoder buffers, with pseudo-random values.
+ *
+ * @return the file content
+ */
+string DecoderTest::largeObsText() {
+    char buffer[100];
+    unsigned int seed = 12345;
+    string text(PLAIN_V3, strstr(PLAIN_V3, "END OF HEADER\n") + 14 - PLAIN_V3);
+    for (int i = 0; i < TST_LARGEEPOCHS; ++i) {
+        snprintf(buffer, sizeof buffer, "> 2021 01 %02d %02d %02d %02d.0000000  0  4\n",
+                 1 + i / 2880, i / 120 % 24, i / 2 % 60, i % 2 * 30);
+        text += buffer;
+        for (int sat = 1; sat <= 4; ++sat) {
+            seed = seed * 1103515245 + 12345;
+            unsigned int value = seed >> 8;
+            snprintf(buffer, sizeof buffer, "G%02d%14.3f %d%14.3f %d%14.3f %d%14.3f %d\n", sat * 3,
+                     20000000.0 + value % 1000000007 / 1000.0, value % 7 + 3, 100000000.0 + value / 997 / 1000.0,
+                     value % 5 + 4, (int) (value % 20000) / 1000.0 - 10.0, value % 3 + 5, 30.0 + value % 30000 / 1000.0, 7);
+            text += buffer;
+        }
+    }
+    return text;
+}
+
+/**inputFile creates a temporary file with the given text, gzip compressed in the given number of members when
+ * members > 0, positioned at its beginning.
+ *
+ * @param name the check name, for messages
+ * @param text the file content
+ * @param members the number of gzip members to compress the content, or 0 to write it uncompressed
+ * @return the file, or NULL if it cannot be created
+ */
+FILE* DecoderTest::inputFile(const char *name, const string &text, int members) {
+    unsigned char out[16384];
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("%s: cannot create the temporary file\n", name);
+        failures++;
+        return NULL;
+    }
+    if (members == 0) fwrite(text.data(), 1, text.size(), file);
+    //members are split at any point, usually in the middle of a line
+    for (int i = 0; i < members; ++i) {
+        size_t start = text.size() * i / members;
+        size_t end = text.size() * (i + 1) / members;
+        z_stream stream;
+        memset(&stream, 0, sizeof stream);
+        //windowBits 15 + 16 to deflate data with a gzip header
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            printf("%s: cannot compress the file\n", name);
+            failures++;
+            fclose(file);
+            return NULL;
+        }
+        stream.next_in = (Bytef*) text.data() + start;
+        stream.avail_in = end - start;
+        do {
+            stream.next_out = out;
+            stream.avail_out = sizeof out;
+            deflate(&stream, Z_FINISH);
+            fwrite(out, 1, sizeof out - stream.avail_out, file);
+        } while (stream.avail_out == 0);
+        deflateEnd(&stream);
+    }
+    rewind(file);
+    return file;
+}
+
+/**readObsEpochs reads sequentially with readObsEpoch the epochs in the given observation file.
+ * Each epoch is given as a string with its time, flag, clock offset, and its observables sorted by satellite and type.
+ *
+ * @param file the observation file
+ * @param decode true to read the file decoded using openInputDecoder, false to read it as plain text
+ * @return the epochs read
+ */
+vector<string> DecoderTest::readObsEpochs(FILE *file, bool decode) {
+    char buffer[100];
+    char obsSys;
+    int week, flag, sat, lli, strg;
+    double tow, bias, value;
+    string obsType;
+    vector<string> epochs;
+    vector<string> obs;
+    RinexData reader(RinexData::V304, &log);
+    if (decode && !reader.openInputDecoder(file)) {
+        epochs.push_back(string("file not compressed"));
+        return epochs;
+    }
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        epochs.push_back(string("header not read"));
+        return epochs;
+    }
+    for (int status = reader.readObsEpoch(file); status != 0 && status != 9; status = reader.readObsEpoch(file)) {
+        reader.getEpochTime(week, tow, bias, flag);
+        formatGPStime(buffer, sizeof buffer, "%Y/%m/%d %H:%M:", "%010.7f", week, tow);
+        string epoch(buffer);
+        snprintf(buffer, sizeof buffer, " %d %.12f", flag, bias);
+        epoch += string(buffer);
+        obs.clear();
+        for (unsigned int i = 0; reader.getObsData(obsSys, sat, obsType, value, lli, strg, i); ++i) {
+            snprintf(buffer, sizeof buffer, " %c%02d %s %.3f %d %d", obsSys, sat, obsType.c_str(), value, lli, strg);
+            obs.push_back(string(buffer));
+        }
+        sort(obs.begin(), obs.end());
+        for (vector<string>::iterator it = obs.begin(); it != obs.end(); ++it) epoch += *it;
+        epochs.push_back(epoch);
+    }
+    reader.closeInputDecoder();
+    return epochs;
+}
+
+int main() {
+    DecoderTest test;
+    int failures = test.run();
+    if (failures == 0) printf("Compressed files decoding: OK\n");
+    else printf("Compressed files decoding: %d checks FAILED\n", failures);
+    return failures == 0? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/** @file NavEpochTest.cpp
+ * Contains a host test of the round trip of navigation epochs: ephemeris printed by printNavEpochs in a RINEX
+ * navigation file shall be read back by readNavEpoch with the same values, for RINEX versions 2.10 and 3.04.
+ * In particular, the SV clock data in the epoch first line shall be read from the columns they are printed.
+ */
+#include "RinexData.h"
+#include "Utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+//@cond DUMMY
+#define TST_SATELLITE 12        //the GPS satellite used in the test
+#define TST_WEEK 2150           //the GPS week and tow of the ephemeris used in the test
+#define TST_TOW 352800.0
+//@endcond
+
+/**NavEpochTest class contains the test cases.
+ */
+class NavEpochTest {
+public:
+    NavEpochTest();
+    int run();
+
+private:
+    Logger log;
+    double bo[BO_MAXLINS][BO_MAXCOLS];
+    double tTag;
+    int failures;
+
+    void checkRoundTrip(RinexData::RINEXversion version, const char *name);
+    static double printed(double value);
+};
+
+NavEpochTest::NavEpochTest() {
+    //broadcast orbit values having all their significant digits, with different signs and exponents
+    for (int i = 0; i < BO_MAXLINS; ++i)
+        for (int j = 0; j < BO_MAXCOLS; ++j)
+            bo[i][j] = ((i + j) % 2 == 0? 1.0 : -1.0) * (1.0 + (i * BO_MAXCOLS + j) / 37.0) * pow(10.0, (i * 7 + j * 3) % 13 - 6);
+    tTag = getInstantGNSStime(TST_WEEK, TST_TOW);
+    bo[0][0] = tTag;
+    failures = 0;
+}
+
+/**run performs all the checks.
+ *
+ * @return the number of failed checks
+ */
+int NavEpochTest::run() {
+    checkRoundTrip(RinexData::V210, "RINEX 2.10");
+    checkRoundTrip(RinexData::V304, "RINEX 3.04");
+    return failures;
+}
+
+/**checkRoundTrip prints a GPS navigation file with one ephemeris in the given version, reads it and checks that
+ * the values read are the ones printed.
+ *
+ * @param version the RINEX version of the file
+ * @param name the version name to be used in messages
+ */
+void NavEpochTest::checkRoundTrip(RinexData::RINEXversion version, const char *name) {
+    char sys;
+    int sat;
+    double boRead[BO_MAXLINS][BO_MAXCOLS];
+    double tTagRead;
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("%s: cannot create the temporary file\n", name);
+        failures++;
+        return;
+    }
+    //print the navigation file
+    RinexData writer(version, &log);
+    writer.setHdLnData(RinexData::RUNBY, string("NavEpochTest"), string("test"), string());
+    vector<string> noObsTypes;
+    writer.setHdLnData(RinexData::SYS, 'G', noObsTypes);
+    writer.saveNavData('G', TST_SATELLITE, bo, tTag);
+    writer.setFilter(noObsTypes, noObsTypes);
+    writer.printNavHeader(file);
+    writer.printNavEpochs(file);
+    rewind(file);
+    //read it and compare data
+    RinexData reader(version, &log);
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        printf("%s: header not read\n", name);
+        failures++;
+    } else if (reader.readNavEpoch(file) != 1) {
+        printf("%s: navigation epoch not read\n", name);
+        failures++;
+    } else if (!reader.getNavData(sys, sat, boRead, tTagRead) || sys != 'G' || sat != TST_SATELLITE || tTagRead != tTag) {
+        printf("%s: wrong satellite or time tag read\n", name);
+        failures++;
+    } else {
+        //the SV clock data in the first line, and the BO_TOTEPHE_GPS broadcast orbit values in the following ones
+        for (int i = 0; i < BO_MAXLINS_GPS; ++i)
+            for (int j = (i == 0? 1 : 0); j < BO_MAXCOLS && (i == 0 || (i - 1) * BO_MAXCOLS + j < BO_TOTEPHE_GPS); ++j)
+                if (boRead[i][j] != printed(bo[i][j])) {
+                    printf("%s: broadcast orbit [%d][%d] printed %19.12E read %19.12E\n", name, i, j, bo[i][j], boRead[i][j]);
+                    failures++;
+                }
+    }
+    fclose(file);
+}
+
+/**printed gives the value that results of printing the given one in a RINEX navigation file.
+ *
+ * @param value the value to print
+ * @return the value printed
+ */
+double NavEpochTest::printed(double value) {
+    char buffer[30];
+    snprintf(buffer, sizeof buffer, "%19.12E", value);
+    return strtod(buffer, NULL);
+}
+
+int main() {
+    NavEpochTest test;
+    int failures = test.run();
+    if (failures == 0) printf("Navigation epochs round trip: OK\n");
+    else printf("Navigation epochs round trip: %d checks FAILED\n", failures);
+    return failures == 0? 0 : 1;
+}
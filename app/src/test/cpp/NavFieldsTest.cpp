@@ -0,0 +1,517 @@
+/** @file NavFieldsTest.cpp
+ * Contains a host test of the navigation message field extraction: the compile time specialized extraction from the
+ * NavBitField tables, and the word based getBits, are checked on random navigation message frames against the code
+ * used before the tables: the bit by bit getBits and the per field extract*Ephemeris methods, with the fields that
+ * were read at wrong positions taken at their ICD positions.
+ * GNSSdataFromGRD.cpp is included to access the field tables and extraction templates, which are local to that file.
+ */
+#include "GNSSdataFromGRD.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+//@cond DUMMY
+#define TST_WORDS 16        //number of words in the stream used to check getBits
+#define TST_MESSAGES 1000   //number of random messages to check
+//bit positions as stated in the ICDs (see GNSSdataFromGRD.cpp)
+#define GPSL1CA_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+#define GLOL1CA_BIT(BITNUMBER) (85 - BITNUMBER)
+#define GALIN_BIT(BITNUMBER) BITNUMBER
+#define BDSD1_BIT(BITNUMBER) ((BITNUMBER-1)/30*32 + (BITNUMBER-1)%30 + 2)
+//@endcond
+
+/**NavFieldsTest class contains the test cases. It is friend of GNSSdataFromGRD to access its frames and extraction methods.
+ * The base* methods are the extract*Ephemeris methods as they were before using field tables, with access to the
+ * GNSSdataFromGRD object through grd, and the bit by bit getBits renamed as baseGetBits.
+ */
+class NavFieldsTest {
+public:
+    NavFieldsTest();
+    int run();
+
+private:
+    typedef void (NavFieldsTest::*BaseExtract)(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    GNSSdataFromGRD grd;
+    uint32_t stream[TST_WORDS];
+    int failures;
+
+    static uint32_t randomWord();
+    static void randomWords(uint32_t *words, int nWords);
+    void checkGetBits();
+    void checkGPSL1CA(int satIdx);
+    void checkGLOL1CA(int satIdx);
+    void checkGALIN(int satIdx);
+    void checkBDSD1(int satIdx);
+    void compare(const char *name, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int (&expected)[BO_LINSTOTAL][BO_MAXCOLS]);
+    static uint32_t baseGetBits(uint32_t *stream, int bitpos, int len);
+    void baseGPSL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void baseGLOL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slt);
+    void baseGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void baseBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void icdGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+    void icdBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]);
+};
+
+NavFieldsTest::NavFieldsTest() {
+    failures = 0;
+    srand(31);
+}
+
+/**run performs all the checks on a set of random messages, stored for a random satellite of each constellation.
+ *
+ * @return the number of failed checks
+ */
+int NavFieldsTest::run() {
+    for (int n = 0; n < TST_MESSAGES; ++n) {
+        randomWords(stream, TST_WORDS);
+        checkGetBits();
+        checkGPSL1CA(rand() % GPS_MAXSATELLITES);
+        checkGLOL1CA(rand() % GLO_MAXSATELLITES);
+        checkGALIN(rand() % GAL_MAXSATELLITES);
+        checkBDSD1(rand() % BDS_MAXSATELLITES);
+    }
+    return failures;
+}
+
+/**randomWord gives a word with random bits.
+ *
+ * @return the random word
+ */
+uint32_t NavFieldsTest::randomWord() {
+    return ((uint32_t) (rand() & 0xFFFF) << 16) | (uint32_t) (rand() & 0xFFFF);
+}
+
+/**randomWords fills the given words with random bits.
+ *
+ * @param words the words to fill
+ * @param nWords the number of words
+ */
+void NavFieldsTest::randomWords(uint32_t *words, int nWords) {
+    for (int i = 0; i < nWords; ++i) words[i] = randomWord();
+}
+
+/**checkGetBits checks getBits against baseGetBits for all positions and lengths in the random stream.
+ */
+void NavFieldsTest::checkGetBits() {
+    for (int pos = 0; pos <= (TST_WORDS - 1) * 32; ++pos) {
+        for (int len = 1; len <= 32; ++len) {
+            if (GNSSdataFromGRD::getBits(stream, pos, len) != baseGetBits(stream, pos, len)) {
+                printf("getBits mismatch at position %d length %d\n", pos, len);
+                failures++;
+            }
+        }
+    }
+}
+
+/**checkGPSL1CA fills the GPS L1 C/A subframes of the given satellite with random bits and checks the ephemeris
+ * extracted by extractGPSL1CAEphemeris against the ones extracted by baseGPSL1CAEphemeris.
+ *
+ * @param satIdx the satellite index in the gpsSatFrame
+ */
+void NavFieldsTest::checkGPSL1CA(int satIdx) {
+    int bom[BO_LINSTOTAL][BO_MAXCOLS];
+    int expected[BO_LINSTOTAL][BO_MAXCOLS];
+    for (int i = 0; i < GPS_MAXSUBFRS; ++i) randomWords(grd.gpsSatFrame[satIdx].gpsSatSubframes[i].words, GPS_SUBFRWORDS);
+    grd.extractGPSL1CAEphemeris(satIdx, bom);
+    baseGPSL1CAEphemeris(satIdx, expected);
+    compare("GPS L1 C/A", bom, expected);
+}
+
+/**checkGLOL1CA fills the GLONASS L1 C/A strings, slot and frequency number of the given satellite with random values
+ * and checks the ephemeris extracted by extractGLOL1CAEphemeris against the ones extracted by baseGLOL1CAEphemeris.
+ *
+ * @param satIdx the satellite index in the gloSatFrame
+ */
+void NavFieldsTest::checkGLOL1CA(int satIdx) {
+    int bom[BO_LINSTOTAL][BO_MAXCOLS];
+    int expected[BO_LINSTOTAL][BO_MAXCOLS];
+    int slt, expectedSlt;
+    for (int i = 0; i < GLO_MAXSTRS; ++i) randomWords(grd.gloSatFrame[satIdx].gloSatStrings[i].words, GLO_STRWORDS);
+    grd.glonassOSN_FCN[satIdx].osn = rand() % 24 + 1;
+    grd.glonassOSN_FCN[satIdx].fcn = rand() % 14 - 7;
+    grd.extractGLOL1CAEphemeris(satIdx, bom, slt);
+    baseGLOL1CAEphemeris(satIdx, expected, expectedSlt);
+    compare("GLONASS L1 C/A", bom, expected);
+    if (slt != expectedSlt) {
+        printf("GLONASS L1 C/A slot: %d, expected %d\n", slt, expectedSlt);
+        failures++;
+    }
+}
+
+/**checkGALIN fills the Galileo I/NAV words of the given satellite with random bits and checks the ephemeris extracted
+ * by extractGALINEphemeris against the ones extracted by baseGALINEphemeris, corrected by icdGALINEphemeris.
+ *
+ * @param satIdx the satellite index in the galInavSatFrame
+ */
+void NavFieldsTest::checkGALIN(int satIdx) {
+    int bom[BO_LINSTOTAL][BO_MAXCOLS];
+    int expected[BO_LINSTOTAL][BO_MAXCOLS];
+    for (int i = 0; i < GALINAV_MAXWORDS; ++i) randomWords(grd.galInavSatFrame[satIdx].pageWord[i].data, GALINAV_DATAW);
+    grd.extractGALINEphemeris(satIdx, bom);
+    baseGALINEphemeris(satIdx, expected);
+    icdGALINEphemeris(satIdx, expected);
+    compare("Galileo I/NAV", bom, expected);
+}
+
+/**checkBDSD1 fills the BDS D1 subframes of the given satellite with random bits and checks the ephemeris extracted
+ * by extractBDSD1Ephemeris against the ones extracted by baseBDSD1Ephemeris, corrected by icdBDSD1Ephemeris.
+ *
+ * @param satIdx the satellite index in the bdsSatFrame
+ */
+void NavFieldsTest::checkBDSD1(int satIdx) {
+    int bom[BO_LINSTOTAL][BO_MAXCOLS];
+    int expected[BO_LINSTOTAL][BO_MAXCOLS];
+    for (int i = 0; i < BDSD1_MAXSUBFRS; ++i) randomWords(grd.bdsSatFrame[satIdx].bdsSatSubframes[i].words, BDSD1_SUBFRWORDS);
+    grd.extractBDSD1Ephemeris(satIdx, bom);
+    baseBDSD1Ephemeris(satIdx, expected);
+    icdBDSD1Ephemeris(satIdx, expected);
+    compare("BDS D1", bom, expected);
+}
+
+/**compare checks all the elements of the broadcast orbit arrangements extracted and expected.
+ *
+ * @param name the navigation message name, for messages
+ * @param bom the broadcast orbit arrangement extracted
+ * @param expected the broadcast orbit arrangement expected
+ */
+void NavFieldsTest::compare(const char *name, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int (&expected)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    for (int i = 0; i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            if (bom[i][j] != expected[i][j]) {
+                printf("%s line %d, column %d: %d, expected %d\n", name, i, j, bom[i][j], expected[i][j]);
+                failures++;
+            }
+        }
+    }
+}
+
+/**baseGetBits extracts bits from a stream one at a time, as getBits did before using whole words.
+ *
+ * @param stream the array of unsigned ints containing the bit stream
+ * @param bitpos the position in the stream of first bit to extract (first left bit)
+ * @param len the number of bits to extract
+ * @return an uint32_t with the extracted bits aligned to the right
+ */
+uint32_t NavFieldsTest::baseGetBits(uint32_t *stream, int bitpos, int len) {
+    uint32_t bitMask;
+    uint32_t bits = 0;
+    for (int i = bitpos; i < bitpos + len; i++) {
+        bits = bits << 1;
+        bitMask = 0x01U << (31 - (i % 32));
+        if ((stream[i/32] & bitMask) != 0) bits |= 0x01;
+    }
+    return bits;
+}
+
+/**baseGPSL1CAEphemeris is extractGPSL1CAEphemeris as it was before using field tables.
+ */
+void NavFieldsTest::baseGPSL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *psubfr1data = grd.gpsSatFrame[satIdx].gpsSatSubframes[0].words;
+    uint32_t *psubfr2data = grd.gpsSatFrame[satIdx].gpsSatSubframes[1].words;
+    uint32_t *psubfr3data = grd.gpsSatFrame[satIdx].gpsSatSubframes[2].words;
+    uint32_t *psubfr4data = grd.gpsSatFrame[satIdx].gpsSatSubframes[3].words;
+    for (int i = 0; i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            bom[i][j] = 0;
+        }
+    }
+    //broadcast line 0
+    bom[0][0] = baseGetBits(psubfr1data, GPSL1CA_BIT(219), 16);	                    //T0C
+    bom[0][1] = getTwosComplement(baseGetBits(psubfr1data, GPSL1CA_BIT(271), 22), 22);	//Af0
+    bom[0][2] = getTwosComplement(baseGetBits(psubfr1data, GPSL1CA_BIT(249), 16), 16);	//Af1
+    bom[0][3] = getTwosComplement(baseGetBits(psubfr1data, GPSL1CA_BIT(241), 8), 8);	//Af2
+    //broadcast line 1
+    bom[1][0] = baseGetBits(psubfr2data, GPSL1CA_BIT(61), 8);	                        //IODE
+    bom[1][1] = getTwosComplement(baseGetBits(psubfr2data, GPSL1CA_BIT(69), 16), 16);	//Crs
+    bom[1][2] = getTwosComplement(baseGetBits(psubfr2data, GPSL1CA_BIT(91), 16), 16);	//Delta n
+    bom[1][3] = (baseGetBits(psubfr2data, GPSL1CA_BIT(107), 8) << 24) | baseGetBits(psubfr2data, GPSL1CA_BIT(121), 24);//M0
+    //broadcast line 2
+    bom[2][0] = getTwosComplement(baseGetBits(psubfr2data, GPSL1CA_BIT(151), 16), 16);			                            //Cuc
+    bom[2][1] = (baseGetBits(psubfr2data, GPSL1CA_BIT(167), 8) << 24) | baseGetBits(psubfr2data, GPSL1CA_BIT(181), 24);	//e
+    bom[2][2] = getTwosComplement(baseGetBits(psubfr2data, GPSL1CA_BIT(211), 16), 16);		                                //Cus
+    bom[2][3] = (baseGetBits(psubfr2data, GPSL1CA_BIT(227), 8) << 24) | baseGetBits(psubfr2data, GPSL1CA_BIT(241), 24);	//sqrt(A)
+    //broadcast line 3
+    bom[3][0] = baseGetBits(psubfr2data, GPSL1CA_BIT(271), 16);	                                                        //Toe
+    bom[3][1] = getTwosComplement(baseGetBits(psubfr3data, GPSL1CA_BIT(61), 16), 16);						                //Cic
+    bom[3][2] = (baseGetBits(psubfr3data, GPSL1CA_BIT(77), 8) << 24) | baseGetBits(psubfr3data, GPSL1CA_BIT(91), 24); 	//OMEGA0
+    bom[3][3] = getTwosComplement(baseGetBits(psubfr3data, GPSL1CA_BIT(121), 16), 16);		                				//CIS
+    //broadcast line 4
+    bom[4][0] = (baseGetBits(psubfr3data, GPSL1CA_BIT(137), 8) << 24) | baseGetBits(psubfr3data, GPSL1CA_BIT(151), 24);	//i0
+    bom[4][1] = getTwosComplement(baseGetBits(psubfr3data, GPSL1CA_BIT(181), 16), 16);										//Crc
+    bom[4][2] = (baseGetBits(psubfr3data, GPSL1CA_BIT(197), 8) << 24) | baseGetBits(psubfr3data, GPSL1CA_BIT(211), 24);	//w (omega)
+    bom[4][3] = getTwosComplement(baseGetBits(psubfr3data, GPSL1CA_BIT(241), 24), 24);                                     //w dot
+    //broadcast line 5
+    bom[5][0] = getTwosComplement(baseGetBits(psubfr3data, GPSL1CA_BIT(279), 14), 14);	//IDOT
+    bom[5][1] = baseGetBits(psubfr1data, GPSL1CA_BIT(71), 2);		            		//Codes on L2
+    bom[5][2] = baseGetBits(psubfr1data, GPSL1CA_BIT(61), 10) + grd.nGPSrollOver * 1024; 	//GPS week#
+    bom[5][3] = baseGetBits(psubfr1data, GPSL1CA_BIT(91), 1);				            //L2P data flag
+    //broadcast line 6
+    bom[6][0] = baseGetBits(psubfr1data, GPSL1CA_BIT(73), 4);		//URA index
+    bom[6][1] = baseGetBits(psubfr1data, GPSL1CA_BIT(77), 6);      	//SV health
+    bom[6][2] = getTwosComplement(baseGetBits(psubfr1data, GPSL1CA_BIT(197), 8), 8);                                //TGD
+    bom[6][3] = (baseGetBits(psubfr1data, GPSL1CA_BIT(83), 2) << 8) | baseGetBits(psubfr1data, GPSL1CA_BIT(211), 8);	//IODC
+    //broadcast line 7
+    bom[7][0] = baseGetBits(psubfr1data, GPSL1CA_BIT(31), 17) *6 *100; //Transmission time of message:
+                // the 17 MSB of the Zcount in HOW converted to sec and scaled by 100
+    bom[7][1] = baseGetBits(psubfr2data, GPSL1CA_BIT(287), 1);			//Fit interval flag
+    bom[BO_LIN_IONOA][0] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(69), 8), 8);    //alfa0
+    bom[BO_LIN_IONOA][1] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(77), 8), 8);    //alfa1
+    bom[BO_LIN_IONOA][2] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(91), 8), 8);    //alfa2
+    bom[BO_LIN_IONOA][3] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(99), 8), 8);    //alfa3
+    bom[BO_LIN_IONOB][0] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(107), 8), 8);   //beta0
+    bom[BO_LIN_IONOB][1] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(121), 8), 8);   //beta1
+    bom[BO_LIN_IONOB][2] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(129), 8), 8);   //beta2
+    bom[BO_LIN_IONOB][3] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(137), 8), 8);   //beta3
+    bom[BO_LIN_TIMEU][0] = (baseGetBits(psubfr4data, GPSL1CA_BIT(181), 24) << 8) | baseGetBits(psubfr4data, GPSL1CA_BIT(211), 8);    //Time correction A0
+    bom[BO_LIN_TIMEU][1] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(151), 24), 24);    //Time correction A1
+    bom[BO_LIN_TIMEU][2] = baseGetBits(psubfr4data, GPSL1CA_BIT(219), 8);       //t0t, ref time for for UTC data
+    bom[BO_LIN_TIMEU][3] = baseGetBits(psubfr4data, GPSL1CA_BIT(227), 8);       //WNt, UTC ref week number
+    bom[BO_LIN_TIMEU][3] |= bom[5][2] & (~MASK8b);       //put WNt as a continuous week number
+    bom[BO_LIN_TIMEG][2] = baseGetBits(psubfr4data, GPSL1CA_BIT(31), 17) * 6; //Transmission time of message: the 17 MSB of the Zcount in HOw
+    bom[BO_LIN_TIMEG][3] = bom[5][2];      //the week number when message was transmitted
+    bom[BO_LIN_LEAPS][0] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(241), 8), 8);    //delta tLS (leap seconds)
+    bom[BO_LIN_LEAPS][1] = getTwosComplement(baseGetBits(psubfr4data, GPSL1CA_BIT(271), 8), 8);    //delta tLSF
+    bom[BO_LIN_LEAPS][2] = baseGetBits(psubfr4data, GPSL1CA_BIT(249), 8);    //WN_LSF
+    bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
+    bom[BO_LIN_LEAPS][3] = baseGetBits(psubfr4data, GPSL1CA_BIT(257), 8);    //DN_LSF
+}
+
+/**baseGLOL1CAEphemeris is extractGLOL1CAEphemeris as it was before using field tables.
+ */
+void NavFieldsTest::baseGLOL1CAEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS], int& slt) {
+    uint32_t *pstring1 = grd.gloSatFrame[satIdx].gloSatStrings[0].words;
+    uint32_t *pstring2 = grd.gloSatFrame[satIdx].gloSatStrings[1].words;
+    uint32_t *pstring3 = grd.gloSatFrame[satIdx].gloSatStrings[2].words;
+    uint32_t *pstring4 = grd.gloSatFrame[satIdx].gloSatStrings[3].words;
+    uint32_t *pstring5 = grd.gloSatFrame[satIdx].gloSatStrings[4].words;
+    for (int i = 0; i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            bom[i][j] = 0;
+        }
+    }
+    //TODO verify need or not for string 5
+    /*  not used in this version
+    slt = baseGetBits(pstring4, GLOL1CA_BIT(15), 5);	//slot number (n) in string 4, bits 15-11
+    */
+    slt = grd.glonassOSN_FCN[satIdx].osn;
+    int n4 = baseGetBits(pstring5, GLOL1CA_BIT(36), 5);	//four-year interval number N4: bits 36-32 string 5
+    int nt = baseGetBits(pstring4, GLOL1CA_BIT(26), 11);	//day number NT: bits 26-16 string 4
+    int tb = baseGetBits(pstring2, GLOL1CA_BIT(76), 7); //time interval index tb: bits 76-70 string 2
+    tb *= 15*60;	//convert index to secs
+    /*  not used in this version
+    uint32_t tk =  baseGetBits(pstring1, GLOL1CA_BIT(76), 12);	//Message frame time: bits 76-65 string 1
+    int tkSec = (tk >> 7) *60*60;		//hours in tk to secs.
+    tkSec += ((tk >> 1) & 0x3F) * 60;	//add min. in tk to secs.
+    tkSec += (tk & 0x01) == 0? 0: 30;	//add sec. interval to secs.
+    */
+    //convert frame time (in GLONASS time) to an UTC instant (use GPS ephemeris for convenience)
+    double tTag = getInstantGPSdate(1996 + (n4-1)*4, 1, nt, 0, 0, (float) tb) - 3*60*60;
+    bom[0][0] = (int) tTag;													//Toc
+    bom[0][1] = -getSigned(baseGetBits(pstring4, GLOL1CA_BIT(80), 22), 22);	//Clock bias TauN: bits 80-59 string 4
+    bom[0][2] = getSigned(baseGetBits(pstring3, GLOL1CA_BIT(79), 11), 11);	//Relative frequency bias GammaN: bits 79-69 string 3
+    bom[0][3] = ((int) getTowGNSSinstant(tTag) + 518400) % 604800;		//seconds from UTC week start (mon 00:00). Note that GNSS week starts sun 00:00.
+    bom[1][0] = getSigned(baseGetBits(pstring1, GLOL1CA_BIT(35), 27), 27);	//Satellite position, X: bits 35-9 string 1
+    bom[1][1] = getSigned(baseGetBits(pstring1, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, X: bits 64-41 string 1
+    bom[1][2] = getSigned(baseGetBits(pstring1, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, X: bits 40-36 string 1
+    bom[1][3] = baseGetBits(pstring2, GLOL1CA_BIT(80), 3);					//Satellite health Bn: bits 80-78 string 2
+    bom[2][0] = getSigned(baseGetBits(pstring2, GLOL1CA_BIT(35), 27), 27);	//Satellite position, Y: bits 35-9 string 2
+    bom[2][1] = getSigned(baseGetBits(pstring2, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, Y: bits 64-41 string 2
+    bom[2][2] = getSigned(baseGetBits(pstring2, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, Y: bits 40-36 string 2
+    bom[2][3] = grd.glonassOSN_FCN[satIdx].fcn;								//Frequency number (-7 ... +6)
+    bom[3][0] = getSigned(baseGetBits(pstring3, GLOL1CA_BIT(35), 27), 27);	//Satellite position, Z: bits 35-9 string 3
+    bom[3][1] = getSigned(baseGetBits(pstring3, GLOL1CA_BIT(64), 24), 24);	//Satellite velocity, Z: bits 64-41 string 3
+    bom[3][2] = getSigned(baseGetBits(pstring3, GLOL1CA_BIT(40), 5), 5);	//Satellite acceleration, Z: bits 40-36 string 3
+    bom[3][3] = baseGetBits(pstring4, GLOL1CA_BIT(53), 5);			//Age of oper. information (days) (En): bits 53-49 string 4
+    //get time corrections data from string 5
+    bom[BO_LIN_TIMEU][0] = baseGetBits(pstring5, GLOL1CA_BIT(69), 32);   //TauC
+    bom[BO_LIN_TIMEG][0] = baseGetBits(pstring5, GLOL1CA_BIT(31), 22);   //TauGPS
+}
+
+/**baseGALINEphemeris is extractGALINEphemeris as it was before using field tables.
+ */
+void NavFieldsTest::baseGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    //use pointers for convenience
+    GNSSdataFromGRD::GALINAVFrameData *pframe = &grd.galInavSatFrame[satIdx];
+    uint32_t *pw1data = pframe->pageWord[0].data;
+    uint32_t *pw2data = pframe->pageWord[1].data;
+    uint32_t *pw3data = pframe->pageWord[2].data;
+    uint32_t *pw4data = pframe->pageWord[3].data;
+    uint32_t *pw5data = pframe->pageWord[4].data;
+    uint32_t *pw6data = pframe->pageWord[5].data;
+    uint32_t *pw10data = pframe->pageWord[9].data;
+    for (int i = 0; i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            bom[i][j] = 0;
+        }
+    }
+    //broadcast line 0
+    bom[0][0] = baseGetBits(pw4data, GALIN_BIT(54), 14);                         //T0C
+    bom[0][1] = getTwosComplement(baseGetBits(pw4data, GALIN_BIT(68), 31), 31);  //Af0
+    bom[0][2] = getTwosComplement(baseGetBits(pw4data, GALIN_BIT(99), 21), 21);  //Af1
+    bom[0][3] = getTwosComplement(baseGetBits(pw4data, GALIN_BIT(120), 6), 6);   //Af2
+    //broadcast line 1
+    bom[1][0] = baseGetBits(pw1data, GALIN_BIT(6), 10);	                        //IODnav
+    bom[1][1] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(104), 16), 16);//Crs
+    bom[1][2] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(40), 16), 16);	//Delta n
+    bom[1][3] = getTwosComplement(baseGetBits(pw1data, GALIN_BIT(30), 32),32);  //M0
+    //broadcast line 2
+    bom[2][0] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(56), 16), 16);	//Cuc
+    bom[2][1] = baseGetBits(pw1data, GALIN_BIT(62), 32);                        //e
+    bom[2][2] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(72), 16), 16);	//Cus
+    bom[2][3] = baseGetBits(pw1data, GALIN_BIT(94), 32);   	                    //sqrt(A)
+    //broadcast line 3
+    bom[3][0] = baseGetBits(pw1data, GALIN_BIT(16), 14);       	                //Toe
+    bom[3][1] = getTwosComplement(baseGetBits(pw4data, GALIN_BIT(22), 16), 16);	//Cic
+    bom[3][2] = getTwosComplement(baseGetBits(pw2data, GALIN_BIT(16), 32), 32); //OMEGA0
+    bom[3][3] = getTwosComplement(baseGetBits(pw4data, GALIN_BIT(38), 16), 16);	//CIS
+    //broadcast line 4
+    bom[4][0] = getTwosComplement(baseGetBits(pw2data, GALIN_BIT(48), 32), 32); //i0
+    bom[4][1] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(88), 16), 16);	//Crc
+    bom[4][2] = getTwosComplement(baseGetBits(pw2data, GALIN_BIT(80), 32), 32); //w (omega)
+    bom[4][3] = getTwosComplement(baseGetBits(pw3data, GALIN_BIT(16), 24), 24); //w dot
+    //broadcast line 5
+    bom[5][0] = getTwosComplement(baseGetBits(pw2data, GALIN_BIT(112), 14), 14);	//IDOT
+    bom[5][1] = 0xA0400000;				        //data source: assumed non-exclusive and for E5b, E1
+    bom[5][2] = baseGetBits(pw5data, GALIN_BIT(73), 12) + 1024 + grd.nGALrollOver * 4096;  //GAL week# (GST week + weeks to 1st GPS roll over + GAL roll over
+    //broadcast line 6
+    bom[6][0] = baseGetBits(pw3data, GALIN_BIT(120), 8);			    //SISA
+    bom[6][1] = (baseGetBits(pw5data, GALIN_BIT(72), 1) << 31)      //SV health: E1B DVS
+                | (baseGetBits(pw5data, GALIN_BIT(69), 2) << 29)	//SV health: E1B HS
+                | (baseGetBits(pw5data, GALIN_BIT(71), 1) << 25)    //SV health: E5b DVS
+                | (baseGetBits(pw5data, GALIN_BIT(69), 2) << 23);   //SV health: E5b HS
+    bom[6][2] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(47), 10), 10);    //BGD E5a / E1
+    bom[6][3] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(57), 10), 10);    //BGD E5b / E1
+    //broadcast line 7
+    bom[7][0] = baseGetBits(pw5data, GALIN_BIT(85), 20);	//Time of message: TOW from GST
+    //extract corrections data
+    bom[BO_LIN_IONOA][0] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(6), 11), 11);   //Iono Ai0
+    bom[BO_LIN_IONOA][1] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(17), 11), 11);  //Iono Ai1
+    bom[BO_LIN_IONOA][2] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(28), 14), 14);  //Iono Ai2
+    bom[BO_LIN_TIMEU][0] = baseGetBits(pw6data, GALIN_BIT(6), 32);                          //GST - UTC correction A0
+    bom[BO_LIN_TIMEU][1] = getTwosComplement(baseGetBits(pw5data, GALIN_BIT(38), 24), 24);  //GST - UTC correction A1
+    bom[BO_LIN_TIMEU][2] = baseGetBits(pw5data, GALIN_BIT(70), 8);   //GST - UTC correction t0t
+    bom[BO_LIN_TIMEU][3] = baseGetBits(pw5data, GALIN_BIT(78), 8);   //GST - UTC correction WN0t
+    bom[BO_LIN_TIMEU][3] |= bom[5][2] & (~MASK8b);       //put WNt as a continuous week number
+    bom[BO_LIN_TIMEG][0] = getTwosComplement(baseGetBits(pw10data, GALIN_BIT(86), 16), 16);     //Time correction AG0
+    bom[BO_LIN_TIMEG][1] = getTwosComplement(baseGetBits(pw10data, GALIN_BIT(102), 12), 12);    //Time correction AG1
+    bom[BO_LIN_TIMEG][2] = baseGetBits(pw10data, GALIN_BIT(114), 8);      //ref time: t0G
+    bom[BO_LIN_TIMEG][3] = baseGetBits(pw10data, GALIN_BIT(122), 6);      //ref week number: WN0G
+    bom[BO_LIN_TIMEG][3] |= bom[5][2] & (~MASK8b);       //put WN0G as a continuous week number
+    bom[BO_LIN_LEAPS][0] = getTwosComplement(baseGetBits(pw6data, GALIN_BIT(62), 8), 8);    //delta tLS (leap seconds)
+    bom[BO_LIN_LEAPS][1] = getTwosComplement(baseGetBits(pw6data, GALIN_BIT(95), 8), 8);    //delta tLSF
+    bom[BO_LIN_LEAPS][2] = baseGetBits(pw6data, GALIN_BIT(86), 8);    //WN_LSF
+    bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
+    bom[BO_LIN_LEAPS][3] = baseGetBits(pw6data, GALIN_BIT(92), 3);    //DN_LSF
+}
+
+/**baseBDSD1Ephemeris is extractBDSD1Ephemeris as it was before using field tables.
+ */
+void NavFieldsTest::baseBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    //TODO test this method with real data
+    uint32_t *psubfr1data = grd.bdsSatFrame[satIdx].bdsSatSubframes[0].words;
+    uint32_t *psubfr2data = grd.bdsSatFrame[satIdx].bdsSatSubframes[1].words;
+    uint32_t *psubfr3data = grd.bdsSatFrame[satIdx].bdsSatSubframes[2].words;
+    uint32_t *psubfr5_9data = grd.bdsSatFrame[satIdx].bdsSatSubframes[3].words;   //subframe 5, page 9
+    uint32_t *psubfr5_10data = grd.bdsSatFrame[satIdx].bdsSatSubframes[4].words;   //subframe 5, page 10
+    for (int i = 0; i < BO_LINSTOTAL; ++i) {
+        for (int j = 0; j < BO_MAXCOLS; ++j) {
+            bom[i][j] = 0;
+        }
+    }
+    //broadcast line 0
+    bom[0][0] = (baseGetBits(psubfr1data, BDSD1_BIT(74), 9) << 8) | baseGetBits(psubfr1data, BDSD1_BIT(91), 8); //T0C
+    bom[0][1] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(226), 7) << 17) | baseGetBits(psubfr1data, BDSD1_BIT(241), 17), 24);	//Af0
+    bom[0][2] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(258), 5) << 17) | baseGetBits(psubfr1data, BDSD1_BIT(241), 17), 22);	//Af1
+    bom[0][3] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(215), 11), 11);    	//Af2
+    //broadcast line 1
+    bom[1][0] = baseGetBits(psubfr1data, BDSD1_BIT(288), 5);	                    //IODE (AODE)
+    bom[1][1] = getTwosComplement((baseGetBits(psubfr2data, BDSD1_BIT(225), 4) << 10) | baseGetBits(psubfr2data, BDSD1_BIT(241), 10), 14); //Crs
+    bom[1][2] = getTwosComplement((baseGetBits(psubfr2data, BDSD1_BIT(43), 10) << 6) | baseGetBits(psubfr2data, BDSD1_BIT(61), 6), 16);	//Delta n
+    bom[1][3] = (baseGetBits(psubfr2data, BDSD1_BIT(93), 20) << 12) | baseGetBits(psubfr2data, BDSD1_BIT(121), 12);//M0
+    //broadcast line 2
+    bom[2][0] = getTwosComplement((baseGetBits(psubfr2data, BDSD1_BIT(67), 16) << 2) | baseGetBits(psubfr2data, BDSD1_BIT(91), 2), 18); //Cuc
+    bom[2][1] = (baseGetBits(psubfr2data, BDSD1_BIT(133), 10) << 22) | baseGetBits(psubfr2data, BDSD1_BIT(151), 25);	//e
+    bom[2][2] = getTwosComplement(baseGetBits(psubfr2data, BDSD1_BIT(181), 18), 18);                                //Cus
+    bom[2][3] = (baseGetBits(psubfr2data, BDSD1_BIT(251), 12) << 20) | baseGetBits(psubfr2data, BDSD1_BIT(271), 20);	//sqrt(A)
+    //broadcast line 3
+    bom[3][0] = (baseGetBits(psubfr2data, BDSD1_BIT(291), 2) << 15) | (baseGetBits(psubfr3data, BDSD1_BIT(43), 10) << 5) | baseGetBits(psubfr3data, BDSD1_BIT(61), 5);                            //Toe
+    bom[3][1] = getTwosComplement((baseGetBits(psubfr3data, BDSD1_BIT(106), 7) << 11) | baseGetBits(psubfr3data, BDSD1_BIT(121), 11), 18);  //Cic
+    bom[3][2] = (baseGetBits(psubfr3data, BDSD1_BIT(212), 21) << 11) | baseGetBits(psubfr3data, BDSD1_BIT(241), 11);                     	//OMEGA0
+    bom[3][3] = getTwosComplement((baseGetBits(psubfr3data, BDSD1_BIT(164), 9) << 9) | baseGetBits(psubfr3data, BDSD1_BIT(181), 9), 18);	//CIS
+    //broadcast line 4
+    bom[4][0] = (baseGetBits(psubfr3data, BDSD1_BIT(66), 17) << 15) | baseGetBits(psubfr3data, BDSD1_BIT(91), 15);                          //i0
+    bom[4][1] = getTwosComplement((baseGetBits(psubfr2data, BDSD1_BIT(199), 4) << 14) | baseGetBits(psubfr2data, BDSD1_BIT(211), 14), 18);	//Crc
+    bom[4][2] = (baseGetBits(psubfr3data, BDSD1_BIT(252), 11) << 21) | baseGetBits(psubfr3data, BDSD1_BIT(271), 21);                    	//w (omega)
+    bom[4][3] = getTwosComplement((baseGetBits(psubfr3data, BDSD1_BIT(132), 11) << 13) | baseGetBits(psubfr3data, BDSD1_BIT(151), 13), 24); //w dot
+    //broadcast line 5
+    bom[5][0] = getTwosComplement((baseGetBits(psubfr3data, BDSD1_BIT(190), 13) << 1) | baseGetBits(psubfr3data, BDSD1_BIT(211), 1) , 14);	//IDOT
+    bom[5][2] = baseGetBits(psubfr1data, BDSD1_BIT(61), 13) + grd.nBDSrollOver * 8192; //BDS week
+    //broadcast line 6
+    bom[6][0] = baseGetBits(psubfr1data, BDSD1_BIT(49), 4);			//URA index
+    bom[6][1] = baseGetBits(psubfr1data, BDSD1_BIT(43), 1);      	//sat H1
+    bom[6][2] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(99), 10), 10);                                                     //TGD1 B1/B3
+    bom[6][3] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(109), 4) << 6) | baseGetBits(psubfr1data, BDSD1_BIT(121), 6), 10);	//TGD2 B2/B3
+    //broadcast line 7
+    bom[7][0] = (baseGetBits(psubfr1data, BDSD1_BIT(19), 8) << 12) | baseGetBits(psubfr1data, BDSD1_BIT(31), 12); //Transmission time of message: SOW
+    bom[7][1] = baseGetBits(psubfr1data, BDSD1_BIT(44), 5);			//IODC (AODC
+    //extract corrections data
+    bom[BO_LIN_IONOA][0] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(127), 8), 8);    //alfa0
+    bom[BO_LIN_IONOA][1] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(135), 8), 8);    //alfa1
+    bom[BO_LIN_IONOA][2] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(151), 8), 8);    //alfa2
+    bom[BO_LIN_IONOA][3] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(159), 8), 8);    //alfa3
+    bom[BO_LIN_IONOB][0] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(167), 6) << 2) | baseGetBits(psubfr1data, BDSD1_BIT(181), 2), 8);   //beta0
+    bom[BO_LIN_IONOB][1] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(183), 8), 8);   //beta1
+    bom[BO_LIN_IONOB][2] = getTwosComplement(baseGetBits(psubfr1data, BDSD1_BIT(191), 8), 8);   //beta2
+    bom[BO_LIN_IONOB][3] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(199), 4)<<4) | baseGetBits(psubfr1data, BDSD1_BIT(211), 4), 8);   //beta3
+    bom[BO_LIN_TIMEU][0] = (baseGetBits(psubfr5_10data, BDSD1_BIT(91), 22) << 10) | baseGetBits(psubfr5_10data, BDSD1_BIT(121), 10);    //Time correction A0UTC
+    bom[BO_LIN_TIMEU][1] = getTwosComplement((baseGetBits(psubfr5_10data, BDSD1_BIT(131), 12) << 12) | baseGetBits(psubfr5_10data, BDSD1_BIT(151), 12), 24);    //A1UTC
+    bom[BO_LIN_TIMEG][0] = getTwosComplement(baseGetBits(psubfr5_9data, BDSD1_BIT(97), 14), 14);      //A0GPS
+    bom[BO_LIN_TIMEG][1] = getTwosComplement((baseGetBits(psubfr5_9data, BDSD1_BIT(111), 2) << 14) | baseGetBits(psubfr5_9data, BDSD1_BIT(121), 14), 16);    //A1GPS
+    bom[BO_LIN_LEAPS][0] = getTwosComplement((baseGetBits(psubfr5_10data, BDSD1_BIT(51), 2) << 6) | baseGetBits(psubfr5_10data, BDSD1_BIT(61), 6) , 8);    //delta tLS (leap seconds)
+    bom[BO_LIN_LEAPS][1] = getTwosComplement(baseGetBits(psubfr5_10data, BDSD1_BIT(67), 8), 8);    //delta tLSF
+    bom[BO_LIN_LEAPS][2] = baseGetBits(psubfr5_10data, BDSD1_BIT(75), 8);    //WN_LSF
+    bom[BO_LIN_LEAPS][2] |= bom[5][2] & (~MASK8b);       //put WN_LSF as a continuous week number
+    bom[BO_LIN_LEAPS][3] = baseGetBits(psubfr5_10data, BDSD1_BIT(163), 8);    //DN_LSF
+}
+
+/**icdGALINEphemeris extracts again the Galileo I/NAV fields that baseGALINEphemeris read at wrong positions, taking
+ * them at their positions in the Galileo OS ICD: A1, t0t and WN0t in word type 6 (not 5), delta tLSF and DN two bits
+ * before, and E5b HS in its own bits (not the E1B HS ones).
+ *
+ * @param satIdx the satellite index in the galInavSatFrame
+ * @param bom the broadcast orbit arrangement extracted by baseGALINEphemeris, to be corrected
+ */
+void NavFieldsTest::icdGALINEphemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *pw5data = grd.galInavSatFrame[satIdx].pageWord[4].data;
+    uint32_t *pw6data = grd.galInavSatFrame[satIdx].pageWord[5].data;
+    bom[6][1] = (bom[6][1] & ~(0x03 << 23)) | (baseGetBits(pw5data, GALIN_BIT(67), 2) << 23);   //SV health: E5b HS
+    bom[BO_LIN_TIMEU][1] = getTwosComplement(baseGetBits(pw6data, GALIN_BIT(38), 24), 24);  //GST - UTC correction A1
+    bom[BO_LIN_TIMEU][2] = baseGetBits(pw6data, GALIN_BIT(70), 8);   //GST - UTC correction t0t
+    bom[BO_LIN_TIMEU][3] = baseGetBits(pw6data, GALIN_BIT(78), 8);   //GST - UTC correction WN0t
+    bom[BO_LIN_TIMEU][3] |= bom[5][2] & (~MASK8b);       //put WNt as a continuous week number
+    bom[BO_LIN_LEAPS][1] = getTwosComplement(baseGetBits(pw6data, GALIN_BIT(97), 8), 8);    //delta tLSF
+    bom[BO_LIN_LEAPS][3] = baseGetBits(pw6data, GALIN_BIT(94), 3);    //DN_LSF
+}
+
+/**icdBDSD1Ephemeris extracts again the BDS D1 fields that baseBDSD1Ephemeris read at wrong positions, taking them at
+ * their positions in the BDS ICD: the Af1 LSBs (not the Af0 ones), the 22 LSBs of e (not 25), and the 8 MSBs of Crs
+ * (not 4).
+ *
+ * @param satIdx the satellite index in the bdsSatFrame
+ * @param bom the broadcast orbit arrangement extracted by baseBDSD1Ephemeris, to be corrected
+ */
+void NavFieldsTest::icdBDSD1Ephemeris(int satIdx, int (&bom)[BO_LINSTOTAL][BO_MAXCOLS]) {
+    uint32_t *psubfr1data = grd.bdsSatFrame[satIdx].bdsSatSubframes[0].words;
+    uint32_t *psubfr2data = grd.bdsSatFrame[satIdx].bdsSatSubframes[1].words;
+    bom[0][2] = getTwosComplement((baseGetBits(psubfr1data, BDSD1_BIT(258), 5) << 17) | baseGetBits(psubfr1data, BDSD1_BIT(271), 17), 22);	//Af1
+    bom[1][1] = getTwosComplement((baseGetBits(psubfr2data, BDSD1_BIT(225), 8) << 10) | baseGetBits(psubfr2data, BDSD1_BIT(241), 10), 18); //Crs
+    bom[2][1] = (baseGetBits(psubfr2data, BDSD1_BIT(133), 10) << 22) | baseGetBits(psubfr2data, BDSD1_BIT(151), 22);	//e
+}
+
+int main() {
+    NavFieldsTest test;
+    int failures = test.run();
+    if (failures == 0) printf("Navigation message fields extraction: OK\n");
+    else printf("Navigation message fields extraction: %d checks FAILED\n", failures);
+    return failures == 0? 0 : 1;
+}
@@ -0,0 +1,412 @@
+/** @file ObsConvertTest.cpp
+ * Contains a host test of the conversion of RINEX files between versions (convertObsFile and convertNavFile), and of
+ * the reading fixes it relies on: values of V2 observables that cannot be translated are not stored under other types,
+ * and the V2 "# / TYPES OF OBSERV" record includes the observables to print of any system.
+ * Converted files are read back with readObsEpoch / readNavEpoch, and their data compared with the ones read from the
+ * input file.
+ */
+#include "RinexData.h"
+#include "Utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+//@cond DUMMY
+#define TST_SATELLITE 12        //the GPS satellite used in the navigation test
+#define TST_WEEK 2150           //the GPS week and tow of the ephemeris used in the navigation test
+#define TST_TOW 352800.0
+//@endcond
+
+//A V2.10 observation file having a type (C2) without V3 equivalence
+static const char UNTRANSLATED[] =
+    "     2.10           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "     3    C1    C2    L1                                    # / TYPES OF OBSERV\n"
+    "                                                            END OF HEADER\n"
+    " 18  5  6  0  0  0.0000000  0  2G02G05\n"
+    "  20002000.003 8  20002001.998 8    105104.00417\n"
+    "  20005000.005 6  20005001.005 6    105120.001 7\n"
+    " 18  5  6  0  0 30.0000000  0  2G02G05\n"
+    "  20002030.003 8                    105106.004 7\n"
+    "  20005030.005 6  20005031.005 6    105122.001 7\n";
+
+//A V3.04 observation file where the first system has no V2 observables
+static const char NOV2TYPES[] =
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE\n"
+    "E    2 C1X L1X                                              SYS / # / OBS TYPES\n"
+    "G    2 C1C L1C                                              SYS / # / OBS TYPES\n"
+    "                                                            END OF HEADER\n"
+    "> 2018 05 06 00 00  0.0000000  0  3\n"
+    "E01  20001000.005 8    105101.005 8\n"
+    "G02  20002000.003 8    105104.004 6\n"
+    "G05  20005000.005 7    105120.00116\n"
+    "> 2018 05 06 00 00 30.0000000  0  2\n"
+    "E01  20001030.005 8    105103.005 8\n"
+    "G02  20002030.003 8    105106.004 6\n";
+
+//A V2.10 observation file with all the V2 observables, empty ones, an event epoch, and epochs with continuation lines
+static const char ALLTYPES[] =
+    "     2.10           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "     7    C1    L1    D1    S1    P1    P2    L2            # / TYPES OF OBSERV\n"
+    "                                                            END OF HEADER\n"
+    " 18  5  6  0  0  0.0000000  0 14G01G02G03G04G05G06G07G08G09G10G11G12 0.123456789\n"
+    "                                G13G14\n"
+    "  20000999.99617 -20001000.99618  20001002.003          -0.6831   20001004.005 8\n"
+    "  20001004.99917  20001005.995 5\n"
+    "  20001999.99617 -20002001.00016  20002002.00518        -0.89218  20002004.004\n"
+    "  20002005.00418  20002006.00415\n"
+    "  20003000.002 6 -20003000.99918  20003002.00217         0.979 8  20003003.997 5\n"
+    "  20003004.9961\n"
+    "  20003999.9951  -20004001.0011   20004002.002 7         0.46915  20004003.99916\n"
+    "                  20004005.996 7\n"
+    "  20005000.0021  -20005001.005 5  20005001.99816         0.156 5\n"
+    "  20005005.0001   20005006.004 5\n"
+    "  20006000.00418 -20006001.001 6  20006002.000 7                  20006004.005 8\n"
+    "  20006005.002 7  20006006.004 6\n"
+    "  20007000.003 6 -20007001.00417                         0.063    20007003.998 6\n"
+    "  20007004.99617  20007005.999 7\n"
+    "  20008000.0031                   20008002.002           0.213 6  20008004.001 6\n"
+    "  20008005.004 5  20008005.99816\n"
+    "                 -20009000.998    20009002.001           0.879 8  20009004.001 8\n"
+    "  20009004.99915  20009006.00216\n"
+    "  20010000.000 6 -20010001.005 5  20010002.00515        -0.926 6  20010003.99615\n"
+    "  20010004.995 6  20010006.0031\n"
+    "  20010999.99718 -20011000.996    20011001.996 7         0.447 5  20011004.00017\n"
+    "  20011005.00015  20011005.999 5\n"
+    "  20012000.00217 -20012000.996 7  20012001.99815         0.470 8  20012003.99515\n"
+    "  20012005.001 8\n"
+    "  20012999.997 6 -20013000.998 6  20013002.0001         -0.53116  20013003.995 8\n"
+    "                  20013006.002 7\n"
+    "  20013999.99717 -20014001.002 7  20014002.003 5        -0.151\n"
+    "  20014005.004 5  20014005.995 5\n"
+    " 18  5  6  0  0 15.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    " 18  5  6  0  0 30.0000000  0 14G01G02G03G04G05G06G07G08G09G10G11G12 0.123457790\n"
+    "                                G13G14\n"
+    "  20001029.99616 -20001031.003 5  20001032.0051         -0.81418  20001033.99717\n"
+    "  20001034.99517  20001036.00216\n"
+    "  20002029.999 8 -20002030.998 6  20002031.99618         0.159    20002034.003 8\n"
+    "  20002035.000\n"
+    "  20003029.998 6 -20003031.00115  20003031.99617         0.41517  20003033.997 8\n"
+    "                  20003035.99815\n"
+    "  20004029.998 8 -20004031.004 8  20004031.99516         0.57218\n"
+    "  20004034.99716  20004035.99818\n"
+    "  20005030.000 6 -20005031.00115  20005032.00117                  20005033.99815\n"
+    "  20005034.99917  20005036.003 8\n"
+    "  20006030.00416 -20006031.00415                        -0.1821   20006034.001 6\n"
+    "  20006035.0001   20006036.003 7\n"
+    "  20007030.002                    20007032.00116         0.37916  20007034.0021\n"
+    "  20007035.00316  20007035.999 8\n"
+    "                 -20008031.00015  20008032.00115        -0.16115  20008033.9981\n"
+    "  20008034.996 5  20008035.99917\n"
+    "  20009029.995 8 -20009030.99518  20009031.99716        -0.706 6  20009034.00215\n"
+    "  20009035.001    20009036.003 8\n"
+    "  20010030.005 5 -20010030.99816  20010031.997 7         0.697 8  20010034.005 8\n"
+    "  20010034.997 6  20010036.000\n"
+    "  20011030.00318 -20011030.999 5  20011031.9981          0.164 5  20011034.005\n"
+    "  20011035.00416\n"
+    "  20012030.00416 -20012030.995 6  20012032.00117        -0.62818  20012033.99618\n"
+    "                  20012035.99518\n"
+    "  20013029.99615 -20013030.9961   20013031.997 5         0.252\n"
+    "  20013034.99918  20013035.995 5\n"
+    "  20014030.005   -20014031.005    20014031.995                    20014034.00218\n"
+    "  20014034.99817  20014035.999 6\n"
+    " 18  5  6  0  1  0.0000000  0  3G01G02G03\n"
+    "  20001059.999 8 -20001060.99718  20001061.99717         0.445 5  20001064.00317\n"
+    "  20001064.998\n"
+    "  20002059.99816 -20002061.00418  20002062.00218        -0.362 6  20002064.001 5\n"
+    "                  20002065.99615\n"
+    "  20003059.998 7 -20003061.002    20003062.00418        -0.949 6\n"
+    "  20003064.99817  20003066.00216\n";
+
+/**ObsConvertTest class contains the test cases.
+ */
+class ObsConvertTest {
+public:
+    ObsConvertTest();
+    int run();
+
+private:
+    Logger log;
+    int failures;
+
+    void checkUntranslatedTypes();
+    void checkV2TypesRecord();
+    void checkObsConversion();
+    void checkNavConversion();
+    FILE* textFile(const char *text, const char *name);
+    FILE* convertObs(FILE *input, RinexData::RINEXversion version, const char *name);
+    vector<string> readObsEpochs(FILE *file, char sys = 0);
+    void compareEpochs(const char *name, vector<string> &read, vector<string> &expected);
+};
+
+ObsConvertTest::ObsConvertTest() {
+    failures = 0;
+}
+
+/**run performs all the checks.
+ *
+ * @return the number of failed checks
+ */
+int ObsConvertTest::run() {
+    checkUntranslatedTypes();
+    checkV2TypesRecord();
+    checkObsConversion();
+    checkNavConversion();
+    return failures;
+}
+
+/**checkUntranslatedTypes reads a V2.10 file having an observable type without V3 equivalence, and checks that values
+ * of the other types are stored under their own type.
+ */
+void ObsConvertTest::checkUntranslatedTypes() {
+    FILE *file = textFile(UNTRANSLATED, "untranslated types");
+    if (file == NULL) return;
+    vector<string> read = readObsEpochs(file);
+    vector<string> expected;
+    expected.push_back("2018/05/06 00:00:00.0000000 0 0.000000000000"
+                       " G02 C1C 20002000.003 0 8 G02 L1C 105104.004 1 7"
+                       " G05 C1C 20005000.005 0 6 G05 L1C 105120.001 0 7");
+    expected.push_back("2018/05/06 00:00:30.0000000 0 0.000000000000"
+                       " G02 C1C 20002030.003 0 8 G02 L1C 105106.004 0 7"
+                       " G05 C1C 20005030.005 0 6 G05 L1C 105122.001 0 7");
+    compareEpochs("untranslated types", read, expected);
+    fclose(file);
+}
+
+/**checkV2TypesRecord converts to V2.10 a V3.04 file where the first system has no V2 observables, and checks that the
+ * "# / TYPES OF OBSERV" record includes the observables of the other system, and that their values are printed.
+ */
+void ObsConvertTest::checkV2TypesRecord() {
+    char lineBuffer[100];
+    bool typesFound = false;
+    FILE *input = textFile(NOV2TYPES, "V2 types record");
+    if (input == NULL) return;
+    FILE *output = convertObs(input, RinexData::V210, "V2 types record");
+    if (output == NULL) {
+        fclose(input);
+        return;
+    }
+    while (fgets(lineBuffer, sizeof lineBuffer, output) != NULL && strstr(lineBuffer, "END OF HEADER") == NULL) {
+        if (strstr(lineBuffer, "# / TYPES OF OBSERV") != NULL) {
+            typesFound = strncmp(lineBuffer, "     2    C1    L1    ", 22) == 0;
+        }
+    }
+    if (!typesFound) {
+        printf("V2 types record: C1 and L1 not in # / TYPES OF OBSERV\n");
+        failures++;
+    }
+    vector<string> read = readObsEpochs(output, 'G');
+    vector<string> expected = readObsEpochs(input, 'G');
+    compareEpochs("V2 types record", read, expected);
+    fclose(output);
+    fclose(input);
+}
+
+/**checkObsConversion converts a V2.10 file to V3.04, and the result again to V2.10, and checks that epochs read from
+ * each converted file are the ones read from the input file.
+ */
+void ObsConvertTest::checkObsConversion() {
+    FILE *v2 = textFile(ALLTYPES, "observation conversion");
+    if (v2 == NULL) return;
+    vector<string> expected = readObsEpochs(v2);
+    FILE *v3 = convertObs(v2, RinexData::V304, "V2.10 to V3.04");
+    if (v3 != NULL) {
+        vector<string> read = readObsEpochs(v3);
+        compareEpochs("V2.10 to V3.04", read, expected);
+        FILE *v3v2 = convertObs(v3, RinexData::V210, "V3.04 to V2.10");
+        if (v3v2 != NULL) {
+            read = readObsEpochs(v3v2);
+            compareEpochs("V3.04 to V2.10", read, expected);
+            fclose(v3v2);
+        }
+        fclose(v3);
+    }
+    fclose(v2);
+}
+
+/**checkNavConversion prints a V3.04 GPS navigation file with one ephemeris, converts it to V2.10, and checks that
+ * the ephemeris read from the converted file are the ones read from the input file.
+ */
+void ObsConvertTest::checkNavConversion() {
+    char sys, sysRead;
+    int sat, satRead;
+    double bo[BO_MAXLINS][BO_MAXCOLS], expected[BO_MAXLINS][BO_MAXCOLS], boRead[BO_MAXLINS][BO_MAXCOLS];
+    double tTag, tTagRead;
+    FILE *input = tmpfile();
+    FILE *output = tmpfile();
+    if (input == NULL || output == NULL) {
+        printf("navigation conversion: cannot create the temporary files\n");
+        failures++;
+        if (input != NULL) fclose(input);
+        if (output != NULL) fclose(output);
+        return;
+    }
+    //print the V3.04 navigation file
+    for (int i = 0; i < BO_MAXLINS; ++i)
+        for (int j = 0; j < BO_MAXCOLS; ++j)
+            bo[i][j] = ((i + j) % 2 == 0? 1.0 : -1.0) * (1.0 + (i * BO_MAXCOLS + j) / 37.0) * (i * 7 + j * 3 + 1) * 1.0E-3;
+    bo[0][0] = getInstantGNSStime(TST_WEEK, TST_TOW);
+    RinexData writer(RinexData::V304, &log);
+    writer.setHdLnData(RinexData::RUNBY, string("ObsConvertTest"), string("test"), string());
+    vector<string> noObsTypes;
+    writer.setHdLnData(RinexData::SYS, 'G', noObsTypes);
+    writer.saveNavData('G', TST_SATELLITE, bo, bo[0][0]);
+    writer.setFilter(noObsTypes, noObsTypes);
+    writer.printNavHeader(input);
+    writer.printNavEpochs(input);
+    //read the ephemeris printed
+    rewind(input);
+    RinexData inReader(RinexData::V304, &log);
+    if (inReader.readRinexHeader(input) != RinexData::EOH || inReader.readNavEpoch(input) != 1
+            || !inReader.getNavData(sys, sat, expected, tTag)) {
+        printf("navigation conversion: input ephemeris not read\n");
+        failures++;
+        fclose(output);
+        fclose(input);
+        return;
+    }
+    //convert to V2.10 and read the ephemeris converted
+    rewind(input);
+    RinexData converter(RinexData::V210, &log);
+    if (converter.convertNavFile(input, output) != 1) {
+        printf("navigation conversion: ephemeris not converted\n");
+        failures++;
+    } else {
+        rewind(output);
+        RinexData outReader(RinexData::V210, &log);
+        if (outReader.readRinexHeader(output) != RinexData::EOH || outReader.readNavEpoch(output) != 1
+                || !outReader.getNavData(sysRead, satRead, boRead, tTagRead)) {
+            printf("navigation conversion: converted ephemeris not read\n");
+            failures++;
+        } else if (sysRead != sys || satRead != sat || tTagRead != tTag) {
+            printf("navigation conversion: wrong satellite or time tag read\n");
+            failures++;
+        } else {
+            for (int i = 0; i < BO_MAXLINS_GPS; ++i)
+                for (int j = (i == 0? 1 : 0); j < BO_MAXCOLS && (i == 0 || (i - 1) * BO_MAXCOLS + j < BO_TOTEPHE_GPS); ++j)
+                    if (boRead[i][j] != expected[i][j]) {
+                        printf("navigation conversion: broadcast orbit [%d][%d] %19.12E, expected %19.12E\n", i, j, boRead[i][j], expected[i][j]);
+                        failures++;
+                    }
+        }
+    }
+    fclose(output);
+    fclose(input);
+}
+
+/**textFile creates a temporary file with the given text, positioned at its beginning.
+ *
+ * @param text the file content
+ * @param name the check name, for messages
+ * @return the file, or NULL if it cannot be created
+ */
+FILE* ObsConvertTest::textFile(const char *text, const char *name) {
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("%s: cannot create the temporary file\n", name);
+        failures++;
+        return NULL;
+    }
+    fputs(text, file);
+    rewind(file);
+    return file;
+}
+
+/**convertObs converts the given observation file to the given version using convertObsFile.
+ *
+ * @param input the file to convert
+ * @param version the version of the converted file
+ * @param name the check name, for messages
+ * @return a temporary file with the converted file, or NULL if it cannot be converted
+ */
+FILE* ObsConvertTest::convertObs(FILE *input, RinexData::RINEXversion version, const char *name) {
+    FILE *output = tmpfile();
+    if (output == NULL) {
+        printf("%s: cannot create the temporary file\n", name);
+        failures++;
+        return NULL;
+    }
+    rewind(input);
+    RinexData converter(version, string("ObsConvertTest"), string("test"), &log);
+    try {
+        if (converter.convertObsFile(input, output) == 0) {
+            printf("%s: no epoch converted\n", name);
+            failures++;
+        }
+    } catch (string error) {
+        printf("%s: %s\n", name, error.c_str());
+        failures++;
+    }
+    rewind(output);
+    return output;
+}
+
+/**readObsEpochs reads sequentially with readObsEpoch the epochs in the given observation file.
+ * Each epoch is given as a string with its time, flag, clock offset, and its observables sorted by satellite and type.
+ *
+ * @param file the observation file
+ * @param sys the system of the observables to include, or 0 to include all of them
+ * @return the epochs read
+ */
+vector<string> ObsConvertTest::readObsEpochs(FILE *file, char sys) {
+    char buffer[100];
+    char obsSys;
+    int week, flag, sat, lli, strg;
+    double tow, bias, value;
+    string obsType;
+    vector<string> epochs;
+    vector<string> obs;
+    rewind(file);
+    RinexData reader(RinexData::V304, &log);
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        epochs.push_back(string("header not read"));
+        return epochs;
+    }
+    for (int status = reader.readObsEpoch(file); status != 0 && status != 9; status = reader.readObsEpoch(file)) {
+        reader.getEpochTime(week, tow, bias, flag);
+        formatGPStime(buffer, sizeof buffer, "%Y/%m/%d %H:%M:", "%010.7f", week, tow);
+        string epoch(buffer);
+        snprintf(buffer, sizeof buffer, " %d %.12f", flag, bias);
+        epoch += string(buffer);
+        obs.clear();
+        for (unsigned int i = 0; reader.getObsData(obsSys, sat, obsType, value, lli, strg, i); ++i) {
+            if (sys != 0 && obsSys != sys) continue;
+            snprintf(buffer, sizeof buffer, " %c%02d %s %.3f %d %d", obsSys, sat, obsType.c_str(), value, lli, strg);
+            obs.push_back(string(buffer));
+        }
+        sort(obs.begin(), obs.end());
+        for (vector<string>::iterator it = obs.begin(); it != obs.end(); ++it) epoch += *it;
+        epochs.push_back(epoch);
+    }
+    return epochs;
+}
+
+/**compareEpochs checks that the epochs read are the expected ones.
+ *
+ * @param name the check name, for messages
+ * @param read the epochs read
+ * @param expected the epochs expected
+ */
+void ObsConvertTest::compareEpochs(const char *name, vector<string> &read, vector<string> &expected) {
+    if (read.size() != expected.size()) {
+        printf("%s: %d epochs read, expected %d\n", name, (int) read.size(), (int) expected.size());
+        failures++;
+        return;
+    }
+    for (size_t i = 0; i < read.size(); ++i) {
+        if (read[i] != expected[i]) {
+            printf("%s: epoch %d\n read     %s\n expected %s\n", name, (int) i, read[i].c_str(), expected[i].c_str());
+            failures++;
+        }
+    }
+}
+
+int main() {
+    ObsConvertTest test;
+    int failures = test.run();
+    if (failures == 0) printf("RINEX files conversion: OK\n");
+    else printf("RINEX files conversion: %d checks FAILED\n", failures);
+    return failures == 0? 0 : 1;
+}
@@ -0,0 +1,718 @@
+/** @file ObsReadTest.cpp
+ * Contains a host test of the reading of RINEX observation files mapped in memory (see mapInputFile): epochs read from
+ * the mapped file shall be the ones read sequentially with readObsEpoch using stdio, also for files with CR LF line
+ * ends, blank lines, or without EOL in the last line, and when the mapping starts or ends in the middle of the file.
+ * Files indexed with indexObsEpochs shall be read from any epoch sought with seekObsEpoch as they are read sequentially,
+ * also when seeking event epochs, and indexing shall not store the header records of events.
+ * Mapped files read in parallel (see setObsReadThreads) shall give the epochs read sequentially. Large files are generated
+ * with chunk limits at the start of an epoch line, in the middle of an epoch line, and at the start of an observation
+ * record, and with events in the middle of a chunk.
+ * Files merged with mergeObsFiles shall have the epochs read sequentially from the inputs in time order, with the epochs
+ * at the same time merged giving priority to the first input, and without new site and header information events.
+ */
+#include "RinexData.h"
+#include "Utilities.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+//@cond DUMMY
+#define TST_LARGECHUNKS 5       //the size in chunks (of OBS_READCHUNK bytes) of the large files generated
+#define TST_READTHREADS 4       //the number of threads reading in parallel
+//@endcond
+
+//A RINEX 2.11 observation file with a new site event, a header information event and an external event
+static const char OBS_V2[] =
+    "     2.11           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "     6    C1    L1    D1    S1    P2    L2                  # / TYPES OF OBSERV\n"
+    "    30.000                                                  INTERVAL\n"
+    "SITE1                                                       MARKER NAME\n"
+    "                                                            END OF HEADER\n"
+    " 21  1  1  0  0  0.0000000  0  3G01G05G12                            0.000123456\n"
+    "  20000999.995 7 105106999.993 7     -1235.576 7        45.259 7  20001002.995 7\n"
+    "  81904999.993\n"
+    "  20005000.007 7 105134999.997 7     -1239.580 7        45.327 7  20005003.007 7\n"
+    "  81924999.997\n"
+    "  20012000.028 7 105184000.004 7     -1246.587 7        45.446 7  20012003.028 7\n"
+    "  81960000.004\n"
+    " 21  1  1  0  0 30.0000000  0  3G01G05G12                            0.000123486\n"
+    "  20001030.010 7 105107157.711 7     -1235.557 7        45.270 7  20001033.020 7\n"
+    "  81905122.893 6\n"
+    "  20005030.026 7                     -1239.557 7        45.338 7  20005033.036 7\n"
+    "  81925122.901 6\n"
+    "  20012030.054 7 105184157.733 7     -1246.557 7        45.457 7  20012033.064 7\n"
+    "  81960122.915 6\n"
+    " 21  1  1  0  0 45.0000000  3  2\n"
+    "SITE2                                                       MARKER NAME\n"
+    "event comment                                               COMMENT\n"
+    " 21  1  1  0  1  0.0000000  0  3G01G12G20\n"
+    "  20001060.031 7 105107315.437 7     -1235.545 7        45.276 7  20001063.042 7\n"
+    "  81905245.792\n"
+    "  20012060.086 7 105184315.47017     -1246.534 7        45.463 7  20012063.097 7\n"
+    "  81960245.825\n"
+    "  20020060.126 7 105240315.494 7     -1254.526 7        45.599 7  20020063.137 7\n"
+    "  82000245.849\n"
+    " 21  1  1  0  1 15.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    " 21  1  1  0  1 30.0000000  0  4G01G05G12G20                        -0.000000012\n"
+    "  20001090.041 7 105107473.137 7     -1235.523 7        45.277 7  20001093.061 7\n"
+    "  81905368.673 6\n"
+    "  20005090.065 7 105135473.153 7     -1239.515 7        45.345 7  20005093.085 7\n"
+    "  81925368.689 6\n"
+    "  20012090.107 7 105184473.181 7     -1246.501 7        45.464 7  20012093.127 7\n"
+    "  81960368.717 6\n"
+    "  20020090.155 7 105240473.213 7                        45.600 7\n"
+    "  82000368.749 6\n"
+    " 21  1  1  0  1 40.0000000  5  0\n"
+    " 21  1  1  0  2  0.0000000  1  3G01G12G20                           -0.000000015\n"
+    "  20001120.057 7 105107630.862 7     -1235.508 7        45.290 7  20001123.077 7\n"
+    "  81905491.570\n"
+    "  20012120.134 7 105184630.917 7     -1246.475 7        45.477 7  20012123.154 7\n"
+    "  81960491.625\n"
+    "  20020120.190 7 105240630.957 7     -1254.451 7        45.613 7  20020123.210 7\n"
+    "  82000491.665\n";
+
+//A RINEX 3.04 observation file with the events in OBS_V2
+static const char OBS_V3[] =
+    "     3.04           OBSERVATION DATA    M                   RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "G    4 C1C L1C D1C S1C                                      SYS / # / OBS TYPES\n"
+    "E    2 C1X L1X                                              SYS / # / OBS TYPES\n"
+    "    30.000                                                  INTERVAL\n"
+    "SITE1                                                       MARKER NAME\n"
+    "                                                            END OF HEADER\n"
+    "> 2021 01 01 00 00  0.0000000  0  3       0.000123456789\n"
+    "E11  21011000.025 7 110177000.003\n"
+    "G01  21000999.995 7 110106999.993 7     -2235.576 7        41.259\n"
+    "G05  21005000.007 7 110134999.997 7     -2239.580 7        41.327\n"
+    "> 2021 01 01 00 00 30.0000000  0  3       0.000123486789\n"
+    "E11  21010970.006 7 110176842.283 6\n"
+    "G01  21000969.986 7 110106842.283 7     -2235.559 7\n"
+    "G05  21004969.994 7 110134842.283 7     -2239.559 7        41.336 6\n"
+    "> 2021 01 01 00 00 45.0000000  3  2\n"
+    "SITE2                                                       MARKER NAME\n"
+    "event comment                                               COMMENT\n"
+    "> 2021 01 01 00 01  0.0000000  0  3\n"
+    "E11  21010939.99317 110176684.571\n"
+    "G01  21000939.983 7 110106684.581 7     -2235.549 7        41.272\n"
+    "G12  21011939.994 7 110183684.570 7     -2246.538 7        41.459\n"
+    "> 2021 01 01 00 01 15.0000000  4  1\n"
+    "event comment                                               COMMENT\n"
+    "> 2021 01 01 00 01 30.0000000  0  4      -0.000000012345\n"
+    "E04  21003909.969 7 110127526.847 6\n"
+    "E11  21010909.969 7 110176526.833 6\n"
+    "G01  21000909.969 7 110106526.853 7     -2235.529 7        41.271 6\n"
+    "G12  21011909.969 7 110183526.831 7     -2246.507 7        41.458 6\n"
+    "> 2021 01 01 00 01 40.0000000  5  0\n"
+    "> 2021 01 01 00 02  0.0000000  1  3      -0.000000012375\n"
+    "E11  21010879.951 7 110176369.120\n"
+    "G01  21000879.961 7 110106369.150 7     -2235.516 7        41.282\n"
+    "G12  21011879.950 7 110183369.117 7     -2246.483 7        41.469\n";
+
+//A RINEX 3.04 observation file to be merged with OBS_V3 and OBS_V2, having epochs at their times, satellites in them,
+//an epoch at another time, and an event
+static const char OBS_MERGE[] =
+    "     3.04           OBSERVATION DATA    G (GPS)             RINEX VERSION / TYPE\n"
+    "DecoderTest         test                20261016 120000 UTC PGM / RUN BY / DATE\n"
+    "G    3 C1C L1C C2W                                          SYS / # / OBS TYPES\n"
+    "    30.000                                                  INTERVAL\n"
+    "                                                            END OF HEADER\n"
+    "> 2021 01 01 00 00 15.0000000  0  1       0.000223456789\n"
+    "G07  22007000.015 7 115607000.013 7  22007003.115\n"
+    "> 2021 01 01 00 00 30.0000000  0  2       0.000223486789\n"
+    "G01  22000969.986 7 115606842.283 7  22000973.086\n"
+    "G07  22006969.994 7 115606842.291 7  22006973.094\n"
+    "> 2021 01 01 00 01  0.0000000  2  0\n"
+    "> 2021 01 01 00 01 30.0000000  0  2      -0.000000022345\n"
+    "G07  22006909.969 7 115606526.851 6  22006913.069\n"
+    "G20  22020909.969 7 115620526.855 6  22020913.069\n";
+
+/**ObsReadTest class contains the test cases.
+ */
+class ObsReadTest {
+public:
+    ObsReadTest();
+    int run();
+
+private:
+    Logger log;
+    int failures;
+
+    void checkMappedRead(const char *name, const string &text, const char *plain);
+    void checkMapAfterHeader(const char *name, const char *text, int nEpochs);
+    void checkSeek(const char *name, const char *text, bool mapped);
+    void checkThreadedRead(const char *name, const string &text, int aheadEpochs = -1);
+    void checkMerge(const char *name, int threads);
+    FILE* textFile(const char *name, const string &text);
+    vector<string> readObsFile(FILE *file, bool mapped);
+    vector<string> readEpochs(RinexData &reader, FILE *file, int maxEpochs = -1, vector<double> *tTags = NULL);
+    void compareEpochs(const char *name, vector<string> &read, vector<string> &expected);
+    static vector<string> mergedEpochs(vector<vector<string> > &inEpochs, vector<vector<double> > &inTags);
+    static vector<string> epochTokens(const string &epoch, int &flag, size_t &nHead);
+    static string withoutZeroObs(const string &epoch);
+    static string crLfLines(const char *text);
+    static string blankLines(const char *text);
+    static string largeObsText(const char *fixture, bool v3);
+    static int countEpochs(const string &text, bool v3, size_t chunks);
+};
+
+ObsReadTest::ObsReadTest() {
+    failures = 0;
+}
+
+/**run performs all the checks.
+ *
+ * @return the number of failed checks
+ */
+int ObsReadTest::run() {
+    checkMappedRead("V2 mapped", OBS_V2, OBS_V2);
+    checkMappedRead("V3 mapped", OBS_V3, OBS_V3);
+    checkMappedRead("V2 with CR LF", crLfLines(OBS_V2), OBS_V2);
+    checkMappedRead("V3 with CR LF", crLfLines(OBS_V3), OBS_V3);
+    checkMappedRead("V2 with blank lines", blankLines(OBS_V2), OBS_V2);
+    checkMappedRead("V3 with blank lines", blankLines(OBS_V3), OBS_V3);
+    checkMappedRead("V2 without last EOL", string(OBS_V2, strlen(OBS_V2) - 1), OBS_V2);
+    checkMappedRead("V3 without last EOL", string(OBS_V3, strlen(OBS_V3) - 1), OBS_V3);
+    checkMapAfterHeader("V2 mapped after header", OBS_V2, 3);
+    checkMapAfterHeader("V3 mapped after header", OBS_V3, 4);
+    checkSeek("V2 seek", OBS_V2, false);
+    checkSeek("V3 seek", OBS_V3, false);
+    checkSeek("V2 mapped seek", OBS_V2, true);
+    checkSeek("V3 mapped seek", OBS_V3, true);
+    checkThreadedRead("V2 in parallel", OBS_V2);
+    checkThreadedRead("V3 in parallel", OBS_V3);
+    string large = largeObsText(OBS_V2, false);
+    checkThreadedRead("large V2 in parallel", large, countEpochs(large, false, TST_READTHREADS));
+    large = largeObsText(OBS_V3, true);
+    checkThreadedRead("large V3 in parallel", large, countEpochs(large, true, TST_READTHREADS));
+    checkMerge("merge", 0);
+    checkMerge("merge in parallel", TST_READTHREADS);
+    return failures;
+}
+
+/**checkMappedRead reads the given file with stdio and mapped in memory, and checks that the epochs read are the ones
+ * read with stdio from the plain file.
+ *
+ * @param name the check name, for messages
+ * @param text the file content
+ * @param plain the content of the file with the same epochs, having LF line ends and no blank lines
+ */
+void ObsReadTest::checkMappedRead(const char *name, const string &text, const char *plain) {
+    FILE *file = textFile(name, text);
+    if (file == NULL) return;
+    FILE *plainFile = textFile(name, plain);
+    if (plainFile == NULL) {
+        fclose(file);
+        return;
+    }
+    vector<string> expected = readObsFile(plainFile, false);
+    vector<string> read = readObsFile(file, false);
+    compareEpochs(name, read, expected);
+    read = readObsFile(file, true);
+    compareEpochs(name, read, expected);
+    fclose(plainFile);
+    fclose(file);
+}
+
+/**checkMapAfterHeader reads the header of the given file with stdio, the first epochs mapped in memory, and the rest of
+ * epochs with stdio after unmapping the file, and checks that the epochs read are the ones read only with stdio.
+ *
+ * @param name the check name, for messages
+ * @param text the file content
+ * @param nEpochs the number of epochs to read while the file is mapped
+ */
+void ObsReadTest::checkMapAfterHeader(const char *name, const char *text, int nEpochs) {
+    FILE *file = textFile(name, text);
+    if (file == NULL) return;
+    vector<string> expected = readObsFile(file, false);
+    rewind(file);
+    RinexData reader(RinexData::V304, &log);
+    vector<string> read;
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        read.push_back(string("header not read"));
+    } else if (!reader.mapInputFile(file)) {
+        read.push_back(string("file not mapped"));
+    } else {
+        read = readEpochs(reader, file, nEpochs);
+        reader.unmapInputFile();
+        vector<string> rest = readEpochs(reader, file);
+        read.insert(read.end(), rest.begin(), rest.end());
+    }
+    compareEpochs(name, read, expected);
+    fclose(file);
+}
+
+/**checkSeek indexes the given file, and checks that the header data are not changed by indexing, that all epochs are
+ * indexed, and that reading from each epoch sought, or from a time tag before it, gives the epochs read sequentially from it.
+ *
+ * @param name the check name, for messages
+ * @param text the file content, with a new site event and all its epochs having a date
+ * @param mapped true to read the file mapped in memory, false to read it using stdio
+ */
+void ObsReadTest::checkSeek(const char *name, const char *text, bool mapped) {
+    char msgSeek[100];
+    string marker;
+    vector<double> tTags;
+    FILE *file = textFile(name, text);
+    if (file == NULL) return;
+    RinexData sequential(RinexData::V304, &log);
+    vector<string> expected;
+    if (sequential.readRinexHeader(file) == RinexData::EOH) expected = readEpochs(sequential, file, -1, &tTags);
+    rewind(file);
+    RinexData reader(RinexData::V304, &log);
+    if (mapped && !reader.mapInputFile(file)) {
+        printf("%s: file not mapped\n", name);
+        failures++;
+        fclose(file);
+        return;
+    }
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        printf("%s: header not read\n", name);
+        failures++;
+    } else if (reader.indexObsEpochs(file) != (int) expected.size()) {
+        printf("%s: %d epochs indexed, expected %d\n", name, reader.indexObsEpochs(file), (int) expected.size());
+        failures++;
+    } else {
+        if (!reader.getHdLnData(RinexData::MRKNAME, marker) || marker.compare(0, 5, "SITE1") != 0) {
+            printf("%s: marker name %s after indexing, expected SITE1\n", name, marker.c_str());
+            failures++;
+        }
+        //reading continues where it was before indexing
+        vector<string> read = readEpochs(reader, file);
+        compareEpochs(name, read, expected);
+        for (size_t i = 0; i < tTags.size(); ++i) {
+            vector<string> rest(expected.begin() + i, expected.end());
+            snprintf(msgSeek, sizeof msgSeek, "%s epoch %d", name, (int) i);
+            if (!reader.seekObsEpoch(file, tTags[i])) {
+                printf("%s: not found\n", msgSeek);
+                failures++;
+                continue;
+            }
+            read = readEpochs(reader, file);
+            compareEpochs(msgSeek, read, rest);
+            //the time tag of the previous epoch is at least 10 seconds before
+            snprintf(msgSeek, sizeof msgSeek, "%s epoch %d - 1s", name, (int) i);
+            if (!reader.seekObsEpoch(file, tTags[i] - 1.0)) {
+                printf("%s: not found\n", msgSeek);
+                failures++;
+                continue;
+            }
+            read = readEpochs(reader, file);
+            compareEpochs(msgSeek, read, rest);
+        }
+        if (!tTags.empty() && reader.seekObsEpoch(file, tTags.back() + 1.0)) {
+            printf("%s: epoch found after the last one\n", name);
+            failures++;
+        }
+    }
+    reader.unmapInputFile();
+    fclose(file);
+}
+
+/**checkThreadedRead reads the given file mapped in memory with TST_READTHREADS threads, and checks that the epochs read
+ * are the ones read sequentially with stdio.
+ * Epochs in chunks not starting where the previous one ended are read again, giving the same epochs. To check that chunks
+ * start at epoch lines, the number of epochs read ahead by the first reading in parallel can also be checked.
+ *
+ * @param name the check name, for messages
+ * @param text the file content
+ * @param aheadEpochs the number of epochs in the first TST_READTHREADS chunks, or -1 to not check them
+ */
+void ObsReadTest::checkThreadedRead(const char *name, const string &text, int aheadEpochs) {
+    FILE *file = textFile(name, text);
+    if (file == NULL) return;
+    vector<string> expected = readObsFile(file, false);
+    rewind(file);
+    RinexData reader(RinexData::V304, &log);
+    vector<string> read;
+    if (!reader.mapInputFile(file)) {
+        read.push_back(string("file not mapped"));
+    } else if (reader.readRinexHeader(file) != RinexData::EOH) {
+        read.push_back(string("header not read"));
+    } else {
+        reader.setObsReadThreads(TST_READTHREADS);
+        read = readEpochs(reader, file, 1);
+        if (aheadEpochs >= 0 && (int) reader.obsReadAhead.size() + 1 != aheadEpochs) {
+            printf("%s: %d epochs read in parallel, expected %d\n", name, (int) reader.obsReadAhead.size() + 1, aheadEpochs);
+            failures++;
+        }
+        vector<string> rest = readEpochs(reader, file);
+        read.insert(read.end(), rest.begin(), rest.end());
+    }
+    reader.unmapInputFile();
+    compareEpochs(name, read, expected);
+    fclose(file);
+}
+
+/**checkMerge merges OBS_V3, OBS_V2 and OBS_MERGE with mergeObsFiles, and checks that the epochs read from the merged
+ * file are the ones read sequentially from the inputs, merged as stated in mergedEpochs. Observables without data are
+ * printed as zero in the merged file, and zero observables are not compared.
+ *
+ * @param name the check name, for messages
+ * @param threads the number of threads reading each input in parallel, or 0 to read them sequentially
+ */
+void ObsReadTest::checkMerge(const char *name, int threads) {
+    const char *texts[] = {OBS_V3, OBS_V2, OBS_MERGE};
+    vector<FILE*> inputs;
+    vector<vector<string> > inEpochs;
+    vector<vector<double> > inTags;
+    for (size_t i = 0; i < sizeof texts / sizeof texts[0]; ++i) {
+        FILE *file = textFile(name, texts[i]);
+        if (file == NULL) break;
+        inputs.push_back(file);
+        RinexData reader(RinexData::V304, &log);
+        inTags.push_back(vector<double>());
+        if (reader.readRinexHeader(file) == RinexData::EOH) inEpochs.push_back(readEpochs(reader, file, -1, &inTags.back()));
+        else inEpochs.push_back(vector<string>(1, string("header not read")));
+        for (vector<string>::iterator it = inEpochs.back().begin(); it != inEpochs.back().end(); ++it) *it = withoutZeroObs(*it);
+        rewind(file);
+    }
+    FILE *output = tmpfile();
+    if (inputs.size() == sizeof texts / sizeof texts[0] && output != NULL) {
+        vector<string> expected = mergedEpochs(inEpochs, inTags);
+        RinexData merger(RinexData::V304, &log);
+        merger.setObsReadThreads(threads);
+        try {
+            int nEpochs = merger.mergeObsFiles(inputs, output);
+            if (nEpochs != (int) expected.size()) {
+                printf("%s: %d epochs merged, expected %d\n", name, nEpochs, (int) expected.size());
+                failures++;
+            }
+            vector<string> read = readObsFile(output, false);
+            for (vector<string>::iterator it = read.begin(); it != read.end(); ++it) *it = withoutZeroObs(*it);
+            compareEpochs(name, read, expected);
+        } catch (string error) {
+            printf("%s: %s\n", name, error.c_str());
+            failures++;
+        }
+    } else if (output == NULL) {
+        printf("%s: cannot create the output file\n", name);
+        failures++;
+    }
+    for (vector<FILE*>::iterator it = inputs.begin(); it != inputs.end(); ++it) fclose(*it);
+    if (output != NULL) fclose(output);
+}
+
+/**textFile creates a temporary file with the given text, positioned at its beginning.
+ *
+ * @param name the check name, for messages
+ * @param text the file content
+ * @return the file, or NULL if it cannot be created
+ */
+FILE* ObsReadTest::textFile(const char *name, const string &text) {
+    FILE *file = tmpfile();
+    if (file == NULL) {
+        printf("%s: cannot create the temporary file\n", name);
+        failures++;
+        return NULL;
+    }
+    fwrite(text.data(), 1, text.size(), file);
+    rewind(file);
+    return file;
+}
+
+/**readObsFile reads the header and the epochs in the given observation file.
+ *
+ * @param file the observation file
+ * @param mapped true to read the file mapped in memory, false to read it using stdio
+ * @return the epochs read (see readEpochs)
+ */
+vector<string> ObsReadTest::readObsFile(FILE *file, bool mapped) {
+    vector<string> epochs;
+    rewind(file);
+    RinexData reader(RinexData::V304, &log);
+    if (mapped && !reader.mapInputFile(file)) {
+        epochs.push_back(string("file not mapped"));
+        return epochs;
+    }
+    if (reader.readRinexHeader(file) != RinexData::EOH) {
+        epochs.push_back(string("header not read"));
+    } else {
+        epochs = readEpochs(reader, file);
+    }
+    reader.unmapInputFile();
+    return epochs;
+}
+
+/**readEpochs reads sequentially with readObsEpoch the epochs in the given observation file, from its current position.
+ * Each epoch is given as a string with its time, status, flag, clock offset, and its observables sorted by satellite
+ * and type. New site events also give the marker name read.
+ *
+ * @param reader the object reading the file, with its header already read
+ * @param file the observation file
+ * @param maxEpochs the maximum number of epochs to read, or -1 to read up to the end of file
+ * @param tTags if not NULL, the vector where the time tag of each epoch read is appended
+ * @return the epochs read
+ */
+vector<string> ObsReadTest::readEpochs(RinexData &reader, FILE *file, int maxEpochs, vector<double> *tTags) {
+    char buffer[100];
+    char obsSys;
+    int week, flag, sat, lli, strg;
+    double tow, bias, value;
+    string obsType, marker;
+    vector<string> epochs;
+    vector<string> obs;
+    while ((maxEpochs < 0 || (int) epochs.size() < maxEpochs)) {
+        int status = reader.readObsEpoch(file);
+        if (status == 0 || status == 9) break;
+        reader.getEpochTime(week, tow, bias, flag);
+        if (tTags != NULL) tTags->push_back(getInstantGNSStime(week, tow));
+        formatGPStime(buffer, sizeof buffer, "%Y/%m/%d %H:%M:", "%010.7f", week, tow);
+        string epoch(buffer);
+        snprintf(buffer, sizeof buffer, " %d %d", status, flag);
+        epoch += string(buffer);
+        //events have not clock offset, and keep the one of the previous epoch read
+        if (flag < 2 || flag > 5) {
+            snprintf(buffer, sizeof buffer, " %.12f", bias);
+            epoch += string(buffer);
+        }
+        if (flag == 3 && reader.getHdLnData(RinexData::MRKNAME, marker)) epoch += " marker " + marker;
+        obs.clear();
+        for (unsigned int i = 0; reader.getObsData(obsSys, sat, obsType, value, lli, strg, i); ++i) {
+            snprintf(buffer, sizeof buffer, " %c%02d %s %.3f %d %d", obsSys, sat, obsType.c_str(), value, lli, strg);
+            obs.push_back(string(buffer));
+        }
+        sort(obs.begin(), obs.end());
+        for (vector<string>::iterator it = obs.begin(); it != obs.end(); ++it) epoch += *it;
+        epochs.push_back(epoch);
+    }
+    return epochs;
+}
+
+/**compareEpochs checks that the epochs read are the expected ones.
+ *
+ * @param name the check name, for messages
+ * @param read the epochs read
+ * @param expected the epochs expected
+ */
+void ObsReadTest::compareEpochs(const char *name, vector<string> &read, vector<string> &expected) {
+    if (read.size() != expected.size()) {
+        printf("%s: %d epochs read, expected %d\n", name, (int) read.size(), (int) expected.size());
+        failures++;
+        return;
+    }
+    for (size_t i = 0; i < read.size(); ++i) {
+        if (read[i] != expected[i]) {
+            printf("%s: epoch %d\n read     %s\n expected %s\n", name, (int) i, read[i].c_str(), expected[i].c_str());
+            failures++;
+            return;
+        }
+    }
+}
+
+/**mergedEpochs gives the epochs expected when merging input files with the given epochs: they are in time order, and
+ * epochs at the same time are in input order. Observation epochs at the same time in several inputs are merged in one,
+ * having the time, flag and clock offset of the first one, and for each satellite the data of the first input having it.
+ * Events are not merged, and new site and header information events are removed.
+ *
+ * @param inEpochs the epochs read from each input (see readEpochs)
+ * @param inTags the time tags of the epochs read from each input
+ * @return the merged epochs
+ */
+vector<string> ObsReadTest::mergedEpochs(vector<vector<string> > &inEpochs, vector<vector<double> > &inTags) {
+    vector<pair<pair<double, size_t>, size_t> > order;     //the time tag, input, and index in it of each epoch to merge
+    vector<string> merged;
+    int flag;
+    size_t nHead;
+    for (size_t i = 0; i < inEpochs.size(); ++i) {
+        for (size_t j = 0; j < inEpochs[i].size(); ++j) {
+            epochTokens(inEpochs[i][j], flag, nHead);
+            if (flag != 3 && flag != 4) order.push_back(make_pair(make_pair(inTags[i][j], i), j));
+        }
+    }
+    sort(order.begin(), order.end());
+    for (size_t k = 0; k < order.size(); ) {
+        const string &first = inEpochs[order[k].first.second][order[k].second];
+        vector<string> tokens = epochTokens(first, flag, nHead);
+        if (flag > 1) {
+            merged.push_back(first);
+            ++k;
+            continue;
+        }
+        string epoch;
+        for (size_t t = 0; t < nHead; ++t) epoch += (t == 0 ? "" : " ") + tokens[t];
+        map<string, size_t> satInput;
+        vector<string> obs;
+        for (size_t time = k; k < order.size() && order[k].first.first == order[time].first.first; ++k) {
+            size_t input = order[k].first.second;
+            tokens = epochTokens(inEpochs[input][order[k].second], flag, nHead);
+            if (flag > 1) break;
+            for (size_t t = nHead; t + 5 <= tokens.size(); t += 5) {
+                if (satInput.insert(make_pair(tokens[t], input)).first->second != input) continue;
+                obs.push_back(" " + tokens[t] + " " + tokens[t + 1] + " " + tokens[t + 2] + " " + tokens[t + 3] + " " + tokens[t + 4]);
+            }
+        }
+        sort(obs.begin(), obs.end());
+        for (vector<string>::iterator it = obs.begin(); it != obs.end(); ++it) epoch += *it;
+        merged.push_back(epoch);
+    }
+    return merged;
+}
+
+/**epochTokens splits in blank separated tokens the given epoch (see readEpochs).
+ *
+ * @param epoch the epoch
+ * @param flag the epoch flag
+ * @param nHead the number of tokens before the observables (date, time, status, flag, and clock offset if any)
+ * @return the tokens
+ */
+vector<string> ObsReadTest::epochTokens(const string &epoch, int &flag, size_t &nHead) {
+    vector<string> tokens;
+    istringstream tokenizer(epoch);
+    string token;
+    while (tokenizer >> token) tokens.push_back(token);
+    flag = tokens.size() > 3 ? atoi(tokens[3].c_str()) : -1;
+    nHead = (flag < 2 || flag > 5) ? 5 : 4;
+    return tokens;
+}
+
+/**withoutZeroObs gives the given epoch (see readEpochs) without the observables having zero value, LLI and strength.
+ *
+ * @param epoch the epoch
+ * @return the epoch without zero observables
+ */
+string ObsReadTest::withoutZeroObs(const string &epoch) {
+    int flag;
+    size_t nHead;
+    vector<string> tokens = epochTokens(epoch, flag, nHead);
+    string result;
+    for (size_t t = 0; t < nHead && t < tokens.size(); ++t) result += (t == 0 ? "" : " ") + tokens[t];
+    for (size_t t = nHead; t + 5 <= tokens.size(); t += 5) {
+        if (tokens[t + 2] == "0.000" && tokens[t + 3] == "0" && tokens[t + 4] == "0") continue;
+        result += " " + tokens[t] + " " + tokens[t + 1] + " " + tokens[t + 2] + " " + tokens[t + 3] + " " + tokens[t + 4];
+    }
+    return result;
+}
+
+/**crLfLines gives the given text with CR LF line ends.
+ *
+ * @param text the text with LF line ends
+ * @return the text with CR LF line ends
+ */
+string ObsReadTest::crLfLines(const char *text) {
+    string result;
+    for (const char *c = text; *c != '\0'; ++c) {
+        if (*c == '\n') result.push_back('\r');
+        result.push_back(*c);
+    }
+    return result;
+}
+
+/**blankLines gives the given text with an empty line and a line of blanks before each epoch line.
+ *
+ * @param text the text of a V2 or V3 observation file
+ * @return the text with blank lines added
+ */
+string ObsReadTest::blankLines(const char *text) {
+    string result;
+    for (const char *line = text; *line != '\0'; ) {
+        const char *eol = strchr(line, '\n');
+        if (strncmp(line, "> ", 2) == 0 || strncmp(line, " 21 ", 4) == 0) result += "\n    \n";
+        result.append(line, eol + 1 - line);
+        line = eol + 1;
+    }
+    return result;
+}
+
+/**largeObsText generates an observation file of TST_LARGECHUNKS chunks with the header of the given fixture and
+ * pseudo-random observables. Chunks start after the header, and blank lines are inserted to have the first chunk limit at
+ * the start of an epoch line, the second one in the middle of an epoch line, and the third one at the start of the first
+ * observation record of an epoch. After the fourth one, a new site event and a header information event are added.
+ *
+ * @param fixture the fixture with the header to use (OBS_V2 or OBS_V3)
+ * @param v3 true if the fixture is a V3 file, false if it is a V2 one
+ * @return the file content
+ */
+string ObsReadTest::largeObsText(const char *fixture, bool v3) {
+    char buffer[100];
+    unsigned int seed = 12345;
+    const int nTypes = v3 ? 4 : 6;
+    bool eventsAdded = false;
+    string text(fixture, strstr(fixture, "END OF HEADER\n") + 14 - fixture);
+    const size_t start = text.size();
+    size_t limit = 1;
+    for (int i = 0; text.size() < start + (size_t) TST_LARGECHUNKS * OBS_READCHUNK; ++i) {
+        //epoch date, used also by events
+        int second = i * 30;
+        if (v3) snprintf(buffer, sizeof buffer, "> 2021 01 %02d %02d %02d %02d.0000000", 1 + second / 86400,
+                         second / 3600 % 24, second / 60 % 60, second % 60);
+        else snprintf(buffer, sizeof buffer, " 21  1 %2d %2d %2d %2d.0000000", 1 + second / 86400,
+                      second / 3600 % 24, second / 60 % 60, second % 60);
+        string date(buffer);
+        if (!eventsAdded && text.size() > start + 4 * OBS_READCHUNK + OBS_READCHUNK / 2) {
+            text += date + "  3  1\n"
+                    "SITE3                                                       MARKER NAME\n";
+            text += date + "  4  1\n"
+                    "event comment                                               COMMENT\n";
+            eventsAdded = true;
+        }
+        //epoch line, with 3 GPS satellites and, in V3, a Galileo one
+        int sats[] = {1 + i / 50 % 30, 2 + i / 70 % 29, 3 + i / 90 % 28};
+        if (v3) snprintf(buffer, sizeof buffer, "  0  4\n");
+        else snprintf(buffer, sizeof buffer, "  0  3G%02dG%02dG%02d\n", sats[0], sats[1], sats[2]);
+        string epoch = date + buffer;
+        size_t recordPos = epoch.size();
+        for (int sat = 0; sat < 4; ++sat) {
+            if (!v3 && sat == 3) break;
+            int n = sat < 3 ? nTypes : 2;
+            string record;
+            if (v3) {
+                snprintf(buffer, sizeof buffer, "%c%02d", sat < 3 ? 'G' : 'E', sat < 3 ? sats[sat] : 11);
+                record = buffer;
+            }
+            for (int k = 0; k < n; ++k) {
+                if (!v3 && k == 5) record += "\n";
+                seed = seed * 1103515245 + 12345;
+                unsigned int value = seed >> 8;
+                //the first observable in each line is not missing, to not have blank lines
+                if (value % 23 == 0 && k % 5 != 0) snprintf(buffer, sizeof buffer, "%16s", "");
+                else snprintf(buffer, sizeof buffer, "%14.3f%c%d", (value % 200000000) / 1000.0 + (k == 2 ? -100000.0 : 20000000.0),
+                              value % 7 == 0 ? '1' : ' ', value % 9 + 1);
+                record += buffer;
+            }
+            record.erase(record.find_last_not_of(' ') + 1);
+            epoch += record + "\n";
+        }
+        //blank lines to set the first chunk limits
+        const size_t offset[] = {0, 5, recordPos};
+        if (limit <= 3 && text.size() + epoch.size() > start + limit * OBS_READCHUNK - offset[limit - 1]) {
+            size_t pad = start + limit * OBS_READCHUNK - offset[limit - 1] - text.size();
+            if (pad > 0) text += string(pad - 1, ' ') + "\n";
+            limit++;
+        }
+        text += epoch;
+    }
+    return text;
+}
+
+/**countEpochs gives the number of epochs in the given number of chunks at the beginning of the given observation file.
+ * Chunks start after the header, and each one ends at the first epoch line starting at or after OBS_READCHUNK bytes from
+ * its start.
+ *
+ * @param text the file content, without blank lines in the header
+ * @param v3 true if the file is a V3 one, false if it is a V2 one
+ * @param chunks the number of chunks
+ * @return the number of epochs in the chunks
+ */
+int ObsReadTest::countEpochs(const string &text, bool v3, size_t chunks) {
+    //epoch lines are the ones starting with '>' in V3 files, and with the year of the generated epochs in V2 files
+    const string epochStart(v3 ? "\n>" : "\n 21 ");
+    size_t start = text.find("END OF HEADER\n") + 14;
+    size_t limit = text.find(epochStart, start + chunks * OBS_READCHUNK - 1);
+    int nEpochs = 0;
+    for (size_t pos = text.find(epochStart, start - 1); pos < limit; pos = text.find(epochStart, pos + 1)) nEpochs++;
+    return nEpochs;
+}
+
+int main() {
+    ObsReadTest test;
+    int failures = test.run();
+    if (failures == 0) printf("Observation files reading: OK\n");
+    else printf("Observation files reading: %d checks FAILED\n", failures);
+    return failures == 0? 0 : 1;
+}